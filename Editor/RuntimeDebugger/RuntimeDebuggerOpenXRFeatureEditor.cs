@@ -9,11 +9,29 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
     {
         private SerializedProperty cacheSize;
         private SerializedProperty perThreadCacheSize;
+        private SerializedProperty captureBudgetMs;
+        private SerializedProperty captureBandwidthBudget;
+        private SerializedProperty captureStacksOnError;
+        private SerializedProperty slowCallStackThresholdMs;
+        private SerializedProperty maxStacksPerSecond;
+        private SerializedProperty streamCapture;
+        private SerializedProperty streamPort;
+        private SerializedProperty streamSocketName;
+        private SerializedProperty streamQueueSize;
 
         void OnEnable()
         {
             cacheSize = serializedObject.FindProperty("cacheSize");
             perThreadCacheSize = serializedObject.FindProperty("perThreadCacheSize");
+            captureBudgetMs = serializedObject.FindProperty("captureBudgetMs");
+            captureBandwidthBudget = serializedObject.FindProperty("captureBandwidthBudget");
+            captureStacksOnError = serializedObject.FindProperty("captureStacksOnError");
+            slowCallStackThresholdMs = serializedObject.FindProperty("slowCallStackThresholdMs");
+            maxStacksPerSecond = serializedObject.FindProperty("maxStacksPerSecond");
+            streamCapture = serializedObject.FindProperty("streamCapture");
+            streamPort = serializedObject.FindProperty("streamPort");
+            streamSocketName = serializedObject.FindProperty("streamSocketName");
+            streamQueueSize = serializedObject.FindProperty("streamQueueSize");
         }
 
         public override void OnInspectorGUI()
@@ -22,6 +40,18 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
 
             EditorGUILayout.PropertyField(cacheSize, new GUIContent("Cache Size", "Defines the maximum size of the cache (in bytes) used to store OpenXR runtime debugging information. The cache stores function call data and frame statistics for analysis in the Runtime Debugger Window. Increase this value if you need to capture more debugging data, especially for longer recording sessions."));
             EditorGUILayout.PropertyField(perThreadCacheSize, new GUIContent("Per Thread Cache Size", "Size of per-thread cache on device for runtime debugger in bytes."));
+            EditorGUILayout.PropertyField(captureBudgetMs, new GUIContent("Capture Budget (ms)", "CPU time per frame the runtime debugger may spend capturing. When capturing takes longer, less detail is captured until there is headroom again. 0 disables the budget."));
+            EditorGUILayout.PropertyField(captureBandwidthBudget, new GUIContent("Capture Bandwidth Budget", "Capture data per frame the runtime debugger may produce, in bytes. 0 disables the budget."));
+            EditorGUILayout.PropertyField(captureStacksOnError, new GUIContent("Capture Stacks On Error", "Record the native stack of OpenXR calls that return an error."));
+            EditorGUILayout.PropertyField(slowCallStackThresholdMs, new GUIContent("Slow Call Stack Threshold (ms)", "Record the native stack of OpenXR calls the runtime takes longer than this to return from. 0 disables it."));
+            EditorGUILayout.PropertyField(maxStacksPerSecond, new GUIContent("Max Stacks Per Second", "Most native stacks recorded per second. Calls over the limit are captured without their stack."));
+            EditorGUILayout.PropertyField(streamCapture, new GUIContent("Stream Capture", "Push capture data to a local socket as it's captured. Connect to it with Stream in the Runtime Debugger window, on Android after forwarding it with adb."));
+            if (streamCapture.boolValue)
+            {
+                EditorGUILayout.PropertyField(streamPort, new GUIContent("Stream Port", "TCP port on 127.0.0.1 the capture stream listens on. Forward it with adb forward tcp:port tcp:port."));
+                EditorGUILayout.PropertyField(streamSocketName, new GUIContent("Stream Socket Name", "Unix domain socket to listen on instead of the port. A leading @ puts it in the abstract namespace, forward it with adb forward tcp:port localabstract:name."));
+                EditorGUILayout.PropertyField(streamQueueSize, new GUIContent("Stream Queue Size", "Capture data the stream may hold while the window falls behind, in bytes. Past half of it, less detail is captured."));
+            }
 
             if (GUILayout.Button("Open Debugger Window"))
             {
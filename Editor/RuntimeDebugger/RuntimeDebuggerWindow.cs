@@ -1,6 +1,10 @@
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.IO;
+using System.Net.Sockets;
 using System.Text;
+using System.Threading;
 using UnityEditor.IMGUI.Controls;
 #if UNITY_6000_2_OR_NEWER
 using TreeView = UnityEditor.IMGUI.Controls.TreeView<int>;
@@ -50,9 +54,13 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
             }
             else
             {
-                if (DebuggerState.xrLut.TryGetValue((UInt32)_mode - 1, out var lut))
+                // Show the entries of every instance together.
+                foreach (var lut in DebuggerState.xrLut)
                 {
-                    foreach (var t in lut.Values)
+                    if ((lut.Key & DebuggerState.LutIndexMask) != (UInt32)_mode - 1)
+                        continue;
+
+                    foreach (var t in lut.Value.Values)
                     {
                         if (string.IsNullOrEmpty(searchString) || (deep ? t.ToString() : t.displayName).IndexOf(searchString, StringComparison.OrdinalIgnoreCase) >= 0)
                             root.AddChild(t);
@@ -85,6 +93,71 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
         }
     }
 
+    /// <summary>
+    /// Reads the capture stream of a player with Stream Capture enabled, see capture_stream.h.
+    /// Frames are read on a background thread and handed to the window from its Update.
+    /// </summary>
+    internal class DebuggerStreamClient : IDisposable
+    {
+        private TcpClient _client;
+        private Thread _thread;
+        private readonly ConcurrentQueue<byte[]> _payloads = new ConcurrentQueue<byte[]>();
+        private volatile bool _closed;
+
+        internal string error { get; private set; }
+        internal bool connected => !_closed;
+
+        internal DebuggerStreamClient(string host, int port)
+        {
+            _client = new TcpClient();
+            _client.Connect(host, port);
+            _thread = new Thread(Read) { IsBackground = true, Name = "OpenXR Runtime Debugger Stream" };
+            _thread.Start();
+        }
+
+        private void Read()
+        {
+            try
+            {
+                using (var r = new BinaryReader(_client.GetStream()))
+                {
+                    while (!_closed)
+                    {
+                        var size = r.ReadUInt32();
+                        r.ReadUInt32(); // frame kind, LUT and capture data parse the same way
+                        _payloads.Enqueue(r.ReadBytes((int)size));
+                    }
+                }
+            }
+            catch (Exception e)
+            {
+                if (!_closed)
+                    error = e.Message;
+            }
+            _closed = true;
+        }
+
+        // Everything received since the last call, in order, or null.
+        internal byte[] TakeReceived()
+        {
+            if (_payloads.IsEmpty)
+                return null;
+
+            using (var ms = new MemoryStream())
+            {
+                while (_payloads.TryDequeue(out var payload))
+                    ms.Write(payload, 0, payload.Length);
+                return ms.ToArray();
+            }
+        }
+
+        public void Dispose()
+        {
+            _closed = true;
+            _client.Close();
+        }
+    }
+
     internal class RuntimeDebuggerWindow : EditorWindow
     {
         private static class Styles
@@ -120,12 +193,231 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
             state = PlayerConnectionGUIUtility.GetConnectionState(this);
             EditorConnection.instance.Initialize();
             EditorConnection.instance.Register(RuntimeDebuggerOpenXRFeature.kPlayerToEditorSendDebuggerOutput, DebuggerState.OnMessageEvent);
+            EditorConnection.instance.Register(RuntimeDebuggerOpenXRFeature.kPlayerToEditorSendDebuggerStats, OnStatsEvent);
         }
 
         void OnDisable()
         {
             EditorConnection.instance.Unregister(RuntimeDebuggerOpenXRFeature.kPlayerToEditorSendDebuggerOutput, DebuggerState.OnMessageEvent);
+            EditorConnection.instance.Unregister(RuntimeDebuggerOpenXRFeature.kPlayerToEditorSendDebuggerStats, OnStatsEvent);
             state.Dispose();
+            StopStream();
+        }
+
+        private DebuggerStreamClient streamClient;
+        private string streamAddress = "127.0.0.1:7960";
+        private double nextStreamUpdate;
+
+        void StartStream()
+        {
+            var separator = streamAddress.LastIndexOf(':');
+            if (separator < 0 || !int.TryParse(streamAddress.Substring(separator + 1), out var port))
+            {
+                _lastRefreshStats = $"Stream address should be host:port, got {streamAddress}";
+                return;
+            }
+
+            try
+            {
+                streamClient = new DebuggerStreamClient(streamAddress.Substring(0, separator), port);
+            }
+            catch (Exception e)
+            {
+                _lastRefreshStats = $"Couldn't connect to {streamAddress}: {e.Message}";
+                return;
+            }
+
+            // The stream starts over with the capture header and LUT.
+            Clear();
+            DebuggerState.SetDoneCallback(() =>
+            {
+                if (treeViewState.Count != DebuggerState.lutNames.Count)
+                {
+                    treeViewState.Clear();
+                    for (int i = 0; i < DebuggerState.lutNames.Count; ++i)
+                    {
+                        treeViewState.Add(new TreeViewState());
+                    }
+                }
+
+                treeView = new DebuggerTreeView(treeViewState[viewMode], viewMode, searchString);
+                _lastRefreshStats = $"Streaming from {streamAddress}, last payload size: {DebuggerState._lastPayloadSize} Calls: {DebuggerState._functionCalls.Count}";
+            });
+            _lastRefreshStats = $"Streaming from {streamAddress} ...";
+        }
+
+        void StopStream()
+        {
+            streamClient?.Dispose();
+            streamClient = null;
+        }
+
+        void Update()
+        {
+            if (streamClient == null)
+                return;
+
+            // Rebuilding the tree is the expensive part, batch what came in.
+            if (EditorApplication.timeSinceStartup < nextStreamUpdate)
+                return;
+            nextStreamUpdate = EditorApplication.timeSinceStartup + 0.5;
+
+            var received = streamClient.TakeReceived();
+            if (received != null)
+                DebuggerState.OnMessageEvent(new MessageEventArgs() { playerId = 0, data = received });
+
+            if (!streamClient.connected)
+            {
+                _lastRefreshStats = $"Stream from {streamAddress} closed{(streamClient.error != null ? ": " + streamClient.error : "")}";
+                StopStream();
+            }
+            Repaint();
+        }
+
+        void OnStatsEvent(MessageEventArgs args)
+        {
+            DebuggerState.OnStatsEvent(args);
+            Repaint();
+        }
+
+        private bool showCaptureFilter;
+        private string filterFunctions = "";
+        private string filterThread = "";
+        private string filterHandle = "";
+        private string filterStartTime = "";
+        private string filterEndTime = "";
+        private RuntimeDebuggerOpenXRFeature.CaptureResultClass filterResults;
+
+        // Sent like Refresh: straight to the feature while playing in the editor, over player connection otherwise.
+        void SendCaptureFilter(byte[] message)
+        {
+            if (EditorApplication.isPlaying)
+            {
+                var debugger = OpenXRSettings.Instance.GetFeature<RuntimeDebuggerOpenXRFeature>();
+                if (debugger.enabled)
+                    debugger.RecvCaptureFilterMsg(new MessageEventArgs() { data = message });
+            }
+            else
+            {
+                EditorConnection.instance.Send(RuntimeDebuggerOpenXRFeature.kEditorToPlayerSetCaptureFilter, message);
+            }
+        }
+
+        void CaptureFilterGUI()
+        {
+            showCaptureFilter = EditorGUILayout.Foldout(showCaptureFilter, new GUIContent("Capture Filter", "Only send matching calls from the player. Applies to the next Refresh."), true);
+            if (!showCaptureFilter)
+                return;
+
+            ++EditorGUI.indentLevel;
+            filterFunctions = EditorGUILayout.TextField(new GUIContent("Functions", "Comma separated function names, empty for all functions."), filterFunctions);
+            filterThread = EditorGUILayout.TextField(new GUIContent("Thread", "Thread id as shown on captured calls, empty for all threads."), filterThread);
+            filterHandle = EditorGUILayout.TextField(new GUIContent("Handle", "Only calls passing this handle, empty for all calls."), filterHandle);
+            filterStartTime = EditorGUILayout.TextField(new GUIContent("Start Time", "Player wall clock time (ex. 14:03:25.5) or capture timestamp of the first call to keep, empty for no limit. Times need a capture, Refresh first."), filterStartTime);
+            filterEndTime = EditorGUILayout.TextField(new GUIContent("End Time", "Player wall clock time or capture timestamp to stop keeping calls at, empty for no limit."), filterEndTime);
+            filterResults = (RuntimeDebuggerOpenXRFeature.CaptureResultClass)EditorGUILayout.EnumFlagsField(new GUIContent("Results", "Nothing matches every result."), filterResults);
+
+            GUILayout.BeginHorizontal();
+            if (GUILayout.Button("Apply Filter"))
+            {
+                if (!TryParseHandle(filterHandle.Trim(), out var handle))
+                {
+                    _lastRefreshStats = $"Filter handle should be a number, got {filterHandle}";
+                }
+                else if (!TryParseTime(filterStartTime.Trim(), out var startTime))
+                {
+                    _lastRefreshStats = $"Filter start time should be a time or a timestamp, got {filterStartTime}";
+                }
+                else if (!TryParseTime(filterEndTime.Trim(), out var endTime))
+                {
+                    _lastRefreshStats = $"Filter end time should be a time or a timestamp, got {filterEndTime}";
+                }
+                else if (startTime != 0 && endTime != 0 && endTime <= startTime)
+                {
+                    _lastRefreshStats = "Filter end time should be after the start time";
+                }
+                else
+                {
+                    var functionNames = filterFunctions.Split(new[] { ',', ' ' }, StringSplitOptions.RemoveEmptyEntries);
+                    var filter = new RuntimeDebuggerOpenXRFeature.CaptureFilter { startTime = startTime, endTime = endTime, handle = handle, resultClasses = filterResults };
+                    SendCaptureFilter(RuntimeDebuggerOpenXRFeature.SerializeCaptureFilter(filter, functionNames, filterThread.Trim()));
+                    _lastRefreshStats = "Capture filter set, Refresh to get matching calls.";
+                }
+            }
+            if (GUILayout.Button("Clear Filter"))
+            {
+                SendCaptureFilter(new byte[0]);
+                _lastRefreshStats = "Capture filter cleared.";
+            }
+            GUILayout.EndHorizontal();
+            --EditorGUI.indentLevel;
+        }
+
+        // Plain numbers are capture timestamps, anything else is a wall clock time on the player, converted with the clocks in
+        // the header of the current capture.
+        static bool TryParseTime(string text, out Int64 timestamp)
+        {
+            timestamp = 0;
+            if (text.Length == 0)
+                return true;
+            if (Int64.TryParse(text, out timestamp))
+                return true;
+            if (DebuggerState.captureHeader == null || !DateTime.TryParse(text, out var time))
+                return false;
+            timestamp = DebuggerState.captureHeader.ToTimestamp(time);
+            return true;
+        }
+
+        // Handles are shown in decimal, accept hex too.
+        static bool TryParseHandle(string text, out UInt64 handle)
+        {
+            handle = 0;
+            if (text.Length == 0)
+                return true;
+            if (text.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+                return UInt64.TryParse(text.Substring(2), System.Globalization.NumberStyles.HexNumber, null, out handle);
+            return UInt64.TryParse(text, out handle);
+        }
+
+        private bool showDeviceStats;
+
+        void DeviceStatsGUI()
+        {
+            showDeviceStats = EditorGUILayout.Foldout(showDeviceStats, new GUIContent("Device Stats", "Computed on the player, updated on Refresh."), true);
+            if (!showDeviceStats)
+                return;
+
+            ++EditorGUI.indentLevel;
+            var stats = DebuggerState.stats;
+            if (stats == null)
+            {
+                EditorGUILayout.LabelField("Refresh to get stats from the player.");
+                --EditorGUI.indentLevel;
+                return;
+            }
+
+            var memory = stats.memory;
+            EditorGUILayout.LabelField("Memory", $"{memory.totalBytes / 1024} KB (capture {memory.mainStoreBytes / 1024} KB, LUT {memory.lutStoreBytes / 1024} KB, {memory.liveThreadBuffers} thread buffers {memory.threadBufferBytes / 1024} KB, analytics {memory.analyticsBytes / 1024} KB)");
+            EditorGUILayout.LabelField("Dropped", $"{memory.cacheNotLargeEnoughCount} calls too large for the cache, {memory.threadBufferFailedWrites} failed thread buffer writes");
+            if (stats.captureDetail != RuntimeDebuggerOpenXRFeature.CaptureDetail.Full)
+                EditorGUILayout.LabelField("Capture Detail", $"{stats.captureDetail}, lowered to stay within the capture budget");
+            if (stats.stacksRateLimited != 0)
+                EditorGUILayout.LabelField("Stacks", $"{stats.stacksRateLimited} calls captured without their stack, over the stacks per second limit");
+
+            var pacing = stats.framePacing;
+            if (pacing.cpuTime != null && pacing.waitToEnd != null)
+            {
+                EditorGUILayout.LabelField("Frames", $"{pacing.totalFrames} total, last {pacing.windowFrames}: {pacing.missedVsyncs} missed vsyncs, {pacing.lateFrames} late, {pacing.discardedFrames} discarded");
+                EditorGUILayout.LabelField("Frame CPU Time", $"median {RuntimeDebuggerOpenXRFeature.HistogramPercentile(pacing.cpuTime, pacing.bucketWidthUs, 0.5f):F1} ms, 95% {RuntimeDebuggerOpenXRFeature.HistogramPercentile(pacing.cpuTime, pacing.bucketWidthUs, 0.95f):F1} ms");
+                EditorGUILayout.LabelField("Wait To End", $"median {RuntimeDebuggerOpenXRFeature.HistogramPercentile(pacing.waitToEnd, pacing.bucketWidthUs, 0.5f):F1} ms, 95% {RuntimeDebuggerOpenXRFeature.HistogramPercentile(pacing.waitToEnd, pacing.bucketWidthUs, 0.95f):F1} ms");
+            }
+
+            foreach (var pose in stats.poses)
+            {
+                var name = pose.viewIndex != UInt32.MaxValue ? $"View {pose.viewIndex}" : $"Space {pose.space} in {pose.baseSpace}";
+                EditorGUILayout.LabelField(name, $"{pose.sampleCount} samples, jitter {pose.positionalJitter * 1000.0f:F2} mm / {pose.rotationalJitter * Mathf.Rad2Deg:F2} deg (max {pose.maxPositionalJitter * 1000.0f:F2} mm / {pose.maxRotationalJitter * Mathf.Rad2Deg:F2} deg), {pose.trackingLossCount} tracking losses ({pose.trackingLossTotal / 1000000.0:F0} ms)");
+            }
+            --EditorGUI.indentLevel;
         }
 
         private Vector2 scrollpos = new Vector2();
@@ -255,6 +547,22 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
 
             GUILayout.EndHorizontal();
 
+            GUILayout.BeginHorizontal();
+            GUI.enabled = streamClient == null;
+            streamAddress = EditorGUILayout.TextField(new GUIContent("Capture Stream", "Address of a player with Stream Capture enabled. For Android devices forward the port first with adb forward."), streamAddress);
+            GUI.enabled = true;
+            if (GUILayout.Button(streamClient == null ? "Stream" : "Stop Stream", GUILayout.ExpandWidth(false)))
+            {
+                if (streamClient == null)
+                    StartStream();
+                else
+                    StopStream();
+            }
+            GUILayout.EndHorizontal();
+
+            CaptureFilterGUI();
+            DeviceStatsGUI();
+
             GUILayout.Label($"Connections: {EditorConnection.instance.ConnectedPlayers.Count}");
             GUILayout.Label(_lastRefreshStats);
             if (treeView != null)
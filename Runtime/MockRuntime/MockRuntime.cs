@@ -62,6 +62,49 @@ namespace UnityEngine.XR.OpenXR.Features.Mock
             HapticStop
         }
 
+        /// <summary>
+        /// How the MockRuntime measures the XrTime values it returns.
+        /// </summary>
+        public enum ClockMode
+        {
+            /// <summary>
+            /// XrTime follows the real time elapsed since the instance was created.
+            /// </summary>
+            RealTime,
+
+            /// <summary>
+            /// XrTime only moves when <see cref="AdvanceClock"/> is called.
+            /// </summary>
+            Virtual,
+
+            /// <summary>
+            /// XrTime moves by exactly one display period on every xrWaitFrame, and when <see cref="AdvanceClock"/> is called.
+            /// </summary>
+            VirtualFastForward
+        }
+
+        // Layout matches MockActionStateRequest in mock_runtime.h
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ActionStateRequest
+        {
+            public ulong action;
+            public ulong subactionPath;
+        }
+
+        // Layout matches MockActionStateResult in mock_runtime.h
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ActionStateResult
+        {
+            public XrResult result;
+            public int type;
+            public uint isActive;
+            public uint changedSinceLastSync;
+            public long lastChangeTime;
+            public uint booleanValue;
+            public float floatValue;
+            public Vector2 vector2fValue;
+        }
+
         /// <summary>
         /// Delegate invoked on ScriptEvents
         /// </summary>
@@ -610,6 +653,50 @@ namespace UnityEngine.XR.OpenXR.Features.Mock
         [DllImport(extLib, EntryPoint = "MockRuntime_CauseRecommendedResolutionChangedEvent")]
         public static extern void CauseRecommendedResolutionChangedEvent();
 
+        /// <summary>
+        /// Choose how the MockRuntime measures time. The current time is carried over to the new mode.
+        /// </summary>
+        /// <param name="mode">Clock mode to use.</param>
+        [DllImport(extLib, EntryPoint = "MockRuntime_SetClockMode")]
+        public static extern void SetClockMode(ClockMode mode);
+
+        /// <summary>
+        /// Move the MockRuntime clock forward.
+        /// </summary>
+        /// <param name="nanoseconds">Time to move the clock by, negative values are ignored.</param>
+        [DllImport(extLib, EntryPoint = "MockRuntime_AdvanceClock")]
+        public static extern void AdvanceClock(long nanoseconds);
+
+        /// <summary>
+        /// Current XrTime of the MockRuntime clock.
+        /// </summary>
+        /// <returns>Current time in nanoseconds, or 0 if there is no MockRuntime instance.</returns>
+        [DllImport(extLib, EntryPoint = "MockRuntime_GetClockTime")]
+        public static extern long GetClockTime();
+
+        [DllImport(extLib, EntryPoint = "MockRuntime_GetActionStates")]
+        static extern XrResult Internal_GetActionStates(ulong session, uint requestCount, ActionStateRequest[] requests, [Out] ActionStateResult[] results);
+
+        /// <summary>
+        /// Read action states from the snapshot taken by the last xrSyncActions, without going through xrGetActionState*.
+        /// </summary>
+        internal static XrResult GetActionStates(ActionStateRequest[] requests, ActionStateResult[] results) =>
+            Internal_GetActionStates(Instance.XrSession, (uint)requests.Length, requests, results);
+
+        /// <summary>
+        /// Deletes the native runtimes of instances that were never destroyed.  Only call it once the loader is shut down.
+        /// </summary>
+        /// <returns>Number of runtimes deleted.</returns>
+        [DllImport(extLib, EntryPoint = "MockRuntime_DestroyLeakedRuntimes")]
+        internal static extern uint DestroyLeakedRuntimes();
+
+        /// <summary>
+        /// Action set an action was created in.
+        /// </summary>
+        /// <returns>XrActionSet handle, or 0 if the action is unknown.</returns>
+        [DllImport(extLib, EntryPoint = "MockRuntime_GetActionSet")]
+        internal static extern ulong GetActionSet(ulong action);
+
         [DllImport(extLib, EntryPoint = "MockRuntime_SetReferenceSpaceBounds")]
         internal static extern void SetReferenceSpaceBounds(XrReferenceSpaceType referenceSpace, Vector2 bounds);
 
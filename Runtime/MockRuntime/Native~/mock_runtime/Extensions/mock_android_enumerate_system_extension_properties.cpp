@@ -4,28 +4,12 @@
 #include <cstddef>
 #include <vector>
 
-#define CHECK_EXT_INIT()                                                      \
-    if (nullptr == MockAndroidEnumerateSystemExtensionProperties::Instance()) \
+#define CHECK_EXT_INIT()                                                    \
+    if (nullptr == runtime->GetAndroidEnumerateSystemExtensionProperties()) \
         return XR_ERROR_FUNCTION_UNSUPPORTED;
 
-std::unique_ptr<MockAndroidEnumerateSystemExtensionProperties> MockAndroidEnumerateSystemExtensionProperties::s_Instance;
 std::unordered_map<std::string, bool> MockAndroidEnumerateSystemExtensionProperties::s_SystemEnabledExtensions{};
 
-MockAndroidEnumerateSystemExtensionProperties* MockAndroidEnumerateSystemExtensionProperties::Instance()
-{
-    return s_Instance.get();
-}
-
-void MockAndroidEnumerateSystemExtensionProperties::Init(MockRuntime& runtime)
-{
-    s_Instance.reset(new MockAndroidEnumerateSystemExtensionProperties(runtime));
-}
-
-void MockAndroidEnumerateSystemExtensionProperties::Deinit()
-{
-    s_Instance.reset();
-}
-
 MockAndroidEnumerateSystemExtensionProperties::MockAndroidEnumerateSystemExtensionProperties(MockRuntime& runtime)
     : m_Runtime{runtime}
 {
@@ -98,7 +82,7 @@ xrEnumerateSystemExtensionPropertiesANDROID(
     CHECK_EXT_INIT();
     MOCK_HOOK_BEFORE();
 
-    XrResult result = MockAndroidEnumerateSystemExtensionProperties::Instance()
+    XrResult result = runtime->GetAndroidEnumerateSystemExtensionProperties()
                           ->EnumerateSystemExtensionProperties(
                               instance,
                               systemId,
@@ -10,10 +10,6 @@ struct XrSystemExtensionPropertiesANDROID;
 class MockAndroidEnumerateSystemExtensionProperties
 {
 public:
-    static MockAndroidEnumerateSystemExtensionProperties* Instance();
-    static void Init(MockRuntime& runtime);
-    static void Deinit();
-
     MockAndroidEnumerateSystemExtensionProperties(MockRuntime& runtime);
 
     XrResult EnumerateSystemExtensionProperties(
@@ -26,8 +22,6 @@ public:
     static void SetSystemExtensionEnabled(const char* extName, bool enabled);
 
 private:
-    static std::unique_ptr<MockAndroidEnumerateSystemExtensionProperties> s_Instance;
-
     MockRuntime& m_Runtime;
 
     static std::unordered_map<std::string, bool> s_SystemEnabledExtensions;
@@ -1,7 +1,10 @@
 #include "../mock.h"
 
-#define CHECK_EXT()       \
-    if (nullptr == s_ext) \
+// Declare ext, the conformance automation state of the runtime that owns the session
+#define CHECK_EXT(session)                                            \
+    CHECK_SESSION(session);                                           \
+    ConformanceAutomation* ext = runtime->GetConformanceAutomation(); \
+    if (nullptr == ext)                                               \
         return XR_ERROR_FUNCTION_UNSUPPORTED;
 
 struct ConformanceAutomation
@@ -21,75 +24,66 @@ struct ConformanceAutomation
     }
 };
 
-static ConformanceAutomation* s_ext = nullptr;
-
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSetInputDeviceActiveEXT(XrSession session, XrPath interactionProfile, XrPath topLevelPath, XrBool32 isActive)
 {
     LOG_FUNC();
-    CHECK_RUNTIME();
-    CHECK_EXT();
-    s_ext->activeStates[std::pair<XrPath, XrPath>(interactionProfile, topLevelPath)] = isActive;
+    CHECK_EXT(session);
+    ext->activeStates[std::pair<XrPath, XrPath>(interactionProfile, topLevelPath)] = isActive;
     return XR_SUCCESS;
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSetInputDeviceStateBoolEXT(XrSession session, XrPath topLevelPath, XrPath inputSourcePath, XrBool32 state)
 {
     LOG_FUNC();
-    CHECK_EXT();
-    s_ext->GetState(inputSourcePath, XR_ACTION_TYPE_BOOLEAN_INPUT).Set(state);
+    CHECK_EXT(session);
+    ext->GetState(inputSourcePath, XR_ACTION_TYPE_BOOLEAN_INPUT).Set(state);
     return XR_SUCCESS;
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSetInputDeviceStateFloatEXT(XrSession session, XrPath topLevelPath, XrPath inputSourcePath, float state)
 {
     LOG_FUNC();
-    CHECK_EXT();
-    CHECK_SESSION(session);
-    s_ext->GetState(inputSourcePath, XR_ACTION_TYPE_FLOAT_INPUT).Set(state);
+    CHECK_EXT(session);
+    ext->GetState(inputSourcePath, XR_ACTION_TYPE_FLOAT_INPUT).Set(state);
     return XR_SUCCESS;
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSetInputDeviceStateVector2fEXT(XrSession session, XrPath topLevelPath, XrPath inputSourcePath, XrVector2f state)
 {
     LOG_FUNC();
-    CHECK_EXT();
-    s_ext->GetState(inputSourcePath, XR_ACTION_TYPE_VECTOR2F_INPUT).Set(state);
+    CHECK_EXT(session);
+    ext->GetState(inputSourcePath, XR_ACTION_TYPE_VECTOR2F_INPUT).Set(state);
     return XR_SUCCESS;
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSetInputDeviceLocationEXT(XrSession session, XrPath topLevelPath, XrPath inputSourcePath, XrSpace space, XrPosef pose)
 {
     LOG_FUNC();
-    CHECK_EXT();
-    s_ext->GetState(inputSourcePath, XR_ACTION_TYPE_POSE_INPUT).Set(space, pose);
+    CHECK_EXT(session);
+    ext->GetState(inputSourcePath, XR_ACTION_TYPE_POSE_INPUT).Set(space, pose);
     return XR_SUCCESS;
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSetInputDeviceVelocityUNITY(XrSession session, XrPath topLevelPath, XrPath inputSourcePath, bool linearValid, XrVector3f linear, bool angularValid, XrVector3f angular)
 {
     LOG_FUNC();
-    CHECK_EXT();
-    s_ext->GetState(inputSourcePath, XR_ACTION_TYPE_POSE_INPUT).SetVelocity(linearValid, linear, angularValid, angular);
+    CHECK_EXT(session);
+    ext->GetState(inputSourcePath, XR_ACTION_TYPE_POSE_INPUT).SetVelocity(linearValid, linear, angularValid, angular);
     return XR_SUCCESS;
 }
 
-void ConformanceAutomation_Create()
+ConformanceAutomation* ConformanceAutomation_Create()
 {
-    // Make sure there is no orphaned extension
-    ConformanceAutomation_Destroy();
-
-    s_ext = new ConformanceAutomation();
+    return new ConformanceAutomation();
 }
 
-void ConformanceAutomation_Destroy()
+void ConformanceAutomation_Destroy(ConformanceAutomation* ext)
 {
-    delete s_ext;
-    s_ext = nullptr;
+    delete ext;
 }
 
 XrResult ConformanceAutomation_GetInstanceProcAddr(const char* name, PFN_xrVoidFunction* function)
 {
-    CHECK_EXT();
     GET_PROC_ADDRESS(xrSetInputDeviceActiveEXT)
     GET_PROC_ADDRESS(xrSetInputDeviceStateBoolEXT)
     GET_PROC_ADDRESS(xrSetInputDeviceStateFloatEXT)
@@ -99,12 +93,13 @@ XrResult ConformanceAutomation_GetInstanceProcAddr(const char* name, PFN_xrVoidF
     return XR_ERROR_FUNCTION_UNSUPPORTED;
 }
 
-XrResult ConformanceAutomation_GetInputState(MockInputState* state)
+XrResult ConformanceAutomation_GetInputState(ConformanceAutomation* ext, MockInputState* state)
 {
-    CHECK_EXT();
+    if (nullptr == ext)
+        return XR_ERROR_FUNCTION_UNSUPPORTED;
 
-    auto it = s_ext->states.find(state->path);
-    if (it == s_ext->states.end())
+    auto it = ext->states.find(state->path);
+    if (it == ext->states.end())
         return XR_ERROR_HANDLE_INVALID;
 
     state->CopyValue(it->second);
@@ -112,16 +107,16 @@ XrResult ConformanceAutomation_GetInputState(MockInputState* state)
     return XR_SUCCESS;
 }
 
-bool ConformanceAutomation_IsActive(XrPath interactionProfilePath, XrPath userPath, bool defaultValue)
+bool ConformanceAutomation_IsActive(ConformanceAutomation* ext, XrPath interactionProfilePath, XrPath userPath, bool defaultValue)
 {
-    if (nullptr == s_ext)
+    if (nullptr == ext)
         return false;
 
-    auto active = s_ext->activeStates.find(std::pair<XrPath, XrPath>(interactionProfilePath, userPath));
-    if (active == s_ext->activeStates.end())
-        active = s_ext->activeStates.find(std::pair<XrPath, XrPath>(XR_NULL_PATH, userPath));
+    auto active = ext->activeStates.find(std::pair<XrPath, XrPath>(interactionProfilePath, userPath));
+    if (active == ext->activeStates.end())
+        active = ext->activeStates.find(std::pair<XrPath, XrPath>(XR_NULL_PATH, userPath));
 
-    return (active != s_ext->activeStates.end()) ? active->second : defaultValue;
+    return (active != ext->activeStates.end()) ? active->second : defaultValue;
 }
 
 #undef CHECK_EXT
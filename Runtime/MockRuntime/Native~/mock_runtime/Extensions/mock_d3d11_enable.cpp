@@ -108,6 +108,7 @@ static XrResult MockD3D11_xrCreateSwapchain(XrSession session, const XrSwapchain
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR MockD3D11_xrCreateSwapchainHook(XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain)
 {
     LOG_FUNC();
+    FIND_RUNTIME(session);
     MOCK_HOOK_NAMED("xrCreateSwapchain", MockD3D11_xrCreateSwapchain(session, createInfo, swapchain));
 }
 
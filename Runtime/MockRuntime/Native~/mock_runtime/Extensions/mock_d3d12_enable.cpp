@@ -128,6 +128,7 @@ static XrResult MockD3D12_xrCreateSwapchain(XrSession session, const XrSwapchain
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR MockD3D12_xrCreateSwapchainHook(XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain)
 {
     LOG_FUNC();
+    FIND_RUNTIME(session);
     MOCK_HOOK_NAMED("xrCreateSwapchain", MockD3D12_xrCreateSwapchain(session, createInfo, swapchain));
 }
 
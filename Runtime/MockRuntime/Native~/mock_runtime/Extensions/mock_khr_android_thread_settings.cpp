@@ -2,27 +2,10 @@
 
 #ifdef XR_USE_PLATFORM_ANDROID
 
-#define CHECK_EXT_INIT()                                  \
-    if (nullptr == MockAndroidThreadSettings::Instance()) \
+#define CHECK_EXT_INIT()                                \
+    if (nullptr == runtime->GetAndroidThreadSettings()) \
         return XR_ERROR_FUNCTION_UNSUPPORTED;
 
-std::unique_ptr<MockAndroidThreadSettings> MockAndroidThreadSettings::s_Instance;
-
-MockAndroidThreadSettings* MockAndroidThreadSettings::Instance()
-{
-    return s_Instance.get();
-}
-
-void MockAndroidThreadSettings::Init(MockRuntime& runtime)
-{
-    s_Instance.reset(new MockAndroidThreadSettings(runtime));
-}
-
-void MockAndroidThreadSettings::Deinit()
-{
-    s_Instance.reset();
-}
-
 MockAndroidThreadSettings::MockAndroidThreadSettings(MockRuntime& runtime)
     : m_Runtime{runtime}
 {
@@ -63,7 +46,7 @@ xrSetAndroidApplicationThreadKHR(
     MOCK_HOOK_BEFORE();
 
     const XrResult result =
-        MockAndroidThreadSettings::Instance()->SetAndroidApplicationThread(
+        runtime->GetAndroidThreadSettings()->SetAndroidApplicationThread(
             threadType,
             threadId);
 
@@ -8,10 +8,6 @@
 class MockAndroidThreadSettings
 {
 public:
-    static MockAndroidThreadSettings* Instance();
-    static void Init(MockRuntime& runtime);
-    static void Deinit();
-
     MockAndroidThreadSettings(MockRuntime& runtime);
 
     XrResult SetAndroidApplicationThread(XrAndroidThreadTypeKHR threadType, uint32_t threadId);
@@ -19,8 +15,6 @@ public:
     uint32_t GetRegisteredAndroidThreadsCount() const;
 
 private:
-    static std::unique_ptr<MockAndroidThreadSettings> s_Instance;
-
     MockRuntime& m_Runtime;
     std::map<uint32_t, XrAndroidThreadTypeKHR> m_AssignedThreadTypes{};
 };
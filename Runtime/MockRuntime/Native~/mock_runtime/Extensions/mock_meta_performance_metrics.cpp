@@ -3,13 +3,10 @@
 #include "../mock.h"
 #include <sstream>
 
-#define CHECK_EXT()                                        \
-    if (nullptr == MockMetaPerformanceMetrics::Instance()) \
+#define CHECK_EXT()                                       \
+    if (nullptr == runtime->GetMetaPerformanceMetrics()) \
         return XR_ERROR_FUNCTION_UNSUPPORTED;
 
-// storage for static
-std::unique_ptr<MockMetaPerformanceMetrics> MockMetaPerformanceMetrics::s_ext;
-
 enum class MockMetaPerformanceMetrics::InternalPaths : int
 {
     Invalid = 0,
@@ -99,21 +96,6 @@ MockMetaPerformanceMetrics::MockMetaPerformanceMetrics(MockRuntime& runtime, con
     }
 }
 
-void MockMetaPerformanceMetrics::Init(MockRuntime& runtime, const int numMockCPUs)
-{
-    s_ext.reset(new MockMetaPerformanceMetrics(runtime, numMockCPUs));
-}
-
-void MockMetaPerformanceMetrics::Deinit()
-{
-    s_ext.reset();
-}
-
-MockMetaPerformanceMetrics* MockMetaPerformanceMetrics::Instance()
-{
-    return s_ext.get();
-}
-
 XrResult MockMetaPerformanceMetrics::EnumeratePaths(
     XrInstance instance,
     uint32_t counterPathCapacityInput,
@@ -219,13 +201,12 @@ xrEnumeratePerformanceMetricsCounterPathsMETA(
     XrPath* counterPaths)
 {
     LOG_FUNC();
-    CHECK_RUNTIME();
     CHECK_INSTANCE(instance);
     CHECK_EXT();
     MOCK_HOOK_BEFORE();
 
     const XrResult result =
-        MockMetaPerformanceMetrics::Instance()->EnumeratePaths(
+        runtime->GetMetaPerformanceMetrics()->EnumeratePaths(
             instance,
             counterPathCapacityInput,
             counterPathCountOutput,
@@ -246,7 +227,7 @@ xrSetPerformanceMetricsStateMETA(
     CHECK_EXT();
     MOCK_HOOK_BEFORE();
 
-    const XrResult result = MockMetaPerformanceMetrics::Instance()->SetState(session, state);
+    const XrResult result = runtime->GetMetaPerformanceMetrics()->SetState(session, state);
 
     MOCK_HOOK_AFTER(result);
 
@@ -263,7 +244,7 @@ xrGetPerformanceMetricsStateMETA(
     CHECK_EXT();
     MOCK_HOOK_BEFORE();
 
-    const XrResult result = MockMetaPerformanceMetrics::Instance()->GetState(session, state);
+    const XrResult result = runtime->GetMetaPerformanceMetrics()->GetState(session, state);
 
     MOCK_HOOK_AFTER(result);
 
@@ -282,7 +263,7 @@ xrQueryPerformanceMetricsCounterMETA(
     MOCK_HOOK_BEFORE();
 
     const XrResult result =
-        MockMetaPerformanceMetrics::Instance()->QueryCounter(
+        runtime->GetMetaPerformanceMetrics()->QueryCounter(
             session,
             counterPath,
             counter);
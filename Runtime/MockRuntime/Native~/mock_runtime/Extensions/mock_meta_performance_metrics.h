@@ -23,9 +23,7 @@ public:
         XrPerformanceMetricsCounterMETA value;
     };
 
-    static void Init(MockRuntime& runtime, const int numMockCPUs);
-    static void Deinit();
-    static MockMetaPerformanceMetrics* Instance();
+    MockMetaPerformanceMetrics(MockRuntime& runtime, const int numMockCPUs);
 
     static InternalPaths InternalPathFromString(const std::string& s);
 
@@ -44,9 +42,6 @@ public:
     void SeedCounterOnce(const std::string& counterPath, MockResult result);
 
 private:
-    MockMetaPerformanceMetrics(MockRuntime& runtime, const int numMockCPUs);
-
-    static std::unique_ptr<MockMetaPerformanceMetrics> s_ext;
     MockRuntime& m_Runtime;
 
     const int m_NumMockCPUs;
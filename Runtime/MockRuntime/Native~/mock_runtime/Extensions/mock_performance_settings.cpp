@@ -1,26 +1,9 @@
 #include "mock_performance_settings.h"
 
-#define CHECK_PERF_SETTINGS_EXT()                       \
-    if (nullptr == MockPerformanceSettings::Instance()) \
+#define CHECK_PERF_SETTINGS_EXT()                     \
+    if (nullptr == runtime->GetPerformanceSettings()) \
         return XR_ERROR_FUNCTION_UNSUPPORTED;
 
-std::unique_ptr<MockPerformanceSettings> MockPerformanceSettings::s_ext;
-
-void MockPerformanceSettings::Init(MockRuntime& runtime)
-{
-    s_ext.reset(new MockPerformanceSettings(runtime));
-}
-
-void MockPerformanceSettings::Deinit()
-{
-    s_ext.reset();
-}
-
-MockPerformanceSettings* MockPerformanceSettings::Instance()
-{
-    return s_ext.get();
-}
-
 MockPerformanceSettings::MockPerformanceSettings(MockRuntime& runtime)
     : m_Runtime(runtime)
 {
@@ -81,7 +64,7 @@ xrPerfSettingsSetPerformanceLevelEXT(
     MOCK_HOOK_BEFORE();
 
     const XrResult result =
-        MockPerformanceSettings::Instance()->SetPerformanceLevel(session, domain, level);
+        runtime->GetPerformanceSettings()->SetPerformanceLevel(session, domain, level);
 
     MOCK_HOOK_AFTER(result);
 
@@ -13,9 +13,7 @@ class MockRuntime;
 class MockPerformanceSettings
 {
 public:
-    static void Init(MockRuntime& runtime);
-    static void Deinit();
-    static MockPerformanceSettings* Instance();
+    MockPerformanceSettings(MockRuntime& runtime);
 
     XrResult SetPerformanceLevel(XrSession session, XrPerfSettingsDomainEXT domain, XrPerfSettingsLevelEXT level);
     XrPerfSettingsLevelEXT GetPerformanceLevelHint(XrPerfSettingsDomainEXT domain);
@@ -24,14 +22,10 @@ public:
     void SetPerformanceSettingsNotificationLevel(XrPerfSettingsDomainEXT domain, XrPerfSettingsSubDomainEXT subdomain, XrPerfSettingsNotificationLevelEXT nextLevel);
 
 private:
-    static std::unique_ptr<MockPerformanceSettings> s_ext;
-
     MockRuntime& m_Runtime;
 
     std::map<XrPerfSettingsDomainEXT, XrPerfSettingsLevelEXT> m_PerformanceLevelHints;
     std::map<std::pair<XrPerfSettingsDomainEXT, XrPerfSettingsSubDomainEXT>, XrPerfSettingsNotificationLevelEXT> m_notificationLevel;
-
-    MockPerformanceSettings(MockRuntime& runtime);
 };
 
 XrResult MockPerformanceSettings_GetInstanceProcAddr(const char* name, PFN_xrVoidFunction* function);
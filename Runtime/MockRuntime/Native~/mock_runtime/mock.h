@@ -61,8 +61,8 @@ extern IUnityXRTrace* s_Trace;
 #include "XR/IUnityXRTrace.h"
 
 #include <chrono>
+#include <deque>
 #include <map>
-#include <queue>
 #include <string>
 #include <unordered_map>
 
@@ -72,7 +72,6 @@ extern IUnityXRTrace* s_Trace;
 #include "openxr_utils.h"
 
 class MockRuntime;
-extern MockRuntime* s_runtime;
 
 #define GET_PROC_ADDRESS(funcName)                 \
     if (strcmp(#funcName, name) == 0)              \
@@ -88,14 +87,21 @@ extern MockRuntime* s_runtime;
         return XR_SUCCESS;                         \
     }
 
-#define CHECK_RUNTIME()       \
-    if (s_runtime == nullptr) \
+// Declare runtime, the MockRuntime that owns the handle or nullptr, for functions that don't validate their handle
+#define FIND_RUNTIME(handle) MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)(handle));
+
+// Declare runtime, the MockRuntime that owns the handle
+#define CHECK_RUNTIME(handle)                                             \
+    MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)(handle)); \
+    if (runtime == nullptr)                                               \
         return XR_ERROR_HANDLE_INVALID;
-#define CHECK_INSTANCE(instance)                                      \
-    if (s_runtime == nullptr || s_runtime->GetInstance() != instance) \
+#define CHECK_INSTANCE(instance)                                            \
+    MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)(instance)); \
+    if (runtime == nullptr || runtime->GetInstance() != instance)           \
         return XR_ERROR_HANDLE_INVALID;
-#define CHECK_SESSION(session)                                      \
-    if (s_runtime == nullptr || s_runtime->GetSession() != session) \
+#define CHECK_SESSION(session)                                             \
+    MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)(session)); \
+    if (runtime == nullptr || runtime->GetSession() != session)            \
         return XR_ERROR_HANDLE_INVALID;
 #define CHECK_SUCCESS(body)       \
     {                             \
@@ -114,18 +120,28 @@ extern MockRuntime* s_runtime;
 
 XrResult GetProcAddrMockAPI(XrInstance instance, const char* name, PFN_xrVoidFunction* function);
 
-XrResult MockRuntime_BeforeFunction(const char* name);
-void MockRuntime_AfterFunction(const char* name, XrResult result);
+class MockRuntime;
+
+#include "mock_runtime_api.h"
+
+// Function callbacks belong to the runtime that owns the handle a function was called with.  The MOCK_HOOK macros use
+// runtime from the calling scope (see CHECK_INSTANCE, CHECK_SESSION and FIND_RUNTIME), nullptr uses the callbacks
+// registered for runtimes that don't exist yet.
+XrResult MockRuntime_BeforeFunction(MockRuntime* runtime, const char* name);
+void MockRuntime_AfterFunction(MockRuntime* runtime, const char* name, XrResult result);
+
+// Gives a runtime that was just created the callbacks registered so far
+void MockRuntime_InitFunctionCallbacks(MockRuntime* runtime);
 
-#define MOCK_HOOK_AFTER_NAMED(name, result) MockRuntime_AfterFunction(name, result);
+#define MOCK_HOOK_AFTER_NAMED(name, result) MockRuntime_AfterFunction(runtime, name, result);
 #define MOCK_HOOK_AFTER(result) MOCK_HOOK_AFTER_NAMED(__FUNCTION__, result);
 
-#define MOCK_HOOK_BEFORE_NAMED(name)                        \
-    XrResult hookResult = MockRuntime_BeforeFunction(name); \
-    if (hookResult != XR_SUCCESS)                           \
-    {                                                       \
-        MOCK_HOOK_AFTER_NAMED(name, hookResult);            \
-        return hookResult;                                  \
+#define MOCK_HOOK_BEFORE_NAMED(name)                                 \
+    XrResult hookResult = MockRuntime_BeforeFunction(runtime, name); \
+    if (hookResult != XR_SUCCESS)                                    \
+    {                                                                \
+        MOCK_HOOK_AFTER_NAMED(name, hookResult);                     \
+        return hookResult;                                           \
     }
 #define MOCK_HOOK_BEFORE() MOCK_HOOK_BEFORE_NAMED(__FUNCTION__)
 
@@ -137,9 +153,16 @@ void MockRuntime_AfterFunction(const char* name, XrResult result);
 
 #define MOCK_HOOK(x) MOCK_HOOK_NAMED(__FUNCTION__, (x))
 
+#include "mock_clock.h"
+#include "mock_event_ring.h"
 #include "mock_events.h"
 #include "mock_extensions.h"
+#include "mock_seqlock.h"
 #include "mock_input_state.h"
+#include "mock_input_state_pool.h"
+#include "mock_path_table.h"
+#include "mock_runtime_registry.h"
+#include "mock_slot_map.h"
 #include "mock_runtime.h"
 
 struct UnityVector3
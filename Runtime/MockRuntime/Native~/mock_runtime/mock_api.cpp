@@ -9,9 +9,7 @@ static PFN_xrCreateInstance s_xrCreateInstance = nullptr;
 static PFN_xrDestroyInstance s_xrDestroyInstance = nullptr;
 static XrInstance s_Instance = XR_NULL_HANDLE;
 
-typedef XrResult(XRAPI_PTR* PFN_BeforeFunctionCallback)(const char* name);
-typedef void(XRAPI_PTR* PFN_AfterFunctionCallback)(const char* name, XrResult result);
-
+// Callbacks of the current runtime, and of the runtimes created from now on
 static PFN_BeforeFunctionCallback s_BeforeFunctionCallback = nullptr;
 static PFN_AfterFunctionCallback s_AfterFunctionCallback = nullptr;
 static bool s_KeepFunctionCallbacks = false;
@@ -21,7 +19,11 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API MockRuntime_RegisterF
     s_BeforeFunctionCallback = before;
     s_AfterFunctionCallback = after;
 
-#if TRAMPOLINE
+#if !TRAMPOLINE
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr != runtime)
+        runtime->SetFunctionCallbacks(before, after);
+#else
     if (s_Instance == nullptr || s_GetInstanceProcAddr == nullptr)
         return;
     void (*fptr)(PFN_BeforeFunctionCallback before, PFN_AfterFunctionCallback after) = nullptr;
@@ -35,20 +37,27 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API MockRuntime_SetKeepFu
     s_KeepFunctionCallbacks = value;
 }
 
-XrResult MockRuntime_BeforeFunction(const char* name)
+XrResult MockRuntime_BeforeFunction(MockRuntime* runtime, const char* name)
 {
-    if (s_BeforeFunctionCallback == nullptr)
+    PFN_BeforeFunctionCallback before = nullptr != runtime ? runtime->GetBeforeFunctionCallback() : s_BeforeFunctionCallback;
+    if (before == nullptr)
         return XR_SUCCESS;
 
-    return s_BeforeFunctionCallback(name);
+    return before(name);
 }
 
-void MockRuntime_AfterFunction(const char* name, XrResult result)
+void MockRuntime_AfterFunction(MockRuntime* runtime, const char* name, XrResult result)
 {
-    if (s_AfterFunctionCallback == nullptr)
+    PFN_AfterFunctionCallback after = nullptr != runtime ? runtime->GetAfterFunctionCallback() : s_AfterFunctionCallback;
+    if (after == nullptr)
         return;
 
-    s_AfterFunctionCallback(name, result);
+    after(name, result);
+}
+
+void MockRuntime_InitFunctionCallbacks(MockRuntime* runtime)
+{
+    runtime->SetFunctionCallbacks(s_BeforeFunctionCallback, s_AfterFunctionCallback);
 }
 
 // Special handling of before / after function callbacks for xrCreateInstance and xrDestroyInstance
@@ -88,6 +97,12 @@ extern "C" PFN_xrGetInstanceProcAddr UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
                 if (!s_KeepFunctionCallbacks)
                 {
                     MockRuntime_RegisterFunctionCallbacks(nullptr, nullptr);
+#if !TRAMPOLINE
+                    // The instance being destroyed may not be the current runtime
+                    MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)instance);
+                    if (nullptr != runtime)
+                        runtime->SetFunctionCallbacks(nullptr, nullptr);
+#endif
                 }
 
                 XrResult ret = XR_SUCCESS;
@@ -134,10 +149,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_SetView,
     (viewConfigurationType, viewIndex, position, orientation, fov))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->SetViewPose(viewConfigurationType, viewIndex, {orientation, position}, fov);
+    runtime->SetViewPose(viewConfigurationType, viewIndex, {orientation, position}, fov);
 }
 #endif
 
@@ -146,10 +162,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_SetViewState,
     (viewConfigurationType, stateFlags))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->SetViewStateFlags(viewConfigurationType, stateFlags);
+    runtime->SetViewStateFlags(viewConfigurationType, stateFlags);
 }
 #endif
 
@@ -158,10 +175,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_SetReferenceSpace,
     (referenceSpace, position, orientation, locationFlags))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->SetSpace(referenceSpace, {orientation, position}, locationFlags);
+    runtime->SetSpace(referenceSpace, {orientation, position}, locationFlags);
 }
 #endif
 
@@ -170,10 +188,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_SetActionSpace,
     (action, position, orientation, locationFlags))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->SetSpace(action, {orientation, position}, locationFlags);
+    runtime->SetSpace(action, {orientation, position}, locationFlags);
 }
 #endif
 
@@ -182,10 +201,11 @@ MOCK_API_TRAMPOLINE(XrSessionState, XR_SESSION_STATE_UNKNOWN, MockRuntime_GetSes
     ())
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return XR_SESSION_STATE_UNKNOWN;
 
-    return s_runtime->GetSessionState();
+    return runtime->GetSessionState();
 }
 #endif
 
@@ -194,10 +214,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_RequestExitSession,
     ())
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->RequestExitSession();
+    runtime->RequestExitSession();
 }
 #endif
 
@@ -206,10 +227,50 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_CauseInstanceLoss,
     ())
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
+        return;
+
+    runtime->CauseInstanceLoss();
+}
+#endif
+
+MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_SetClockMode,
+    (MockClockMode mode),
+    (mode))
+#if !TRAMPOLINE
+{
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->CauseInstanceLoss();
+    runtime->GetClock().SetMode(mode);
+}
+#endif
+
+MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_AdvanceClock,
+    (XrDuration duration),
+    (duration))
+#if !TRAMPOLINE
+{
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
+        return;
+
+    runtime->GetClock().Advance(duration);
+}
+#endif
+
+MOCK_API_TRAMPOLINE(XrTime, 0, MockRuntime_GetClockTime,
+    (),
+    ())
+#if !TRAMPOLINE
+{
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
+        return 0;
+
+    return runtime->GetClock().Now();
 }
 #endif
 
@@ -218,10 +279,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_ChangeRecommendedResolution,
     (width, height))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->ChangeRecommendedImageRectExtents(width, height);
+    runtime->ChangeRecommendedImageRectExtents(width, height);
 }
 #endif
 
@@ -230,10 +292,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_CauseRecommendedResolutionCha
     ())
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->CauseRecommendedResolutionChangedEvent();
+    runtime->CauseRecommendedResolutionChangedEvent();
 }
 #endif
 
@@ -242,10 +305,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_CauseUserPresenceChange,
     (hasUserPresent))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->CauseUserPresenceChange(hasUserPresent);
+    runtime->CauseUserPresenceChange(hasUserPresent);
 }
 #endif
 
@@ -254,10 +318,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_SetReferenceSpaceBounds,
     (referenceSpaceType, bounds))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->SetExtentsForReferenceSpace(referenceSpaceType, bounds);
+    runtime->SetExtentsForReferenceSpace(referenceSpaceType, bounds);
 }
 #endif
 
@@ -269,10 +334,43 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_GetEndFrameStats,
     *primaryLayerCount = 0;
     *secondaryLayerCount = 0;
 
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->GetEndFrameStats(primaryLayerCount, secondaryLayerCount);
+    runtime->GetEndFrameStats(primaryLayerCount, secondaryLayerCount);
+}
+#endif
+
+MOCK_API_TRAMPOLINE(XrResult, XR_ERROR_HANDLE_INVALID, MockRuntime_GetActionStates,
+    (XrSession session, uint32_t requestCount, const MockActionStateRequest* requests, MockActionStateResult* results),
+    (session, requestCount, requests, results))
+#if !TRAMPOLINE
+{
+    CHECK_SESSION(session);
+    MOCK_HOOK(runtime->GetActionStates(requestCount, requests, results));
+}
+#endif
+
+MOCK_API_TRAMPOLINE(uint32_t, 0, MockRuntime_DestroyLeakedRuntimes,
+    (),
+    ())
+#if !TRAMPOLINE
+{
+    return MockRuntimeRegistry::DestroyAll();
+}
+#endif
+
+MOCK_API_TRAMPOLINE(XrActionSet, XR_NULL_HANDLE, MockRuntime_GetActionSet,
+    (XrAction action),
+    (action))
+#if !TRAMPOLINE
+{
+    MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)action);
+    if (nullptr == runtime)
+        return XR_NULL_HANDLE;
+
+    return runtime->GetActionSet(action);
 }
 #endif
 
@@ -281,10 +379,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_ActivateSecondaryView,
     (viewConfigurationType, activate))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->ActivateSecondaryView(viewConfigurationType, activate);
+    runtime->ActivateSecondaryView(viewConfigurationType, activate);
 }
 #endif
 
@@ -293,10 +392,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_RegisterScriptEventCallback,
     (callback))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
 
-    s_runtime->RegisterScriptEventCallback(callback);
+    runtime->RegisterScriptEventCallback(callback);
 }
 #endif
 
@@ -305,18 +405,19 @@ MOCK_API_TRAMPOLINE(bool, false, MockRuntime_TransitionToState,
     (requestedState, forceTransition))
 #if !TRAMPOLINE
 {
-    if (nullptr == s_runtime)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return false;
 
-    if (!forceTransition && !s_runtime->IsStateTransitionValid(requestedState))
+    if (!forceTransition && !runtime->IsStateTransitionValid(requestedState))
     {
         MOCK_TRACE_ERROR("Failed to request state. Was transition valid: %s with force %s",
-            s_runtime->IsStateTransitionValid(requestedState) ? "TRUE" : "FALSE",
+            runtime->IsStateTransitionValid(requestedState) ? "TRUE" : "FALSE",
             forceTransition ? "TRUE" : "FALSE");
         return false;
     }
 
-    s_runtime->ChangeSessionState(requestedState);
+    runtime->ChangeSessionState(requestedState);
 
     return true;
 }
@@ -327,7 +428,11 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_MetaPerformanceMetrics_SeedCo
     (xrPathString, value, unit))
 #if !TRAMPOLINE
 {
-    MockMetaPerformanceMetrics::Instance()->SeedCounterOnce(
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime || nullptr == runtime->GetMetaPerformanceMetrics())
+        return;
+
+    runtime->GetMetaPerformanceMetrics()->SeedCounterOnce(
         xrPathString,
         {XR_SUCCESS,
             {XR_TYPE_PERFORMANCE_METRICS_COUNTER_META,
@@ -344,9 +449,10 @@ MOCK_API_TRAMPOLINE(void, NO_RETURN(), MockRuntime_PerformanceSettings_CauseNoti
     (domain, subdomain, level))
 #if !TRAMPOLINE
 {
-    if (s_runtime == nullptr)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime)
         return;
-    s_runtime->CausePerformanceSettingsNotification(domain, subdomain, level);
+    runtime->CausePerformanceSettingsNotification(domain, subdomain, level);
 }
 #endif
 
@@ -355,9 +461,10 @@ MOCK_API_TRAMPOLINE(XrPerfSettingsLevelEXT, XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIG
     (domain))
 #if !TRAMPOLINE
 {
-    if (MockPerformanceSettings::Instance() == nullptr)
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime || nullptr == runtime->GetPerformanceSettings())
         return XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT;
-    return MockPerformanceSettings::Instance()->GetPerformanceLevelHint(domain);
+    return runtime->GetPerformanceSettings()->GetPerformanceLevelHint(domain);
 }
 #endif
 
@@ -377,8 +484,11 @@ MOCK_API_TRAMPOLINE(bool, false, MockRuntime_IsAndroidThreadTypeRegistered,
 #if !TRAMPOLINE
 {
     LOG_FUNC();
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime || nullptr == runtime->GetAndroidThreadSettings())
+        return false;
     auto threadType = static_cast<XrAndroidThreadTypeKHR>(threadTypeValue);
-    return MockAndroidThreadSettings::Instance()->IsAndroidThreadTypeRegistered(threadType);
+    return runtime->GetAndroidThreadSettings()->IsAndroidThreadTypeRegistered(threadType);
 }
 #endif // !TRAMPOLINE
 
@@ -388,8 +498,11 @@ MOCK_API_TRAMPOLINE(uint32_t, 0, MockRuntime_GetRegisteredAndroidThreadsCount,
 #if !TRAMPOLINE
 {
     LOG_FUNC();
+    MockRuntime* runtime = MockRuntimeRegistry::GetCurrent();
+    if (nullptr == runtime || nullptr == runtime->GetAndroidThreadSettings())
+        return 0;
     MOCK_TRACE_DEBUG("Session is valid");
-    return MockAndroidThreadSettings::Instance()->GetRegisteredAndroidThreadsCount();
+    return runtime->GetAndroidThreadSettings()->GetRegisteredAndroidThreadsCount();
 }
 #endif // !TRAMPOLINE
 #endif // XR_USE_PLATFORM_ANDROID
@@ -404,11 +517,17 @@ XrResult GetProcAddrMockAPI(XrInstance instance, const char* name, PFN_xrVoidFun
     GET_PROC_ADDRESS(MockRuntime_GetSessionState)
     GET_PROC_ADDRESS(MockRuntime_RequestExitSession)
     GET_PROC_ADDRESS(MockRuntime_CauseInstanceLoss)
+    GET_PROC_ADDRESS(MockRuntime_SetClockMode)
+    GET_PROC_ADDRESS(MockRuntime_AdvanceClock)
+    GET_PROC_ADDRESS(MockRuntime_GetClockTime)
     GET_PROC_ADDRESS(MockRuntime_ChangeRecommendedResolution)
     GET_PROC_ADDRESS(MockRuntime_CauseRecommendedResolutionChangedEvent)
     GET_PROC_ADDRESS(MockRuntime_CauseUserPresenceChange)
     GET_PROC_ADDRESS(MockRuntime_SetReferenceSpaceBounds)
     GET_PROC_ADDRESS(MockRuntime_GetEndFrameStats)
+    GET_PROC_ADDRESS(MockRuntime_GetActionStates)
+    GET_PROC_ADDRESS(MockRuntime_GetActionSet)
+    GET_PROC_ADDRESS(MockRuntime_DestroyLeakedRuntimes)
     GET_PROC_ADDRESS(MockRuntime_ActivateSecondaryView)
     GET_PROC_ADDRESS(MockRuntime_RegisterScriptEventCallback)
     GET_PROC_ADDRESS(MockRuntime_RegisterFunctionCallbacks)
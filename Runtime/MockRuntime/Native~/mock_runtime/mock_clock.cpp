@@ -0,0 +1,50 @@
+#include "mock.h"
+
+MockClock::MockClock()
+    : startTime(std::chrono::high_resolution_clock::now())
+    , mode(MR_CLOCK_REAL_TIME)
+    , offset(0)
+{
+}
+
+XrDuration MockClock::GetElapsedRealTime() const
+{
+    return (XrDuration)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void MockClock::SetMode(MockClockMode newMode)
+{
+    if (newMode != MR_CLOCK_REAL_TIME && newMode != MR_CLOCK_VIRTUAL && newMode != MR_CLOCK_VIRTUAL_FAST_FORWARD)
+        return;
+
+    // Carry the current time over to the new mode
+    XrTime now = Now();
+    if (newMode == MR_CLOCK_REAL_TIME)
+        offset.store(now - GetElapsedRealTime(), std::memory_order_relaxed);
+    else
+        offset.store(now, std::memory_order_relaxed);
+
+    mode.store(newMode, std::memory_order_release);
+}
+
+XrTime MockClock::Now() const
+{
+    if (GetMode() == MR_CLOCK_REAL_TIME)
+        return offset.load(std::memory_order_relaxed) + GetElapsedRealTime();
+
+    return offset.load(std::memory_order_relaxed);
+}
+
+void MockClock::Advance(XrDuration duration)
+{
+    if (duration > 0)
+        offset.fetch_add(duration, std::memory_order_relaxed);
+}
+
+XrTime MockClock::WaitFrame()
+{
+    if (GetMode() == MR_CLOCK_VIRTUAL_FAST_FORWARD)
+        return offset.fetch_add(kDisplayPeriod, std::memory_order_relaxed) + kDisplayPeriod;
+
+    return Now();
+}
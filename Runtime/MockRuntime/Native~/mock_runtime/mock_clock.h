@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+typedef uint32_t MockClockMode;
+
+// XrTime follows the time elapsed since the runtime was created.
+static const MockClockMode MR_CLOCK_REAL_TIME = 0;
+
+// XrTime only moves when MockRuntime_AdvanceClock is called.
+static const MockClockMode MR_CLOCK_VIRTUAL = 1;
+
+// XrTime moves by exactly one display period on every xrWaitFrame, and when MockRuntime_AdvanceClock is called.
+static const MockClockMode MR_CLOCK_VIRTUAL_FAST_FORWARD = 2;
+
+// Source of every XrTime the runtime hands out (predicted display times, action state change times, event times).
+// The virtual modes make those times independent of how fast the test runs, so a test sees the same times on every
+// run and hours of frames can be simulated in seconds.  Switching modes carries the current time over, and is meant
+// to be done between frames.  Now, Advance and WaitFrame may be called from any thread.
+class MockClock
+{
+public:
+    static const XrDuration kDisplayPeriod = 16666000;
+
+    MockClock();
+
+    MockClockMode GetMode() const
+    {
+        return mode.load(std::memory_order_acquire);
+    }
+
+    void SetMode(MockClockMode newMode);
+
+    XrTime Now() const;
+
+    // Moves the time forward, in real time mode the time keeps running from the new value.  Negative durations are
+    // ignored.
+    void Advance(XrDuration duration);
+
+    // Predicted display time of the frame being waited on
+    XrTime WaitFrame();
+
+private:
+    XrDuration GetElapsedRealTime() const;
+
+    std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
+    std::atomic<MockClockMode> mode;
+
+    // Real time mode: added to the real time elapsed since startTime.  Virtual modes: the time itself.
+    std::atomic<XrTime> offset;
+};
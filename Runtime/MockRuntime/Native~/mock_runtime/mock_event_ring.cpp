@@ -0,0 +1,72 @@
+#include "mock.h"
+
+MockEventRing::MockEventRing()
+    : data(new uint8_t[kCapacity])
+    , published(new std::atomic<uint32_t>[kCapacity / kAlignment])
+    , writeCursor(0)
+    , readCursor(0)
+{
+    for (uint32_t i = 0; i < kCapacity / kAlignment; ++i)
+        published[i].store(0, std::memory_order_relaxed);
+}
+
+bool MockEventRing::Push(const void* event, uint32_t size)
+{
+    if (size == 0 || size > kCapacity)
+        return false;
+
+    uint32_t recordSize = Align(size);
+
+    // Reserve the record, plus the bytes left at the end of the ring if the record doesn't fit before it.
+    uint64_t cursor = writeCursor.load(std::memory_order_relaxed);
+    uint32_t offset;
+    uint32_t paddingSize;
+    do
+    {
+        offset = (uint32_t)(cursor % kCapacity);
+        paddingSize = offset + recordSize > kCapacity ? kCapacity - offset : 0;
+
+        if (cursor + paddingSize + recordSize - readCursor.load(std::memory_order_acquire) > kCapacity)
+            return false;
+    } while (!writeCursor.compare_exchange_weak(cursor, cursor + paddingSize + recordSize, std::memory_order_relaxed));
+
+    if (paddingSize != 0)
+    {
+        published[offset / kAlignment].store(kPaddingFlag | paddingSize, std::memory_order_release);
+        offset = 0;
+    }
+
+    memcpy(data.get() + offset, event, size);
+    published[offset / kAlignment].store(size, std::memory_order_release);
+    return true;
+}
+
+uint32_t MockEventRing::Pop(void* buffer, uint32_t bufferSize)
+{
+    std::lock_guard<std::mutex> lock(popMutex);
+
+    uint64_t cursor = readCursor.load(std::memory_order_relaxed);
+    while (true)
+    {
+        uint32_t offset = (uint32_t)(cursor % kCapacity);
+
+        // Records are published in any order but popped in the order they were reserved, so a record that is still
+        // being written holds back the ones after it.
+        uint32_t size = published[offset / kAlignment].load(std::memory_order_acquire);
+        if (size == 0)
+            return 0;
+
+        published[offset / kAlignment].store(0, std::memory_order_relaxed);
+
+        if ((size & kPaddingFlag) != 0)
+        {
+            cursor += size & ~kPaddingFlag;
+            readCursor.store(cursor, std::memory_order_release);
+            continue;
+        }
+
+        memcpy(buffer, data.get() + offset, size < bufferSize ? size : bufferSize);
+        readCursor.store(cursor + Align(size), std::memory_order_release);
+        return size;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Queue of variable size event records for QueueEvent and xrPollEvent.
+// Any number of threads may push without taking a lock: a producer reserves the bytes of its record by moving the
+// write cursor with a compare and swap, copies the event in, and then publishes the record by storing its size.
+// Records only take the real size of their event (rounded up to 8 bytes) instead of a whole XrEventDataBuffer, and are
+// copied exactly once on the way out, straight into the caller's buffer.  A record never wraps around the end of the
+// ring, the bytes left at the end are skipped with a padding record instead.
+class MockEventRing
+{
+public:
+    static const uint32_t kCapacity = 256 * 1024;
+
+    MockEventRing();
+
+    // Returns false, dropping the event, if size is 0, larger than the ring, or the ring is full.
+    bool Push(const void* event, uint32_t size);
+
+    // Copies the oldest published event into buffer and returns its size, or returns 0 if there is none.
+    // Events larger than bufferSize are truncated.  Pops are serialized with each other but never block a Push.
+    uint32_t Pop(void* buffer, uint32_t bufferSize);
+
+private:
+    static const uint32_t kAlignment = 8;
+    static const uint32_t kPaddingFlag = 0x80000000;
+
+    static uint32_t Align(uint32_t size)
+    {
+        return (size + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    std::unique_ptr<uint8_t[]> data;
+
+    // Size of the record starting at each 8 byte block, or 0 if no published record starts there.  Kept apart from
+    // the records so publishing is a plain atomic store, the consumer clears the entry of every record it pops.
+    std::unique_ptr<std::atomic<uint32_t>[]> published;
+
+    // Byte offsets that only ever grow, the position in the ring is the offset modulo kCapacity.
+    std::atomic<uint64_t> writeCursor;
+    std::atomic<uint64_t> readCursor;
+
+    std::mutex popMutex;
+};
@@ -10,11 +10,11 @@
 struct ConformanceAutomation;
 class MockInputState;
 
-void ConformanceAutomation_Create();
-void ConformanceAutomation_Destroy();
+ConformanceAutomation* ConformanceAutomation_Create();
+void ConformanceAutomation_Destroy(ConformanceAutomation* ext);
 XrResult ConformanceAutomation_GetInstanceProcAddr(const char* name, PFN_xrVoidFunction* function);
-XrResult ConformanceAutomation_GetInputState(MockInputState* state);
-bool ConformanceAutomation_IsActive(XrPath interactionProfile, XrPath userPath, bool defaultValue = true);
+XrResult ConformanceAutomation_GetInputState(ConformanceAutomation* ext, MockInputState* state);
+bool ConformanceAutomation_IsActive(ConformanceAutomation* ext, XrPath interactionProfile, XrPath userPath, bool defaultValue = true);
 
 // XR_KHR_VULKAN_ENABLE2
 
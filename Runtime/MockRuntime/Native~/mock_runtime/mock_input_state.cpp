@@ -2,68 +2,74 @@
 
 void MockInputState::Reset()
 {
-    switch (type)
-    {
-    case XR_ACTION_TYPE_BOOLEAN_INPUT:
-        value.boolValue = false;
-        break;
-
-    case XR_ACTION_TYPE_FLOAT_INPUT:
-        value.floatValue = false;
-        break;
-
-    case XR_ACTION_TYPE_VECTOR2F_INPUT:
-        value.vectorValue = {0, 0};
-        break;
-
-    case XR_ACTION_TYPE_POSE_INPUT:
-        value.locationValue.pose = {{0, 0, 0, 1}, {0, 0, 0}};
-        value.locationValue.space = XR_NULL_HANDLE;
-        value.locationValue.linearVelocityValid = false;
-        value.locationValue.linearVelocity = {0, 0, 0};
-        value.locationValue.angularVelocityValid = false;
-        value.locationValue.angularVelocity = {0, 0, 0};
-        break;
-
-    default:
-        break;
-    }
+    value.Update([this](Value& current) {
+        switch (type)
+        {
+        case XR_ACTION_TYPE_BOOLEAN_INPUT:
+            current.boolValue = false;
+            break;
+
+        case XR_ACTION_TYPE_FLOAT_INPUT:
+            current.floatValue = false;
+            break;
+
+        case XR_ACTION_TYPE_VECTOR2F_INPUT:
+            current.vectorValue = {0, 0};
+            break;
+
+        case XR_ACTION_TYPE_POSE_INPUT:
+            current.locationValue.pose = {{0, 0, 0, 1}, {0, 0, 0}};
+            current.locationValue.space = XR_NULL_HANDLE;
+            current.locationValue.linearVelocityValid = false;
+            current.locationValue.linearVelocity = {0, 0, 0};
+            current.locationValue.angularVelocityValid = false;
+            current.locationValue.angularVelocity = {0, 0, 0};
+            break;
+
+        default:
+            break;
+        }
+    });
 }
 
 void MockInputState::Set(float v)
 {
-    switch (type)
-    {
-    case XR_ACTION_TYPE_FLOAT_INPUT:
-        value.floatValue = v;
-        break;
-
-    case XR_ACTION_TYPE_BOOLEAN_INPUT:
-        value.boolValue = v != 0.0f;
-        break;
-
-    default:
-        value.floatValue = 0.0f;
-        break;
-    }
+    value.Update([this, v](Value& current) {
+        switch (type)
+        {
+        case XR_ACTION_TYPE_FLOAT_INPUT:
+            current.floatValue = v;
+            break;
+
+        case XR_ACTION_TYPE_BOOLEAN_INPUT:
+            current.boolValue = v != 0.0f;
+            break;
+
+        default:
+            current.floatValue = 0.0f;
+            break;
+        }
+    });
 }
 
 void MockInputState::Set(XrBool32 v)
 {
-    switch (type)
-    {
-    case XR_ACTION_TYPE_BOOLEAN_INPUT:
-        value.boolValue = v;
-        break;
-
-    case XR_ACTION_TYPE_FLOAT_INPUT:
-        value.floatValue = v ? 1.0f : 0.0f;
-        break;
-
-    default:
-        value.boolValue = false;
-        break;
-    }
+    value.Update([this, v](Value& current) {
+        switch (type)
+        {
+        case XR_ACTION_TYPE_BOOLEAN_INPUT:
+            current.boolValue = v;
+            break;
+
+        case XR_ACTION_TYPE_FLOAT_INPUT:
+            current.floatValue = v ? 1.0f : 0.0f;
+            break;
+
+        default:
+            current.boolValue = false;
+            break;
+        }
+    });
 }
 
 void MockInputState::Set(XrVector2f v)
@@ -74,7 +80,7 @@ void MockInputState::Set(XrVector2f v)
         return;
     }
 
-    value.vectorValue = v;
+    value.Update([v](Value& current) { current.vectorValue = v; });
 }
 
 void MockInputState::Set(XrSpace space, XrPosef pose)
@@ -85,16 +91,20 @@ void MockInputState::Set(XrSpace space, XrPosef pose)
         return;
     }
 
-    value.locationValue.space = space;
-    value.locationValue.pose = pose;
+    value.Update([space, pose](Value& current) {
+        current.locationValue.space = space;
+        current.locationValue.pose = pose;
+    });
 }
 
 void MockInputState::SetVelocity(bool linearValid, XrVector3f linear, bool angularValid, XrVector3f angular)
 {
-    value.locationValue.linearVelocityValid = linearValid;
-    value.locationValue.linearVelocity = linearValid ? linear : XrVector3f{0, 0, 0};
-    value.locationValue.angularVelocityValid = angularValid;
-    value.locationValue.angularVelocity = angularValid ? angular : XrVector3f{0, 0, 0};
+    value.Update([=](Value& current) {
+        current.locationValue.linearVelocityValid = linearValid;
+        current.locationValue.linearVelocity = linearValid ? linear : XrVector3f{0, 0, 0};
+        current.locationValue.angularVelocityValid = angularValid;
+        current.locationValue.angularVelocity = angularValid ? angular : XrVector3f{0, 0, 0};
+    });
 }
 
 float MockInputState::GetFloat() const
@@ -102,10 +112,10 @@ float MockInputState::GetFloat() const
     switch (type)
     {
     case XR_ACTION_TYPE_BOOLEAN_INPUT:
-        return (float)value.boolValue;
+        return (float)value.Read().boolValue;
 
     case XR_ACTION_TYPE_FLOAT_INPUT:
-        return value.floatValue;
+        return value.Read().floatValue;
 
     default:
         break;
@@ -119,10 +129,10 @@ XrBool32 MockInputState::GetBoolean() const
     switch (type)
     {
     case XR_ACTION_TYPE_BOOLEAN_INPUT:
-        return value.boolValue;
+        return value.Read().boolValue;
 
     case XR_ACTION_TYPE_FLOAT_INPUT:
-        return value.floatValue != 0.0f;
+        return value.Read().floatValue != 0.0f;
 
     default:
         break;
@@ -134,7 +144,7 @@ XrBool32 MockInputState::GetBoolean() const
 XrVector2f MockInputState::GetVector2() const
 {
     if (type == XR_ACTION_TYPE_VECTOR2F_INPUT)
-        return value.vectorValue;
+        return value.Read().vectorValue;
 
     return XrVector2f();
 }
@@ -142,7 +152,7 @@ XrVector2f MockInputState::GetVector2() const
 XrSpace MockInputState::GetLocationSpace() const
 {
     if (type == XR_ACTION_TYPE_POSE_INPUT)
-        return value.locationValue.space;
+        return value.Read().locationValue.space;
 
     return XR_NULL_HANDLE;
 }
@@ -150,33 +160,63 @@ XrSpace MockInputState::GetLocationSpace() const
 XrPosef MockInputState::GetLocationPose() const
 {
     if (type == XR_ACTION_TYPE_POSE_INPUT)
-        return value.locationValue.pose;
+        return value.Read().locationValue.pose;
 
     return XrPosef();
 }
 
+XrPosef MockInputState::GetLocation(XrSpaceVelocity* velocity) const
+{
+    if (type != XR_ACTION_TYPE_POSE_INPUT)
+    {
+        if (nullptr != velocity)
+        {
+            velocity->velocityFlags = 0;
+            velocity->linearVelocity = XrVector3f{};
+            velocity->angularVelocity = XrVector3f{};
+        }
+        return XrPosef();
+    }
+
+    Value current = value.Read();
+    if (nullptr != velocity)
+    {
+        velocity->velocityFlags = 0;
+        velocity->velocityFlags |= (current.locationValue.linearVelocityValid ? XR_SPACE_VELOCITY_LINEAR_VALID_BIT : 0);
+        velocity->linearVelocity = current.locationValue.linearVelocity;
+        velocity->velocityFlags |= (current.locationValue.angularVelocityValid ? XR_SPACE_VELOCITY_ANGULAR_VALID_BIT : 0);
+        velocity->angularVelocity = current.locationValue.angularVelocity;
+    }
+
+    return current.locationValue.pose;
+}
+
 bool MockInputState::HasLinearVelocity() const
 {
-    return type == XR_ACTION_TYPE_POSE_INPUT && value.locationValue.linearVelocityValid;
+    return type == XR_ACTION_TYPE_POSE_INPUT && value.Read().locationValue.linearVelocityValid;
 }
 
 XrVector3f MockInputState::GetLinearVelocity() const
 {
-    if (HasLinearVelocity())
-        return value.locationValue.linearVelocity;
+    if (type == XR_ACTION_TYPE_POSE_INPUT)
+    {
+        Value current = value.Read();
+        if (current.locationValue.linearVelocityValid)
+            return current.locationValue.linearVelocity;
+    }
 
     return XrVector3f{};
 }
 
 bool MockInputState::HasAngularVelocity() const
 {
-    return type == XR_ACTION_TYPE_POSE_INPUT && value.locationValue.angularVelocityValid;
+    return type == XR_ACTION_TYPE_POSE_INPUT && value.Read().locationValue.angularVelocityValid;
 }
 
 XrVector3f MockInputState::GetAngularVelocity() const
 {
     if (type == XR_ACTION_TYPE_POSE_INPUT)
-        return value.locationValue.angularVelocity;
+        return value.Read().locationValue.angularVelocity;
 
     return XrVector3f{};
 }
@@ -198,30 +238,30 @@ bool MockInputState::IsCompatibleType(XrActionType actionType) const
 
 void MockInputState::CopyValue(const MockInputState& state)
 {
+    Value copy = {};
     switch (type)
     {
     case XR_ACTION_TYPE_BOOLEAN_INPUT:
-        value.boolValue = state.GetBoolean();
+        copy.boolValue = state.GetBoolean();
         break;
 
     case XR_ACTION_TYPE_FLOAT_INPUT:
-        value.floatValue = state.GetFloat();
+        copy.floatValue = state.GetFloat();
         break;
 
     case XR_ACTION_TYPE_VECTOR2F_INPUT:
-        value.vectorValue = state.GetVector2();
+        copy.vectorValue = state.GetVector2();
         break;
 
     case XR_ACTION_TYPE_POSE_INPUT:
-        value.locationValue.space = state.GetLocationSpace();
-        value.locationValue.pose = state.GetLocationPose();
-        value.locationValue.angularVelocityValid = state.HasAngularVelocity();
-        value.locationValue.angularVelocity = state.GetAngularVelocity();
-        value.locationValue.linearVelocityValid = state.HasLinearVelocity();
-        value.locationValue.linearVelocity = state.GetLinearVelocity();
+        // Pose and velocity are read together so they come from the same write
+        if (state.IsType(XR_ACTION_TYPE_POSE_INPUT))
+            copy.locationValue = state.value.Read().locationValue;
         break;
 
     default:
-        break;
+        return;
     }
+
+    value.Write(copy);
 }
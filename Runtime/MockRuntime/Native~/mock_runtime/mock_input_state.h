@@ -31,13 +31,17 @@ public:
     XrSpace GetLocationSpace() const;
     XrPosef GetLocationPose() const;
 
+    // Pose and, if velocity isn't nullptr, velocity of the same value, for readers that may race a writer
+    XrPosef GetLocation(XrSpaceVelocity* velocity) const;
+
     bool HasAngularVelocity() const;
     bool HasLinearVelocity() const;
     XrVector3f GetAngularVelocity() const;
     XrVector3f GetLinearVelocity() const;
 
 private:
-    union
+    // Written by xrSyncActions while xrLocateSpace may read it on another thread
+    union Value
     {
         XrBool32 boolValue;
         float floatValue;
@@ -51,6 +55,7 @@ private:
             bool linearVelocityValid;
             bool angularVelocityValid;
         } locationValue;
+    };
 
-    } value;
+    MockSeqLock<Value> value;
 };
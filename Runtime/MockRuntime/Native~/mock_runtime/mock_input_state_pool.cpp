@@ -0,0 +1,29 @@
+#include "mock.h"
+
+MockInputStatePool::MockInputStatePool()
+    : chunkUsed(kChunkSize)
+{
+}
+
+MockInputStateHandle MockInputStatePool::Allocate(uint32_t count)
+{
+    if (count == 0 || count > kChunkSize)
+        return kInvalidInputStateHandle;
+
+    // The tail of the last chunk is left unused rather than splitting the range.
+    if (chunkUsed + count > kChunkSize)
+    {
+        chunks.emplace_back(new MockInputState[kChunkSize]);
+        chunkUsed = 0;
+    }
+
+    MockInputStateHandle handle = (MockInputStateHandle)(chunks.size() - 1) * kChunkSize + chunkUsed;
+    chunkUsed += count;
+    return handle;
+}
+
+void MockInputStatePool::Clear()
+{
+    chunks.clear();
+    chunkUsed = kChunkSize;
+}
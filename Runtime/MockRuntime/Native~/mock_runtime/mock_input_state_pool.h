@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+// Index of a MockInputState in a MockInputStatePool
+typedef uint32_t MockInputStateHandle;
+static const MockInputStateHandle kInvalidInputStateHandle = 0xFFFFFFFF;
+
+// Storage for the input states of all interaction profiles.
+// States live in fixed size chunks that never move, so handles and pointers to a state stay valid when more states
+// are added.  A range from Allocate never crosses a chunk, which keeps the input states of an interaction profile next
+// to each other in memory.
+class MockInputStatePool
+{
+public:
+    static const uint32_t kChunkSize = 256;
+
+    MockInputStatePool();
+
+    // Returns the first of count contiguous states, or kInvalidInputStateHandle if count is 0 or doesn't fit in a chunk.
+    MockInputStateHandle Allocate(uint32_t count);
+
+    // Invalidates every handle.
+    void Clear();
+
+    MockInputState& operator[](MockInputStateHandle handle)
+    {
+        return chunks[handle / kChunkSize][handle % kChunkSize];
+    }
+
+    const MockInputState& operator[](MockInputStateHandle handle) const
+    {
+        return chunks[handle / kChunkSize][handle % kChunkSize];
+    }
+
+private:
+    std::vector<std::unique_ptr<MockInputState[]>> chunks;
+
+    // States allocated from the last chunk
+    uint32_t chunkUsed;
+};
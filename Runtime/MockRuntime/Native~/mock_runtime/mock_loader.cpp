@@ -3,9 +3,8 @@
 #include <openxr/loader_interfaces.h>
 
 IUnityXRTrace* s_Trace = nullptr;
-MockRuntime* s_runtime = nullptr;
 
-uint64_t s_nextInstanceId = 11; // Start at 11 because 10 is a special test case
+static std::atomic<uint64_t> s_nextInstanceId(11); // Start at 11 because 10 is a special test case
 
 #define XR_UNITY_mock_test_SPEC_VERSION 123
 #define XR_UNITY_MOCK_TEST_EXTENSION_NAME "XR_UNITY_mock_test"
@@ -242,13 +241,6 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateInstance(const XrIn
 {
     LOG_FUNC();
 
-    // Destroy any existing runtime if there is one
-    if (s_runtime != nullptr)
-    {
-        delete s_runtime;
-        s_runtime = nullptr;
-    }
-
     *instance = 0;
 
     MockRuntimeCreateFlags flags = 0;
@@ -395,9 +387,28 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateInstance(const XrIn
     if (*instance == 0)
         *instance = (XrInstance)(s_nextInstanceId++);
 
-    s_runtime = new MockRuntime(*instance, flags);
+    // No runtime yet, the callbacks registered for new runtimes are used until it exists.
+    MockRuntime* runtime = nullptr;
+    MOCK_HOOK_BEFORE();
 
-    MOCK_HOOK(XR_SUCCESS);
+    // Existing instances are left alone, the runtime id in the handle tells them apart.  Runtimes of instances that are
+    // never destroyed are reclaimed by MockRuntime_DestroyLeakedRuntimes.
+    uint32_t runtimeId = MockRuntimeRegistry::Reserve();
+    if (runtimeId == MockRuntimeRegistry::kInvalidRuntimeId)
+    {
+        *instance = XR_NULL_HANDLE;
+        MOCK_HOOK_AFTER(XR_ERROR_LIMIT_REACHED);
+        return XR_ERROR_LIMIT_REACHED;
+    }
+
+    *instance = (XrInstance)MockRuntimeRegistry::MakeHandle(runtimeId, (uint64_t)*instance);
+    runtime = new MockRuntime(*instance, flags);
+    MockRuntime_InitFunctionCallbacks(runtime);
+    MockRuntimeRegistry::Register(runtimeId, runtime);
+
+    MOCK_HOOK_AFTER(XR_SUCCESS);
+
+    return XR_SUCCESS;
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrDestroyInstance(XrInstance instance)
@@ -407,10 +418,13 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrDestroyInstance(XrInstanc
 
     MOCK_HOOK_BEFORE();
 
-    delete s_runtime;
-    s_runtime = nullptr;
+    // The callbacks go with the runtime
+    PFN_AfterFunctionCallback after = runtime->GetAfterFunctionCallback();
+    MockRuntimeRegistry::Unregister(MockRuntimeRegistry::GetRuntimeId((uint64_t)instance));
+    delete runtime;
 
-    MOCK_HOOK_AFTER(XR_SUCCESS);
+    if (after != nullptr)
+        after(__FUNCTION__, XR_SUCCESS);
 
     return XR_SUCCESS;
 }
@@ -430,7 +444,7 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrPollEvent(XrInstance inst
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->GetNextEvent(eventData));
+    MOCK_HOOK(runtime->GetNextEvent(eventData));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrResultToString(XrInstance instance, XrResult value, char buffer[XR_MAX_RESULT_STRING_SIZE])
@@ -473,14 +487,14 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetSystemProperties(XrIns
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->GetSystemProperties(systemId, properties));
+    MOCK_HOOK(runtime->GetSystemProperties(systemId, properties));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateEnvironmentBlendModes(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t environmentBlendModeCapacityInput, uint32_t* environmentBlendModeCountOutput, XrEnvironmentBlendMode* environmentBlendModes)
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->EnumerateEnvironmentBlendModes(systemId, viewConfigurationType, environmentBlendModeCapacityInput, environmentBlendModeCountOutput, environmentBlendModes));
+    MOCK_HOOK(runtime->EnumerateEnvironmentBlendModes(systemId, viewConfigurationType, environmentBlendModeCapacityInput, environmentBlendModeCountOutput, environmentBlendModes));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateSession(XrInstance instance, const XrSessionCreateInfo* createInfo, XrSession* session)
@@ -489,9 +503,9 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateSession(XrInstance
     CHECK_INSTANCE(instance);
     MOCK_HOOK_BEFORE();
 
-    XrResult result = s_runtime->CreateSession(createInfo);
+    XrResult result = runtime->CreateSession(createInfo);
     if (result == XR_SUCCESS)
-        *session = s_runtime->GetSession();
+        *session = runtime->GetSession();
 
     MOCK_HOOK_AFTER(result);
 
@@ -502,7 +516,7 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrDestroySession(XrSession
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->DestroySession());
+    MOCK_HOOK(runtime->DestroySession());
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateReferenceSpaces(XrSession session, uint32_t spaceCapacityInput, uint32_t* spaceCountOutput, XrReferenceSpaceType* spaces)
@@ -513,7 +527,7 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateReferenceSpaces(
     if (!spaceCountOutput)
         return XR_ERROR_VALIDATION_FAILURE;
 
-    if (s_runtime->IsLocalFloorSpaceEnabled())
+    if (runtime->IsLocalFloorSpaceEnabled())
     {
         *spaceCountOutput = 5;
     }
@@ -532,7 +546,7 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateReferenceSpaces(
     spaces[1] = XR_REFERENCE_SPACE_TYPE_LOCAL;
     spaces[2] = XR_REFERENCE_SPACE_TYPE_STAGE;
     spaces[3] = XR_REFERENCE_SPACE_TYPE_UNBOUNDED_MSFT;
-    if (s_runtime->IsLocalFloorSpaceEnabled())
+    if (runtime->IsLocalFloorSpaceEnabled())
     {
         spaces[4] = XR_REFERENCE_SPACE_TYPE_LOCAL_FLOOR_EXT;
     }
@@ -544,46 +558,48 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateReferenceSpace(XrSe
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->CreateReferenceSpace(createInfo, space));
+    MOCK_HOOK(runtime->CreateReferenceSpace(createInfo, space));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetReferenceSpaceBoundsRect(XrSession session, XrReferenceSpaceType referenceSpaceType, XrExtent2Df* bounds)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->GetReferenceSpaceBoundsRect(referenceSpaceType, bounds));
+    MOCK_HOOK(runtime->GetReferenceSpaceBoundsRect(referenceSpaceType, bounds));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* createInfo, XrSpace* space)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->CreateActionSpace(createInfo, space));
+    MOCK_HOOK(runtime->CreateActionSpace(createInfo, space));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location)
 {
     LOG_FUNC();
-    CHECK_RUNTIME();
-    MOCK_HOOK(s_runtime->LocateSpace(space, baseSpace, time, location));
+    CHECK_RUNTIME(space);
+    MOCK_HOOK(runtime->LocateSpace(space, baseSpace, time, location));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrDestroySpace(XrSpace space)
 {
     LOG_FUNC();
-    MOCK_HOOK(XR_SUCCESS);
+    CHECK_RUNTIME(space);
+    MOCK_HOOK(runtime->DestroySpace(space));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateViewConfigurations(XrInstance instance, XrSystemId systemId, uint32_t viewConfigurationTypeCapacityInput, uint32_t* viewConfigurationTypeCountOutput, XrViewConfigurationType* viewConfigurationTypes)
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->EnumerateViewConfigurations(systemId, viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput, viewConfigurationTypes));
+    MOCK_HOOK(runtime->EnumerateViewConfigurations(systemId, viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput, viewConfigurationTypes));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetViewConfigurationProperties(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, XrViewConfigurationProperties* configurationProperties)
 {
     LOG_FUNC();
+    FIND_RUNTIME(instance);
     MOCK_HOOK(XR_SUCCESS);
 }
 
@@ -591,7 +607,7 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateViewConfiguratio
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->EnumerateViewConfigurationViews(systemId, viewConfigurationType, viewCapacityInput, viewCountOutput, views));
+    MOCK_HOOK(runtime->EnumerateViewConfigurationViews(systemId, viewConfigurationType, viewCapacityInput, viewCountOutput, views));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateSwapchainFormats(XrSession session, uint32_t formatCapacityInput, uint32_t* formatCountOutput, int64_t* formats)
@@ -613,23 +629,26 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateSwapchainFormats
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain)
 {
     LOG_FUNC();
-
-    static uint64_t uniqueSwapchainHandle = 0;
-
-    *swapchain = (XrSwapchain)++uniqueSwapchainHandle;
-
-    MOCK_HOOK(XR_SUCCESS);
+    CHECK_SESSION(session);
+    MOCK_HOOK(runtime->CreateSwapchain(createInfo, swapchain));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrDestroySwapchain(XrSwapchain swapchain)
 {
     LOG_FUNC();
-    MOCK_HOOK(XR_SUCCESS);
+
+    // Swapchains created by the graphics extensions are not in any runtime, destroying them always succeeds.
+    MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)swapchain);
+    MOCK_HOOK(runtime != nullptr && runtime->IsValidSwapchain(swapchain) ? runtime->DestroySwapchain(swapchain) : XR_SUCCESS);
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t* imageCountOutput, XrSwapchainImageBaseHeader* images)
 {
     LOG_FUNC();
+    CHECK_RUNTIME(swapchain);
+
+    if (!runtime->IsValidSwapchain(swapchain))
+        return XR_ERROR_HANDLE_INVALID;
 
     *imageCountOutput = 1;
 
@@ -644,6 +663,10 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateSwapchainImages(
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index)
 {
     LOG_FUNC();
+    CHECK_RUNTIME(swapchain);
+
+    if (!runtime->IsValidSwapchain(swapchain))
+        return XR_ERROR_HANDLE_INVALID;
 
     *index = 0;
 
@@ -653,12 +676,18 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrAcquireSwapchainImage(XrS
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo)
 {
     LOG_FUNC();
+    FIND_RUNTIME(swapchain);
     MOCK_HOOK(XR_SUCCESS);
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo)
 {
     LOG_FUNC();
+    CHECK_RUNTIME(swapchain);
+
+    if (!runtime->IsValidSwapchain(swapchain))
+        return XR_ERROR_HANDLE_INVALID;
+
     MOCK_HOOK(XR_SUCCESS);
 }
 
@@ -666,7 +695,7 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrBeginSession(XrSession se
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->BeginSession(beginInfo));
+    MOCK_HOOK(runtime->BeginSession(beginInfo));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEndSession(XrSession session)
@@ -675,26 +704,27 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEndSession(XrSession sess
     CHECK_SESSION(session);
     // CHECK_EXPECTED_RESULT(XR_SUCCESS, XR_ERROR_SESSION_NOT_STOPPING);
 
-    MOCK_HOOK(s_runtime->EndSession());
+    MOCK_HOOK(runtime->EndSession());
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrRequestExitSession(XrSession session)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->RequestExitSession());
+    MOCK_HOOK(runtime->RequestExitSession());
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrWaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->WaitFrame(frameWaitInfo, frameState));
+    MOCK_HOOK(runtime->WaitFrame(frameWaitInfo, frameState));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo)
 {
     LOG_FUNC();
+    FIND_RUNTIME(session);
     MOCK_HOOK(XR_SUCCESS);
 }
 
@@ -702,140 +732,140 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEndFrame(XrSession sessio
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->EndFrame(frameEndInfo));
+    MOCK_HOOK(runtime->EndFrame(frameEndInfo));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrLocateViews(XrSession session, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->LocateViews(viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views));
+    MOCK_HOOK(runtime->LocateViews(viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrStringToPath(XrInstance instance, const char* pathString, XrPath* path)
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->StringToPath(pathString, path));
+    MOCK_HOOK(runtime->StringToPath(pathString, path));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrPathToString(XrInstance instance, XrPath path, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer)
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->PathToString(path, bufferCapacityInput, bufferCountOutput, buffer));
+    MOCK_HOOK(runtime->PathToString(path, bufferCapacityInput, bufferCountOutput, buffer));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo* createInfo, XrActionSet* actionSet)
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->CreateActionSet(createInfo, actionSet));
+    MOCK_HOOK(runtime->CreateActionSet(createInfo, actionSet));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrDestroyActionSet(XrActionSet actionSet)
 {
     LOG_FUNC();
-    CHECK_RUNTIME();
-    MOCK_HOOK(s_runtime->DestroyActionSet(actionSet));
+    CHECK_RUNTIME(actionSet);
+    MOCK_HOOK(runtime->DestroyActionSet(actionSet));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action)
 {
     LOG_FUNC();
-    CHECK_RUNTIME();
-    MOCK_HOOK(s_runtime->CreateAction(actionSet, createInfo, action));
+    CHECK_RUNTIME(actionSet);
+    MOCK_HOOK(runtime->CreateAction(actionSet, createInfo, action));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrDestroyAction(XrAction action)
 {
     LOG_FUNC();
-    CHECK_RUNTIME();
-    MOCK_HOOK(s_runtime->DestroyAction(action));
+    CHECK_RUNTIME(action);
+    MOCK_HOOK(runtime->DestroyAction(action));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSuggestInteractionProfileBindings(XrInstance instance, const XrInteractionProfileSuggestedBinding* suggestedBindings)
 {
     LOG_FUNC();
     CHECK_INSTANCE(instance);
-    MOCK_HOOK(s_runtime->SuggestInteractionProfileBindings(suggestedBindings));
+    MOCK_HOOK(runtime->SuggestInteractionProfileBindings(suggestedBindings));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo* attachInfo)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->AttachSessionActionSets(attachInfo));
+    MOCK_HOOK(runtime->AttachSessionActionSets(attachInfo));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetCurrentInteractionProfile(XrSession session, XrPath topLevelUserPath, XrInteractionProfileState* interactionProfile)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->GetCurrentInteractionProfile(topLevelUserPath, interactionProfile));
+    MOCK_HOOK(runtime->GetCurrentInteractionProfile(topLevelUserPath, interactionProfile));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->GetActionStateBoolean(getInfo, state));
+    MOCK_HOOK(runtime->GetActionStateBoolean(getInfo, state));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetActionStateFloat(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->GetActionStateFloat(getInfo, state));
+    MOCK_HOOK(runtime->GetActionStateFloat(getInfo, state));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->GetActionStateVector2f(getInfo, state));
+    MOCK_HOOK(runtime->GetActionStateVector2f(getInfo, state));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetActionStatePose(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStatePose* state)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->GetActionStatePose(getInfo, state));
+    MOCK_HOOK(runtime->GetActionStatePose(getInfo, state));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrSyncActions(XrSession session, const XrActionsSyncInfo* syncInfo)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->SyncActions(syncInfo));
+    MOCK_HOOK(runtime->SyncActions(syncInfo));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrEnumerateBoundSourcesForAction(XrSession session, const XrBoundSourcesForActionEnumerateInfo* enumerateInfo, uint32_t sourceCapacityInput, uint32_t* sourceCountOutput, XrPath* sources)
 {
     LOG_FUNC();
     CHECK_SESSION(session)
-    MOCK_HOOK(s_runtime->EnumerateBoundSourcesForAction(enumerateInfo, sourceCapacityInput, sourceCountOutput, sources));
+    MOCK_HOOK(runtime->EnumerateBoundSourcesForAction(enumerateInfo, sourceCapacityInput, sourceCountOutput, sources));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetInputSourceLocalizedName(XrSession session, const XrInputSourceLocalizedNameGetInfo* getInfo, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->GetInputSourceLocalizedName(getInfo, bufferCapacityInput, bufferCountOutput, buffer));
+    MOCK_HOOK(runtime->GetInputSourceLocalizedName(getInfo, bufferCapacityInput, bufferCountOutput, buffer));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrApplyHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo, const XrHapticBaseHeader* hapticFeedback)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->ApplyHapticFeedback(hapticActionInfo, hapticFeedback));
+    MOCK_HOOK(runtime->ApplyHapticFeedback(hapticActionInfo, hapticFeedback));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrStopHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo)
 {
     LOG_FUNC();
     CHECK_SESSION(session);
-    MOCK_HOOK(s_runtime->StopHapticFeedback(hapticActionInfo));
+    MOCK_HOOK(runtime->StopHapticFeedback(hapticActionInfo));
 }
 
 extern uint32_t s_VisibilityMaskVerticesSizes[4][3];
@@ -867,14 +897,16 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetRecommendedLayerResolu
     XrRecommendedLayerResolutionMETA* recommendedLayerResolution)
 {
     LOG_FUNC();
-    MOCK_HOOK(s_runtime->GetRecommendedLayerResolution(session, recommendedLayerResolutionGetInfo, recommendedLayerResolution));
+    CHECK_SESSION(session);
+    MOCK_HOOK(runtime->GetRecommendedLayerResolution(session, recommendedLayerResolutionGetInfo, recommendedLayerResolution));
 }
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function)
 {
     LOG_FUNC();
 
-    if (s_runtime != nullptr && XR_SUCCESS == s_runtime->GetInstanceProcAddr(name, function))
+    MockRuntime* runtime = MockRuntimeRegistry::Find((uint64_t)instance);
+    if (runtime != nullptr && runtime->GetInstance() == instance && XR_SUCCESS == runtime->GetInstanceProcAddr(name, function))
         return XR_SUCCESS;
 
     GET_PROC_ADDRESS(xrEnumerateApiLayerProperties)
@@ -0,0 +1,133 @@
+#include "mock.h"
+
+size_t MockPathTable::PathHash::operator()(const char* s) const
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (; *s; ++s)
+    {
+        hash ^= (uint8_t)*s;
+        hash *= 1099511628211ull;
+    }
+    return (size_t)hash;
+}
+
+MockPathTable::MockPathTable()
+    : arenaUsed(kArenaBlockSize)
+{
+    // Pair (0, 0) is XR_NULL_PATH
+    fullPaths.resize(PairIndex(0, 1), PathString{"", 0});
+}
+
+MockPathTable::PathString MockPathTable::Store(const char* prefix, uint32_t prefixLength, const char* suffix, uint32_t suffixLength)
+{
+    // Strings are at most a user path and a component path, both shorter than XR_MAX_PATH_LENGTH, so always fit a block.
+    uint32_t size = prefixLength + suffixLength + 1;
+    if (arenaUsed + size > kArenaBlockSize)
+    {
+        arenaBlocks.emplace_back(new char[kArenaBlockSize]);
+        arenaUsed = 0;
+    }
+    char* string = arenaBlocks.back().get() + arenaUsed;
+    arenaUsed += size;
+
+    memcpy(string, prefix, prefixLength);
+    memcpy(string + prefixLength, suffix, suffixLength);
+    string[prefixLength + suffixLength] = '\0';
+    return PathString{string, prefixLength + suffixLength};
+}
+
+void MockPathTable::AddPair(uint32_t userIndex, uint32_t componentIndex)
+{
+    PathString full;
+    if (userIndex == 0)
+        full = componentPaths[componentIndex - 1];
+    else if (componentIndex == 0)
+        full = userPaths[userIndex - 1];
+    else
+    {
+        const PathString& user = userPaths[userIndex - 1];
+        const PathString& component = componentPaths[componentIndex - 1];
+        full = Store(user.string, user.length, component.string, component.length);
+    }
+
+    fullPaths[PairIndex(userIndex, componentIndex)] = full;
+
+    // Strings too long for StringToPath can still be made with MakePath, but must not be found.
+    if (full.length < XR_MAX_PATH_LENGTH)
+        pathHandles.emplace(full.string, ((XrPath)componentIndex << 32) | userIndex);
+}
+
+XrPath MockPathTable::AddUserPath(const char* userPath)
+{
+    if (userPaths.size() == kMaxUserPaths)
+        return XR_NULL_PATH;
+
+    userPaths.push_back(Store(userPath, (uint32_t)strlen(userPath), "", 0));
+    uint32_t userIndex = (uint32_t)userPaths.size();
+
+    // Components interned before the user path was added get their full strings now.
+    for (uint32_t componentIndex = 0; componentIndex <= (uint32_t)componentPaths.size(); ++componentIndex)
+        AddPair(userIndex, componentIndex);
+
+    return (XrPath)userIndex;
+}
+
+XrPath MockPathTable::Find(const char* path) const
+{
+    auto it = pathHandles.find(path);
+    return it != pathHandles.end() ? it->second : XR_NULL_PATH;
+}
+
+XrPath MockPathTable::Intern(const char* path)
+{
+    XrPath handle = Find(path);
+    if (handle != XR_NULL_PATH)
+        return handle;
+
+    // Split off the user path, it has to end at a path separator.
+    uint32_t userIndex = 0;
+    const char* component = path;
+    for (uint32_t i = 0; i < (uint32_t)userPaths.size(); ++i)
+    {
+        const PathString& user = userPaths[i];
+        if (strncmp(path, user.string, user.length) == 0 && (path[user.length] == '/' || path[user.length] == '\0'))
+        {
+            userIndex = i + 1;
+            component = path + user.length;
+            break;
+        }
+    }
+
+    if (component[0] == '\0')
+        return (XrPath)userIndex;
+
+    uint32_t componentIndex;
+    auto it = componentIndices.find(component);
+    if (it != componentIndices.end())
+    {
+        componentIndex = it->second;
+    }
+    else
+    {
+        componentPaths.push_back(Store(component, (uint32_t)strlen(component), "", 0));
+        componentIndex = (uint32_t)componentPaths.size();
+        componentIndices.emplace(componentPaths.back().string, componentIndex);
+
+        fullPaths.resize(PairIndex(0, componentIndex + 1), PathString{"", 0});
+        for (uint32_t i = 0; i <= (uint32_t)userPaths.size(); ++i)
+            AddPair(i, componentIndex);
+    }
+
+    return ((XrPath)componentIndex << 32) | userIndex;
+}
+
+MockPathTable::PathString MockPathTable::ToString(XrPath path) const
+{
+    uint32_t userIndex = (uint32_t)(path & 0xFFFFFFFF);
+    uint32_t componentIndex = (uint32_t)(path >> 32);
+    if (userIndex > userPaths.size() || componentIndex > componentPaths.size())
+        return PathString{"", 0};
+
+    return fullPaths[PairIndex(userIndex, componentIndex)];
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+// Interned path strings for StringToPath and PathToString.
+// XrPath handles keep the layout described in the README: the low 32 bits are the user path index + 1 and the high
+// 32 bits are the component path index + 1.  Every string the table hands out lives in an arena and stays valid for
+// the lifetime of the table.  The full string of every user path and component path pair is built once, when the
+// second of the two is added, so converting a path back to a string never allocates.
+class MockPathTable
+{
+public:
+    static const uint32_t kMaxUserPaths = 15;
+
+    struct PathString
+    {
+        const char* string;
+        uint32_t length;
+    };
+
+    MockPathTable();
+
+    // Returns the user path handle, or XR_NULL_PATH if the table is full.
+    XrPath AddUserPath(const char* userPath);
+
+    // Returns the handle of an already interned path, or XR_NULL_PATH.  Does not validate the string.
+    XrPath Find(const char* path) const;
+
+    // Interns a path that passed ValidatePath, splitting off a leading user path.
+    XrPath Intern(const char* path);
+
+    // Empty string for XR_NULL_PATH and handles the table didn't create.
+    PathString ToString(XrPath path) const;
+
+    uint32_t GetUserPathCount() const
+    {
+        return (uint32_t)userPaths.size();
+    }
+
+    uint32_t GetComponentPathCount() const
+    {
+        return (uint32_t)componentPaths.size();
+    }
+
+private:
+    struct PathHash
+    {
+        size_t operator()(const char* s) const;
+    };
+
+    struct PathEqual
+    {
+        bool operator()(const char* a, const char* b) const
+        {
+            return strcmp(a, b) == 0;
+        }
+    };
+
+    PathString Store(const char* prefix, uint32_t prefixLength, const char* suffix, uint32_t suffixLength);
+    void AddPair(uint32_t userIndex, uint32_t componentIndex);
+
+    // Index of a pair in fullPaths.  User and component indices are 1 based, 0 is "not present".
+    static size_t PairIndex(uint32_t userIndex, uint32_t componentIndex)
+    {
+        return (size_t)componentIndex * (kMaxUserPaths + 1) + userIndex;
+    }
+
+    static const uint32_t kArenaBlockSize = 16 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> arenaBlocks;
+    uint32_t arenaUsed;
+
+    std::vector<PathString> userPaths;
+    std::vector<PathString> componentPaths;
+    std::vector<PathString> fullPaths;
+
+    // Keys point into the arena.  Components are kept apart from full paths so a component that happens to spell a
+    // user path ("/user/hand/left/user/head") still gets its own index.
+    std::unordered_map<const char*, XrPath, PathHash, PathEqual> pathHandles;
+    std::unordered_map<const char*, uint32_t, PathHash, PathEqual> componentIndices;
+};
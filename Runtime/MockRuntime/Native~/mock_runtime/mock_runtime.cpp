@@ -2,10 +2,13 @@
 #include <algorithm>
 #include <mutex>
 
-static std::mutex s_EventQueueMutex;
 static std::mutex s_ExpectedResultMutex;
 
 MockRuntime::MockRuntime(XrInstance instance, MockRuntimeCreateFlags flags)
+    : actionSets(MockRuntimeRegistry::GetRuntimeId((uint64_t)instance))
+    , actions(MockRuntimeRegistry::GetRuntimeId((uint64_t)instance))
+    , spaces(MockRuntimeRegistry::GetRuntimeId((uint64_t)instance))
+    , swapchains(MockRuntimeRegistry::GetRuntimeId((uint64_t)instance))
 {
     this->instance = instance;
     session = XR_NULL_HANDLE;
@@ -14,12 +17,14 @@ MockRuntime::MockRuntime(XrInstance instance, MockRuntimeCreateFlags flags)
     currentState = XR_SESSION_STATE_UNKNOWN;
 
     scriptEventCallback = nullptr;
+    beforeFunctionCallback = nullptr;
+    afterFunctionCallback = nullptr;
+    conformanceAutomation = nullptr;
 
     isRunning = false;
     exitSessionRequested = false;
     actionSetsAttached = false;
-
-    startTime = std::chrono::high_resolution_clock::now();
+    frontActionStates = 0;
 
     XrViewStateFlags defaultViewStateFlags =
         XR_VIEW_STATE_ORIENTATION_TRACKED_BIT |
@@ -40,22 +45,23 @@ MockRuntime::MockRuntime(XrInstance instance, MockRuntimeCreateFlags flags)
     stereoViewConfig.primary = true;
     stereoViewConfig.enabled = true;
     stereoViewConfig.active = true;
-    stereoViewConfig.stateFlags = defaultViewStateFlags;
-    stereoViewConfig.views =
-        {{defaultViewConfig,
-             {{0.0f, 0.0f, 0.0f, 1.0f}, {-0.011f, 0.0f, 0.0f}},
-             {-0.995535672f, 0.811128199f, 0.954059243f, -0.954661012f}},
-            {defaultViewConfig,
-                {{0.0f, 0.0f, 0.0f, 1.0f}, {0.011f, 0.0f, 0.0f}},
-                {-0.812360585f, 0.995566666f, 0.955580175f, -0.953877985f}}};
+    stereoViewConfig.views = {{defaultViewConfig}, {defaultViewConfig}};
+
+    MockViewLocations stereoViewLocations = {};
+    stereoViewLocations.stateFlags = defaultViewStateFlags;
+    stereoViewLocations.views[0] =
+        {{{0.0f, 0.0f, 0.0f, 1.0f}, {-0.011f, 0.0f, 0.0f}},
+            {-0.995535672f, 0.811128199f, 0.954059243f, -0.954661012f}};
+    stereoViewLocations.views[1] =
+        {{{0.0f, 0.0f, 0.0f, 1.0f}, {0.011f, 0.0f, 0.0f}},
+            {-0.812360585f, 0.995566666f, 0.955580175f, -0.953877985f}};
+    stereoViewConfig.locations.Write(stereoViewLocations);
     viewConfigurations[XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO] = stereoViewConfig;
 
     // Add quad view poses if the extension is enabled
     if ((createFlags & MR_CREATE_VARJO_QUAD_VIEWS_EXT) != 0)
     {
-        auto& stereoView0 = viewConfigurations[XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO].views[0];
-        auto& stereoView1 = viewConfigurations[XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO].views[1];
-        XrViewConfigurationView quadViewConfigView = stereoView0.configuration;
+        XrViewConfigurationView quadViewConfigView = stereoViewConfig.views[0].configuration;
         quadViewConfigView.recommendedImageRectWidth /= 3;
         quadViewConfigView.maxImageRectWidth /= 3;
         quadViewConfigView.recommendedImageRectHeight /= 3;
@@ -65,22 +71,31 @@ MockRuntime::MockRuntime(XrInstance instance, MockRuntimeCreateFlags flags)
         quadViewConfig.primary = true;
         quadViewConfig.enabled = true;
         quadViewConfig.active = true;
-        quadViewConfig.stateFlags = defaultViewStateFlags;
         quadViewConfig.views = {
-            stereoView0,
-            stereoView1,
-            {quadViewConfigView,
-                stereoView0.pose,
+            stereoViewConfig.views[0],
+            stereoViewConfig.views[1],
+            {quadViewConfigView},
+            {quadViewConfigView}};
+
+        const MockViewLocation& stereoView0 = stereoViewLocations.views[0];
+        const MockViewLocation& stereoView1 = stereoViewLocations.views[1];
+        MockViewLocations quadViewLocations = {};
+        quadViewLocations.stateFlags = defaultViewStateFlags;
+        quadViewLocations.views[0] = stereoView0;
+        quadViewLocations.views[1] = stereoView1;
+        quadViewLocations.views[2] =
+            {stereoView0.pose,
                 {stereoView0.fov.angleLeft / 3.0f,
                     stereoView0.fov.angleRight / 3.0f,
                     stereoView0.fov.angleUp / 3.0f,
-                    stereoView0.fov.angleDown / 3.0f}},
-            {quadViewConfigView,
-                stereoView1.pose,
+                    stereoView0.fov.angleDown / 3.0f}};
+        quadViewLocations.views[3] =
+            {stereoView1.pose,
                 {stereoView1.fov.angleLeft / 3.0f,
                     stereoView1.fov.angleRight / 3.0f,
                     stereoView1.fov.angleUp / 3.0f,
-                    stereoView1.fov.angleDown / 3.0f}}};
+                    stereoView1.fov.angleDown / 3.0f}};
+        quadViewConfig.locations.Write(quadViewLocations);
         viewConfigurations[XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO] = quadViewConfig;
     }
 
@@ -93,18 +108,18 @@ MockRuntime::MockRuntime(XrInstance instance, MockRuntimeCreateFlags flags)
         MSFTThirdPersonObserver_Init();
 
     if ((createFlags & MR_CREATE_META_PERFORMANCE_METRICS_EXT) == MR_CREATE_META_PERFORMANCE_METRICS_EXT)
-        MockMetaPerformanceMetrics::Init(*this, 4);
+        metaPerformanceMetrics.reset(new MockMetaPerformanceMetrics(*this, 4));
 
     if ((createFlags & MR_CREATE_PERFORMANCE_SETTINGS_EXT) == MR_CREATE_PERFORMANCE_SETTINGS_EXT)
-        MockPerformanceSettings::Init(*this);
+        performanceSettings.reset(new MockPerformanceSettings(*this));
 
 #ifdef XR_USE_PLATFORM_ANDROID
     if ((createFlags & MR_CREATE_KHR_ANDROID_THREAD_SETTINGS_EXT) == MR_CREATE_KHR_ANDROID_THREAD_SETTINGS_EXT)
-        MockAndroidThreadSettings::Init(*this);
+        androidThreadSettings.reset(new MockAndroidThreadSettings(*this));
 #endif
 
     if ((createFlags & MR_CREATE_ANDROID_ENUMERATE_SYSTEM_EXTENSION_PROPERTIES) == MR_CREATE_ANDROID_ENUMERATE_SYSTEM_EXTENSION_PROPERTIES)
-        MockAndroidEnumerateSystemExtensionProperties::Init(*this);
+        androidEnumerateSystemExtensionProperties.reset(new MockAndroidEnumerateSystemExtensionProperties(*this));
 
     recommendedResolutionChanged = false;
 
@@ -119,16 +134,18 @@ MockRuntime::MockRuntime(XrInstance instance, MockRuntimeCreateFlags flags)
     if ((createFlags & MR_CREATE_EYE_GAZE_INTERACTION_EXT) != 0)
         userPaths.push_back({"/user/eyes_ext", "Eyes", nullptr});
 
+    for (const MockUserPath& userPath : userPaths)
+        paths.AddUserPath(userPath.path.c_str());
+
     InitializeInteractionProfiles();
 
     if (IsConformanceAutomationEnabled())
-        ConformanceAutomation_Create();
+        conformanceAutomation = ConformanceAutomation_Create();
 }
 
 MockRuntime::~MockRuntime()
 {
-    if (IsConformanceAutomationEnabled())
-        ConformanceAutomation_Destroy();
+    ConformanceAutomation_Destroy(conformanceAutomation);
 }
 
 XrResult MockRuntime::GetReferenceSpaceBoundsRect(XrReferenceSpaceType referenceSpace, XrExtent2Df* extents)
@@ -171,18 +188,19 @@ void MockRuntime::ChangeSessionState(XrSessionState state)
         XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED,
         nullptr,
         session,
-        state});
+        state,
+        clock.Now()});
 }
 
 XrTime MockRuntime::GetPredictedTime()
 {
-    return (XrTime)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return clock.Now();
 }
 
 XrResult MockRuntime::WaitFrame(const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState)
 {
-    frameState->predictedDisplayTime = GetPredictedTime();
-    frameState->predictedDisplayPeriod = 16666000;
+    frameState->predictedDisplayTime = clock.WaitFrame();
+    frameState->predictedDisplayPeriod = MockClock::kDisplayPeriod;
     frameState->shouldRender = (createFlags & MR_CREATE_ALL_GFX_EXT) != 0;
 
     XrResult result = XR_SUCCESS;
@@ -212,7 +230,7 @@ XrResult MockRuntime::EndFrame(const XrFrameEndInfo* frameEndInfo)
 
 XrResult MockRuntime::CreateSession(const XrSessionCreateInfo* createInfo)
 {
-    session = (XrSession)3;
+    session = (XrSession)MockRuntimeRegistry::MakeHandle(MockRuntimeRegistry::GetRuntimeId((uint64_t)instance), 3);
 
     ChangeSessionState(XR_SESSION_STATE_IDLE);
 
@@ -232,6 +250,19 @@ XrResult MockRuntime::DestroySession()
     exitSessionRequested = false;
     session = XR_NULL_HANDLE;
     actionSetsAttached = false;
+    spaces.Clear();
+    swapchains.Clear();
+
+    // The slots went with the session, they're built again when action sets are attached to the next one
+    for (auto& mockActionSet : actionSets)
+    {
+        mockActionSet.firstStateSlot = 0;
+        mockActionSet.stateSlotCount = 0;
+    }
+    actionStateSlots.clear();
+    actionStateBindings.clear();
+    actionStates[0].clear();
+    actionStates[1].clear();
     currentState = XR_SESSION_STATE_UNKNOWN;
 
     return XR_SUCCESS;
@@ -270,21 +301,10 @@ XrResult MockRuntime::EndSession()
     return XR_SUCCESS;
 }
 
-void MockRuntime::QueueEvent(const XrEventDataBuffer& buffer)
+void MockRuntime::QueueEvent(const void* event, uint32_t size)
 {
-    std::lock_guard<std::mutex> lock(s_EventQueueMutex);
-    eventQueue.push(buffer);
-}
-
-XrEventDataBuffer MockRuntime::GetNextEvent()
-{
-    std::lock_guard<std::mutex> lock(s_EventQueueMutex);
-    if (eventQueue.size() == 0)
-        return XrEventDataBuffer{};
-
-    XrEventDataBuffer event = eventQueue.front();
-    eventQueue.pop();
-    return event;
+    if (!eventQueue.Push(event, size))
+        MOCK_TRACE_ERROR("[QueueEvent] event queue full, dropped event type=%s", to_string(((const XrEventDataBaseHeader*)event)->type));
 }
 
 XrResult MockRuntime::GetNextEvent(XrEventDataBuffer* eventData)
@@ -294,14 +314,12 @@ XrResult MockRuntime::GetNextEvent(XrEventDataBuffer* eventData)
 
     while (true)
     {
-        *eventData = GetNextEvent();
+        if (eventQueue.Pop(eventData, (uint32_t)sizeof(XrEventDataBuffer)) == 0)
+            return XR_EVENT_UNAVAILABLE;
 
         // Handle mock internal events
         switch (eventData->type)
         {
-        case XR_TYPE_UNKNOWN:
-            return XR_EVENT_UNAVAILABLE;
-
         case XR_TYPE_EVENT_SCRIPT_EVENT_MOCK:
         {
             XrEventScriptEventMOCK* scriptEvent = (XrEventScriptEventMOCK*)eventData;
@@ -363,7 +381,7 @@ void MockRuntime::SetExtentsForReferenceSpace(XrReferenceSpaceType referenceSpac
     evt.next = nullptr;
     evt.session = session;
     evt.referenceSpaceType = referenceSpace;
-    evt.changeTime = 0;
+    evt.changeTime = clock.Now();
     evt.poseValid = false;
     evt.poseInPreviousSpace = {{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}};
     QueueEvent(evt);
@@ -373,12 +391,12 @@ XrResult MockRuntime::CauseInstanceLoss()
 {
     instanceIsLost = true;
 
-    auto killTime = std::chrono::system_clock::now() + std::chrono::seconds(5);
+    XrTime lossTime = clock.Now() + std::chrono::nanoseconds(std::chrono::seconds(5)).count();
 
     QueueEvent(XrEventDataInstanceLossPending{
         XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING,
         nullptr,
-        killTime.time_since_epoch().count()});
+        lossTime});
 
     return XR_SUCCESS;
 }
@@ -411,8 +429,7 @@ void MockRuntime::SetSpace(XrAction action, XrPosef pose, XrSpaceLocationFlags s
         if (mockSpace.action != action)
             continue;
 
-        mockSpace.pose = pose;
-        mockSpace.locationFlags = spaceLocationFlags;
+        mockSpace.location.Write({pose, spaceLocationFlags});
     }
 }
 
@@ -422,10 +439,7 @@ void MockRuntime::SetSpace(XrReferenceSpaceType referenceType, XrPosef pose, XrS
     for (auto& mockSpace : spaces)
     {
         if (mockSpace.referenceSpaceType == referenceType)
-        {
-            mockSpace.pose = pose;
-            mockSpace.locationFlags = spaceLocationFlags;
-        }
+            mockSpace.location.Write({pose, spaceLocationFlags});
     }
 }
 
@@ -437,8 +451,9 @@ XrResult MockRuntime::LocateSpace(XrSpace space, XrSpace baseSpace, XrTime time,
 
     // TODO: relative to the base space?
 
-    location->pose = mockSpace->pose;
-    location->locationFlags = mockSpace->locationFlags;
+    MockSpaceLocation mockSpaceLocation = mockSpace->location.Read();
+    location->pose = mockSpaceLocation.pose;
+    location->locationFlags = mockSpaceLocation.locationFlags;
 
     if (mockSpace->action != XR_NULL_HANDLE)
     {
@@ -446,23 +461,15 @@ XrResult MockRuntime::LocateSpace(XrSpace space, XrSpace baseSpace, XrTime time,
         if (nullptr == mockAction)
             return XR_ERROR_HANDLE_INVALID;
 
-        for (auto& binding : mockAction->bindings)
+        for (MockInputStateHandle bindingHandle : mockAction->bindings)
         {
+            const MockInputState* binding = &inputStates[bindingHandle];
             if (mockSpace->subActionPath != XR_NULL_PATH && GetUserPath(binding->path) != mockSpace->subActionPath)
                 continue;
 
-            location->pose = binding->GetLocationPose();
-
             // Optional velocity driven by conformance automation
             XrSpaceVelocity* spaceVelocity = FindNextPointerType<XrSpaceVelocity>(location, XR_TYPE_SPACE_VELOCITY);
-            if (nullptr != spaceVelocity)
-            {
-                spaceVelocity->velocityFlags = 0;
-                spaceVelocity->velocityFlags |= (binding->HasLinearVelocity() ? XR_SPACE_VELOCITY_LINEAR_VALID_BIT : 0);
-                spaceVelocity->linearVelocity = binding->GetLinearVelocity();
-                spaceVelocity->velocityFlags |= (binding->HasAngularVelocity() ? XR_SPACE_VELOCITY_ANGULAR_VALID_BIT : 0);
-                spaceVelocity->angularVelocity = binding->GetAngularVelocity();
-            }
+            location->pose = binding->GetLocation(spaceVelocity);
             break;
         }
     }
@@ -486,17 +493,23 @@ void MockRuntime::SetViewStateFlags(XrViewConfigurationType viewConfigurationTyp
     if (nullptr == mockViewConfiguration)
         return;
 
-    mockViewConfiguration->stateFlags = viewStateFlags;
+    mockViewConfiguration->locations.Update([viewStateFlags](MockViewLocations& locations) {
+        locations.stateFlags = viewStateFlags;
+    });
 }
 
 void MockRuntime::SetViewPose(XrViewConfigurationType viewConfigurationType, int viewIndex, XrPosef pose, XrFovf fov)
 {
-    MockView* mockView = GetMockView(viewConfigurationType, viewIndex);
-    if (nullptr == mockView)
+    MockViewConfiguration* mockViewConfiguration = GetMockViewConfiguration(viewConfigurationType);
+    if (nullptr == mockViewConfiguration)
+        return;
+
+    if (viewIndex < 0 || (size_t)viewIndex >= mockViewConfiguration->views.size())
         return;
 
-    mockView->pose = pose;
-    mockView->fov = fov;
+    mockViewConfiguration->locations.Update([viewIndex, pose, fov](MockViewLocations& locations) {
+        locations.views[viewIndex] = {pose, fov};
+    });
 }
 
 XrResult MockRuntime::LocateViews(const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views)
@@ -528,7 +541,8 @@ XrResult MockRuntime::LocateViews(const XrViewLocateInfo* viewLocateInfo, XrView
     if (viewCapacityInput < (uint32_t)mockViewConfiguration->views.size())
         return XR_ERROR_VALIDATION_FAILURE;
 
-    viewState->viewStateFlags = mockViewConfiguration->stateFlags;
+    MockViewLocations locations = mockViewConfiguration->locations.Read();
+    viewState->viewStateFlags = locations.stateFlags;
 
     // If the view is not active then remove the tracked bits
     if (!mockViewConfiguration->active)
@@ -536,9 +550,8 @@ XrResult MockRuntime::LocateViews(const XrViewLocateInfo* viewLocateInfo, XrView
 
     for (uint32_t i = 0; i < mockViewConfiguration->views.size(); i++)
     {
-        const MockView& mockView = mockViewConfiguration->views[i];
-        views[i].pose = mockView.pose;
-        views[i].fov = mockView.fov;
+        views[i].pose = locations.views[i].pose;
+        views[i].fov = locations.views[i].fov;
     }
 
     return XR_SUCCESS;
@@ -664,15 +677,16 @@ XrResult MockRuntime::CreateActionSet(const XrActionSetCreateInfo* createInfo, X
             return XR_ERROR_LOCALIZED_NAME_DUPLICATED;
     }
 
-    if (actionSets.size() >= 0xFFFE)
+    // Add a new action set.
+    XrActionSet handle = (XrActionSet)actionSets.Add();
+    if (handle == XR_NULL_HANDLE)
         return XR_ERROR_LIMIT_REACHED;
 
-    // Add a new action set.
-    actionSets.emplace_back();
-    auto& added = actionSets.back();
-    added.actionSet = (XrActionSet)actionSets.size();
-    added.isDestroyed = false;
+    auto& added = *actionSets.Get((uint64_t)handle);
+    added.actionSet = handle;
     added.attached = false;
+    added.firstStateSlot = 0;
+    added.stateSlotCount = 0;
     added.name = createInfo->actionSetName;
     added.localizedName = createInfo->localizedActionSetName;
 
@@ -684,20 +698,17 @@ XrResult MockRuntime::CreateActionSet(const XrActionSetCreateInfo* createInfo, X
 
 XrResult MockRuntime::DestroyActionSet(XrActionSet actionSet)
 {
-    // Scan the action sets for a match
-    for (auto it = actionSets.begin(); it != actionSets.end(); it++)
-    {
-        auto& mockActionSet = *it;
-        if (mockActionSet.actionSet == actionSet)
-        {
-            actionSets.erase(it);
+    MockActionSet* mockActionSet = GetMockActionSet(actionSet);
+    if (nullptr == mockActionSet)
+        return XR_ERROR_HANDLE_INVALID;
 
-            // TODO: The implementation must not free underlying resources for the action set while there are other valid handles that refer to those resources. The implementation may release resources for an action set when all of the action spaces for actions in that action set have been destroyed. See Action Spaces Lifetime for details.
-            return XR_SUCCESS;
-        }
-    }
+    // Destroying an action set destroys its actions, their handles go stale along with the action set handle.
+    // TODO: The implementation must not free underlying resources for the action set while there are other valid handles that refer to those resources. The implementation may release resources for an action set when all of the action spaces for actions in that action set have been destroyed. See Action Spaces Lifetime for details.
+    for (XrAction action : mockActionSet->actions)
+        actions.Remove((uint64_t)action);
 
-    return XR_ERROR_HANDLE_INVALID;
+    actionSets.Remove((uint64_t)actionSet);
+    return XR_SUCCESS;
 }
 
 MockRuntime::MockReferenceSpace* MockRuntime::GetMockReferenceSpace(XrReferenceSpaceType referenceSpaceType)
@@ -718,29 +729,9 @@ MockRuntime::MockViewConfiguration* MockRuntime::GetMockViewConfiguration(XrView
     return &it->second;
 }
 
-MockRuntime::MockView* MockRuntime::GetMockView(XrViewConfigurationType viewConfigType, size_t viewIndex)
-{
-    MockViewConfiguration* mockViewConfiguration = GetMockViewConfiguration(viewConfigType);
-    if (nullptr == mockViewConfiguration)
-        return nullptr;
-
-    if (viewIndex >= mockViewConfiguration->views.size())
-        return nullptr;
-
-    return &mockViewConfiguration->views[viewIndex];
-}
-
 MockRuntime::MockActionSet* MockRuntime::GetMockActionSet(XrActionSet actionSet)
 {
-    size_t actionSetIndex = ((uint64_t)actionSet) - 1;
-    if (actionSetIndex >= actionSets.size())
-        return nullptr;
-
-    MockActionSet* mockActionSet = &actionSets[actionSetIndex];
-    if (mockActionSet->actionSet != actionSet)
-        return nullptr;
-
-    return mockActionSet;
+    return actionSets.Get((uint64_t)actionSet);
 }
 
 XrResult MockRuntime::CreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action)
@@ -771,20 +762,13 @@ XrResult MockRuntime::CreateAction(XrActionSet actionSet, const XrActionCreateIn
         return XR_ERROR_LOCALIZED_NAME_INVALID;
 
     // OpenXR 1.0: If actionName or localizedActionName are duplicates of the corresponding field for any existing action in the specified action set, the runtime must return XR_ERROR_NAME_DUPLICATED or XR_ERROR_LOCALIZED_NAME_DUPLICATED respectively
-    MockAction* mockAction = nullptr;
-    for (auto& existingMockAction : mockActionSet->actions)
+    for (XrAction existingAction : mockActionSet->actions)
     {
-        if (existingMockAction.isDestroyed)
-        {
-            if (existingMockAction.name == createInfo->actionName)
-                mockAction = &existingMockAction;
-            continue;
-        }
-
+        const MockAction& existingMockAction = *GetMockAction(existingAction);
         if (existingMockAction.name == createInfo->actionName)
             return XR_ERROR_NAME_DUPLICATED;
 
-        if (!existingMockAction.isDestroyed && existingMockAction.localizedName == createInfo->localizedActionName)
+        if (existingMockAction.localizedName == createInfo->localizedActionName)
             return XR_ERROR_LOCALIZED_NAME_DUPLICATED;
     }
 
@@ -802,26 +786,9 @@ XrResult MockRuntime::CreateAction(XrActionSet actionSet, const XrActionCreateIn
         return XR_ERROR_VALIDATION_FAILURE;
     }
 
-    if (mockActionSet->actions.size() >= 0xFFFE)
-        return XR_ERROR_LIMIT_REACHED;
-
     if (createInfo->countSubactionPaths > 0 && createInfo->subactionPaths == nullptr)
         return XR_ERROR_VALIDATION_FAILURE;
 
-    // Create a new action if we arent reusing a destroyed action
-    if (nullptr == mockAction)
-    {
-        mockActionSet->actions.emplace_back();
-        mockAction = &mockActionSet->actions.back();
-    }
-
-    // Create a new mock action
-    mockAction->action = (XrAction)((uint64_t)actionSet + (mockActionSet->actions.size() << 32));
-    mockAction->name = createInfo->actionName;
-    mockAction->localizedName = createInfo->localizedActionName;
-    mockAction->type = createInfo->actionType;
-    mockAction->isDestroyed = false;
-
     for (uint32_t i = 0; i < createInfo->countSubactionPaths; i++)
     {
         auto subactionPath = createInfo->subactionPaths[i];
@@ -829,13 +796,27 @@ XrResult MockRuntime::CreateAction(XrActionSet actionSet, const XrActionCreateIn
             return XR_ERROR_PATH_UNSUPPORTED;
 
         // Do not allow duplicate sub action paths
-        if (std::find(mockAction->userPaths.begin(), mockAction->userPaths.end(), subactionPath) != mockAction->userPaths.end())
+        if (std::find(createInfo->subactionPaths, createInfo->subactionPaths + i, subactionPath) != createInfo->subactionPaths + i)
             return XR_ERROR_PATH_UNSUPPORTED;
-
-        mockAction->userPaths.push_back(subactionPath);
     }
 
-    *action = mockAction->action;
+    // Create a new mock action
+    XrAction handle = (XrAction)actions.Add();
+    if (handle == XR_NULL_HANDLE)
+        return XR_ERROR_LIMIT_REACHED;
+
+    MockAction* mockAction = GetMockAction(handle);
+    mockAction->action = handle;
+    mockAction->actionSet = actionSet;
+    mockAction->name = createInfo->actionName;
+    mockAction->localizedName = createInfo->localizedActionName;
+    mockAction->type = createInfo->actionType;
+    mockAction->stateSlot = 0;
+    mockAction->userPaths.assign(createInfo->subactionPaths, createInfo->subactionPaths + createInfo->countSubactionPaths);
+
+    mockActionSet->actions.push_back(handle);
+
+    *action = handle;
 
     return XR_SUCCESS;
 }
@@ -846,7 +827,10 @@ XrResult MockRuntime::DestroyAction(XrAction action)
     if (nullptr == mockAction)
         return XR_ERROR_HANDLE_INVALID;
 
-    mockAction->isDestroyed = true;
+    std::vector<XrAction>& siblings = GetMockActionSet(mockAction->actionSet)->actions;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), action));
+
+    actions.Remove((uint64_t)action);
     return XR_SUCCESS;
 }
 
@@ -874,6 +858,14 @@ XrPath MockRuntime::StringToPath(const char* pathString)
 
 XrResult MockRuntime::StringToPath(const char* pathString, XrPath* path)
 {
+    // Interned strings were validated when they were added
+    XrPath interned = paths.Find(pathString);
+    if (interned != XR_NULL_PATH)
+    {
+        *path = interned;
+        return XR_SUCCESS;
+    }
+
     CHECK_SUCCESS(ValidatePath(pathString));
 
     // Ensure the string is not too long
@@ -883,62 +875,19 @@ XrResult MockRuntime::StringToPath(const char* pathString, XrPath* path)
         return XR_ERROR_PATH_FORMAT_INVALID;
     }
 
-    // If the path contains a user path then separate the user path from the component path
-    XrPath result = XR_NULL_PATH;
-    for (size_t i = 0; i < userPaths.size(); i++)
-    {
-        auto& userPathString = userPaths[i].path;
-        if (strncmp(pathString, userPathString.c_str(), userPathString.length()) == 0)
-        {
-            result |= (XrPath)(i + 1);
-            pathString += userPathString.length();
-            break;
-        }
-    }
-
-    // Search the component paths
-    if (pathString[0] == '/')
-    {
-        for (size_t i = 0llu; i < componentPathStrings.size(); i++)
-        {
-            if (strcmp(pathString, componentPathStrings[i].c_str()) == 0)
-            {
-                result |= (XrPath)((i + 1) << 32);
-                *path = result;
-                return XR_SUCCESS;
-            }
-        }
-
-        componentPathStrings.push_back(pathString);
-        result |= (XrPath)(componentPathStrings.size() << 32);
-    }
-
-    *path = result;
+    *path = paths.Intern(pathString);
     return XR_SUCCESS;
 }
 
-std::string MockRuntime::PathToString(XrPath path) const
+const char* MockRuntime::PathToString(XrPath path) const
 {
-    size_t userPath = (size_t)(path & 0xFFFFFFFF) - 1;
-    size_t componentPath = (size_t)(((uint64_t)path) >> 32) - 1;
-
-    // Both user path and component path are there.
-    if (userPath < userPaths.size() && componentPath < componentPathStrings.size())
-        return userPaths[userPath].path + componentPathStrings[componentPath];
-
-    if (userPath < userPaths.size())
-        return userPaths[userPath].path;
-
-    if (componentPath < componentPathStrings.size())
-        return componentPathStrings[componentPath];
-
-    return "";
+    return paths.ToString(path).string;
 }
 
 XrResult MockRuntime::PathToString(XrPath path, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) const
 {
-    std::string pathString = PathToString(path);
-    if (pathString.length() == 0)
+    MockPathTable::PathString pathString = paths.ToString(path);
+    if (pathString.length == 0)
     {
         *bufferCountOutput = 0;
         return XR_ERROR_PATH_INVALID;
@@ -946,21 +895,18 @@ XrResult MockRuntime::PathToString(XrPath path, uint32_t bufferCapacityInput, ui
 
     if (buffer == nullptr)
     {
-        *bufferCountOutput = (uint32_t)(pathString.length() + 1);
+        *bufferCountOutput = pathString.length + 1;
         return XR_SUCCESS;
     }
 
-    if (pathString.length() + 1 > bufferCapacityInput)
+    if (pathString.length + 1 > bufferCapacityInput)
     {
         *bufferCountOutput = 0;
         return XR_ERROR_SIZE_INSUFFICIENT;
     }
 
-    uint32_t strSize = (uint32_t)pathString.length();
-    memcpy(buffer, pathString.c_str(), pathString.length());
-
-    buffer[strSize] = '\0';
-    *bufferCountOutput = strSize + 1;
+    memcpy(buffer, pathString.string, pathString.length + 1);
+    *bufferCountOutput = pathString.length + 1;
 
     return XR_SUCCESS;
 }
@@ -972,16 +918,23 @@ bool MockRuntime::IsValidHandle(XrPath path) const
 
     size_t userPath = (size_t)(path & 0xFFFFFFFF);
     size_t componentPath = (size_t)(path >> 32);
-    return userPath <= userPaths.size() && componentPath <= componentPathStrings.size();
+    return userPath <= paths.GetUserPathCount() && componentPath <= paths.GetComponentPathCount();
 }
 
 XrPath MockRuntime::AppendPath(XrPath path, const char* append)
 {
-    std::string current = PathToString(path);
-    if (current.length() == 0)
+    MockPathTable::PathString current = paths.ToString(path);
+    if (current.length == 0)
+        return XR_NULL_PATH;
+
+    size_t appendLength = strlen(append);
+    if (current.length + appendLength >= XR_MAX_PATH_LENGTH)
         return XR_NULL_PATH;
 
-    return StringToPath((current + append).c_str());
+    char appended[XR_MAX_PATH_LENGTH];
+    memcpy(appended, current.string, current.length);
+    memcpy(appended + current.length, append, appendLength + 1);
+    return StringToPath(appended);
 }
 
 XrPath MockRuntime::MakePath(XrPath userPath, XrPath componentPath) const
@@ -1039,10 +992,10 @@ XrResult MockRuntime::SuggestInteractionProfileBindings(const XrInteractionProfi
                 return XR_ERROR_PATH_UNSUPPORTED;
 
         // Try to bind directly to a known input source
-        MockInputState* inputState = GetMockInputState(*mockProfile, suggestedBinding.binding, mockAction->type);
-        if (nullptr == inputState)
+        MockInputStateHandle inputState = GetMockInputStateHandle(*mockProfile, suggestedBinding.binding, mockAction->type);
+        if (kInvalidInputStateHandle == inputState)
         {
-            MOCK_TRACE_ERROR("[SuggestInteractionProfileBindings] %s:%s%s: XR_ERROR_PATH_UNSUPPORTED", mockAction->name.c_str(), PathToString(mockProfile->path).c_str(), PathToString(suggestedBinding.binding).c_str());
+            MOCK_TRACE_ERROR("[SuggestInteractionProfileBindings] %s:%s%s: XR_ERROR_PATH_UNSUPPORTED", mockAction->name.c_str(), PathToString(mockProfile->path), PathToString(suggestedBinding.binding));
             return XR_ERROR_PATH_UNSUPPORTED;
         }
 
@@ -1052,18 +1005,6 @@ XrResult MockRuntime::SuggestInteractionProfileBindings(const XrInteractionProfi
     return XR_SUCCESS;
 }
 
-MockInputState* MockRuntime::AddMockInputState(XrPath interactionPath, XrPath path, XrActionType actionType, const char* localizedName)
-{
-    inputStates.emplace_back();
-    MockInputState& mockInputState = inputStates.back();
-    mockInputState.interactionProfile = interactionPath;
-    mockInputState.path = path;
-    mockInputState.type = actionType;
-    mockInputState.localizedName = localizedName;
-    mockInputState.Reset();
-    return &mockInputState;
-}
-
 bool MockRuntime::SetActiveInteractionProfile(MockUserPath* mockUserPath, const MockInteractionProfile* mockProfile)
 {
     if (nullptr == mockUserPath || nullptr == mockProfile)
@@ -1107,14 +1048,18 @@ XrResult MockRuntime::AttachSessionActionSets(const XrSessionActionSetsAttachInf
 
     actionSetsAttached = true;
 
+    // Bindings can't change once action sets are attached
+    BuildActionStateSlots();
+
 #if 0
     // Print all bindings
     for (auto& as : actionSets)
-        for (auto& a : as.actions)
+        for (auto action : as.actions)
         {
+            auto& a = *GetMockAction(action);
             int bindingIndex = 0;
-            for (auto& b : a.bindings)
-                MOCK_TRACE_LOG("[Binding] %s.%s(%d) -> %s%s", as.name.c_str(), a.name.c_str(), bindingIndex++, PathToString(b->interactionProfile).c_str(), PathToString(b->path).c_str());
+            for (auto b : a.bindings)
+                MOCK_TRACE_LOG("[Binding] %s.%s(%d) -> %s%s", as.name.c_str(), a.name.c_str(), bindingIndex++, PathToString(inputStates[b].interactionProfile), PathToString(inputStates[b].path));
         }
 #endif
 
@@ -1148,60 +1093,177 @@ MockRuntime::MockUserPath* MockRuntime::GetMockUserPath(XrPath path)
 
 MockRuntime::MockActionSet* MockRuntime::GetMockActionSet(XrAction action)
 {
-    size_t actionSetIndex = (size_t)((uint64_t)action & 0xFFFF) - 1;
-    if (actionSetIndex >= actionSets.size())
+    MockAction* mockAction = GetMockAction(action);
+    if (nullptr == mockAction)
         return nullptr;
 
-    return &actionSets[actionSetIndex];
+    return GetMockActionSet(mockAction->actionSet);
 }
 
 MockRuntime::MockAction* MockRuntime::GetMockAction(XrAction action)
 {
-    MockActionSet* mockActionSet = GetMockActionSet(action);
-    if (nullptr == mockActionSet)
-        return nullptr;
+    return actions.Get((uint64_t)action);
+}
 
-    size_t actionIndex = (size_t)(((uint64_t)action) >> 32) - 1;
-    if (actionIndex >= mockActionSet->actions.size())
-        return nullptr;
+XrActionSet MockRuntime::GetActionSet(XrAction action)
+{
+    MockAction* mockAction = GetMockAction(action);
+    return nullptr != mockAction ? mockAction->actionSet : XR_NULL_HANDLE;
+}
 
-    MockAction* mockAction = &mockActionSet->actions[actionIndex];
-    if (mockAction->action != action)
-        return nullptr;
+MockInputStateHandle MockRuntime::GetMockInputStateHandle(const MockInteractionProfile& mockProfile, XrPath path, XrActionType actionType) const
+{
+    auto it = inputSources.find(MockInputSourceKey{mockProfile.path, path});
+    if (it == inputSources.end())
+        return kInvalidInputStateHandle;
+
+    const MockInputSource& source = it->second;
+    MockInputStateHandle state = source.state;
+
+    // Nothing was found, could be a parent path
+    if (state == kInvalidInputStateHandle)
+    {
+        switch (actionType)
+        {
+        case XR_ACTION_TYPE_BOOLEAN_INPUT:
+            state = source.valueState != kInvalidInputStateHandle ? source.valueState : source.clickState;
+            break;
 
-    return mockAction;
+        case XR_ACTION_TYPE_FLOAT_INPUT:
+            state = source.valueState;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return state;
 }
 
 MockInputState* MockRuntime::GetMockInputState(const MockInteractionProfile& mockProfile, XrPath path, XrActionType actionType)
 {
-    for (auto& mockInputState : inputStates)
-    {
-        if (mockInputState.interactionProfile == mockProfile.path && mockInputState.path == path)
-            return &mockInputState;
-    }
+    MockInputStateHandle state = GetMockInputStateHandle(mockProfile, path, actionType);
+    return state != kInvalidInputStateHandle ? &inputStates[state] : nullptr;
+}
 
-    // Nothing was found, could be a parent path, lets check
-    switch (actionType)
-    {
-    case XR_ACTION_TYPE_BOOLEAN_INPUT:
+void MockRuntime::BuildActionStateSlots()
+{
+    actionStateSlots.clear();
+    actionStateBindings.clear();
+
+    size_t slotsPerAction = userPaths.size() + 1;
+    for (auto& mockActionSet : actionSets)
     {
-        MockInputState* mockInputState = GetMockInputState(mockProfile, AppendPath(path, "/value"));
-        if (nullptr != mockInputState)
-            return mockInputState;
+        mockActionSet.firstStateSlot = actionStateSlots.size();
+
+        if (mockActionSet.attached)
+        {
+            for (XrAction action : mockActionSet.actions)
+            {
+                MockAction& mockAction = *GetMockAction(action);
+                mockAction.stateSlot = actionStateSlots.size();
 
-        return GetMockInputState(mockProfile, AppendPath(path, "/click"));
+                for (size_t userPath = 0; userPath < slotsPerAction; userPath++)
+                {
+                    MockActionStateSlot slot = {(uint32_t)actionStateBindings.size(), 0, true, true, true};
+                    for (MockInputStateHandle bindingHandle : mockAction.bindings)
+                    {
+                        MockInputState* binding = &inputStates[bindingHandle];
+
+                        // The XR_NULL_PATH slot aggregates the bindings of all user paths
+                        if (userPath != 0 && GetUserPath(binding->path) != (XrPath)userPath)
+                            continue;
+
+                        actionStateBindings.push_back(binding);
+                        slot.bindingCount++;
+                        slot.booleanCompatible = slot.booleanCompatible && binding->IsCompatibleType(XR_ACTION_TYPE_BOOLEAN_INPUT);
+                        slot.floatCompatible = slot.floatCompatible && binding->IsCompatibleType(XR_ACTION_TYPE_FLOAT_INPUT);
+                        slot.vector2fCompatible = slot.vector2fCompatible && binding->IsCompatibleType(XR_ACTION_TYPE_VECTOR2F_INPUT);
+                    }
+
+                    actionStateSlots.push_back(slot);
+                }
+            }
+        }
+
+        mockActionSet.stateSlotCount = actionStateSlots.size() - mockActionSet.firstStateSlot;
     }
 
-    case XR_ACTION_TYPE_FLOAT_INPUT:
+    actionStates[0].assign(actionStateSlots.size(), MockSeqLock<MockActionState>());
+    actionStates[1].assign(actionStateSlots.size(), MockSeqLock<MockActionState>());
+    frontActionStates.store(0, std::memory_order_release);
+}
+
+void MockRuntime::UpdateActionStates(const MockActionSet& mockActionSet, XrPath subactionPath, XrTime time)
+{
+    uint32_t frontIndex = frontActionStates.load(std::memory_order_relaxed);
+    const std::vector<MockSeqLock<MockActionState>>& front = actionStates[frontIndex];
+    std::vector<MockSeqLock<MockActionState>>& back = actionStates[frontIndex ^ 1];
+
+    size_t slotsPerAction = userPaths.size() + 1;
+    for (size_t i = mockActionSet.firstStateSlot; i < mockActionSet.firstStateSlot + mockActionSet.stateSlotCount; i++)
     {
-        return GetMockInputState(mockProfile, AppendPath(path, "/value"));
+        // OpenXR 1.0: Only the subaction path named by the sync is active, the other slots keep the inactive copy made by SyncActions
+        size_t userPath = (i - mockActionSet.firstStateSlot) % slotsPerAction;
+        if (subactionPath != XR_NULL_PATH && userPath != 0 && (XrPath)userPath != subactionPath)
+            continue;
+
+        const MockActionStateSlot& slot = actionStateSlots[i];
+        MockActionState state = {};
+        float vector2fLength = 0.0f;
+
+        for (uint32_t b = slot.firstBinding; b < slot.firstBinding + slot.bindingCount; b++)
+        {
+            const MockInputState* binding = actionStateBindings[b];
+
+            if (slot.booleanCompatible && binding->GetBoolean())
+                state.booleanValue = XR_TRUE;
+
+            // OpenXR 1.0: The current state must be the state of the input with the largest absolute value
+            if (slot.floatCompatible)
+            {
+                float bindingValue = binding->GetFloat();
+                if (std::abs(bindingValue) > std::abs(state.floatValue))
+                    state.floatValue = bindingValue;
+            }
+
+            if (slot.vector2fCompatible)
+            {
+                XrVector2f bindingValue = binding->GetVector2();
+                float bindingValueLength = bindingValue.x * bindingValue.x + bindingValue.y * bindingValue.y;
+                if (bindingValueLength > vector2fLength)
+                {
+                    vector2fLength = bindingValueLength;
+                    state.vector2fValue = bindingValue;
+                }
+            }
+        }
+
+        const MockActionState previous = front[i].Read();
+        state.isActive = slot.bindingCount > 0 ? XR_TRUE : XR_FALSE;
+        state.changedSinceLastSync =
+            state.booleanValue != previous.booleanValue ||
+            state.floatValue != previous.floatValue ||
+            state.vector2fValue.x != previous.vector2fValue.x ||
+            state.vector2fValue.y != previous.vector2fValue.y;
+        state.lastChangeTime = state.changedSinceLastSync ? time : previous.lastChangeTime;
+        back[i].Write(state);
     }
+}
 
-    default:
-        break;
+const MockRuntime::MockActionStateSlot* MockRuntime::GetActionStateSlot(const MockAction& mockAction, XrPath subactionPath, MockActionState* state) const
+{
+    // Nothing can be bound to a subaction path that isn't a user path
+    if (subactionPath != XR_NULL_PATH && (!IsValidUserPath(subactionPath) || subactionPath > userPaths.size()))
+    {
+        *state = {};
+        return nullptr;
     }
 
-    return nullptr;
+    size_t slot = mockAction.stateSlot + (size_t)subactionPath;
+    *state = actionStates[frontActionStates.load(std::memory_order_acquire)][slot].Read();
+    return &actionStateSlots[slot];
 }
 
 XrResult MockRuntime::SyncActions(const XrActionsSyncInfo* syncInfo)
@@ -1221,31 +1283,53 @@ XrResult MockRuntime::SyncActions(const XrActionsSyncInfo* syncInfo)
             return XR_ERROR_HANDLE_INVALID;
 
         // OpenXR 1.0: If any action sets not attached to this session are passed to xrSyncActions it must return XR_ERROR_ACTIONSET_NOT_ATTACHED
-        if (!mockActionSet->attached)
+        if (!actionSetsAttached || !mockActionSet->attached)
             return XR_ERROR_ACTIONSET_NOT_ATTACHED;
 
         // Update the all input sources for this action set from conformance automation if eneabled
         if (IsConformanceAutomationEnabled())
         {
-            for (auto& mockAction : mockActionSet->actions)
+            for (XrAction action : mockActionSet->actions)
             {
-                for (auto& binding : mockAction.bindings)
+                for (MockInputStateHandle bindingHandle : GetMockAction(action)->bindings)
                 {
+                    MockInputState* binding = &inputStates[bindingHandle];
+
                     // If a specific sub action path is given then ignore bindings that dont match that path
                     if (syncInfo->activeActionSets[i].subactionPath != XR_NULL_PATH && syncInfo->activeActionSets[i].subactionPath != GetUserPath(binding->path))
                         continue;
 
-                    ConformanceAutomation_GetInputState(binding);
+                    ConformanceAutomation_GetInputState(conformanceAutomation, binding);
                 }
             }
         }
     }
 
+    // Action sets that aren't synced keep their values but are inactive
+    uint32_t frontIndex = frontActionStates.load(std::memory_order_relaxed);
+    const std::vector<MockSeqLock<MockActionState>>& front = actionStates[frontIndex];
+    std::vector<MockSeqLock<MockActionState>>& back = actionStates[frontIndex ^ 1];
+    for (size_t i = 0; i < back.size(); i++)
+    {
+        MockActionState state = front[i].Read();
+        state.isActive = XR_FALSE;
+        state.changedSinceLastSync = XR_FALSE;
+        back[i].Write(state);
+    }
+
     // OpenXR 1.0: If session is not focused, the runtime must return XR_SESSION_NOT_FOCUSED, and all action states in the session must be inactive
-    if (currentState != XR_SESSION_STATE_FOCUSED)
-        return XR_SESSION_NOT_FOCUSED;
+    bool focused = currentState == XR_SESSION_STATE_FOCUSED;
+    if (focused)
+    {
+        XrTime time = GetPredictedTime();
+        for (size_t i = 0; i < syncInfo->countActiveActionSets; i++)
+            UpdateActionStates(*GetMockActionSet(syncInfo->activeActionSets[i].actionSet), syncInfo->activeActionSets[i].subactionPath, time);
+    }
 
-    return XR_SUCCESS;
+    // Publish the new snapshot
+    frontActionStates.store(frontIndex ^ 1, std::memory_order_release);
+
+    return focused ? XR_SUCCESS : XR_SESSION_NOT_FOCUSED;
 }
 
 bool MockRuntime::IsActionAttached(XrAction action)
@@ -1277,26 +1361,16 @@ XrResult MockRuntime::GetActionStateFloat(const XrActionStateGetInfo* getInfo, X
     if (!IsActionAttached(mockAction->action))
         return XR_ERROR_ACTIONSET_NOT_ATTACHED;
 
-    float value = 0.0f;
-
-    for (auto& binding : mockAction->bindings)
-    {
-        // If a subpath is given the binding subpath must match
-        if (getInfo->subactionPath != XR_NULL_PATH && GetUserPath(binding->path) != getInfo->subactionPath)
-            continue;
-
-        // Must match the action type
-        if (!binding->IsCompatibleType(XR_ACTION_TYPE_FLOAT_INPUT))
-            return XR_ERROR_ACTION_TYPE_MISMATCH;
-
-        // OpenXR 1.0: The current state must be the state of the input with the largest absolute value
-        float bindingValue = binding->GetFloat();
-        if (std::abs(bindingValue) > std::abs(value))
-            value = bindingValue;
-    }
+    // Must match the action type
+    MockActionState actionState;
+    const MockActionStateSlot* slot = GetActionStateSlot(*mockAction, getInfo->subactionPath, &actionState);
+    if (nullptr != slot && !slot->floatCompatible)
+        return XR_ERROR_ACTION_TYPE_MISMATCH;
 
-    state->currentState = value;
-    state->lastChangeTime = GetPredictedTime();
+    state->currentState = actionState.floatValue;
+    state->changedSinceLastSync = actionState.changedSinceLastSync;
+    state->lastChangeTime = actionState.lastChangeTime;
+    state->isActive = actionState.isActive;
     return XR_SUCCESS;
 }
 
@@ -1312,21 +1386,15 @@ XrResult MockRuntime::GetActionStateBoolean(const XrActionStateGetInfo* getInfo,
     if (!IsActionAttached(mockAction->action))
         return XR_ERROR_ACTIONSET_NOT_ATTACHED;
 
-    bool value = false;
-
-    for (auto& binding : mockAction->bindings)
-    {
-        if (getInfo->subactionPath == XR_NULL_PATH || GetUserPath(binding->path) == getInfo->subactionPath)
-        {
-            if (!binding->IsCompatibleType(XR_ACTION_TYPE_BOOLEAN_INPUT))
-                return XR_ERROR_ACTION_TYPE_MISMATCH;
-
-            value |= (bool)binding->GetBoolean();
-        }
-    }
+    MockActionState actionState;
+    const MockActionStateSlot* slot = GetActionStateSlot(*mockAction, getInfo->subactionPath, &actionState);
+    if (nullptr != slot && !slot->booleanCompatible)
+        return XR_ERROR_ACTION_TYPE_MISMATCH;
 
-    state->currentState = (XrBool32)value;
-    state->lastChangeTime = GetPredictedTime();
+    state->currentState = actionState.booleanValue;
+    state->changedSinceLastSync = actionState.changedSinceLastSync;
+    state->lastChangeTime = actionState.lastChangeTime;
+    state->isActive = actionState.isActive;
     return XR_SUCCESS;
 }
 
@@ -1342,28 +1410,15 @@ XrResult MockRuntime::GetActionStateVector2f(const XrActionStateGetInfo* getInfo
     if (!IsActionAttached(mockAction->action))
         return XR_ERROR_ACTIONSET_NOT_ATTACHED;
 
-    XrVector2f value = {};
-    float valueLength = 0.0f;
-
-    for (auto& binding : mockAction->bindings)
-    {
-        if (getInfo->subactionPath == XR_NULL_PATH || GetUserPath(binding->path) == getInfo->subactionPath)
-        {
-            if (!binding->IsCompatibleType(XR_ACTION_TYPE_VECTOR2F_INPUT))
-                return XR_ERROR_ACTION_TYPE_MISMATCH;
-
-            XrVector2f bindingValue = binding->GetVector2();
-            float bindingValueLength = bindingValue.x * bindingValue.x + bindingValue.y * bindingValue.y;
-            if (bindingValueLength > valueLength)
-            {
-                valueLength = bindingValueLength;
-                value = bindingValue;
-            }
-        }
-    }
+    MockActionState actionState;
+    const MockActionStateSlot* slot = GetActionStateSlot(*mockAction, getInfo->subactionPath, &actionState);
+    if (nullptr != slot && !slot->vector2fCompatible)
+        return XR_ERROR_ACTION_TYPE_MISMATCH;
 
-    state->currentState = value;
-    state->lastChangeTime = GetPredictedTime();
+    state->currentState = actionState.vector2fValue;
+    state->changedSinceLastSync = actionState.changedSinceLastSync;
+    state->lastChangeTime = actionState.lastChangeTime;
+    state->isActive = actionState.isActive;
     return XR_SUCCESS;
 }
 
@@ -1387,7 +1442,84 @@ XrResult MockRuntime::GetActionStatePose(const XrActionStateGetInfo* getInfo, Xr
     {
         MockUserPath* mockUserPath = GetMockUserPath(getInfo->subactionPath);
         if (nullptr != mockUserPath)
-            state->isActive = ConformanceAutomation_IsActive(XR_NULL_PATH, getInfo->subactionPath, state->isActive);
+            state->isActive = ConformanceAutomation_IsActive(conformanceAutomation, XR_NULL_PATH, getInfo->subactionPath, state->isActive);
+    }
+
+    return XR_SUCCESS;
+}
+
+XrResult MockRuntime::GetActionStates(uint32_t requestCount, const MockActionStateRequest* requests, MockActionStateResult* results)
+{
+    if (requestCount > 0 && (nullptr == requests || nullptr == results))
+        return XR_ERROR_VALIDATION_FAILURE;
+
+    for (uint32_t i = 0; i < requestCount; i++)
+    {
+        const MockActionStateRequest& request = requests[i];
+        MockActionStateResult& result = results[i];
+        result = {};
+
+        MockAction* mockAction = GetMockAction(request.action);
+        if (nullptr == mockAction)
+        {
+            result.result = XR_ERROR_HANDLE_INVALID;
+            continue;
+        }
+
+        result.type = mockAction->type;
+
+        if (!IsActionAttached(mockAction->action))
+        {
+            result.result = XR_ERROR_ACTIONSET_NOT_ATTACHED;
+            continue;
+        }
+
+        if (mockAction->type == XR_ACTION_TYPE_POSE_INPUT)
+        {
+            XrActionStateGetInfo getInfo = {XR_TYPE_ACTION_STATE_GET_INFO, nullptr, request.action, request.subactionPath};
+            XrActionStatePose state = {XR_TYPE_ACTION_STATE_POSE};
+            result.result = GetActionStatePose(&getInfo, &state);
+            result.isActive = state.isActive;
+            continue;
+        }
+
+        MockActionState actionState;
+        const MockActionStateSlot* slot = GetActionStateSlot(*mockAction, request.subactionPath, &actionState);
+
+        bool compatible;
+        switch (mockAction->type)
+        {
+        case XR_ACTION_TYPE_BOOLEAN_INPUT:
+            compatible = nullptr == slot || slot->booleanCompatible;
+            break;
+
+        case XR_ACTION_TYPE_FLOAT_INPUT:
+            compatible = nullptr == slot || slot->floatCompatible;
+            break;
+
+        case XR_ACTION_TYPE_VECTOR2F_INPUT:
+            compatible = nullptr == slot || slot->vector2fCompatible;
+            break;
+
+        default:
+            // Output actions have no state
+            compatible = false;
+            break;
+        }
+
+        if (!compatible)
+        {
+            result.result = XR_ERROR_ACTION_TYPE_MISMATCH;
+            continue;
+        }
+
+        result.result = XR_SUCCESS;
+        result.isActive = actionState.isActive;
+        result.changedSinceLastSync = actionState.changedSinceLastSync;
+        result.lastChangeTime = actionState.lastChangeTime;
+        result.booleanValue = actionState.booleanValue;
+        result.floatValue = actionState.floatValue;
+        result.vector2fValue = actionState.vector2fValue;
     }
 
     return XR_SUCCESS;
@@ -1422,20 +1554,21 @@ XrResult MockRuntime::CreateReferenceSpace(const XrReferenceSpaceCreateInfo* cre
     }
 
     // Add the sapce and create the handle
-    spaces.emplace_back();
-    MockSpace& mockSpace = spaces.back();
-    mockSpace.pose = createInfo->poseInReferenceSpace;
-    mockSpace.locationFlags =
+    XrSpace handle = (XrSpace)spaces.Add();
+    if (handle == XR_NULL_HANDLE)
+        return XR_ERROR_LIMIT_REACHED;
+
+    MockSpace& mockSpace = *GetMockSpace(handle);
+    mockSpace.location.Write({createInfo->poseInReferenceSpace,
         XR_SPACE_LOCATION_ORIENTATION_VALID_BIT |
-        XR_SPACE_LOCATION_POSITION_VALID_BIT |
-        XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT |
-        XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
-    mockSpace.isDestroyed = false;
+            XR_SPACE_LOCATION_POSITION_VALID_BIT |
+            XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT |
+            XR_SPACE_LOCATION_POSITION_TRACKED_BIT});
     mockSpace.action = XR_NULL_HANDLE;
     mockSpace.referenceSpaceType = createInfo->referenceSpaceType;
     mockSpace.subActionPath = XR_NULL_PATH;
 
-    *space = (XrSpace)spaces.size();
+    *space = handle;
 
     return XR_SUCCESS;
 }
@@ -1467,20 +1600,21 @@ XrResult MockRuntime::CreateActionSpace(const XrActionSpaceCreateInfo* createInf
     }
 
     // Add the space and create the handle
-    spaces.emplace_back();
-    MockSpace& mockSpace = spaces.back();
-    mockSpace.pose = createInfo->poseInActionSpace;
-    mockSpace.isDestroyed = false;
+    XrSpace handle = (XrSpace)spaces.Add();
+    if (handle == XR_NULL_HANDLE)
+        return XR_ERROR_LIMIT_REACHED;
+
+    MockSpace& mockSpace = *GetMockSpace(handle);
+    mockSpace.location.Write({createInfo->poseInActionSpace,
+        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT |
+            XR_SPACE_LOCATION_POSITION_VALID_BIT |
+            XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT |
+            XR_SPACE_LOCATION_POSITION_TRACKED_BIT});
     mockSpace.action = mockAction->action;
     mockSpace.subActionPath = createInfo->subactionPath;
     mockSpace.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_MAX_ENUM;
-    mockSpace.locationFlags =
-        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT |
-        XR_SPACE_LOCATION_POSITION_VALID_BIT |
-        XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT |
-        XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
 
-    *space = (XrSpace)spaces.size();
+    *space = handle;
 
     return XR_SUCCESS;
 }
@@ -1565,7 +1699,7 @@ XrResult MockRuntime::EnumerateBoundSourcesForAction(const XrBoundSourcesForActi
         return XR_ERROR_ACTIONSET_NOT_ATTACHED;
 
     *sourceCountOutput = 0;
-    for (auto& mockInputState : mockAction->bindings)
+    for (MockInputStateHandle mockInputState : mockAction->bindings)
     {
         if (sources != nullptr && *sourceCountOutput >= sourceCapacityInput)
             return XR_ERROR_SIZE_INSUFFICIENT;
@@ -1573,7 +1707,7 @@ XrResult MockRuntime::EnumerateBoundSourcesForAction(const XrBoundSourcesForActi
         (*sourceCountOutput)++;
 
         if (sources != nullptr)
-            *(sources++) = mockInputState->path;
+            *(sources++) = inputStates[mockInputState].path;
     }
 
     return XR_SUCCESS;
@@ -1621,10 +1755,47 @@ XrResult MockRuntime::StopHapticFeedback(const XrHapticActionInfo* hapticActionI
 
 MockRuntime::MockSpace* MockRuntime::GetMockSpace(XrSpace space)
 {
-    if (space == 0 || ((size_t)space) > spaces.size())
-        return nullptr;
+    return spaces.Get((uint64_t)space);
+}
+
+XrResult MockRuntime::DestroySpace(XrSpace space)
+{
+    if (!spaces.Remove((uint64_t)space))
+        return XR_ERROR_HANDLE_INVALID;
 
-    return &spaces[((size_t)space) - 1];
+    return XR_SUCCESS;
+}
+
+XrResult MockRuntime::CreateSwapchain(const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain)
+{
+    if (nullptr == createInfo || nullptr == swapchain)
+        return XR_ERROR_VALIDATION_FAILURE;
+
+    XrSwapchain handle = (XrSwapchain)swapchains.Add();
+    if (handle == XR_NULL_HANDLE)
+        return XR_ERROR_LIMIT_REACHED;
+
+    MockSwapchain& mockSwapchain = *swapchains.Get((uint64_t)handle);
+    mockSwapchain.width = createInfo->width;
+    mockSwapchain.height = createInfo->height;
+    mockSwapchain.arraySize = createInfo->arraySize;
+
+    *swapchain = handle;
+
+    return XR_SUCCESS;
+}
+
+XrResult MockRuntime::DestroySwapchain(XrSwapchain swapchain)
+{
+    if (!swapchains.Remove((uint64_t)swapchain))
+        return XR_ERROR_HANDLE_INVALID;
+
+    return XR_SUCCESS;
+}
+
+bool MockRuntime::IsValidSwapchain(XrSwapchain swapchain)
+{
+    return nullptr != swapchains.Get((uint64_t)swapchain);
 }
 
 XrResult MockRuntime::EnumerateViewConfigurations(XrSystemId systemId, uint32_t viewConfigurationTypeCapacityInput, uint32_t* viewConfigurationTypeCountOutput, XrViewConfigurationType* viewConfigurationTypes)
@@ -1748,18 +1919,18 @@ XrResult MockRuntime::GetInstanceProcAddr(const char* name, PFN_xrVoidFunction*
     if (IsConformanceAutomationEnabled() && XR_SUCCESS == ConformanceAutomation_GetInstanceProcAddr(name, function))
         return XR_SUCCESS;
 
-    if (MockMetaPerformanceMetrics::Instance() && XR_SUCCESS == MockMetaPerformanceMetrics_GetInstanceProcAddr(name, function))
+    if (metaPerformanceMetrics && XR_SUCCESS == MockMetaPerformanceMetrics_GetInstanceProcAddr(name, function))
         return XR_SUCCESS;
 
-    if (MockPerformanceSettings::Instance() && XR_SUCCESS == MockPerformanceSettings_GetInstanceProcAddr(name, function))
+    if (performanceSettings && XR_SUCCESS == MockPerformanceSettings_GetInstanceProcAddr(name, function))
         return XR_SUCCESS;
 
 #if defined(XR_USE_PLATFORM_ANDROID)
-    if (MockAndroidThreadSettings::Instance() && XR_SUCCESS == MockAndroidThreadSettings_GetInstanceProcAddr(name, function))
+    if (androidThreadSettings && XR_SUCCESS == MockAndroidThreadSettings_GetInstanceProcAddr(name, function))
         return XR_SUCCESS;
 #endif
 
-    if (MockAndroidEnumerateSystemExtensionProperties::Instance() && XR_SUCCESS == MockAndroidEnumerateSystemExtensionProperties_GetInstanceProcAddr(name, function))
+    if (androidEnumerateSystemExtensionProperties && XR_SUCCESS == MockAndroidEnumerateSystemExtensionProperties_GetInstanceProcAddr(name, function))
         return XR_SUCCESS;
 
     return XR_ERROR_FUNCTION_UNSUPPORTED;
@@ -1802,10 +1973,10 @@ XrResult MockRuntime::GetSystemProperties(XrSystemId systemId, XrSystemPropertie
 
 XrResult MockRuntime::CausePerformanceSettingsNotification(XrPerfSettingsDomainEXT domain, XrPerfSettingsSubDomainEXT subdomain, XrPerfSettingsNotificationLevelEXT nextLevel)
 {
-    if (MockPerformanceSettings::Instance())
+    if (performanceSettings)
     {
-        auto previousLevel = MockPerformanceSettings::Instance()->GetPerformanceSettingsNotificationLevel(domain, subdomain);
-        MockPerformanceSettings::Instance()->SetPerformanceSettingsNotificationLevel(domain, subdomain, nextLevel);
+        auto previousLevel = performanceSettings->GetPerformanceSettingsNotificationLevel(domain, subdomain);
+        performanceSettings->SetPerformanceSettingsNotificationLevel(domain, subdomain, nextLevel);
         QueueEvent(XrEventDataPerfSettingsEXT{
             XR_TYPE_EVENT_DATA_PERF_SETTINGS_EXT,
             nullptr,
@@ -26,6 +26,9 @@ static const MockRuntimeCreateFlags MR_CREATE_ANDROID_ENUMERATE_SYSTEM_EXTENSION
 
 static const MockRuntimeCreateFlags MR_CREATE_ALL_GFX_EXT = MR_CREATE_VULKAN_GFX_EXT | MR_CREATE_NULL_GFX_EXT | MR_CREATE_D3D11_GFX_EXT | MR_CREATE_D3D12_GFX_EXT;
 
+// Interaction profile definition, see mock_runtime_interaction_profiles.cpp
+struct MockInteractionProfileDef;
+
 class MockRuntime
 {
 public:
@@ -68,6 +71,35 @@ public:
         return (createFlags & MR_CREATE_CONFORMANCE_AUTOMATION_EXT) != 0;
     }
 
+    // Extension state, nullptr when the extension isn't enabled
+
+    ConformanceAutomation* GetConformanceAutomation() const
+    {
+        return conformanceAutomation;
+    }
+
+    MockMetaPerformanceMetrics* GetMetaPerformanceMetrics() const
+    {
+        return metaPerformanceMetrics.get();
+    }
+
+    MockPerformanceSettings* GetPerformanceSettings() const
+    {
+        return performanceSettings.get();
+    }
+
+#ifdef XR_USE_PLATFORM_ANDROID
+    MockAndroidThreadSettings* GetAndroidThreadSettings() const
+    {
+        return androidThreadSettings.get();
+    }
+#endif
+
+    MockAndroidEnumerateSystemExtensionProperties* GetAndroidEnumerateSystemExtensionProperties() const
+    {
+        return androidEnumerateSystemExtensionProperties.get();
+    }
+
     bool IsLocalFloorSpaceEnabled() const
     {
         return true;
@@ -110,6 +142,11 @@ public:
         return instanceIsLost;
     };
 
+    MockClock& GetClock()
+    {
+        return clock;
+    }
+
     void SetNullGfx(bool nullGfx);
     bool IsNullGfx() const
     {
@@ -153,16 +190,25 @@ public:
     XrResult GetActionStateBoolean(const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state);
     XrResult GetActionStateVector2f(const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state);
     XrResult GetActionStatePose(const XrActionStateGetInfo* getInfo, XrActionStatePose* state);
+    XrResult GetActionStates(uint32_t requestCount, const MockActionStateRequest* requests, MockActionStateResult* results);
+
+    // Action set an action was created in, or XR_NULL_HANDLE
+    XrActionSet GetActionSet(XrAction action);
 
     XrResult CreateReferenceSpace(const XrReferenceSpaceCreateInfo* createInfo, XrSpace* space);
     XrResult CreateActionSpace(const XrActionSpaceCreateInfo* createInfo, XrSpace* space);
+    XrResult DestroySpace(XrSpace space);
+
+    XrResult CreateSwapchain(const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain);
+    XrResult DestroySwapchain(XrSwapchain swapchain);
+    bool IsValidSwapchain(XrSwapchain swapchain);
 
     void VisibilityMaskChangedKHR(XrViewConfigurationType viewConfigurationType, uint32_t viewIndex);
 
     XrResult StringToPath(const char* pathString, XrPath* path);
     XrPath StringToPath(const char* pathString);
 
-    std::string PathToString(XrPath) const;
+    const char* PathToString(XrPath) const;
     XrResult PathToString(XrPath path, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) const;
 
     // Return the user path portion of the given path handle
@@ -213,6 +259,21 @@ public:
 
     XrResult RegisterScriptEventCallback(PFN_ScriptEventCallback callback);
 
+    // Called before and after every function called with a handle of this runtime, see MockRuntime_RegisterFunctionCallbacks
+    void SetFunctionCallbacks(PFN_BeforeFunctionCallback before, PFN_AfterFunctionCallback after)
+    {
+        beforeFunctionCallback.store(before, std::memory_order_release);
+        afterFunctionCallback.store(after, std::memory_order_release);
+    }
+    PFN_BeforeFunctionCallback GetBeforeFunctionCallback() const
+    {
+        return beforeFunctionCallback.load(std::memory_order_acquire);
+    }
+    PFN_AfterFunctionCallback GetAfterFunctionCallback() const
+    {
+        return afterFunctionCallback.load(std::memory_order_acquire);
+    }
+
     XrResult GetSystemProperties(XrSystemId systemId, XrSystemProperties* properties);
 
     XrResult CausePerformanceSettingsNotification(XrPerfSettingsDomainEXT domain, XrPerfSettingsSubDomainEXT subdomain, XrPerfSettingsNotificationLevelEXT nextLevel);
@@ -222,17 +283,31 @@ public:
     XrResult GetRecommendedLayerResolution(XrSession session, XrRecommendedLayerResolutionGetInfoMETA* recommendedLayerResolutionGetInfo, XrRecommendedLayerResolutionMETA* recommendedLayerResolution);
 
 private:
+    static const uint32_t kMaxViewsPerConfiguration = 4;
+
     struct MockView
     {
         XrViewConfigurationView configuration;
+    };
+
+    struct MockViewLocation
+    {
         XrPosef pose;
         XrFovf fov;
     };
 
-    struct MockViewConfiguration
+    // Everything xrLocateViews returns for a view configuration, published as one value so a reader never mixes views
+    // from different MockRuntime_SetView calls
+    struct MockViewLocations
     {
         XrViewStateFlags stateFlags;
+        MockViewLocation views[kMaxViewsPerConfiguration];
+    };
+
+    struct MockViewConfiguration
+    {
         std::vector<MockView> views;
+        MockSeqLock<MockViewLocations> locations;
         bool primary;
         bool enabled;
         bool active;
@@ -241,13 +316,16 @@ private:
     struct MockAction
     {
         XrAction action;
+        XrActionSet actionSet;
         XrPath path;
         std::string name;
         std::string localizedName;
         XrActionType type;
-        std::vector<MockInputState*> bindings;
+        std::vector<MockInputStateHandle> bindings;
         std::vector<XrPath> userPaths;
-        bool isDestroyed;
+
+        // First of the action's slots in actionStateSlots, set when its action set is attached
+        size_t stateSlot;
     };
 
     struct MockActionSet
@@ -256,8 +334,38 @@ private:
         bool attached;
         std::string name;
         std::string localizedName;
-        std::vector<MockAction> actions;
-        bool isDestroyed;
+
+        // Handles into actions, in creation order
+        std::vector<XrAction> actions;
+
+        // Slots of all actions in the set, which are contiguous in actionStateSlots
+        size_t firstStateSlot;
+        size_t stateSlotCount;
+    };
+
+    // Bindings of an action resolved for one subaction path.  Every attached action has one slot for XR_NULL_PATH
+    // followed by one slot per user path, so the slot of a subaction path is stateSlot + its user path index.
+    struct MockActionStateSlot
+    {
+        // Range in actionStateBindings
+        uint32_t firstBinding;
+        uint32_t bindingCount;
+
+        // False if any of the bindings can't be read as that type
+        bool booleanCompatible;
+        bool floatCompatible;
+        bool vector2fCompatible;
+    };
+
+    // Aggregated state of a slot as of the last xrSyncActions, see actionStates
+    struct MockActionState
+    {
+        XrBool32 booleanValue;
+        float floatValue;
+        XrVector2f vector2fValue;
+        XrBool32 isActive;
+        XrBool32 changedSinceLastSync;
+        XrTime lastChangeTime;
     };
 
     struct MockInteractionInputSource
@@ -272,6 +380,10 @@ private:
         XrPath path;
         const char* localizedName;
         std::vector<XrPath> userPaths;
+
+        // Range in inputStates
+        MockInputStateHandle firstInputState;
+        uint32_t inputStateCount;
     };
 
     struct MockUserPath
@@ -281,16 +393,56 @@ private:
         const MockInteractionProfile* profile;
     };
 
-    struct MockSpace
+    // Input states of an interaction profile by path.  Boolean and float actions may bind to the parent of a
+    // ".../value" or ".../click" input source, those are resolved once when the profiles are initialized.
+    struct MockInputSourceKey
+    {
+        XrPath interactionProfile;
+        XrPath path;
+
+        bool operator==(const MockInputSourceKey& other) const
+        {
+            return interactionProfile == other.interactionProfile && path == other.path;
+        }
+    };
+
+    struct MockInputSourceKeyHash
+    {
+        size_t operator()(const MockInputSourceKey& key) const
+        {
+            return std::hash<uint64_t>()(key.interactionProfile * 0x9E3779B97F4A7C15ull ^ key.path);
+        }
+    };
+
+    // Handles into inputStates
+    struct MockInputSource
+    {
+        MockInputStateHandle state;
+        MockInputStateHandle valueState;
+        MockInputStateHandle clickState;
+    };
+
+    struct MockSpaceLocation
     {
         XrPosef pose;
-        bool isDestroyed;
+        XrSpaceLocationFlags locationFlags;
+    };
+
+    struct MockSpace
+    {
+        MockSeqLock<MockSpaceLocation> location;
         XrAction action;
         XrPath subActionPath;
-        XrSpaceLocationFlags locationFlags;
         XrReferenceSpaceType referenceSpaceType;
     };
 
+    struct MockSwapchain
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t arraySize;
+    };
+
     struct MockReferenceSpace
     {
         bool validExtent;
@@ -318,10 +470,13 @@ private:
     MockAction* GetMockAction(XrAction action);
     const MockInteractionProfile* GetMockInteractionProfile(XrPath interactionProfile) const;
     bool IsActionAttached(XrAction action);
+    const MockActionStateSlot* GetActionStateSlot(const MockAction& mockAction, XrPath subactionPath, MockActionState* state) const;
+    void BuildActionStateSlots();
+    void UpdateActionStates(const MockActionSet& mockActionSet, XrPath subactionPath, XrTime time);
+    MockInputStateHandle GetMockInputStateHandle(const MockInteractionProfile& mockProfile, XrPath path, XrActionType actionType = XR_ACTION_TYPE_MAX_ENUM) const;
     MockInputState* GetMockInputState(const MockInteractionProfile& mockProfile, XrPath path, XrActionType actionType = XR_ACTION_TYPE_MAX_ENUM);
     MockSpace* GetMockSpace(XrSpace space);
     MockViewConfiguration* GetMockViewConfiguration(XrViewConfigurationType viewConfigType);
-    MockView* GetMockView(XrViewConfigurationType viewConfigType, size_t viewIndex);
     MockUserPath* GetMockUserPath(XrPath path);
     MockReferenceSpace* GetMockReferenceSpace(XrReferenceSpaceType referenceSpaceType);
 
@@ -331,9 +486,10 @@ private:
     XrTime GetPredictedTime();
 
     void InitializeInteractionProfiles();
+    const MockInteractionProfile* AddInteractionProfile(const MockInteractionProfileDef& def);
+    void IndexInputSources(const MockInteractionProfile& mockProfile);
 
     bool SetActiveInteractionProfile(MockUserPath* mockUserPath, const MockInteractionProfile* mockProfile);
-    MockInputState* AddMockInputState(XrPath interactionPath, XrPath path, XrActionType actionType, const char* localizedName);
 
     //// XR_MSFT_secondary_view_configuration
 
@@ -344,12 +500,10 @@ private:
     template <typename T>
     void QueueEvent(const T& event)
     {
-        QueueEvent((const XrEventDataBuffer&)event);
+        QueueEvent(&event, (uint32_t)sizeof(T));
     }
 
-    void QueueEvent(const XrEventDataBuffer& buffer);
-
-    XrEventDataBuffer GetNextEvent();
+    void QueueEvent(const void* event, uint32_t size);
 
     std::vector<XrSecondaryViewConfigurationStateMSFT> secondaryViewConfigurationStates;
 
@@ -361,10 +515,11 @@ private:
 
     XrResult MSFTThirdPersonObserver_Init();
 
-    std::vector<MockInteractionProfile> interactionProfiles;
+    // A deque so MockUserPath::profile stays valid when profiles are added
+    std::deque<MockInteractionProfile> interactionProfiles;
 
     MockRuntimeCreateFlags createFlags;
-    std::queue<XrEventDataBuffer> eventQueue;
+    MockEventRing eventQueue;
     XrInstance instance;
     XrSession session;
     XrSessionState currentState;
@@ -378,10 +533,10 @@ private:
     std::map<XrViewConfigurationType, MockViewConfiguration> viewConfigurations;
     XrViewConfigurationType primaryViewConfiguration;
 
-    std::vector<std::string> componentPathStrings;
+    MockPathTable paths;
     std::vector<MockUserPath> userPaths;
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
+    MockClock clock;
 
     bool instanceIsLost;
     bool nullGfx;
@@ -393,12 +548,35 @@ private:
 
     bool recommendedResolutionChanged;
 
-    std::vector<MockActionSet> actionSets;
-    std::vector<MockInputState> inputStates;
-    std::vector<MockSpace> spaces;
+    // Actions and action sets are children of the instance, spaces and swapchains of the session.
+    MockSlotMap<MockActionSet> actionSets;
+    MockSlotMap<MockAction> actions;
+    MockInputStatePool inputStates;
+    std::unordered_map<MockInputSourceKey, MockInputSource, MockInputSourceKeyHash> inputSources;
+
+    // Action states are aggregated by xrSyncActions into the back snapshot, which then becomes the front snapshot
+    // read by xrGetActionState*.  Readers on other threads load frontActionStates once and read each state through its
+    // sequence lock, so a reader that is still on the old front while the next xrSyncActions rewrites it gets a
+    // whole state from one sync or the other.
+    std::vector<MockActionStateSlot> actionStateSlots;
+    // Pointers are safe to keep, states in inputStates never move
+    std::vector<MockInputState*> actionStateBindings;
+    std::vector<MockSeqLock<MockActionState>> actionStates[2];
+    std::atomic<uint32_t> frontActionStates;
+    MockSlotMap<MockSpace> spaces;
+    MockSlotMap<MockSwapchain> swapchains;
     std::map<XrReferenceSpaceType, MockReferenceSpace> referenceSpaces;
 
     PFN_ScriptEventCallback scriptEventCallback;
+    // Set from the test thread while any thread may be calling in
+    std::atomic<PFN_BeforeFunctionCallback> beforeFunctionCallback;
+    std::atomic<PFN_AfterFunctionCallback> afterFunctionCallback;
+
+    ConformanceAutomation* conformanceAutomation;
+    std::unique_ptr<MockMetaPerformanceMetrics> metaPerformanceMetrics;
+    std::unique_ptr<MockPerformanceSettings> performanceSettings;
+#ifdef XR_USE_PLATFORM_ANDROID
+    std::unique_ptr<MockAndroidThreadSettings> androidThreadSettings;
+#endif
+    std::unique_ptr<MockAndroidEnumerateSystemExtensionProperties> androidEnumerateSystemExtensionProperties;
 };
-
-extern MockRuntime* s_runtime;
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <openxr/openxr.h>
+
+// Types of the mock only exports that don't depend on the runtime's internals, so tools that load mock_runtime can
+// include them instead of redeclaring them.
+
+// Called before and after every hooked function, see MockRuntime_RegisterFunctionCallbacks
+typedef XrResult(XRAPI_PTR* PFN_BeforeFunctionCallback)(const char* name);
+typedef void(XRAPI_PTR* PFN_AfterFunctionCallback)(const char* name, XrResult result);
+
+// One action state asked for through MockRuntime_GetActionStates
+struct MockActionStateRequest
+{
+    XrAction action;
+    XrPath subactionPath;
+};
+
+// State of a MockActionStateRequest.  result is what the matching xrGetActionState* call would have returned, and
+// type is the type of the action, which selects the value that is set.  Pose actions only set isActive.
+struct MockActionStateResult
+{
+    XrResult result;
+    XrActionType type;
+    XrBool32 isActive;
+    XrBool32 changedSinceLastSync;
+    XrTime lastChangeTime;
+    XrBool32 booleanValue;
+    float floatValue;
+    XrVector2f vector2fValue;
+};
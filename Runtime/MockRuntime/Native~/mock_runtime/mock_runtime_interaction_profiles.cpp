@@ -535,28 +535,90 @@ static std::vector<MockInteractionProfileDef> s_InteractionProfiles = {
 
 void MockRuntime::InitializeInteractionProfiles()
 {
-    inputStates.clear();
-    interactionProfiles.reserve(s_InteractionProfiles.size());
+    interactionProfiles.clear();
+    inputStates.Clear();
+    inputSources.clear();
     for (MockInteractionProfileDef& def : s_InteractionProfiles)
     {
         // Require specific create flags to use this profile?
         if ((def.requiredFlags & createFlags) != def.requiredFlags)
             continue;
 
-        interactionProfiles.emplace_back();
-        MockInteractionProfile& mockProfile = interactionProfiles.back();
-        mockProfile.path = StringToPath(def.name);
-        mockProfile.userPaths.reserve(def.userPaths.size());
-        mockProfile.localizedName = def.localizedName;
-        for (const char* userPathString : def.userPaths)
-        {
-            mockProfile.userPaths.push_back(StringToPath(userPathString));
-        }
+        AddInteractionProfile(def);
+    }
+}
 
-        for (MockInputSourcePath& componentDef : def.inputSources)
-        {
-            AddMockInputState(mockProfile.path, StringToPath(componentDef.path), componentDef.type, componentDef.localizedName);
-        }
+// Input states and bindings to them stay valid when a profile is added, so profiles can be added at any time.
+const MockRuntime::MockInteractionProfile* MockRuntime::AddInteractionProfile(const MockInteractionProfileDef& def)
+{
+    uint32_t inputStateCount = (uint32_t)def.inputSources.size();
+    MockInputStateHandle firstInputState = inputStates.Allocate(inputStateCount);
+    if (firstInputState == kInvalidInputStateHandle && inputStateCount != 0)
+    {
+        MOCK_TRACE_ERROR("[AddInteractionProfile] %s has more than %u input sources", def.name, MockInputStatePool::kChunkSize);
+        return nullptr;
+    }
+
+    interactionProfiles.emplace_back();
+    MockInteractionProfile& mockProfile = interactionProfiles.back();
+    mockProfile.path = StringToPath(def.name);
+    mockProfile.userPaths.reserve(def.userPaths.size());
+    mockProfile.localizedName = def.localizedName;
+    mockProfile.firstInputState = firstInputState;
+    mockProfile.inputStateCount = inputStateCount;
+    for (const char* userPathString : def.userPaths)
+    {
+        mockProfile.userPaths.push_back(StringToPath(userPathString));
+    }
+
+    for (uint32_t i = 0; i < inputStateCount; ++i)
+    {
+        const MockInputSourcePath& componentDef = def.inputSources[i];
+        MockInputState& mockInputState = inputStates[firstInputState + i];
+        mockInputState.interactionProfile = mockProfile.path;
+        mockInputState.path = StringToPath(componentDef.path);
+        mockInputState.type = componentDef.type;
+        mockInputState.localizedName = componentDef.localizedName;
+        mockInputState.Reset();
+    }
+
+    IndexInputSources(mockProfile);
+    return &mockProfile;
+}
+
+void MockRuntime::IndexInputSources(const MockInteractionProfile& mockProfile)
+{
+    inputSources.reserve(inputSources.size() + mockProfile.inputStateCount * 2);
+
+    const MockInputSource none = {kInvalidInputStateHandle, kInvalidInputStateHandle, kInvalidInputStateHandle};
+    for (uint32_t i = 0; i < mockProfile.inputStateCount; ++i)
+    {
+        MockInputStateHandle handle = mockProfile.firstInputState + i;
+        const MockInputState& inputState = inputStates[handle];
+        auto it = inputSources.emplace(MockInputSourceKey{inputState.interactionProfile, inputState.path}, none).first;
+        if (it->second.state == kInvalidInputStateHandle)
+            it->second.state = handle;
+
+        // Let the parent of ".../value" and ".../click" resolve to this input state.  The parent is interned here so
+        // later lookups don't have to.
+        const char* pathString = PathToString(inputState.path);
+        size_t length = strlen(pathString);
+        bool isValue = length > 6 && strcmp(pathString + length - 6, "/value") == 0;
+        bool isClick = length > 6 && strcmp(pathString + length - 6, "/click") == 0;
+        if (!isValue && !isClick)
+            continue;
+
+        char parentString[XR_MAX_PATH_LENGTH];
+        memcpy(parentString, pathString, length - 6);
+        parentString[length - 6] = '\0';
+        XrPath parent = StringToPath(parentString);
+        if (parent == XR_NULL_PATH)
+            continue;
+
+        it = inputSources.emplace(MockInputSourceKey{inputState.interactionProfile, parent}, none).first;
+        MockInputStateHandle& parentState = isValue ? it->second.valueState : it->second.clickState;
+        if (parentState == kInvalidInputStateHandle)
+            parentState = handle;
     }
 }
 
@@ -0,0 +1,88 @@
+#include "mock.h"
+
+std::atomic<bool> MockRuntimeRegistry::s_Reserved[kMaxRuntimes];
+std::atomic<MockRuntime*> MockRuntimeRegistry::s_Runtimes[kMaxRuntimes];
+std::atomic<uint32_t> MockRuntimeRegistry::s_LastRuntimeId(kInvalidRuntimeId);
+
+// Runtime created last on this thread, kept with its id so a runtime destroyed since is noticed without touching it.
+static thread_local uint32_t t_CurrentRuntimeId = MockRuntimeRegistry::kInvalidRuntimeId;
+static thread_local MockRuntime* t_CurrentRuntime = nullptr;
+
+uint32_t MockRuntimeRegistry::Reserve()
+{
+    for (uint32_t runtimeId = 0; runtimeId < kMaxRuntimes; ++runtimeId)
+    {
+        bool reserved = false;
+        if (s_Reserved[runtimeId].compare_exchange_strong(reserved, true, std::memory_order_acq_rel))
+            return runtimeId;
+    }
+
+    return kInvalidRuntimeId;
+}
+
+void MockRuntimeRegistry::Register(uint32_t runtimeId, MockRuntime* runtime)
+{
+    s_Runtimes[runtimeId].store(runtime, std::memory_order_release);
+    s_LastRuntimeId.store(runtimeId, std::memory_order_release);
+
+    t_CurrentRuntimeId = runtimeId;
+    t_CurrentRuntime = runtime;
+}
+
+void MockRuntimeRegistry::Unregister(uint32_t runtimeId)
+{
+    s_Runtimes[runtimeId].store(nullptr, std::memory_order_release);
+
+    // Hand the fallback of GetCurrent to a runtime that's still alive.  Done before the slot is freed, so a runtime
+    // registered in the same slot right after can't have its id replaced.
+    uint32_t nextRuntimeId = kInvalidRuntimeId;
+    for (uint32_t otherRuntimeId = 0; otherRuntimeId < kMaxRuntimes; ++otherRuntimeId)
+    {
+        if (s_Runtimes[otherRuntimeId].load(std::memory_order_acquire) != nullptr)
+        {
+            nextRuntimeId = otherRuntimeId;
+            break;
+        }
+    }
+
+    uint32_t lastRuntimeId = runtimeId;
+    s_LastRuntimeId.compare_exchange_strong(lastRuntimeId, nextRuntimeId, std::memory_order_acq_rel);
+
+    s_Reserved[runtimeId].store(false, std::memory_order_release);
+}
+
+uint32_t MockRuntimeRegistry::DestroyAll()
+{
+    uint32_t destroyed = 0;
+    for (uint32_t runtimeId = 0; runtimeId < kMaxRuntimes; ++runtimeId)
+    {
+        // Taken out of the slot first, so a runtime is only deleted once
+        MockRuntime* runtime = s_Runtimes[runtimeId].exchange(nullptr, std::memory_order_acq_rel);
+        if (runtime == nullptr)
+            continue;
+
+        Unregister(runtimeId);
+        delete runtime;
+        ++destroyed;
+    }
+
+    return destroyed;
+}
+
+MockRuntime* MockRuntimeRegistry::Find(uint64_t handle)
+{
+    // Always in range, the id is the top 8 bits of the handle.
+    return s_Runtimes[GetRuntimeId(handle)].load(std::memory_order_acquire);
+}
+
+MockRuntime* MockRuntimeRegistry::GetCurrent()
+{
+    if (t_CurrentRuntimeId != kInvalidRuntimeId && s_Runtimes[t_CurrentRuntimeId].load(std::memory_order_acquire) == t_CurrentRuntime)
+        return t_CurrentRuntime;
+
+    uint32_t runtimeId = s_LastRuntimeId.load(std::memory_order_acquire);
+    if (runtimeId == kInvalidRuntimeId)
+        return nullptr;
+
+    return s_Runtimes[runtimeId].load(std::memory_order_acquire);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+
+class MockRuntime;
+
+// Every live MockRuntime in the process, so separate instances can run side by side (ex. test shards on separate
+// threads).  A runtime is registered in a slot, and the slot index is stored in the high 8 bits of every handle the
+// runtime creates (instance, session, action set, action, space and swapchain), so the runtime that owns a handle is
+// found with one table lookup and without taking a lock.  The runtime in slot 0 creates the same handles as a runtime
+// that is alone in the process.
+class MockRuntimeRegistry
+{
+public:
+    static const uint32_t kMaxRuntimes = 256;
+    static const uint32_t kRuntimeIdShift = 56;
+    static const uint32_t kInvalidRuntimeId = 0xFFFFFFFF;
+
+    // Reserves the lowest free slot for a runtime that is about to be created, or returns kInvalidRuntimeId.
+    static uint32_t Reserve();
+
+    // Makes the runtime in a reserved slot visible to Find and the current runtime of the calling thread.
+    static void Register(uint32_t runtimeId, MockRuntime* runtime);
+
+    // Frees the slot of a runtime that is about to be destroyed.  If it was the last runtime registered, GetCurrent falls
+    // back to another registered runtime.
+    static void Unregister(uint32_t runtimeId);
+
+    // Unregisters and deletes every runtime, returns how many there were.  For test teardown, to reclaim the runtimes of
+    // instances that were never destroyed.  No thread may still be calling into them.
+    static uint32_t DestroyAll();
+
+    // Runtime that created a handle, or nullptr.  Does not check that the handle is still valid in that runtime.
+    static MockRuntime* Find(uint64_t handle);
+
+    // Runtime used by the MockRuntime_* functions, which don't take a handle: the last runtime created on the calling
+    // thread if it still exists, otherwise the last runtime created on any thread.
+    static MockRuntime* GetCurrent();
+
+    static uint32_t GetRuntimeId(uint64_t handle)
+    {
+        return (uint32_t)(handle >> kRuntimeIdShift);
+    }
+
+    static uint64_t MakeHandle(uint32_t runtimeId, uint64_t value)
+    {
+        return ((uint64_t)runtimeId << kRuntimeIdShift) | value;
+    }
+
+private:
+    static std::atomic<bool> s_Reserved[kMaxRuntimes];
+    static std::atomic<MockRuntime*> s_Runtimes[kMaxRuntimes];
+    static std::atomic<uint32_t> s_LastRuntimeId;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <string.h>
+#include <type_traits>
+
+// Value that is written by test code (ex. the MockRuntime_* functions) while the engine reads it from other threads
+// (ex. xrLocateSpace, xrLocateViews and xrGetActionState*), published with a sequence lock.  A writer makes the
+// sequence odd, stores the value and makes the sequence even again.  A reader copies the value and retries if the
+// sequence was odd or changed meanwhile, so readers never take a lock, never block a writer and never see a value that
+// is half written.  Writers are serialized with each other by the odd sequence.  The value is kept in atomic 64 bit
+// words so readers racing a writer are well defined, which limits T to small trivially copyable types.
+template <typename T>
+class MockSeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "MockSeqLock values are copied word by word");
+
+public:
+    MockSeqLock()
+        : sequence(0)
+    {
+        Store(T());
+    }
+
+    MockSeqLock(const MockSeqLock& other)
+        : sequence(0)
+    {
+        Store(other.Read());
+    }
+
+    MockSeqLock& operator=(const MockSeqLock& other)
+    {
+        Write(other.Read());
+        return *this;
+    }
+
+    T Read() const
+    {
+        T value;
+        while (true)
+        {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            Load(value);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return value;
+        }
+    }
+
+    void Write(const T& value)
+    {
+        Update([&value](T& current) { current = value; });
+    }
+
+    // Changes part of the value, ex. one view of a view configuration, without losing a concurrent write to another part.
+    template <typename F>
+    void Update(F update)
+    {
+        uint32_t before = sequence.load(std::memory_order_relaxed);
+        while ((before & 1) != 0 || !sequence.compare_exchange_weak(before, before + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            before = sequence.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_release);
+
+        T value;
+        Load(value);
+        update(value);
+        Store(value);
+
+        sequence.store(before + 2, std::memory_order_release);
+    }
+
+private:
+    static const size_t kWordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    void Load(T& value) const
+    {
+        uint64_t buffer[kWordCount];
+        for (size_t i = 0; i < kWordCount; ++i)
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        memcpy(&value, buffer, sizeof(T));
+    }
+
+    void Store(const T& value)
+    {
+        uint64_t buffer[kWordCount] = {};
+        memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < kWordCount; ++i)
+            words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint64_t> words[kWordCount];
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+// Values addressed by 64 bit handles, used for the XrActionSet, XrAction, XrSpace and XrSwapchain handles of the
+// mock runtime.  The low 32 bits of a handle are the slot index + 1, the next 24 bits are the generation of the slot,
+// which changes every time the slot is freed, and the high 8 bits are the runtime id of the map.  A stale handle, or
+// one from another runtime, is rejected in O(1) instead of reaching whatever reused its slot.  Freed slots are reused
+// before the map grows, and values never move.
+template <typename T>
+class MockSlotMap
+{
+    struct Slot
+    {
+        T value;
+        uint32_t generation;
+        bool used;
+    };
+
+public:
+    class Iterator
+    {
+    public:
+        Iterator(std::deque<Slot>& slots, size_t index)
+            : slots(slots)
+            , index(index)
+        {
+            SkipUnused();
+        }
+
+        T& operator*() const
+        {
+            return slots[index].value;
+        }
+
+        T* operator->() const
+        {
+            return &slots[index].value;
+        }
+
+        Iterator& operator++()
+        {
+            ++index;
+            SkipUnused();
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return index != other.index;
+        }
+
+    private:
+        void SkipUnused()
+        {
+            while (index < slots.size() && !slots[index].used)
+                ++index;
+        }
+
+        std::deque<Slot>& slots;
+        size_t index;
+    };
+
+    explicit MockSlotMap(uint32_t runtimeId = 0)
+        : runtimeId(runtimeId)
+        , count(0)
+    {
+    }
+
+    // Adds a value initialized T and returns its handle, or 0 if every slot index is taken.
+    uint64_t Add()
+    {
+        uint32_t index;
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            if (slots.size() >= 0xFFFFFFFE)
+                return 0;
+
+            index = (uint32_t)slots.size();
+            slots.emplace_back();
+            slots.back().generation = 1;
+        }
+
+        Slot& slot = slots[index];
+        slot.value = T();
+        slot.used = true;
+        ++count;
+        return MakeHandle(index, slot.generation);
+    }
+
+    // nullptr for 0, stale and unknown handles
+    T* Get(uint64_t handle)
+    {
+        uint32_t index = (uint32_t)(handle & 0xFFFFFFFF) - 1;
+        if (index >= slots.size())
+            return nullptr;
+
+        Slot& slot = slots[index];
+        if (!slot.used || MakeHandle(index, slot.generation) != handle)
+            return nullptr;
+
+        return &slot.value;
+    }
+
+    // Returns false for 0, stale and unknown handles.
+    bool Remove(uint64_t handle)
+    {
+        if (nullptr == Get(handle))
+            return false;
+
+        Free((uint32_t)(handle & 0xFFFFFFFF) - 1);
+        return true;
+    }
+
+    // Removes every value.  Slots are kept for reuse, and handles from before stay stale.
+    void Clear()
+    {
+        for (uint32_t index = 0; index < (uint32_t)slots.size(); ++index)
+            if (slots[index].used)
+                Free(index);
+    }
+
+    size_t Size() const
+    {
+        return count;
+    }
+
+    Iterator begin()
+    {
+        return Iterator(slots, 0);
+    }
+
+    Iterator end()
+    {
+        return Iterator(slots, slots.size());
+    }
+
+private:
+    void Free(uint32_t index)
+    {
+        Slot& slot = slots[index];
+        slot.value = T(); // releases whatever the value owns
+        slot.used = false;
+
+        // Generation 0 is skipped so a handle is never just the slot index.
+        if (++slot.generation > kMaxGeneration)
+            slot.generation = 1;
+
+        freeSlots.push_back(index);
+        --count;
+    }
+
+    static const uint32_t kMaxGeneration = 0xFFFFFF;
+
+    uint64_t MakeHandle(uint32_t index, uint32_t generation) const
+    {
+        return MockRuntimeRegistry::MakeHandle(runtimeId, ((uint64_t)generation << 32) | (index + 1));
+    }
+
+    uint32_t runtimeId;
+    std::deque<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t count;
+};
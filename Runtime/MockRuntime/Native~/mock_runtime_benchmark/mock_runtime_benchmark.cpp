@@ -0,0 +1,362 @@
+// Compares reading action states with one xrGetActionState* call per state against one MockRuntime_GetActionStates
+// call for all of them.
+//
+// The mock runtime is driven with the input of a pair of touch controllers, 13 actions with a state per hand, synced
+// once per frame.  Each query mode is run without and with before / after function callbacks registered, the way the
+// c# tests register them, and reports ns per frame and ns per state.
+//
+// Usage: mock_runtime_benchmark [frames]
+// mock_runtime must be loadable from the working directory or library path.
+
+#define XR_NO_PROTOTYPES
+#include <openxr/openxr.h>
+
+#include "../mock_runtime/mock_runtime_api.h"
+#include "plugin_load.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const uint32_t kDefaultFrames = 100000;
+
+// Mock only functions, from xrGetInstanceProcAddr.
+typedef XrResult (*PFN_MockRuntime_GetActionStates)(XrSession session, uint32_t requestCount, const MockActionStateRequest* requests, MockActionStateResult* results);
+typedef bool (*PFN_MockRuntime_TransitionToState)(XrSessionState requestedState, bool forceTransition);
+typedef void (*PFN_MockRuntime_RegisterFunctionCallbacks)(PFN_BeforeFunctionCallback before, PFN_AfterFunctionCallback after);
+
+#define TOOL_FUNCS(_)                      \
+    _(xrDestroyInstance)                   \
+    _(xrGetSystem)                         \
+    _(xrPollEvent)                         \
+    _(xrCreateSession)                     \
+    _(xrDestroySession)                    \
+    _(xrBeginSession)                      \
+    _(xrStringToPath)                      \
+    _(xrCreateActionSet)                   \
+    _(xrCreateAction)                      \
+    _(xrSuggestInteractionProfileBindings) \
+    _(xrAttachSessionActionSets)           \
+    _(xrSyncActions)                       \
+    _(xrGetActionStateBoolean)             \
+    _(xrGetActionStateFloat)               \
+    _(xrGetActionStateVector2f)            \
+    _(xrGetActionStatePose)                \
+    _(MockRuntime_GetActionStates)         \
+    _(MockRuntime_TransitionToState)       \
+    _(MockRuntime_RegisterFunctionCallbacks)
+
+#include "openxr_tool.h"
+
+struct ActionDesc
+{
+    const char* name;
+    XrActionType type;
+    const char* bindings[2];
+};
+
+static const ActionDesc kActions[] = {
+    {"primary", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/x/click", "/user/hand/right/input/a/click"}},
+    {"primary_touch", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/x/touch", "/user/hand/right/input/a/touch"}},
+    {"secondary", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/y/click", "/user/hand/right/input/b/click"}},
+    {"secondary_touch", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/y/touch", "/user/hand/right/input/b/touch"}},
+    {"trigger_touch", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/trigger/touch", "/user/hand/right/input/trigger/touch"}},
+    {"thumbstick_click", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/thumbstick/click", "/user/hand/right/input/thumbstick/click"}},
+    {"thumbstick_touch", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/thumbstick/touch", "/user/hand/right/input/thumbstick/touch"}},
+    {"thumbrest_touch", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/thumbrest/touch", "/user/hand/right/input/thumbrest/touch"}},
+    {"trigger", XR_ACTION_TYPE_FLOAT_INPUT, {"/user/hand/left/input/trigger/value", "/user/hand/right/input/trigger/value"}},
+    {"grip", XR_ACTION_TYPE_FLOAT_INPUT, {"/user/hand/left/input/squeeze/value", "/user/hand/right/input/squeeze/value"}},
+    {"thumbstick", XR_ACTION_TYPE_VECTOR2F_INPUT, {"/user/hand/left/input/thumbstick", "/user/hand/right/input/thumbstick"}},
+    {"device_pose", XR_ACTION_TYPE_POSE_INPUT, {"/user/hand/left/input/grip/pose", "/user/hand/right/input/grip/pose"}},
+    {"pointer_pose", XR_ACTION_TYPE_POSE_INPUT, {"/user/hand/left/input/aim/pose", "/user/hand/right/input/aim/pose"}},
+};
+
+static const uint32_t kActionCount = sizeof(kActions) / sizeof(kActions[0]);
+static const uint32_t kHandCount = 2;
+static const uint32_t kStateCount = kActionCount * kHandCount;
+
+struct XrState
+{
+    XrFunctions xr;
+    XrInstance instance;
+    XrSystemId systemId;
+    XrSession session;
+    XrActionSet actionSet;
+    XrAction actions[kActionCount];
+    XrPath hands[kHandCount];
+    MockActionStateRequest requests[kStateCount];
+};
+
+static bool CreateActions(XrState& state)
+{
+    XrActionSetCreateInfo actionSetInfo = {XR_TYPE_ACTION_SET_CREATE_INFO};
+    strcpy(actionSetInfo.actionSetName, "benchmark");
+    strcpy(actionSetInfo.localizedActionSetName, "Benchmark");
+    CHECK_XR(state.xr.xrCreateActionSet(state.instance, &actionSetInfo, &state.actionSet));
+
+    CHECK_XR(state.xr.xrStringToPath(state.instance, "/user/hand/left", &state.hands[0]));
+    CHECK_XR(state.xr.xrStringToPath(state.instance, "/user/hand/right", &state.hands[1]));
+
+    XrActionSuggestedBinding bindings[kStateCount];
+    for (uint32_t i = 0; i < kActionCount; ++i)
+    {
+        XrActionCreateInfo actionInfo = {XR_TYPE_ACTION_CREATE_INFO};
+        strcpy(actionInfo.actionName, kActions[i].name);
+        strcpy(actionInfo.localizedActionName, kActions[i].name);
+        actionInfo.actionType = kActions[i].type;
+        actionInfo.countSubactionPaths = kHandCount;
+        actionInfo.subactionPaths = state.hands;
+        CHECK_XR(state.xr.xrCreateAction(state.actionSet, &actionInfo, &state.actions[i]));
+
+        for (uint32_t hand = 0; hand < kHandCount; ++hand)
+        {
+            XrActionSuggestedBinding& binding = bindings[i * kHandCount + hand];
+            binding.action = state.actions[i];
+            CHECK_XR(state.xr.xrStringToPath(state.instance, kActions[i].bindings[hand], &binding.binding));
+
+            state.requests[i * kHandCount + hand] = {state.actions[i], state.hands[hand]};
+        }
+    }
+
+    XrInteractionProfileSuggestedBinding suggested = {XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
+    CHECK_XR(state.xr.xrStringToPath(state.instance, "/interaction_profiles/oculus/touch_controller", &suggested.interactionProfile));
+    suggested.countSuggestedBindings = kStateCount;
+    suggested.suggestedBindings = bindings;
+    CHECK_XR(state.xr.xrSuggestInteractionProfileBindings(state.instance, &suggested));
+
+    XrSessionActionSetsAttachInfo attachInfo = {XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+    attachInfo.countActionSets = 1;
+    attachInfo.actionSets = &state.actionSet;
+    CHECK_XR(state.xr.xrAttachSessionActionSets(state.session, &attachInfo));
+    return true;
+}
+
+static bool CreateXrState(XrState& state, PFN_xrGetInstanceProcAddr getInstanceProcAddr)
+{
+    state = {};
+    if (!CreateMockSession(state.xr, getInstanceProcAddr, "mock_runtime_benchmark", state.instance, state.systemId, state.session))
+        return false;
+
+    // xrSyncActions only updates action states while the session is focused.
+    if (!state.xr.MockRuntime_TransitionToState(XR_SESSION_STATE_FOCUSED, true))
+    {
+        printf("MockRuntime_TransitionToState failed\n");
+        return false;
+    }
+    if (!PollEvents(state.xr, state.instance))
+        return false;
+
+    return CreateActions(state);
+}
+
+static void DestroyXrState(XrState& state)
+{
+    if (state.session != XR_NULL_HANDLE)
+        state.xr.xrDestroySession(state.session);
+    if (state.instance != XR_NULL_HANDLE)
+        state.xr.xrDestroyInstance(state.instance);
+    state = {};
+}
+
+static bool SyncActions(const XrState& state)
+{
+    XrActiveActionSet activeSet = {state.actionSet, XR_NULL_PATH};
+    XrActionsSyncInfo syncInfo = {XR_TYPE_ACTIONS_SYNC_INFO};
+    syncInfo.countActiveActionSets = 1;
+    syncInfo.activeActionSets = &activeSet;
+    CHECK_XR(state.xr.xrSyncActions(state.session, &syncInfo));
+    return true;
+}
+
+// One xrGetActionState* call per request, results in the layout of MockRuntime_GetActionStates.
+static void QueryPerCall(const XrState& state, MockActionStateResult* results)
+{
+    XrActionStateGetInfo getInfo = {XR_TYPE_ACTION_STATE_GET_INFO};
+    for (uint32_t i = 0; i < kStateCount; ++i)
+    {
+        const MockActionStateRequest& request = state.requests[i];
+        MockActionStateResult& result = results[i];
+        getInfo.action = request.action;
+        getInfo.subactionPath = request.subactionPath;
+        result.type = kActions[i / kHandCount].type;
+
+        switch (result.type)
+        {
+        case XR_ACTION_TYPE_BOOLEAN_INPUT:
+        {
+            XrActionStateBoolean booleanState = {XR_TYPE_ACTION_STATE_BOOLEAN};
+            result.result = state.xr.xrGetActionStateBoolean(state.session, &getInfo, &booleanState);
+            result.isActive = booleanState.isActive;
+            result.changedSinceLastSync = booleanState.changedSinceLastSync;
+            result.lastChangeTime = booleanState.lastChangeTime;
+            result.booleanValue = booleanState.currentState;
+            break;
+        }
+
+        case XR_ACTION_TYPE_FLOAT_INPUT:
+        {
+            XrActionStateFloat floatState = {XR_TYPE_ACTION_STATE_FLOAT};
+            result.result = state.xr.xrGetActionStateFloat(state.session, &getInfo, &floatState);
+            result.isActive = floatState.isActive;
+            result.changedSinceLastSync = floatState.changedSinceLastSync;
+            result.lastChangeTime = floatState.lastChangeTime;
+            result.floatValue = floatState.currentState;
+            break;
+        }
+
+        case XR_ACTION_TYPE_VECTOR2F_INPUT:
+        {
+            XrActionStateVector2f vector2fState = {XR_TYPE_ACTION_STATE_VECTOR2F};
+            result.result = state.xr.xrGetActionStateVector2f(state.session, &getInfo, &vector2fState);
+            result.isActive = vector2fState.isActive;
+            result.changedSinceLastSync = vector2fState.changedSinceLastSync;
+            result.lastChangeTime = vector2fState.lastChangeTime;
+            result.vector2fValue = vector2fState.currentState;
+            break;
+        }
+
+        default:
+        {
+            XrActionStatePose poseState = {XR_TYPE_ACTION_STATE_POSE};
+            result.result = state.xr.xrGetActionStatePose(state.session, &getInfo, &poseState);
+            result.isActive = poseState.isActive;
+            break;
+        }
+        }
+    }
+}
+
+static void QueryBatched(const XrState& state, MockActionStateResult* results)
+{
+    state.xr.MockRuntime_GetActionStates(state.session, kStateCount, state.requests, results);
+}
+
+// Both ways of querying have to agree before their timings mean anything.
+static bool CompareResults(const MockActionStateResult* perCall, const MockActionStateResult* batched)
+{
+    for (uint32_t i = 0; i < kStateCount; ++i)
+    {
+        const MockActionStateResult& a = perCall[i];
+        const MockActionStateResult& b = batched[i];
+        if (a.result != b.result || a.type != b.type || a.isActive != b.isActive || a.changedSinceLastSync != b.changedSinceLastSync ||
+            a.lastChangeTime != b.lastChangeTime || a.booleanValue != b.booleanValue || a.floatValue != b.floatValue ||
+            a.vector2fValue.x != b.vector2fValue.x || a.vector2fValue.y != b.vector2fValue.y)
+        {
+            printf("%s (hand %u): per call and batched states differ\n", kActions[i / kHandCount].name, i % kHandCount);
+            return false;
+        }
+    }
+    return true;
+}
+
+static XrResult XRAPI_PTR BeforeFunction(const char*)
+{
+    return XR_SUCCESS;
+}
+
+static void XRAPI_PTR AfterFunction(const char*, XrResult)
+{
+}
+
+typedef void (*QueryFunction)(const XrState& state, MockActionStateResult* results);
+
+// Returns the ns spent querying, over all frames.
+static int64_t RunFrames(const XrState& state, QueryFunction query, uint32_t frames)
+{
+    MockActionStateResult results[kStateCount];
+    int64_t queryNs = 0;
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        SyncActions(state);
+
+        int64_t start = NowNs();
+        query(state, results);
+        queryNs += NowNs() - start;
+    }
+    return queryNs;
+}
+
+static bool RunBenchmark(PFN_xrGetInstanceProcAddr getInstanceProcAddr, bool hooks, uint32_t frames)
+{
+    XrState state;
+    if (!CreateXrState(state, getInstanceProcAddr))
+    {
+        DestroyXrState(state);
+        return false;
+    }
+
+    if (hooks)
+        state.xr.MockRuntime_RegisterFunctionCallbacks(BeforeFunction, AfterFunction);
+
+    bool ok = SyncActions(state);
+    MockActionStateResult perCall[kStateCount] = {};
+    MockActionStateResult batched[kStateCount] = {};
+    QueryPerCall(state, perCall);
+    QueryBatched(state, batched);
+    ok = ok && CompareResults(perCall, batched);
+
+    if (ok)
+    {
+        static const QueryFunction kQueries[] = {QueryPerCall, QueryBatched};
+        static const char* const kQueryNames[] = {"per call", "batched"};
+
+        int64_t queryNs[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            // Warm up, then measure.
+            RunFrames(state, kQueries[i], frames / 10 + 1);
+            queryNs[i] = RunFrames(state, kQueries[i], frames);
+
+            printf("%-8s %-10s %12.1f %12.2f\n",
+                hooks ? "yes" : "no",
+                kQueryNames[i],
+                (double)queryNs[i] / frames,
+                (double)queryNs[i] / ((double)frames * kStateCount));
+        }
+
+        printf("%-8s %-10s %12.2fx\n", hooks ? "yes" : "no", "speedup", queryNs[1] != 0 ? (double)queryNs[0] / queryNs[1] : 0.0);
+    }
+
+    if (hooks)
+        state.xr.MockRuntime_RegisterFunctionCallbacks(nullptr, nullptr);
+
+    DestroyXrState(state);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : kDefaultFrames;
+    if (frames == 0)
+        frames = kDefaultFrames;
+
+    PluginHandle mock = Plugin_LoadLibrary(L"mock_runtime");
+    if (mock == nullptr)
+    {
+        printf("Failed to load mock_runtime\n");
+        return 1;
+    }
+
+    PFN_xrGetInstanceProcAddr getInstanceProcAddr = (PFN_xrGetInstanceProcAddr)Plugin_GetSymbol(mock, "xrGetInstanceProcAddr");
+    if (getInstanceProcAddr == nullptr)
+    {
+        printf("mock_runtime is missing xrGetInstanceProcAddr\n");
+        return 1;
+    }
+
+    printf("%u frames per run, %u action states per frame\n", frames, kStateCount);
+    printf("%-8s %-10s %12s %12s\n", "hooks", "query", "ns/frame", "ns/state");
+
+    int exitCode = 0;
+    for (int hooks = 0; hooks < 2; ++hooks)
+    {
+        if (!RunBenchmark(getInstanceProcAddr, hooks != 0, frames))
+        {
+            printf("benchmark %s hooks failed\n", hooks ? "with" : "without");
+            exitCode = 1;
+        }
+    }
+
+    Plugin_FreeLibrary(mock);
+    return exitCode;
+}
@@ -12,9 +12,11 @@ using TreeViewItem = UnityEditor.IMGUI.Controls.TreeViewItem<int>;
 #endif
 using UnityEngine;
 using UnityEngine.Networking.PlayerConnection;
+using UnityEngine.XR.OpenXR.Features.RuntimeDebugger;
 using CompressionLevel = System.IO.Compression.CompressionLevel;
 
 [assembly: InternalsVisibleTo("Unity.XR.OpenXR.Features.RuntimeDebugger.Editor")]
+[assembly: InternalsVisibleTo("Unity.XR.OpenXR.Editor.Tests")]
 namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
 {
     internal class DebuggerState
@@ -40,25 +42,213 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
             kLUTEntryUpdateStart,
             kLutEntryUpdateEnd,
             kLUTLookup,
+
+            kHandleLiveCounts,
+            kHandleLeak,
+            kHandleUseAfterDestroy,
+
+            kCaptureHeader,
+            kCaptureDetailChanged,
+            kCaptureCallCounts,
+
+            kMarkerPush,
+            kMarkerPop,
+            kMarkerInstant,
+
+            kPolledEvent,
+
+            kCaptureCommandCount,
         };
 
-        private const byte FileVersion = 2;
+        /// <summary>
+        /// First record of every capture, see capture_header.h.
+        /// </summary>
+        internal class CaptureHeader
+        {
+            internal const UInt32 Magic = 0x44525846;
+            internal const UInt32 SupportedFormatVersion = 6;
+            internal const UInt32 EndianMarker = 0x01020304;
+
+            public UInt32 formatVersion;
+            public UInt32 pointerSize;
+            public bool typeSafeHandles;
+            public UInt64 apiVersion;
+            public UInt32 commandCount;
+            public UInt64 resultTableHash;
+            public UInt64 structureTypeTableHash;
+            public UInt64 functionTableHash;
+            public UInt64 lutTableHash;
+            public string clockName;
+            public UInt64 clockTicksPerSecond;
+            public Int64 clockEpoch;
+            public Int64 wallClockEpoch;
+
+            // False if the player was built against other structure types than the runtime debugger plugin of this editor.
+            // Structs such as polled events are only expanded by the plugin if they match.
+            public bool structureTypesMatch = true;
+
+            public string apiVersionString => $"{apiVersion >> 48}.{(apiVersion >> 32) & 0xffff}.{apiVersion & 0xffffffff}";
+
+            internal const UInt64 HashSeed = 14695981039346656037;
+
+            /// <summary>
+            /// FNV-1a of a name and its terminator, matches CaptureHash in capture_header.h.
+            /// </summary>
+            internal static UInt64 Hash(UInt64 hash, string name)
+            {
+                foreach (var b in Encoding.UTF8.GetBytes(name))
+                {
+                    hash ^= b;
+                    hash *= 1099511628211;
+                }
+
+                // The terminator is a 0 byte, xor leaves the hash as is.
+                return hash * 1099511628211;
+            }
+
+            /// <summary>
+            /// Checks the LUT names defined by the capture against the hash in its header.
+            /// </summary>
+            internal void ValidateLUTNames(IEnumerable<string> names)
+            {
+                var hash = HashSeed;
+                foreach (var name in names)
+                    hash = Hash(hash, name);
+                if (hash != lutTableHash)
+                    throw new InvalidDataException("Capture LUT names don't match the LUT table hash in its header.");
+            }
+
+            // Results and function names are recorded as text, so captures from a player built against other OpenXR headers still read fine.
+            private void CompareSchema()
+            {
+                RuntimeDebuggerOpenXRFeature.CaptureSchema local;
+                try
+                {
+                    local = RuntimeDebuggerOpenXRFeature.GetCaptureSchema();
+                }
+                catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+                {
+                    return;
+                }
+
+                structureTypesMatch = structureTypeTableHash == local.structureTypeTableHash;
+                if (!structureTypesMatch || resultTableHash != local.resultTableHash || functionTableHash != local.functionTableHash)
+                    Debug.LogWarning($"Runtime Debugger capture was made with OpenXR {apiVersionString} headers that differ from this editor's, some fields may not be decoded.");
+            }
+
+            internal static CaptureHeader Read(BinaryReader r)
+            {
+                if (r.ReadUInt32() != Magic)
+                    throw new InvalidDataException("Not a runtime debugger capture.");
+
+                var header = new CaptureHeader();
+                header.formatVersion = r.ReadUInt32();
+                if (r.ReadUInt32() != EndianMarker)
+                    throw new InvalidDataException("Capture was written with a different byte order.");
+                if (header.formatVersion > SupportedFormatVersion)
+                    throw new InvalidDataException($"Capture format {header.formatVersion} is newer than supported ({SupportedFormatVersion}).");
+
+                header.pointerSize = r.ReadUInt32();
+                header.typeSafeHandles = r.ReadUInt32() != 0;
+                header.apiVersion = r.ReadUInt64();
+                // Commands are only ever appended, so older captures use a subset of the ones known here.
+                header.commandCount = r.ReadUInt32();
+                if (header.commandCount > (UInt32)Command.kCaptureCommandCount)
+                    throw new InvalidDataException($"Capture has {header.commandCount} commands, only {(UInt32)Command.kCaptureCommandCount} are supported.");
+
+                header.resultTableHash = r.ReadUInt64();
+                header.structureTypeTableHash = r.ReadUInt64();
+                header.functionTableHash = r.ReadUInt64();
+                header.lutTableHash = r.ReadUInt64();
+                header.CompareSchema();
+                header.clockName = ReadString(r);
+                header.clockTicksPerSecond = r.ReadUInt64();
+                header.clockEpoch = r.ReadInt64();
+                header.wallClockEpoch = r.ReadInt64();
+                return header;
+            }
+
+            /// <summary>
+            /// Converts a capture timestamp to wall clock time.
+            /// </summary>
+            public DateTime ToDateTime(Int64 timestamp)
+            {
+                var ticks = (Int64)((double)(timestamp - clockEpoch) * TimeSpan.TicksPerSecond / clockTicksPerSecond);
+                return DateTimeOffset.FromUnixTimeMilliseconds(wallClockEpoch / 1000000).UtcDateTime.AddTicks(ticks);
+            }
+
+            /// <summary>
+            /// Converts a wall clock time to a capture timestamp, the inverse of <see cref="ToDateTime"/>.
+            /// </summary>
+            public Int64 ToTimestamp(DateTime time)
+            {
+                var ticks = (time.ToUniversalTime() - DateTimeOffset.FromUnixTimeMilliseconds(wallClockEpoch / 1000000).UtcDateTime).Ticks;
+                return clockEpoch + (Int64)((double)ticks * clockTicksPerSecond / TimeSpan.TicksPerSecond);
+            }
+        }
+
+        private const byte FileVersion = 3;
         private static readonly byte[] Header = new byte[] { 0xea, 0x24, 0x39, 0x5c, 0xe0, 0xac, 0x79, FileVersion };
 
         internal static List<FunctionCall> _functionCalls = new List<FunctionCall>();
         private static List<byte> saveToFile = new List<byte>(Header);
         private static byte openedFileVersion = FileVersion;
 
+        // Capture header and LUT records received since the last capture header.  The player only sends them once, so Clear
+        // writes them back to saveToFile for captures saved afterwards to still be readable.
+        private static List<byte> lutRecords = new List<byte>();
+
+        // LUT keys carry the instance scope in the upper 16 bits, the LUT index (into lutNames, after "All Calls") in the lower.
+        internal const UInt32 LutIndexMask = 0xFFFF;
+
+        // Marker names, not instance scoped.  Matches kMarkerNames in capture_format.h.
+        internal const UInt32 MarkerLut = 4;
+
+        // Events returned by xrPollEvent, not instance scoped.  Matches kEvents in capture_format.h.
+        internal const UInt32 EventLut = 6;
+
+        // Start times of the marker ranges still open on each thread, innermost last.
+        private static Dictionary<string, Stack<Int64>> _openMarkers = new Dictionary<string, Stack<Int64>>();
+
         internal static Dictionary<UInt32, Dictionary<UInt64, HandleDebugEvent>> xrLut = new Dictionary<UInt32, Dictionary<UInt64, HandleDebugEvent>>();
         internal static List<string> lutNames = new List<string>();
 
+        // Captures without a header (file version 2 and older) have no timestamps.
+        internal static CaptureHeader captureHeader;
+
+        // Analytics the player sent with its last capture, not saved to files.
+        internal static RuntimeDebuggerOpenXRFeature.DebuggerStats stats;
+
         internal static void Clear()
         {
             _functionCalls.Clear();
+            _openMarkers.Clear();
+            stats = null;
             saveToFile.Clear();
             saveToFile.AddRange(Header);
 
             openedFileVersion = FileVersion;
+
+            // Parsed again from the kept records, which also puts them back in saveToFile.
+            captureHeader = null;
+            var lut = lutRecords.ToArray();
+            lutRecords.Clear();
+            if (lut.Length > 0)
+                OnMessageEvent(new MessageEventArgs() { data = lut });
+        }
+
+        private static bool IsLutRecord(Command command)
+        {
+            switch (command)
+            {
+                case Command.kCaptureHeader:
+                case Command.kLUTDefineTables:
+                case Command.kLUTEntryUpdateStart:
+                case Command.kLutEntryUpdateEnd:
+                    return true;
+                default:
+                    return false;
+            }
         }
 
         private static Action _doneCallback;
@@ -71,6 +261,92 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
             _doneCallback = done;
         }
 
+        private static string GetMarkerName(UInt32 markerId)
+        {
+            if (xrLut.TryGetValue(MarkerLut, out var markers) && markers.TryGetValue(markerId, out var marker))
+                return marker.GetValue();
+            return $"Marker {markerId}";
+        }
+
+        private static FunctionCall ReadMarker(BinaryReader r, Command command)
+        {
+            var thread = ReadString(r);
+            var timestamp = r.ReadInt64();
+            var name = GetMarkerName(r.ReadUInt32());
+
+            if (!_openMarkers.TryGetValue(thread, out var open))
+                _openMarkers[thread] = open = new Stack<Int64>();
+
+            string displayName;
+            switch (command)
+            {
+                case Command.kMarkerPush:
+                    open.Push(timestamp);
+                    displayName = $"Begin {name}";
+                    break;
+                case Command.kMarkerPop:
+                    // The push may have been in a capture that was dropped.
+                    displayName = open.Count > 0 ? $"End {name} ({(timestamp - open.Pop()) / 1000000.0:F3} ms)" : $"End {name}";
+                    break;
+                default:
+                    displayName = $"Marker {name}";
+                    break;
+            }
+            return new FunctionCall(thread, displayName) { timestamp = timestamp };
+        }
+
+        // Events are raw copies of the event struct, sent ahead of their xrPollEvent call and keyed by event id.  The native library turns
+        // them back into fields (see event_records.h).
+        private static void ReadPolledEvent(BinaryReader r)
+        {
+            var thread = ReadString(r);
+            var timestamp = r.ReadInt64();
+            var eventId = r.ReadUInt64();
+            var scope = r.ReadUInt32();
+            var eventData = r.ReadBytes((int)r.ReadUInt32());
+
+            // Struct layout depends on the pointer size and the OpenXR headers of the player.
+            byte[] expanded = null;
+            if (captureHeader != null && captureHeader.pointerSize == IntPtr.Size && captureHeader.structureTypesMatch)
+            {
+                try
+                {
+                    expanded = RuntimeDebuggerOpenXRFeature.ExpandPolledEvent(eventData, scope);
+                }
+                catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+                {
+                }
+            }
+
+            HandleDebugEvent evt;
+            if (expanded != null)
+            {
+                using var er = new BinaryReader(new MemoryStream(expanded), Encoding.UTF8);
+                var structName = $"Event type {BitConverter.ToUInt32(eventData, 0)}";
+                if ((Command)er.ReadUInt32() == Command.kStartStruct)
+                {
+                    ReadString(er);
+                    structName = ReadString(er);
+                }
+                else
+                {
+                    er.BaseStream.Position = 0;
+                }
+                evt = new HandleDebugEvent(structName, eventId);
+                evt.Parse(er);
+            }
+            else
+            {
+                evt = new HandleDebugEvent($"Event type {BitConverter.ToUInt32(eventData, 0)}", eventId);
+            }
+            evt.AddChildEvent(new StringDebugEvent("thread", thread));
+            evt.AddChildEvent(new Int64DebugEvent("timestamp", timestamp));
+
+            if (!xrLut.TryGetValue(EventLut, out var events))
+                xrLut[EventLut] = events = new Dictionary<UInt64, HandleDebugEvent>();
+            events[eventId] = evt;
+        }
+
         private static StringBuilder _sb = new StringBuilder();
         internal static string ReadString(BinaryReader r)
         {
@@ -95,6 +371,10 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
             xrLut.Clear();
             lutNames.Clear();
             lutNames.Add("All Calls");
+            captureHeader = null;
+            lutRecords.Clear();
+            saveToFile.Clear();
+            saveToFile.AddRange(Header);
             using var inStream = File.OpenRead(path);
             var gzip = new GZipStream(inStream, CompressionMode.Decompress);
             byte[] bytes;
@@ -124,6 +404,21 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
             OnMessageEvent(new MessageEventArgs() {data = bytes.Skip(8).ToArray()});
         }
 
+        internal static void OnStatsEvent(MessageEventArgs args)
+        {
+            if (args == null || args.data == null)
+                return;
+
+            try
+            {
+                stats = RuntimeDebuggerOpenXRFeature.DebuggerStats.Deserialize(args.data);
+            }
+            catch (Exception e)
+            {
+                Debug.LogError(e);
+            }
+        }
+
         internal static void OnMessageEvent(MessageEventArgs args)
         {
             if (args == null || args.data == null)
@@ -139,13 +434,19 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
                     {
                         while (r.BaseStream.Position != r.BaseStream.Length)
                         {
+                            var recordStart = (int)r.BaseStream.Position;
                             var command = (Command)r.ReadUInt32();
                             switch (command)
                             {
                                 case Command.kStartFunctionCall:
+                                    // Record size, only needed when skipping calls.
+                                    if (captureHeader != null && captureHeader.formatVersion >= 2)
+                                        r.ReadUInt32();
                                     var thread = ReadString(r);
                                     var funcName = ReadString(r);
                                     var funcCall = new FunctionCall(thread, funcName);
+                                    if (captureHeader != null)
+                                        funcCall.timestamp = r.ReadInt64();
                                     _functionCalls.Add(funcCall);
                                     funcCall.Parse(r);
 
@@ -163,6 +464,7 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
                                         xrLut[lutIndex] = new Dictionary<UInt64, HandleDebugEvent>();
                                         lutNames.Add(ReadString(r));
                                     }
+                                    captureHeader?.ValidateLUTNames(lutNames.Skip(1));
 
                                     break;
                                 case Command.kLUTEntryUpdateStart:
@@ -177,19 +479,85 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
 
                                     var evt = new HandleDebugEvent(handleName, handle);
                                     evt.Parse(r);
-                                    xrLut[lutKey][handle] = evt;
+                                    if (!xrLut.TryGetValue(lutKey, out var lutEntries))
+                                        xrLut[lutKey] = lutEntries = new Dictionary<UInt64, HandleDebugEvent>();
+                                    lutEntries[handle] = evt;
                                     break;
                                 case Command.kLutEntryUpdateEnd:
                                     break;
                                 case Command.kCacheNotLargeEnough:
-                                    funcCall = new FunctionCall(r.ReadUInt32().ToString(), ReadString(r));
+                                    funcCall = new FunctionCall(ReadString(r), ReadString(r));
                                     _functionCalls.Add(funcCall);
                                     var result = ReadString(r);
                                     funcCall.displayName += " = " + result + " (cache not large enough)";
                                     break;
+                                case Command.kHandleLiveCounts:
+                                    var liveCounts = new FunctionCall("", "Live handles");
+                                    var numHandleTypes = r.ReadUInt32();
+                                    for (UInt32 i = 0; i < numHandleTypes; ++i)
+                                    {
+                                        liveCounts.AddChildEvent(new UInt32DebugEvent(ReadString(r), r.ReadUInt32()));
+                                    }
+                                    _functionCalls.Add(liveCounts);
+                                    break;
+                                case Command.kHandleLeak:
+                                    var releasedBy = ReadString(r);
+                                    var leakedType = ReadString(r);
+                                    var leakedHandle = r.ReadUInt64();
+                                    var createdBy = ReadString(r);
+                                    _functionCalls.Add(new FunctionCall("", $"Leaked {leakedType} {leakedHandle} (created by {createdBy}, released by {releasedBy})"));
+                                    break;
+                                case Command.kHandleUseAfterDestroy:
+                                    thread = ReadString(r);
+                                    funcName = ReadString(r);
+                                    var paramName = ReadString(r);
+                                    var destroyedType = ReadString(r);
+                                    var destroyedHandle = r.ReadUInt64();
+                                    _functionCalls.Add(new FunctionCall(thread, $"{funcName} used destroyed {destroyedType} {destroyedHandle} ({paramName})"));
+                                    break;
+                                case Command.kCaptureHeader:
+                                    captureHeader = CaptureHeader.Read(r);
+                                    break;
+                                case Command.kCaptureDetailChanged:
+                                    var changedAt = r.ReadInt64();
+                                    var previousDetail = (RuntimeDebuggerOpenXRFeature.CaptureDetail)r.ReadUInt32();
+                                    var detail = (RuntimeDebuggerOpenXRFeature.CaptureDetail)r.ReadUInt32();
+                                    var frameCost = r.ReadInt64();
+                                    var frameBytes = r.ReadUInt64();
+                                    _functionCalls.Add(new FunctionCall("", $"Capture detail {previousDetail} -> {detail} (last frame {frameCost / 1000000.0:F3} ms, {frameBytes} bytes)") { timestamp = changedAt });
+                                    break;
+                                case Command.kCaptureCallCounts:
+                                    var callCounts = new FunctionCall("", "Call counts") { timestamp = r.ReadInt64() };
+                                    var numFunctions = r.ReadUInt32();
+                                    for (UInt32 i = 0; i < numFunctions; ++i)
+                                    {
+                                        var countedFunction = ReadString(r);
+                                        var count = r.ReadUInt32();
+                                        callCounts.AddChildEvent(new UInt32DebugEvent(countedFunction, count));
+                                        if (countedFunction == "xrBeginFrame")
+                                            _frameCount += count;
+                                    }
+                                    _functionCalls.Add(callCounts);
+                                    break;
+                                case Command.kMarkerPush:
+                                case Command.kMarkerPop:
+                                case Command.kMarkerInstant:
+                                    _functionCalls.Add(ReadMarker(r, command));
+                                    break;
+                                case Command.kPolledEvent:
+                                    ReadPolledEvent(r);
+                                    break;
                                 default:
                                     throw new ArgumentOutOfRangeException();
                             }
+
+                            if (IsLutRecord(command))
+                            {
+                                // A new header means the player started its LUT over.
+                                if (command == Command.kCaptureHeader)
+                                    lutRecords.Clear();
+                                lutRecords.AddRange(new ArraySegment<byte>(args.data, recordStart, (int)r.BaseStream.Position - recordStart));
+                            }
                         }
                     }
                 }
@@ -261,7 +629,7 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
                             var fieldName = ReadString(r);
                             var handle = r.ReadUInt64();
 
-                            if (xrLut[lutKey].TryGetValue(handle, out var evt))
+                            if (xrLut.TryGetValue(lutKey, out var lut) && lut.TryGetValue(handle, out var evt))
                             {
                                 AddChildEvent(evt.Clone(fieldName));
                             }
@@ -313,7 +681,7 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
                 return childrenEvents[0];
             }
 
-            private DebugEvent AddChildEvent(DebugEvent evt)
+            internal DebugEvent AddChildEvent(DebugEvent evt)
             {
                 childrenEvents.Add(evt);
                 AddChild(evt);
@@ -366,6 +734,7 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
         {
             public string threadId { get; }
             public string returnVal { get; set; }
+            public Int64 timestamp { get; set; }
 
             public FunctionCall(string threadId, string displayName)
                 : base("", displayName)
@@ -375,7 +744,7 @@ namespace UnityEditor.XR.OpenXR.Features.RuntimeDebugger
 
             public override DebugEvent Clone()
             {
-                return AddClonedChildren(new FunctionCall(threadId, displayName));
+                return AddClonedChildren(new FunctionCall(threadId, displayName) { timestamp = timestamp });
             }
         }
 
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <vector>
+
+// Filters function calls out of s_MainDataStore as it is drained, so focused investigations only ship the calls they need.
+// Markers only have to match the thread and time range.  Other records (LUT updates, handle reports, ...) always pass.
+
+// Accessing these must be protected with s_DataMutex.
+static bool s_CaptureFilterSet = false;
+static CaptureFilter s_CaptureFilter = {};
+static std::vector<uint8_t> s_CaptureFilterFunctions; // indexed by function id, empty matches all
+static std::string s_CaptureFilterThread;
+static std::vector<uint8_t> s_FilteredData;
+
+static uint32_t GetResultClass(const char* result)
+{
+    if (strcmp(result, "XR_SUCCESS") == 0)
+        return kResultClassSuccess;
+    if (strncmp(result, "XR_ERROR_", 9) == 0)
+        return kResultClassError;
+    return kResultClassQualifiedSuccess;
+}
+
+// Handles are serialized as kUInt64 values or LUT lookups.  This can match other 64 bit values that happen to be equal,
+// which is fine for narrowing down a capture.
+static bool FieldsContainHandle(const uint8_t* fields, uint32_t fieldsSize, uint64_t handle)
+{
+    RecordCursor cursor = {};
+    cursor.data = fields;
+    cursor.size = fieldsSize;
+
+    uint32_t offset = 0;
+    while (offset < fieldsSize)
+    {
+        Command command;
+        if (!CursorRead(cursor, offset, &command, sizeof(command)))
+            return false;
+
+        uint64_t value;
+        switch (command)
+        {
+            case kStartStruct:
+            case kString:
+                if (!CursorSkipStrings(cursor, offset, 2))
+                    return false;
+                break;
+            case kFloat:
+            case kInt32:
+            case kUInt32:
+                if (!CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, 4))
+                    return false;
+                break;
+            case kInt64:
+                if (!CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, 8))
+                    return false;
+                break;
+            case kUInt64:
+                if (!CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, &value, sizeof(value)))
+                    return false;
+                if (value == handle)
+                    return true;
+                break;
+            case kLUTLookup:
+                if (!CursorRead(cursor, offset, nullptr, sizeof(LUT)) || !CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, &value, sizeof(value)))
+                    return false;
+                if (value == handle)
+                    return true;
+                break;
+            case kEndStruct:
+                break;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// Must be called with s_DataMutex held.
+static bool CaptureFilterMatches(const RecordView& view)
+{
+    if (view.command == kMarkerPush || view.command == kMarkerPop || view.command == kMarkerInstant)
+    {
+        if (!s_CaptureFilterThread.empty() && s_CaptureFilterThread != view.thread)
+            return false;
+        if (s_CaptureFilter.startTime != 0 && view.timestamp < s_CaptureFilter.startTime)
+            return false;
+        return s_CaptureFilter.endTime == 0 || view.timestamp < s_CaptureFilter.endTime;
+    }
+
+    if (view.command != kStartFunctionCall && view.command != kCacheNotLargeEnough)
+        return true;
+
+    if (!s_CaptureFilterFunctions.empty() && (view.functionId >= s_CaptureFilterFunctions.size() || !s_CaptureFilterFunctions[view.functionId]))
+        return false;
+
+    if (s_CaptureFilter.resultClasses != 0 && (view.result == nullptr || (GetResultClass(view.result) & s_CaptureFilter.resultClasses) == 0))
+        return false;
+
+    if (!s_CaptureFilterThread.empty() && (view.thread == nullptr || s_CaptureFilterThread != view.thread))
+        return false;
+
+    // Calls that didn't fit into the cache have no timestamp or fields, they can only match on function, result and thread.
+    if (s_CaptureFilter.startTime != 0 || s_CaptureFilter.endTime != 0)
+    {
+        if (view.command != kStartFunctionCall)
+            return false;
+        if (s_CaptureFilter.startTime != 0 && view.timestamp < s_CaptureFilter.startTime)
+            return false;
+        if (s_CaptureFilter.endTime != 0 && view.timestamp >= s_CaptureFilter.endTime)
+            return false;
+    }
+
+    if (s_CaptureFilter.handle != 0 && (view.command != kStartFunctionCall || !FieldsContainHandle(view.fields, view.fieldsSize, s_CaptureFilter.handle)))
+        return false;
+
+    return true;
+}
+
+// Installs a filter applied by GetFilteredDataForRead.  functionIds may be null to match all functions, thread may be null or empty to match all threads.
+extern "C" void UNITY_INTERFACE_EXPORT SetCaptureFilter(const CaptureFilter* filter, const uint32_t* functionIds, uint32_t functionIdCount, const char* thread)
+{
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    s_CaptureFilterSet = true;
+    s_CaptureFilter = *filter;
+
+    s_CaptureFilterFunctions.clear();
+    if (functionIds != nullptr && functionIdCount != 0)
+    {
+        s_CaptureFilterFunctions.resize(kFunctionCount, 0);
+        for (uint32_t i = 0; i < functionIdCount; ++i)
+        {
+            if (functionIds[i] < kFunctionCount)
+                s_CaptureFilterFunctions[functionIds[i]] = 1;
+        }
+    }
+
+    s_CaptureFilterThread = thread != nullptr ? thread : "";
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT ClearCaptureFilter()
+{
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    s_CaptureFilterSet = false;
+    s_CaptureFilter = {};
+    s_CaptureFilterFunctions.clear();
+    s_CaptureFilterThread.clear();
+    std::vector<uint8_t>().swap(s_FilteredData);
+}
+
+// Drains s_MainDataStore keeping only records that pass the capture filter.  Use instead of GetDataForRead, between
+// StartDataAccess and EndDataAccess.  The returned data stays valid until EndDataAccess.
+// Returns the number of calls that were filtered out.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetFilteredDataForRead(uint8_t** ptr, uint32_t* size)
+{
+    s_FilteredData.clear();
+
+    // Ring buffer, so the data may come in two chunks.
+    s_MainDataStore.SetOverflowMode(RingBuf::kOverflowModeWrap);
+    uint8_t* chunk;
+    uint32_t chunkSize;
+    bool more = true;
+    for (int i = 0; i < 2 && more; ++i)
+    {
+        more = s_MainDataStore.GetForReadAndClear(&chunk, &chunkSize);
+        if (chunkSize > 0)
+            s_FilteredData.insert(s_FilteredData.end(), chunk, chunk + chunkSize);
+    }
+
+    // Compact matching records to the front in place.
+    RecordCursor cursor = {};
+    cursor.data = s_FilteredData.data();
+    cursor.size = (uint32_t)s_FilteredData.size();
+    cursor.formatVersion = kCaptureFormatVersion;
+
+    uint32_t written = 0;
+    uint32_t dropped = 0;
+    RecordView view;
+    while (CursorNextRecord(cursor, view))
+    {
+        if (!s_CaptureFilterSet || CaptureFilterMatches(view))
+        {
+            uint32_t start = (uint32_t)(view.record - cursor.data);
+            if (start != written)
+                memmove(s_FilteredData.data() + written, view.record, view.recordSize);
+            written += view.recordSize;
+        }
+        else
+        {
+            ++dropped;
+        }
+    }
+
+    // Keep whatever couldn't be parsed rather than silently losing it.
+    if (cursor.error != nullptr)
+    {
+        uint32_t remaining = cursor.size - cursor.offset;
+        memmove(s_FilteredData.data() + written, cursor.data + cursor.offset, remaining);
+        written += remaining;
+    }
+
+    s_FilteredData.resize(written);
+    *ptr = s_FilteredData.data();
+    *size = written;
+    return dropped;
+}
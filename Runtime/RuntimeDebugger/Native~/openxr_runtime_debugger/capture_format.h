@@ -0,0 +1,126 @@
+#pragma once
+
+#include <stdint.h>
+
+// Capture format and export layouts.
+// Shared with the tools built next to the debugger (runtime_debugger_benchmark, runtime_debugger_replay), which include
+// this on its own, so only plain types and constants go here.  The c# side mirrors these in DebuggerState and
+// RuntimeDebuggerOpenXRFeature.
+
+enum Command
+{
+    kStartFunctionCall,
+    kStartStruct,
+
+    kFloat,
+    kString,
+    kInt32,
+    kInt64,
+    kUInt32,
+    kUInt64,
+
+    kEndStruct,
+    kEndFunctionCall,
+
+    kCacheNotLargeEnough,
+
+    kLUTDefineTables,
+    kLUTEntryUpdateStart,
+    kLutEntryUpdateEnd,
+    kLUTLookup,
+
+    kHandleLiveCounts,
+    kHandleLeak,
+    kHandleUseAfterDestroy,
+
+    kCaptureHeader,
+    kCaptureDetailChanged,
+    kCaptureCallCounts,
+
+    kMarkerPush,
+    kMarkerPop,
+    kMarkerInstant,
+
+    kPolledEvent,
+
+    // Keep last, part of the capture header schema.
+    kCaptureCommandCount,
+
+    kEndData = 0xFFFFFFFF
+};
+
+// LUT ids in the capture carry the scope of the instance they belong to in their upper 16 bits.
+enum LUT
+{
+    kXrPath,
+    kXrAction,
+    kXrActionSet,
+    kXrSpace,
+    kMarkerNames, // not scoped, marker names are shared by every instance
+    kStacks,      // not scoped, see stack_capture.h
+    kEvents,      // not scoped, see event_records.h
+
+    kLUTPadding = 0xFFFFFFFF,
+};
+
+static const uint32_t kLutScopeShift = 16;
+static const uint32_t kLutIndexMask = 0xFFFF;
+
+enum CaptureDetail : uint32_t
+{
+    kCaptureDetailFull,     // every parameter, structs and arrays expanded
+    kCaptureDetailTopLevel, // parameters only, struct and array pointers are sent as addresses
+    kCaptureDetailTiming,   // function, thread, timestamp and result
+    kCaptureDetailCounts,   // no per call records, call counts per function are written once per frame
+};
+
+// Budgets that are 0 are disabled.  See capture_governor.h.
+struct CaptureBudget
+{
+    int64_t cpuNsPerFrame;
+    uint64_t bytesPerFrame;
+};
+
+enum CaptureResultClass : uint32_t
+{
+    kResultClassSuccess = 1 << 0,          // XR_SUCCESS
+    kResultClassQualifiedSuccess = 1 << 1, // any other non error result, e.g. XR_SESSION_LOSS_PENDING
+    kResultClassError = 1 << 2,            // XR_ERROR_*
+};
+
+// Criteria that are 0 match everything.  See capture_filter.h.
+struct CaptureFilter
+{
+    int64_t startTime; // inclusive, capture timestamp
+    int64_t endTime;   // exclusive, capture timestamp
+    uint64_t handle;   // any handle passed to or returned from the call
+    uint32_t resultClasses;
+};
+
+// One top level record, see record_cursor.h.  Pointers point into the buffer the cursor was opened on.
+struct RecordView
+{
+    int64_t timestamp;        // kStartFunctionCall, kCaptureDetailChanged, kCaptureCallCounts, markers and kPolledEvent only
+    const uint8_t* record;    // whole record, starting at the command
+    const char* thread;       // nullptr if the record has no thread
+    const char* name;         // function name, or nullptr
+    const char* result;       // function result, or nullptr
+    const uint8_t* fields;    // record payload after the fixed part, see record_cursor.h
+    uint32_t command;
+    uint32_t functionId;      // kInvalidFunctionId if the record isn't for a function, or the function is unknown
+    uint32_t recordSize;
+    uint32_t fieldsSize;
+};
+
+enum CaptureStreamFrameKind : uint32_t
+{
+    kCaptureStreamLUT,  // LUT store bytes, appended to what was sent before
+    kCaptureStreamData, // s_MainDataStore bytes
+};
+
+// Every capture stream frame starts with this, followed by size bytes.  See capture_stream.h.
+struct CaptureStreamFrameHeader
+{
+    uint32_t size;
+    uint32_t kind;
+};
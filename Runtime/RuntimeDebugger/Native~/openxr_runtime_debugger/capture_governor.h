@@ -0,0 +1,171 @@
+#pragma once
+
+// Capture budget governor.
+// Holds the debugger to a per frame CPU time and bandwidth budget by trading capture detail for cost.  The capture path
+// measures its own cost (see s_FrameCaptureCost), which is evaluated once per frame at xrEndFrame.  Going over budget
+// steps detail down one level, staying well under budget for a while steps it back up.
+// Every change is written to the capture as kCaptureDetailChanged so readers know what is missing from the calls that follow.
+// The capture stream (capture_stream.h) counts as over budget while its client can't keep up, budget or not.
+
+static const uint32_t kCaptureStepUpFrames = 30;         // frames with headroom before stepping back up
+static const uint32_t kCaptureMaxStepUpFrames = 30 * 64; // step ups that don't hold back off up to this
+
+static std::atomic<uint32_t> s_CaptureDetail{kCaptureDetailFull};
+
+// Set by the capture stream while data queues up faster than its client reads it.
+static std::atomic<bool> s_CaptureBackpressure{false};
+
+// Calls made at kCaptureDetailCounts, sent and cleared every frame.
+static std::atomic<uint32_t> s_CallCounts[kFunctionCount];
+static std::atomic<bool> s_CallCountsPending{false};
+
+// Accessing these must be protected with s_GovernorMutex.  Lock before s_DataMutex.
+static std::mutex s_GovernorMutex;
+static CaptureBudget s_CaptureBudget = {};
+static uint32_t s_FramesWithHeadroom = 0;
+static uint32_t s_FramesSinceStepUp = 0;
+static uint32_t s_StepUpFrames = kCaptureStepUpFrames;
+
+static CaptureDetail CurrentCaptureDetail()
+{
+    return (CaptureDetail)s_CaptureDetail.load(std::memory_order_relaxed);
+}
+
+static void CountCall(FunctionId functionId)
+{
+    s_CallCounts[functionId].fetch_add(1, std::memory_order_relaxed);
+    if (!s_CallCountsPending.load(std::memory_order_relaxed))
+        s_CallCountsPending.store(true, std::memory_order_relaxed);
+}
+
+static void SendCallCounts()
+{
+    if (!s_CallCountsPending.exchange(false, std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    PrepareMainDataStore();
+    s_MainDataStore.CreateNewBlock();
+    s_MainDataStore.Write(kCaptureCallCounts);
+    s_MainDataStore.Write(CaptureTimestamp());
+    uint32_t* numFunctions = (uint32_t*)s_MainDataStore.GetForWrite(sizeof(uint32_t));
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < kFunctionCount; ++i)
+    {
+        uint32_t count = s_CallCounts[i].exchange(0, std::memory_order_relaxed);
+        if (count == 0)
+            continue;
+        s_MainDataStore.Write(kFunctionNames[i]);
+        s_MainDataStore.Write(count);
+        ++written;
+    }
+    if (numFunctions != nullptr)
+        *numFunctions = written;
+}
+
+// Must be called with s_GovernorMutex held.
+static void ChangeCaptureDetail(CaptureDetail detail, int64_t frameCost, uint64_t frameBytes)
+{
+    CaptureDetail previous = CurrentCaptureDetail();
+    if (detail == previous)
+        return;
+
+    s_CaptureDetail.store(detail, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    PrepareMainDataStore();
+    s_MainDataStore.CreateNewBlock();
+    s_MainDataStore.Write(kCaptureDetailChanged);
+    s_MainDataStore.Write(CaptureTimestamp());
+    s_MainDataStore.Write((uint32_t)previous);
+    s_MainDataStore.Write((uint32_t)detail);
+    s_MainDataStore.Write(frameCost);
+    s_MainDataStore.Write(frameBytes);
+}
+
+// Called once per frame, from xrEndFrame.
+static void EvaluateCaptureBudget()
+{
+    int64_t frameCost = s_FrameCaptureCost.exchange(0, std::memory_order_relaxed);
+    uint64_t frameBytes = s_FrameCaptureBytes.exchange(0, std::memory_order_relaxed);
+
+    // Before any change, so counts land in the frame they were made in.
+    SendCallCounts();
+
+    std::lock_guard<std::mutex> guard(s_GovernorMutex);
+    const CaptureBudget& budget = s_CaptureBudget;
+    bool backpressure = s_CaptureBackpressure.load(std::memory_order_relaxed);
+    if (budget.cpuNsPerFrame == 0 && budget.bytesPerFrame == 0 && !backpressure && CurrentCaptureDetail() == kCaptureDetailFull)
+        return;
+
+    bool overBudget = backpressure || (budget.cpuNsPerFrame != 0 && frameCost > budget.cpuNsPerFrame) || (budget.bytesPerFrame != 0 && frameBytes > budget.bytesPerFrame);
+
+    // Each level costs a few times less than the one above, half the budget leaves room to try the next level up.
+    bool headroom = (budget.cpuNsPerFrame == 0 || frameCost < budget.cpuNsPerFrame / 2) && (budget.bytesPerFrame == 0 || frameBytes < budget.bytesPerFrame / 2);
+
+    if (s_FramesSinceStepUp < kCaptureMaxStepUpFrames)
+        ++s_FramesSinceStepUp;
+
+    CaptureDetail detail = CurrentCaptureDetail();
+    if (overBudget)
+    {
+        s_FramesWithHeadroom = 0;
+        if (detail == kCaptureDetailCounts)
+            return;
+
+        // The last step up didn't hold, wait longer before trying again.
+        if (s_FramesSinceStepUp < s_StepUpFrames && s_StepUpFrames < kCaptureMaxStepUpFrames)
+            s_StepUpFrames *= 2;
+        ChangeCaptureDetail((CaptureDetail)(detail + 1), frameCost, frameBytes);
+    }
+    else if (headroom && detail != kCaptureDetailFull)
+    {
+        if (++s_FramesWithHeadroom < s_StepUpFrames)
+            return;
+
+        s_FramesWithHeadroom = 0;
+        s_FramesSinceStepUp = 0;
+        ChangeCaptureDetail((CaptureDetail)(detail - 1), frameCost, frameBytes);
+    }
+    else
+    {
+        s_FramesWithHeadroom = 0;
+    }
+}
+
+// Parameters sent at kCaptureDetailTopLevel.  Values and strings are sent as usual, anything else behind a pointer
+// (structs, arrays, output parameters) is only sent as its address.
+template <typename T>
+static typename std::enable_if<!std::is_pointer<T>::value>::type SendTopLevel(const char* fieldName, T t)
+{
+    SendToCSharp(fieldName, t);
+}
+
+template <typename T>
+static void SendTopLevel(const char* fieldName, T* t)
+{
+    SendUInt64(fieldName, (uint64_t)(uintptr_t)t);
+}
+
+static void SendTopLevel(const char* fieldName, const char* t)
+{
+    SendToCSharp(fieldName, t);
+}
+
+// Sets the budget the governor holds the capture to.  A budget of 0 (both members) turns the governor off and goes back to full detail.
+extern "C" void UNITY_INTERFACE_EXPORT SetCaptureBudget(const CaptureBudget* budget)
+{
+    std::lock_guard<std::mutex> guard(s_GovernorMutex);
+    s_CaptureBudget = *budget;
+    s_FramesWithHeadroom = 0;
+    s_FramesSinceStepUp = kCaptureMaxStepUpFrames;
+    s_StepUpFrames = kCaptureStepUpFrames;
+
+    if (s_CaptureBudget.cpuNsPerFrame == 0 && s_CaptureBudget.bytesPerFrame == 0)
+        ChangeCaptureDetail(kCaptureDetailFull, 0, 0);
+}
+
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetCaptureDetail()
+{
+    return CurrentCaptureDetail();
+}
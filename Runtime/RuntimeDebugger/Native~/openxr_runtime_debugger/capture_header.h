@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+
+// Self describing header written as the first record of every capture.
+// Readers check it before parsing anything else, so stale or foreign captures are rejected up front rather than misparsed.
+//
+// Bump kCaptureFormatVersion whenever the layout of any record changes.
+//   1: initial version, kStartFunctionCall carries a timestamp.
+//   2: kStartFunctionCall carries the size of the whole call record.
+//   3: LUT ids carry the instance scope in their upper 16 bits.
+//   4: kCaptureDetailChanged and kCaptureCallCounts, calls may carry fewer fields than their signature.
+//   5: kMarkerPush, kMarkerPop and kMarkerInstant, the Markers LUT.
+//   6: kPolledEvent entries in the Events LUT.  xrPollEvent carries a kLUTLookup of the event instead of its fields.
+
+static const uint32_t kCaptureMagic = 0x44525846; // "FXRD" read as little endian bytes
+static const uint32_t kCaptureFormatVersion = 6;
+static const uint32_t kCaptureEndianMarker = 0x01020304;
+
+// Timestamps in the capture are steady_clock nanoseconds.
+static int64_t CaptureTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a, used to fingerprint the tables the capture refers to by index or value.
+static uint64_t CaptureHash(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t CaptureHash(uint64_t hash, const char* s)
+{
+    // Include the terminator so adjacent names can't run together.
+    return CaptureHash(hash, s, strlen(s) + 1);
+}
+
+static uint64_t CaptureHash(uint64_t hash, int64_t value)
+{
+    return CaptureHash(hash, &value, sizeof(value));
+}
+
+static const uint64_t kCaptureHashSeed = 14695981039346656037ull;
+
+#define CAPTURE_HASH_ENUM_ENTRY(name, value) \
+    hash = CaptureHash(CaptureHash(hash, #name), (int64_t)value);
+
+#define CAPTURE_HASH_FUNC(name, ...) \
+    hash = CaptureHash(hash, #name);
+
+static uint64_t HashResultTable()
+{
+    uint64_t hash = kCaptureHashSeed;
+    XR_LIST_ENUM_XrResult(CAPTURE_HASH_ENUM_ENTRY);
+    return hash;
+}
+
+static uint64_t HashStructureTypeTable()
+{
+    uint64_t hash = kCaptureHashSeed;
+    XR_LIST_ENUM_XrStructureType(CAPTURE_HASH_ENUM_ENTRY);
+    return hash;
+}
+
+static uint64_t HashFunctionTable()
+{
+    uint64_t hash = kCaptureHashSeed;
+    XR_LIST_FUNCS(CAPTURE_HASH_FUNC);
+    return hash;
+}
+
+static uint64_t HashLUTTable()
+{
+    uint64_t hash = kCaptureHashSeed;
+    for (const char* name : kLutNames)
+        hash = CaptureHash(hash, name);
+    return hash;
+}
+
+#undef CAPTURE_HASH_ENUM_ENTRY
+#undef CAPTURE_HASH_FUNC
+
+static void WriteCaptureHeader(RingBuf& store)
+{
+    store.Write(kCaptureHeader);
+    store.Write(kCaptureMagic);
+    store.Write(kCaptureFormatVersion);
+    store.Write(kCaptureEndianMarker);
+    store.Write((uint32_t)sizeof(void*));
+    store.Write((uint32_t)(XR_TYPE_SAFE_HANDLES ? 1 : 0));
+    store.Write((uint64_t)XR_CURRENT_API_VERSION);
+
+    // Schema: the command set and the tables enums / functions / LUTs are encoded against.
+    store.Write((uint32_t)kCaptureCommandCount);
+    store.Write(HashResultTable());
+    store.Write(HashStructureTypeTable());
+    store.Write(HashFunctionTable());
+    store.Write(HashLUTTable());
+
+    // Clock: units of the timestamps, and a paired steady / wall clock sample so they can be put on a calendar.
+    store.Write("steady_clock");
+    store.Write((uint64_t)1000000000);
+    store.Write(CaptureTimestamp());
+    store.Write((int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// Schema of captures written by this build, so readers can tell whether a capture was encoded against the same tables.
+struct CaptureSchema
+{
+    uint32_t formatVersion;
+    uint32_t commandCount;
+    uint64_t resultTableHash;
+    uint64_t structureTypeTableHash;
+    uint64_t functionTableHash;
+    uint64_t lutTableHash;
+};
+
+extern "C" void UNITY_INTERFACE_EXPORT GetCaptureSchema(CaptureSchema* schema)
+{
+    schema->formatVersion = kCaptureFormatVersion;
+    schema->commandCount = (uint32_t)kCaptureCommandCount;
+    schema->resultTableHash = HashResultTable();
+    schema->structureTypeTableHash = HashStructureTypeTable();
+    schema->functionTableHash = HashFunctionTable();
+    schema->lutTableHash = HashLUTTable();
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// User markers.
+// Lets the app put its own events (scene loads, asset streaming, GC, shader compiles, ...) in the capture next to the OpenXR calls.
+// Names are registered once and written to the LUT store, markers then only carry the name id and a timestamp.
+// Marker records are written to the calling thread's s_ThreadLocalMarkerStore without taking a lock and go out with
+// the thread's next OpenXR call, under the lock that call takes anyway.  Threads that never make OpenXR calls flush when their outermost range closes, and
+// any thread flushes once half its buffer is markers.  Those flushes are skipped while s_DataMutex is busy.  Whatever
+// is left goes out at thread exit.
+
+static const uint32_t kMaxMarkerDepth = 64;
+static const uint32_t kInvalidMarkerId = 0xFFFFFFFF;
+
+// Accessing these must be protected with s_DataMutex.
+static std::vector<std::string> s_MarkerNames;
+static std::unordered_map<std::string, uint32_t> s_MarkerIds;
+
+// Open ranges of this thread, innermost last.  Ranges pushed past kMaxMarkerDepth aren't recorded, and neither are their pops.
+thread_local uint32_t s_MarkerStack[kMaxMarkerDepth];
+thread_local uint32_t s_MarkerDepth = 0;
+
+static void WriteMarkerName(RingBuf& store, uint32_t id, const std::string& name)
+{
+    store.CreateNewBlock();
+    store.Write(kLUTEntryUpdateStart);
+    store.Write(kMarkerNames);
+    store.Write((uint64_t)id);
+    store.Write(name);
+    store.Write(kStartStruct);
+    store.Write("");
+    store.Write("");
+    store.Write(kEndStruct);
+}
+
+// Must be called with s_DataMutex held.
+static void WriteMarkerNames(RingBuf& store)
+{
+    for (uint32_t i = 0; i < (uint32_t)s_MarkerNames.size(); ++i)
+        WriteMarkerName(store, i, s_MarkerNames[i]);
+}
+
+static void WriteMarker(Command command, uint32_t nameId)
+{
+    // Not hooked yet, or called back from inside a call this thread is capturing.
+    if (s_PerThreadCacheSize == 0 || s_ThreadLocalRecordSize != nullptr)
+        return;
+
+    PrepareThreadLocalMarkerStore();
+    s_ThreadLocalMarkersPending = true;
+
+    s_ThreadLocalMarkerStore.CreateNewBlock();
+    s_ThreadLocalMarkerStore.Write(command);
+    s_ThreadLocalMarkerStore.Write(CurrentThreadName());
+    s_ThreadLocalMarkerStore.Write(CaptureTimestamp());
+    s_ThreadLocalMarkerStore.Write(nameId);
+    s_ThreadLocalMarkerBytes += s_ThreadLocalMarkerStore.blockSize;
+    s_MarkersWritten.fetch_add(1, std::memory_order_relaxed);
+
+    // Threads making calls flush with their next call, others when their outermost range closes.  Either flushes early
+    // rather than let the oldest markers be overwritten.
+    if ((!s_ThreadMakesCalls && s_MarkerDepth == 0) || s_ThreadLocalMarkerBytes > s_ThreadLocalMarkerStore.cacheSize / 2)
+        TryFlushThreadLocalMarkers();
+}
+
+// Returns the id of a marker name, registering it on first use.  Safe to call from any thread, but takes a lock: look ids up once and keep them.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT RegisterMarkerName(const char* name)
+{
+    if (name == nullptr)
+        return kInvalidMarkerId;
+
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    PrepareLUTDataStore();
+
+    auto it = s_MarkerIds.find(name);
+    if (it != s_MarkerIds.end())
+        return it->second;
+
+    uint32_t id = (uint32_t)s_MarkerNames.size();
+    s_MarkerNames.push_back(name);
+    s_MarkerIds[name] = id;
+    WriteMarkerName(s_LUTDataStore, id, s_MarkerNames.back());
+    return id;
+}
+
+// Opens a range on the calling thread.
+extern "C" void UNITY_INTERFACE_EXPORT PushMarker(uint32_t nameId)
+{
+    if (s_MarkerDepth < kMaxMarkerDepth)
+        s_MarkerStack[s_MarkerDepth] = nameId;
+    ++s_MarkerDepth;
+
+    if (s_MarkerDepth <= kMaxMarkerDepth)
+        WriteMarker(kMarkerPush, nameId);
+}
+
+// Closes the innermost range opened on the calling thread.
+extern "C" void UNITY_INTERFACE_EXPORT PopMarker()
+{
+    if (s_MarkerDepth == 0)
+        return;
+
+    --s_MarkerDepth;
+    if (s_MarkerDepth < kMaxMarkerDepth)
+        WriteMarker(kMarkerPop, s_MarkerStack[s_MarkerDepth]);
+}
+
+// A point in time on the calling thread.
+extern "C" void UNITY_INTERFACE_EXPORT InstantMarker(uint32_t nameId)
+{
+    WriteMarker(kMarkerInstant, nameId);
+}
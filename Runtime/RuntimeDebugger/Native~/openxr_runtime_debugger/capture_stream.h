@@ -0,0 +1,422 @@
+#pragma once
+
+#include <condition_variable>
+#include <vector>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stddef.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Live capture streaming.
+// An optional thread that pushes capture data to a local socket as it's written, rather than waiting for the editor to
+// ask for it.  It listens on 127.0.0.1 or on a Unix domain socket, so on Android it's reached through adb:
+//   adb forward tcp:<port> tcp:<port>    or    adb forward tcp:<port> localabstract:<name>
+// One client at a time.  A client first gets the whole LUT store, which starts with the capture header, then LUT
+// updates and capture data as they're written.  Both go out as frames of CaptureStreamFrameHeader followed by size bytes.
+// While the stream runs it's the only reader of s_MainDataStore.
+//
+// Flow control: data waits in a queue until the socket takes it.  Past half of maxQueuedBytes the capture governor is
+// told to lower detail (s_CaptureBackpressure), and s_MainDataStore is only drained while its contents fit in the queue,
+// so calls are dropped there as kCacheNotLargeEnough rather than queued past maxQueuedBytes.
+
+// Layout is mirrored in c#.
+struct CaptureStreamStats
+{
+    uint64_t bytesSent;
+    uint64_t framesSent;
+    uint64_t connections;
+    uint32_t queuedBytes;
+    uint32_t connected;
+};
+
+#if defined(_WIN32)
+typedef SOCKET CaptureSocket;
+static const CaptureSocket kInvalidCaptureSocket = INVALID_SOCKET;
+
+static void CloseCaptureSocket(CaptureSocket s)
+{
+    closesocket(s);
+}
+
+static bool SetCaptureSocketNonBlocking(CaptureSocket s)
+{
+    u_long nonBlocking = 1;
+    return ioctlsocket(s, FIONBIO, &nonBlocking) == 0;
+}
+
+static bool CaptureSocketWouldBlock()
+{
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+static int PollCaptureSocket(CaptureSocket s, short events, int timeoutMs)
+{
+    WSAPOLLFD fd = {s, events, 0};
+    return WSAPoll(&fd, 1, timeoutMs);
+}
+#else
+typedef int CaptureSocket;
+static const CaptureSocket kInvalidCaptureSocket = -1;
+
+static void CloseCaptureSocket(CaptureSocket s)
+{
+    close(s);
+}
+
+static bool SetCaptureSocketNonBlocking(CaptureSocket s)
+{
+    int flags = fcntl(s, F_GETFL, 0);
+    return flags != -1 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static bool CaptureSocketWouldBlock()
+{
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+static int PollCaptureSocket(CaptureSocket s, short events, int timeoutMs)
+{
+    pollfd fd = {s, events, 0};
+    return poll(&fd, 1, timeoutMs);
+}
+#endif
+
+#if defined(MSG_NOSIGNAL)
+static const int kCaptureSendFlags = MSG_NOSIGNAL;
+#else
+static const int kCaptureSendFlags = 0;
+#endif
+
+// How long the stream thread sleeps when there's nothing to send, frames ending wake it earlier.
+static const int kCaptureStreamIdleMs = 5;
+
+static std::thread s_CaptureStreamThread;
+static std::atomic<bool> s_CaptureStreamStop{false};
+static std::atomic<bool> s_CaptureStreamRunning{false};
+static CaptureSocket s_CaptureStreamListener = kInvalidCaptureSocket;
+static uint32_t s_CaptureStreamMaxQueuedBytes = 0;
+
+// Woken once per frame from xrEndFrame.
+static std::mutex s_CaptureStreamWakeMutex;
+static std::condition_variable s_CaptureStreamWake;
+static bool s_CaptureStreamPending = false;
+
+static std::atomic<uint64_t> s_CaptureStreamBytesSent{0};
+static std::atomic<uint64_t> s_CaptureStreamFramesSent{0};
+static std::atomic<uint64_t> s_CaptureStreamConnections{0};
+static std::atomic<uint32_t> s_CaptureStreamQueuedBytes{0};
+static std::atomic<bool> s_CaptureStreamConnected{false};
+
+// Only touched by the stream thread.
+struct CaptureStreamClient
+{
+    CaptureSocket socket;
+    std::vector<uint8_t> queue;
+    size_t queueHead;
+    uint32_t lutOffset;
+    uint32_t lutGeneration;
+};
+
+static void QueueStreamFrame(CaptureStreamClient& client, CaptureStreamFrameKind kind, const uint8_t* data, uint32_t size)
+{
+    CaptureStreamFrameHeader header = {size, kind};
+    client.queue.insert(client.queue.end(), (const uint8_t*)&header, (const uint8_t*)&header + sizeof(header));
+    client.queue.insert(client.queue.end(), data, data + size);
+    s_CaptureStreamFramesSent.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Moves new LUT entries and, if the queue has room for it, everything in s_MainDataStore into the client's queue.
+static void CollectStreamData(CaptureStreamClient& client)
+{
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+
+    // LUT first so lookups in the data that follows resolve.  Always sent, the data can't be read without it.
+    uint8_t* ptr = nullptr;
+    uint32_t size = 0;
+    s_LUTDataStore.GetForRead(&ptr, &size);
+    if (client.lutGeneration != s_LUTGeneration)
+    {
+        client.lutGeneration = s_LUTGeneration;
+        client.lutOffset = 0;
+    }
+    if (size > client.lutOffset)
+    {
+        QueueStreamFrame(client, kCaptureStreamLUT, ptr + client.lutOffset, size - client.lutOffset);
+        client.lutOffset = size;
+    }
+
+    // An empty queue always takes the store, or a store larger than the queue would never go out.
+    size_t queued = client.queue.size() - client.queueHead;
+    if (queued != 0 && queued + s_MainDataStore.ReadableSize() > s_CaptureStreamMaxQueuedBytes)
+        return;
+
+    // Ring buffer, so the data may come in two chunks.
+    for (int chunk = 0; chunk < 2; ++chunk)
+    {
+        bool more = s_MainDataStore.GetForReadAndClear(&ptr, &size);
+        if (size != 0)
+            QueueStreamFrame(client, kCaptureStreamData, ptr, size);
+        if (!more)
+            break;
+    }
+    s_MainDataStore.Reset();
+}
+
+// Sends as much of the queue as the socket takes.  Returns false if the client went away.
+static bool SendStreamData(CaptureStreamClient& client)
+{
+    while (client.queueHead < client.queue.size())
+    {
+        size_t remaining = client.queue.size() - client.queueHead;
+        int chunk = remaining < 64 * 1024 ? (int)remaining : 64 * 1024;
+        int sent = (int)send(client.socket, (const char*)client.queue.data() + client.queueHead, chunk, kCaptureSendFlags);
+        if (sent < 0)
+        {
+            if (CaptureSocketWouldBlock())
+                break;
+            return false;
+        }
+        client.queueHead += sent;
+        s_CaptureStreamBytesSent.fetch_add(sent, std::memory_order_relaxed);
+    }
+
+    if (client.queueHead == client.queue.size())
+    {
+        client.queue.clear();
+        client.queueHead = 0;
+    }
+    else if (client.queueHead > client.queue.size() / 2)
+    {
+        client.queue.erase(client.queue.begin(), client.queue.begin() + client.queueHead);
+        client.queueHead = 0;
+    }
+    return true;
+}
+
+static void UpdateCaptureBackpressure(uint32_t queuedBytes)
+{
+    s_CaptureStreamQueuedBytes.store(queuedBytes, std::memory_order_relaxed);
+
+    // Raised at half, cleared at a quarter, so the governor doesn't flip detail every frame around one threshold.
+    if (queuedBytes > s_CaptureStreamMaxQueuedBytes / 2)
+        s_CaptureBackpressure.store(true, std::memory_order_relaxed);
+    else if (queuedBytes < s_CaptureStreamMaxQueuedBytes / 4)
+        s_CaptureBackpressure.store(false, std::memory_order_relaxed);
+}
+
+static void DisconnectStreamClient(CaptureStreamClient& client)
+{
+    if (client.socket != kInvalidCaptureSocket)
+        CloseCaptureSocket(client.socket);
+    client = {kInvalidCaptureSocket};
+    s_CaptureStreamConnected.store(false, std::memory_order_relaxed);
+    UpdateCaptureBackpressure(0);
+}
+
+static void CaptureStreamThread()
+{
+    CaptureStreamClient client = {kInvalidCaptureSocket};
+    while (!s_CaptureStreamStop.load(std::memory_order_relaxed))
+    {
+        if (client.socket == kInvalidCaptureSocket)
+        {
+            if (PollCaptureSocket(s_CaptureStreamListener, POLLIN, 100) <= 0)
+                continue;
+
+            CaptureSocket accepted = accept(s_CaptureStreamListener, nullptr, nullptr);
+            if (accepted == kInvalidCaptureSocket)
+                continue;
+            if (!SetCaptureSocketNonBlocking(accepted))
+            {
+                CloseCaptureSocket(accepted);
+                continue;
+            }
+#if defined(SO_NOSIGPIPE)
+            int noSigPipe = 1;
+            setsockopt(accepted, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+            client = {accepted};
+            client.lutGeneration = (uint32_t)-1;
+            s_CaptureStreamConnections.fetch_add(1, std::memory_order_relaxed);
+            s_CaptureStreamConnected.store(true, std::memory_order_relaxed);
+        }
+
+        if (client.queueHead < client.queue.size())
+        {
+            // Wait for the socket to take more.
+            PollCaptureSocket(client.socket, POLLOUT, kCaptureStreamIdleMs);
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(s_CaptureStreamWakeMutex);
+            s_CaptureStreamWake.wait_for(lock, std::chrono::milliseconds(kCaptureStreamIdleMs), []() { return s_CaptureStreamPending || s_CaptureStreamStop.load(std::memory_order_relaxed); });
+            s_CaptureStreamPending = false;
+        }
+
+        CollectStreamData(client);
+        if (!SendStreamData(client))
+        {
+            DisconnectStreamClient(client);
+            continue;
+        }
+        UpdateCaptureBackpressure((uint32_t)(client.queue.size() - client.queueHead));
+    }
+
+    DisconnectStreamClient(client);
+}
+
+// Called once per frame, from xrEndFrame.
+static void NotifyCaptureStream()
+{
+    if (!s_CaptureStreamRunning.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> lock(s_CaptureStreamWakeMutex);
+    s_CaptureStreamPending = true;
+    s_CaptureStreamWake.notify_one();
+}
+
+static CaptureSocket ListenForStreamClients(uint16_t port, const char* socketName)
+{
+#if defined(_WIN32)
+    static bool s_WinsockStarted = false;
+    if (!s_WinsockStarted)
+    {
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+            return kInvalidCaptureSocket;
+        s_WinsockStarted = true;
+    }
+#endif
+
+    CaptureSocket listener;
+    if (socketName != nullptr && socketName[0] != 0)
+    {
+#if defined(_WIN32)
+        return kInvalidCaptureSocket;
+#else
+        // A leading @ puts the socket in the abstract namespace (Android, Linux), it then needs no file system path.
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        size_t nameLength = strlen(socketName);
+        if (nameLength >= sizeof(address.sun_path))
+            return kInvalidCaptureSocket;
+        memcpy(address.sun_path, socketName, nameLength);
+        if (socketName[0] == '@')
+            address.sun_path[0] = 0;
+        else
+            unlink(socketName);
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener == kInvalidCaptureSocket)
+            return kInvalidCaptureSocket;
+        if (bind(listener, (sockaddr*)&address, (socklen_t)(offsetof(sockaddr_un, sun_path) + nameLength)) != 0)
+        {
+            CloseCaptureSocket(listener);
+            return kInvalidCaptureSocket;
+        }
+#endif
+    }
+    else
+    {
+        // Loopback only, the capture isn't meant to leave the device other than through adb.
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener == kInvalidCaptureSocket)
+            return kInvalidCaptureSocket;
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+        if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0)
+        {
+            CloseCaptureSocket(listener);
+            return kInvalidCaptureSocket;
+        }
+    }
+
+    if (listen(listener, 1) != 0)
+    {
+        CloseCaptureSocket(listener);
+        return kInvalidCaptureSocket;
+    }
+    return listener;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT StopCaptureStream()
+{
+    if (!s_CaptureStreamRunning.load(std::memory_order_relaxed))
+        return;
+
+    s_CaptureStreamStop.store(true, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(s_CaptureStreamWakeMutex);
+        s_CaptureStreamWake.notify_one();
+    }
+    s_CaptureStreamThread.join();
+
+    CloseCaptureSocket(s_CaptureStreamListener);
+    s_CaptureStreamListener = kInvalidCaptureSocket;
+    s_CaptureStreamRunning.store(false, std::memory_order_relaxed);
+}
+
+// Starts streaming to clients connecting on 127.0.0.1:port, or on socketName if it isn't empty.  Restarts the stream
+// if it's already running.  Returns false if the socket couldn't be set up.
+extern "C" bool UNITY_INTERFACE_EXPORT StartCaptureStream(uint16_t port, const char* socketName, uint32_t maxQueuedBytes)
+{
+    StopCaptureStream();
+
+    s_CaptureStreamListener = ListenForStreamClients(port, socketName);
+    if (s_CaptureStreamListener == kInvalidCaptureSocket)
+        return false;
+
+    s_CaptureStreamMaxQueuedBytes = maxQueuedBytes;
+    s_CaptureStreamStop.store(false, std::memory_order_relaxed);
+    s_CaptureStreamRunning.store(true, std::memory_order_relaxed);
+    s_CaptureStreamThread = std::thread(CaptureStreamThread);
+    return true;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT GetCaptureStreamStats(CaptureStreamStats* stats)
+{
+    stats->bytesSent = s_CaptureStreamBytesSent.load(std::memory_order_relaxed);
+    stats->framesSent = s_CaptureStreamFramesSent.load(std::memory_order_relaxed);
+    stats->connections = s_CaptureStreamConnections.load(std::memory_order_relaxed);
+    stats->queuedBytes = s_CaptureStreamQueuedBytes.load(std::memory_order_relaxed);
+    stats->connected = s_CaptureStreamConnected.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+// The feature calls StopCaptureStream when its instance is destroyed.  A stream still running at unload is only told to
+// stop and detached: joining from a static destructor can deadlock on the loader lock, and letting the std::thread be
+// destroyed joinable would terminate the process.
+struct CaptureStreamOwner
+{
+    ~CaptureStreamOwner()
+    {
+        if (!s_CaptureStreamThread.joinable())
+            return;
+
+        s_CaptureStreamStop.store(true, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(s_CaptureStreamWakeMutex);
+            s_CaptureStreamWake.notify_one();
+        }
+        s_CaptureStreamThread.detach();
+    }
+};
+
+static CaptureStreamOwner s_CaptureStreamOwner;
@@ -0,0 +1,64 @@
+#pragma once
+
+// Memory footprint of the debugger and counts of capture data that was dropped.  Layout is mirrored in c#.
+struct DebuggerMemoryStats
+{
+    uint64_t totalBytes;
+    uint64_t mainStoreBytes;
+    uint64_t lutStoreBytes;
+    uint64_t threadBufferBytes;
+    uint64_t pooledThreadBufferBytes;
+    uint64_t analyticsBytes;
+
+    uint32_t liveThreadBuffers;
+    uint32_t pooledThreadBuffers;
+    uint32_t threadBufferHighWaterMark;
+    uint32_t threadBufferSize;
+
+    // Calls that didn't fit into the main cache (sent as kCacheNotLargeEnough).
+    uint64_t cacheNotLargeEnoughCount;
+    // Writes that didn't fit into a per-thread cache, the buffer is grown on the thread's next call.
+    uint64_t threadBufferFailedWrites;
+};
+
+extern "C" void UNITY_INTERFACE_EXPORT GetDebuggerMemoryStats(DebuggerMemoryStats* stats)
+{
+    *stats = {};
+
+    {
+        std::lock_guard<std::mutex> guard(s_DataMutex);
+        stats->mainStoreBytes = s_MainDataStore.data != nullptr ? s_MainDataStore.cacheSize : 0;
+        stats->lutStoreBytes = s_LUTDataStore.data != nullptr ? s_LUTDataStore.cacheSize : 0;
+        stats->cacheNotLargeEnoughCount = s_CacheNotLargeEnoughCount;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(s_ThreadBufferPoolMutex);
+        stats->pooledThreadBuffers = (uint32_t)s_PooledThreadBuffers.size();
+        for (const RingBuf& buffer : s_PooledThreadBuffers)
+            stats->pooledThreadBufferBytes += buffer.cacheSize;
+    }
+
+    stats->liveThreadBuffers = s_LiveThreadBuffers.load(std::memory_order_relaxed);
+    stats->threadBufferBytes = s_LiveThreadBufferBytes.load(std::memory_order_relaxed);
+    stats->threadBufferHighWaterMark = s_ThreadBufferHighWaterMark.load(std::memory_order_relaxed);
+    stats->threadBufferSize = GetThreadBufferSize();
+    stats->threadBufferFailedWrites = s_ThreadBufferFailedWrites.load(std::memory_order_relaxed);
+
+    stats->analyticsBytes = sizeof(s_PoseStream) + sizeof(s_FramePacing);
+#if XR_TYPE_SAFE_HANDLES
+    {
+        std::lock_guard<std::mutex> guard(s_HandleMutex);
+        stats->analyticsBytes += s_HandleTable.capacity.load(std::memory_order_relaxed) * sizeof(HandleRecord);
+    }
+#endif
+
+    stats->totalBytes = stats->mainStoreBytes + stats->lutStoreBytes + stats->threadBufferBytes + stats->pooledThreadBufferBytes + stats->analyticsBytes;
+}
+
+// Contention on the mutex guarding the main capture store.  Counts are cumulative, diff two samples to measure a period.
+extern "C" void UNITY_INTERFACE_EXPORT GetDebuggerLockStats(uint64_t* acquisitions, uint64_t* contentions)
+{
+    *acquisitions = s_DataMutexAcquisitions.load(std::memory_order_relaxed);
+    *contentions = s_DataMutexContentions.load(std::memory_order_relaxed);
+}
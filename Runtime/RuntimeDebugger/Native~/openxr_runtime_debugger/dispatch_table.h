@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+
+// Per-instance dispatch.
+// Function pointers are loaded per XrInstance so overlapping instances (e.g. OpenXRRestarter bringing up a new instance
+// while the old one is torn down) each call into the runtime that created them.
+// Calls are routed by their first handle parameter.  While only one instance is live every call goes straight to its table,
+// otherwise the handle's record in s_HandleTable holds the index of its table.
+// Members are atomic because tables are filled in (ShareDispatchFunction, slot reuse) while other threads call through them.
+
+static const uint32_t kMaxDispatchTables = 8;
+
+#define GEN_DISPATCH_MEMBER(f, ...) std::atomic<PFN_##f> f;
+
+struct DispatchTable
+{
+    std::atomic<XrInstance> instance;
+    std::atomic<uint32_t> lutScope;
+    std::atomic<PFN_xrGetInstanceProcAddr> getInstanceProcAddr;
+    XR_LIST_FUNCS(GEN_DISPATCH_MEMBER)
+};
+
+#undef GEN_DISPATCH_MEMBER
+
+// Functions loaded without an instance, and the most recently loaded pointer of every function.  The latter is used
+// for calls whose instance can't be found (handles created before the debugger was hooked, 32-bit builds).
+static DispatchTable s_GlobalDispatchTable;
+
+// Changing these must be protected with s_DispatchMutex.
+// Slots are reused but never freed, so a thread racing xrDestroyInstance still calls through valid pointers.
+static std::mutex s_DispatchMutex;
+static DispatchTable s_DispatchTables[kMaxDispatchTables];
+static uint32_t s_LiveDispatchTables = 0;
+static uint32_t s_NextLUTScope = 0;
+
+// The only live instance table, or null when there are none or several.
+static std::atomic<DispatchTable*> s_SingleDispatchTable{nullptr};
+
+// Must be called with s_DispatchMutex held.
+static void UpdateSingleDispatchTable()
+{
+    DispatchTable* single = nullptr;
+    if (s_LiveDispatchTables == 1)
+    {
+        for (DispatchTable& table : s_DispatchTables)
+        {
+            if (table.instance.load(std::memory_order_relaxed) != XR_NULL_HANDLE)
+                single = &table;
+        }
+    }
+    s_SingleDispatchTable.store(single, std::memory_order_release);
+}
+
+#define GEN_DISPATCH_COPY(f, ...) target.f.store(source.f.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+static void CopyDispatchFunctions(DispatchTable& target, const DispatchTable& source)
+{
+    target.getInstanceProcAddr.store(source.getInstanceProcAddr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    XR_LIST_FUNCS(GEN_DISPATCH_COPY)
+}
+
+#undef GEN_DISPATCH_COPY
+
+// Finds or creates the table for instance.  XR_NULL_HANDLE, or running out of slots, gives the global table.
+static DispatchTable& AcquireDispatchTable(XrInstance instance)
+{
+    if (instance == XR_NULL_HANDLE)
+        return s_GlobalDispatchTable;
+
+    std::lock_guard<std::mutex> guard(s_DispatchMutex);
+    DispatchTable* freeTable = nullptr;
+    for (DispatchTable& table : s_DispatchTables)
+    {
+        XrInstance tableInstance = table.instance.load(std::memory_order_relaxed);
+        if (tableInstance == instance)
+            return table;
+        if (freeTable == nullptr && tableInstance == XR_NULL_HANDLE)
+            freeTable = &table;
+    }
+
+    if (freeTable == nullptr)
+        return s_GlobalDispatchTable;
+
+    // Start from what's loaded so far so functions the app never loads for this instance still have a target.
+    CopyDispatchFunctions(*freeTable, s_GlobalDispatchTable);
+    freeTable->lutScope.store((s_NextLUTScope++ % 0xFFFF) + 1, std::memory_order_relaxed);
+    freeTable->instance.store(instance, std::memory_order_release);
+    ++s_LiveDispatchTables;
+    UpdateSingleDispatchTable();
+    return *freeTable;
+}
+
+static void ReleaseDispatchTable(XrInstance instance)
+{
+    std::lock_guard<std::mutex> guard(s_DispatchMutex);
+    for (DispatchTable& table : s_DispatchTables)
+    {
+        if (table.instance.load(std::memory_order_relaxed) == instance && instance != XR_NULL_HANDLE)
+        {
+            table.instance.store(XR_NULL_HANDLE, std::memory_order_relaxed);
+            --s_LiveDispatchTables;
+            UpdateSingleDispatchTable();
+            return;
+        }
+    }
+}
+
+static bool HasLiveDispatchTables()
+{
+    std::lock_guard<std::mutex> guard(s_DispatchMutex);
+    return s_LiveDispatchTables != 0;
+}
+
+// A function was loaded for one instance: make it the fallback, and fill it in for instances that haven't loaded it.
+template <typename PFN>
+static void ShareDispatchFunction(std::atomic<PFN> DispatchTable::*member, PFN func)
+{
+    std::lock_guard<std::mutex> guard(s_DispatchMutex);
+    (s_GlobalDispatchTable.*member).store(func, std::memory_order_relaxed);
+    for (DispatchTable& table : s_DispatchTables)
+    {
+        // An instance loading its own pointer stores it without the lock, don't overwrite it.
+        PFN expected = nullptr;
+        (table.*member).compare_exchange_strong(expected, func, std::memory_order_relaxed);
+    }
+}
+
+#if XR_TYPE_SAFE_HANDLES
+
+// Index stored in handle records for the table of instance: its slot + 1, or 0 for the global table.
+// Only called when a handle is created, so scanning the few slots is fine.
+static uint32_t DispatchIndexOf(uint64_t instance)
+{
+    if (instance == 0)
+        return 0;
+
+    for (uint32_t i = 0; i < kMaxDispatchTables; ++i)
+    {
+        if ((uint64_t)s_DispatchTables[i].instance.load(std::memory_order_acquire) == instance)
+            return i + 1;
+    }
+    return 0;
+}
+
+static DispatchTable& FindDispatchTable(HandleRef ref)
+{
+    HandleState state;
+    uint32_t dispatchIndex;
+    if (!s_HandleTable.TryFind(ref.type, ref.handle, state, dispatchIndex))
+    {
+        std::lock_guard<std::mutex> guard(s_HandleMutex);
+        const HandleRecord* record = s_HandleTable.Find(ref.type, ref.handle);
+        state = record != nullptr ? record->state.load(std::memory_order_relaxed) : kHandleStateEmpty;
+        dispatchIndex = record != nullptr ? record->dispatchIndex.load(std::memory_order_relaxed) : 0;
+    }
+
+    // Instances created before the debugger was hooked aren't tracked, but get a table when they load functions.
+    if (state == kHandleStateEmpty && ref.type == kHandleType_XrInstance)
+        dispatchIndex = DispatchIndexOf(ref.handle);
+
+    return dispatchIndex != 0 ? s_DispatchTables[dispatchIndex - 1] : s_GlobalDispatchTable;
+}
+
+template <typename... Args>
+static DispatchTable& DispatchTableFor(Args... args)
+{
+    // Resolved at compile time, functions without a handle (xrCreateInstance, xrEnumerate*Properties) are global.
+    HandleRef ref = FirstHandleOf(args...);
+    if (ref.type == kHandleTypeNone)
+        return s_GlobalDispatchTable;
+
+    DispatchTable* single = s_SingleDispatchTable.load(std::memory_order_acquire);
+    if (single != nullptr)
+        return *single;
+
+    return FindDispatchTable(ref);
+}
+
+#else
+
+// Handles aren't tracked, so there's nothing to route on.  Every call uses the most recently loaded functions.
+template <typename... Args>
+static DispatchTable& DispatchTableFor(Args...)
+{
+    return s_GlobalDispatchTable;
+}
+
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+// Events returned by xrPollEvent.
+// Each event is written as one kPolledEvent record holding a raw copy of the event struct, sized from reflection by its
+// XrStructureType, instead of being expanded field by field into the call.  Records are the entries of the Events LUT,
+// keyed by event id, and the call only carries a kLUTLookup of that id.  Readers index events by id and can list every
+// event of a capture without walking the calls.
+// Unlike the other LUTs, events aren't written to the LUT store, which is never truncated and would grow with every
+// event of a long session.  The xrPollEvent hook writes the record to the thread's marker store without taking a lock,
+// and it goes into the main store ahead of the call, like markers do (see capture_markers.h).  The flush makes sure the
+// Events LUT is defined under the same lock.  Events are recorded at every capture detail level.
+// Readers turn a record back into fields with ExpandPolledEvent, which only works with the pointer size of this build.
+
+// Ids start at 1, 0 means the last xrPollEvent on this thread didn't record an event.
+static std::atomic<uint64_t> s_NextPolledEventId{1};
+thread_local uint64_t s_PolledEventId = 0;
+
+#define POLLED_EVENT_SIZE(typeName, typeType) \
+    case typeType:                            \
+        return (uint32_t)sizeof(typeName);
+
+// Bytes of the event struct for type, or the base header alone for types this build doesn't know.
+static uint32_t PolledEventSize(XrStructureType type)
+{
+    switch (type)
+    {
+        XR_LIST_BASE_STRUCT_TYPES_XrEventDataBaseHeader(POLLED_EVENT_SIZE);
+        default:
+            return (uint32_t)sizeof(XrEventDataBaseHeader);
+    }
+}
+
+#undef POLLED_EVENT_SIZE
+
+// Called from the xrPollEvent hook, before the call's fields are written.
+static void WritePolledEvent(const XrEventDataBuffer* eventData)
+{
+    uint32_t size = PolledEventSize(eventData->type);
+    s_PolledEventId = s_NextPolledEventId.fetch_add(1, std::memory_order_relaxed);
+
+    PrepareThreadLocalMarkerStore();
+    s_ThreadLocalMarkersPending = true;
+
+    s_ThreadLocalMarkerStore.CreateNewBlock();
+    s_ThreadLocalMarkerStore.Write(kPolledEvent);
+    s_ThreadLocalMarkerStore.Write(CurrentThreadName());
+    s_ThreadLocalMarkerStore.Write(CaptureTimestamp());
+    s_ThreadLocalMarkerStore.Write(s_PolledEventId);
+    s_ThreadLocalMarkerStore.Write(s_LUTScope);
+    s_ThreadLocalMarkerStore.Write(size);
+    uint8_t* bytes = s_ThreadLocalMarkerStore.GetForWrite(size);
+    if (bytes != nullptr)
+    {
+        memcpy(bytes, eventData, size);
+        // The chain belongs to the app and is gone by the time anyone reads the record.
+        memset(bytes + offsetof(XrEventDataBaseHeader, next), 0, sizeof(eventData->next));
+    }
+    s_ThreadLocalMarkerBytes += s_ThreadLocalMarkerStore.blockSize;
+
+    // Calls that are only counted don't reach EndFunctionCall.
+    if (s_ThreadLocalRecordSize == nullptr)
+        FlushThreadLocalMarkers();
+}
+
+template <>
+void SendToCSharp<>(const char* fieldname, XrEventDataBuffer* t)
+{
+    if (t != nullptr && s_PolledEventId != 0)
+    {
+        s_ThreadLocalDataStore.Write(kLUTLookup);
+        s_ThreadLocalDataStore.Write(kEvents);
+        s_ThreadLocalDataStore.Write(fieldname);
+        s_ThreadLocalDataStore.Write(s_PolledEventId);
+        return;
+    }
+
+    // Nothing was polled.
+    if (t == nullptr)
+        SendToCSharpNullPtr(fieldname);
+    else
+        SendToCSharp(fieldname, t->type);
+}
+
+// Expands the event struct of a kPolledEvent record into a kStartStruct .. kEndStruct span, as it would have been
+// written into the call.  scope is the LUT scope from the record.  Returns the bytes written to out, or 0 if the event
+// is malformed or the span doesn't fit in capacity.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT ExpandPolledEvent(const uint8_t* event, uint32_t size, uint32_t scope, uint8_t* out, uint32_t capacity)
+{
+    XrEventDataBuffer buffer = {};
+    if (event == nullptr || out == nullptr || size < sizeof(XrEventDataBaseHeader) || size > sizeof(buffer))
+        return 0;
+    memcpy(&buffer, event, size);
+    buffer.next = nullptr;
+
+    RingBuf expanded = {};
+    expanded.Create(capacity, RingBuf::kOverflowModeTruncate);
+    expanded.CreateNewBlock();
+
+    RingBuf callStore = s_ThreadLocalDataStore;
+    uint32_t callScope = s_LUTScope;
+    s_ThreadLocalDataStore = expanded;
+    s_LUTScope = scope;
+    SendToCSharp("", (XrEventDataBaseHeader*)&buffer);
+    expanded = s_ThreadLocalDataStore;
+    s_ThreadLocalDataStore = callStore;
+    s_LUTScope = callScope;
+
+    uint32_t written = expanded.failedWrites == 0 ? expanded.blockSize : 0;
+    memcpy(out, expanded.data, written);
+    expanded.Destroy();
+    return written;
+}
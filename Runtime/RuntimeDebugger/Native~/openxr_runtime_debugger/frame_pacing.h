@@ -0,0 +1,238 @@
+#pragma once
+
+// Frame pacing analytics derived from xrWaitFrame / xrBeginFrame / xrEndFrame, independent of any vendor perf extension.
+// Frames are followed from the xrWaitFrame that predicted them to the xrEndFrame that submitted them.
+// Apps may wait on the next frame before ending the current one, so a few frames can be in flight at once.
+// Times come from CaptureTimestamp (capture_header.h), the clock of every other timestamp in the capture.
+
+static const uint32_t kFramePacingLogCapacity = 1024;
+static const uint32_t kFramePacingHistogramBuckets = 64;
+static const uint32_t kFramePacingBucketWidthUs = 500;
+static const uint32_t kMaxFramesInFlight = 4;
+
+enum FramePacingFlags : uint16_t
+{
+    kFrameShouldRender = 1 << 0,
+    kFrameLate = 1 << 1,
+    kFrameDiscarded = 1 << 2,
+};
+
+// One entry of the per-frame log.
+struct FramePacingRecord
+{
+    XrTime predictedDisplayTime;
+    uint32_t frameIndex;
+    uint32_t cpuTimeUs;   // xrBeginFrame -> xrEndFrame
+    uint32_t waitToEndUs; // xrWaitFrame returned -> xrEndFrame
+    uint32_t markers;     // user markers written on any thread, xrBeginFrame -> xrEndFrame
+    uint16_t missedVsyncs;
+    uint16_t flags;
+};
+
+// Rolling histograms over the frames currently in the log.  Layout is mirrored in c#.
+struct FramePacingHistogram
+{
+    uint32_t totalFrames;
+    uint32_t windowFrames;
+    uint32_t missedVsyncs;
+    uint32_t lateFrames;
+    uint32_t discardedFrames;
+    uint32_t bucketWidthUs;
+    uint32_t cpuTime[kFramePacingHistogramBuckets];
+    uint32_t waitToEnd[kFramePacingHistogramBuckets];
+};
+
+struct FrameInFlight
+{
+    XrTime predictedDisplayTime;
+    XrDuration predictedDisplayPeriod;
+    int64_t waitReturned;
+    int64_t beginCalled;
+    uint32_t markersAtBegin;
+    uint16_t missedVsyncs;
+    uint16_t flags;
+    bool begun;
+};
+
+struct FramePacing
+{
+    FramePacingRecord log[kFramePacingLogCapacity];
+    uint32_t logHead;
+    uint32_t logCount;
+
+    FramePacingHistogram histogram;
+
+    FrameInFlight inFlight[kMaxFramesInFlight];
+    uint32_t numInFlight;
+
+    XrTime lastPredictedDisplayTime;
+    uint32_t nextFrameIndex;
+};
+
+// Accessing this must be protected with s_FramePacingMutex.
+static std::mutex s_FramePacingMutex;
+static FramePacing s_FramePacing = {};
+
+static uint32_t FramePacingBucket(uint32_t us)
+{
+    uint32_t bucket = us / kFramePacingBucketWidthUs;
+    return bucket < kFramePacingHistogramBuckets ? bucket : kFramePacingHistogramBuckets - 1;
+}
+
+// Must be called with s_FramePacingMutex held.
+static void AddToFramePacingHistogram(const FramePacingRecord& record, int32_t delta)
+{
+    FramePacingHistogram& histogram = s_FramePacing.histogram;
+    histogram.windowFrames += delta;
+    histogram.missedVsyncs += delta * record.missedVsyncs;
+    histogram.cpuTime[FramePacingBucket(record.cpuTimeUs)] += delta;
+    histogram.waitToEnd[FramePacingBucket(record.waitToEndUs)] += delta;
+    if (record.flags & kFrameLate)
+        histogram.lateFrames += delta;
+    if (record.flags & kFrameDiscarded)
+        histogram.discardedFrames += delta;
+}
+
+// Moves an in-flight frame into the log.  Must be called with s_FramePacingMutex held.
+static void CompleteFrame(uint32_t inFlightIndex, int64_t now)
+{
+    FrameInFlight& frame = s_FramePacing.inFlight[inFlightIndex];
+
+    FramePacingRecord record = {};
+    record.predictedDisplayTime = frame.predictedDisplayTime;
+    record.frameIndex = s_FramePacing.nextFrameIndex++;
+    record.cpuTimeUs = frame.begun ? (uint32_t)((now - frame.beginCalled) / 1000) : 0;
+    record.waitToEndUs = (uint32_t)((now - frame.waitReturned) / 1000);
+    record.markers = frame.begun ? s_MarkersWritten.load(std::memory_order_relaxed) - frame.markersAtBegin : 0;
+    record.missedVsyncs = frame.missedVsyncs;
+    record.flags = frame.flags;
+
+    // XrTime isn't necessarily on our clock, so a frame counts as late when it took longer than a display period to submit.
+    if (now - frame.waitReturned > frame.predictedDisplayPeriod)
+        record.flags |= kFrameLate;
+
+    if (s_FramePacing.logCount == kFramePacingLogCapacity)
+        AddToFramePacingHistogram(s_FramePacing.log[s_FramePacing.logHead], -1);
+    else
+        ++s_FramePacing.logCount;
+
+    s_FramePacing.log[s_FramePacing.logHead] = record;
+    s_FramePacing.logHead = (s_FramePacing.logHead + 1) % kFramePacingLogCapacity;
+    AddToFramePacingHistogram(record, 1);
+    ++s_FramePacing.histogram.totalFrames;
+
+    for (uint32_t i = inFlightIndex + 1; i < s_FramePacing.numInFlight; ++i)
+        s_FramePacing.inFlight[i - 1] = s_FramePacing.inFlight[i];
+    --s_FramePacing.numInFlight;
+}
+
+static void RecordWaitFrame(const XrFrameState* frameState)
+{
+    if (frameState == nullptr)
+        return;
+
+    int64_t now = CaptureTimestamp();
+    std::lock_guard<std::mutex> guard(s_FramePacingMutex);
+
+    // Frames that were waited on but never begun or ended can't be timed, drop the oldest to make room.
+    if (s_FramePacing.numInFlight == kMaxFramesInFlight)
+        CompleteFrame(0, now);
+
+    FrameInFlight& frame = s_FramePacing.inFlight[s_FramePacing.numInFlight++];
+    frame = {};
+    frame.predictedDisplayTime = frameState->predictedDisplayTime;
+    frame.predictedDisplayPeriod = frameState->predictedDisplayPeriod;
+    frame.waitReturned = now;
+    if (frameState->shouldRender)
+        frame.flags |= kFrameShouldRender;
+
+    // Predicted display time jumping by more than one period means the runtime skipped vsyncs.
+    XrTime delta = frameState->predictedDisplayTime - s_FramePacing.lastPredictedDisplayTime;
+    if (s_FramePacing.lastPredictedDisplayTime != 0 && frameState->predictedDisplayPeriod > 0 && delta > frameState->predictedDisplayPeriod * 3 / 2)
+        frame.missedVsyncs = (uint16_t)((delta + frameState->predictedDisplayPeriod / 2) / frameState->predictedDisplayPeriod - 1);
+    s_FramePacing.lastPredictedDisplayTime = frameState->predictedDisplayTime;
+}
+
+static void RecordBeginFrame(XrResult result)
+{
+    int64_t now = CaptureTimestamp();
+    std::lock_guard<std::mutex> guard(s_FramePacingMutex);
+
+    // XR_FRAME_DISCARDED: the previously begun frame was never ended.
+    if (result == XR_FRAME_DISCARDED)
+    {
+        for (uint32_t i = 0; i < s_FramePacing.numInFlight; ++i)
+        {
+            if (s_FramePacing.inFlight[i].begun)
+            {
+                s_FramePacing.inFlight[i].flags |= kFrameDiscarded;
+                CompleteFrame(i, now);
+                break;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < s_FramePacing.numInFlight; ++i)
+    {
+        FrameInFlight& frame = s_FramePacing.inFlight[i];
+        if (!frame.begun)
+        {
+            frame.begun = true;
+            frame.beginCalled = now;
+            frame.markersAtBegin = s_MarkersWritten.load(std::memory_order_relaxed);
+            break;
+        }
+    }
+}
+
+static void RecordEndFrame(const XrFrameEndInfo* frameEndInfo)
+{
+    if (frameEndInfo == nullptr)
+        return;
+
+    int64_t now = CaptureTimestamp();
+    std::lock_guard<std::mutex> guard(s_FramePacingMutex);
+
+    // Match on display time, the app has to pass back the predicted time it was given.  Fall back to the oldest begun frame.
+    uint32_t match = kMaxFramesInFlight;
+    for (uint32_t i = 0; i < s_FramePacing.numInFlight; ++i)
+    {
+        const FrameInFlight& frame = s_FramePacing.inFlight[i];
+        if (!frame.begun)
+            continue;
+        if (frame.predictedDisplayTime == frameEndInfo->displayTime)
+        {
+            match = i;
+            break;
+        }
+        if (match == kMaxFramesInFlight)
+            match = i;
+    }
+
+    if (match != kMaxFramesInFlight)
+        CompleteFrame(match, now);
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT GetFramePacingHistogram(FramePacingHistogram* histogram)
+{
+    std::lock_guard<std::mutex> guard(s_FramePacingMutex);
+    *histogram = s_FramePacing.histogram;
+    histogram->bucketWidthUs = kFramePacingBucketWidthUs;
+}
+
+// Copies up to capacity of the most recent frames, oldest first.  Returns the number of frames written.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetFramePacingLog(FramePacingRecord* records, uint32_t capacity)
+{
+    std::lock_guard<std::mutex> guard(s_FramePacingMutex);
+    uint32_t count = capacity < s_FramePacing.logCount ? capacity : s_FramePacing.logCount;
+    uint32_t start = (s_FramePacing.logHead + kFramePacingLogCapacity - count) % kFramePacingLogCapacity;
+    for (uint32_t i = 0; i < count; ++i)
+        records[i] = s_FramePacing.log[(start + i) % kFramePacingLogCapacity];
+    return count;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT ResetFramePacing()
+{
+    std::lock_guard<std::mutex> guard(s_FramePacingMutex);
+    s_FramePacing = {};
+}
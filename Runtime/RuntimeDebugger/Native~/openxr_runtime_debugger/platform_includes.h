@@ -1,5 +1,10 @@
 #pragma once
 
+// Ahead of anything that pulls in windows.h, which would otherwise bring in the older winsock.h.
+#ifdef _WIN32
+#include <winsock2.h>
+#endif
+
 #ifdef XR_USE_PLATFORM_ANDROID
 #include <jni.h>
 #include <sys/system_properties.h>
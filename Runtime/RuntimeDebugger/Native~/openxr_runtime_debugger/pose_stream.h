@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cmath>
+
+// Pose stream analytics.
+// Outputs of xrLocateSpace, xrLocateSpaces and xrLocateViews are kept natively in a struct-of-arrays ring,
+// and rolling statistics are updated per track as samples come in so long runs can be validated without
+// sending every pose to the editor.
+// A track is one (space, base space) pair, or one view of an xrLocateViews call.
+
+static const uint32_t kPoseStreamCapacity = 4096;
+static const uint32_t kMaxPoseTracks = 64;
+static const uint32_t kPoseTrackNotAView = 0xFFFFFFFF;
+
+// Rolling statistics are exponential moving averages over roughly this many samples.
+static const float kPoseStatsWindow = 64.0f;
+
+// Tracked bits are laid out the same for XrSpaceLocationFlags and XrViewStateFlags.
+static const uint32_t kPoseTrackedBits = XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+
+// Exported per-track statistics.  Layout is mirrored in c#.
+struct PoseTrackStats
+{
+    uint64_t space;
+    uint64_t baseSpace;
+    uint32_t viewIndex;
+    uint32_t sampleCount;
+
+    float positionalJitter;    // meters, rms deviation from constant linear velocity
+    float rotationalJitter;    // radians, rms deviation from constant angular velocity
+    float maxPositionalJitter; // meters
+    float maxRotationalJitter; // radians
+    float linearSpeed;         // meters / second
+    float angularSpeed;        // radians / second
+
+    uint32_t trackingLossCount;
+    uint32_t inTrackingLoss;
+    int64_t trackingLossTotal;   // nanoseconds
+    int64_t trackingLossLongest; // nanoseconds
+};
+
+struct PoseTrack
+{
+    PoseTrackStats stats;
+
+    XrTime lastTime;
+    XrPosef lastPose;
+    XrVector3f lastLinearStep; // per nanosecond
+    XrQuaternionf lastAngularStep;
+    XrTime lastStepDuration;
+    XrTime trackingLossStart;
+    uint32_t motionSamples;
+
+    float positionalJitterSq;
+    float rotationalJitterSq;
+};
+
+// Struct-of-arrays sample storage, oldest samples are overwritten.
+struct PoseStream
+{
+    XrTime time[kPoseStreamCapacity];
+    float positionX[kPoseStreamCapacity];
+    float positionY[kPoseStreamCapacity];
+    float positionZ[kPoseStreamCapacity];
+    float orientationX[kPoseStreamCapacity];
+    float orientationY[kPoseStreamCapacity];
+    float orientationZ[kPoseStreamCapacity];
+    float orientationW[kPoseStreamCapacity];
+    uint16_t flags[kPoseStreamCapacity];
+    uint16_t track[kPoseStreamCapacity];
+
+    uint32_t head;
+    uint32_t count;
+
+    PoseTrack tracks[kMaxPoseTracks];
+    uint32_t numTracks;
+};
+
+// Accessing this must be protected with s_PoseStreamMutex.
+static std::mutex s_PoseStreamMutex;
+static PoseStream s_PoseStream = {};
+
+static XrQuaternionf QuatMul(const XrQuaternionf& a, const XrQuaternionf& b)
+{
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+static XrQuaternionf QuatConjugate(const XrQuaternionf& q)
+{
+    return {-q.x, -q.y, -q.z, q.w};
+}
+
+static float QuatAngle(const XrQuaternionf& q)
+{
+    float w = std::fabs(q.w);
+    return w >= 1.0f ? 0.0f : 2.0f * std::acos(w);
+}
+
+// Scales the rotation angle of q by scale, keeping its axis.
+static XrQuaternionf QuatScaleAngle(const XrQuaternionf& q, float scale)
+{
+    float sinHalf = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+    if (sinHalf < 1e-6f)
+        return {0.0f, 0.0f, 0.0f, 1.0f};
+
+    float halfAngle = std::atan2(sinHalf, q.w) * scale;
+    float s = std::sin(halfAngle) / sinHalf;
+    return {q.x * s, q.y * s, q.z * s, std::cos(halfAngle)};
+}
+
+// Must be called with s_PoseStreamMutex held.
+static uint32_t FindOrAddPoseTrack(uint64_t space, uint64_t baseSpace, uint32_t viewIndex)
+{
+    for (uint32_t i = 0; i < s_PoseStream.numTracks; ++i)
+    {
+        const PoseTrackStats& stats = s_PoseStream.tracks[i].stats;
+        if (stats.space == space && stats.baseSpace == baseSpace && stats.viewIndex == viewIndex)
+            return i;
+    }
+
+    if (s_PoseStream.numTracks == kMaxPoseTracks)
+        return kMaxPoseTracks;
+
+    PoseTrack& track = s_PoseStream.tracks[s_PoseStream.numTracks];
+    track = {};
+    track.stats.space = space;
+    track.stats.baseSpace = baseSpace;
+    track.stats.viewIndex = viewIndex;
+    return s_PoseStream.numTracks++;
+}
+
+// Must be called with s_PoseStreamMutex held.
+static void UpdatePoseTrack(PoseTrack& track, XrTime time, const XrPosef& pose, uint32_t flags)
+{
+    PoseTrackStats& stats = track.stats;
+
+    bool tracked = (flags & kPoseTrackedBits) == kPoseTrackedBits;
+    if (!tracked && stats.inTrackingLoss == 0)
+    {
+        stats.inTrackingLoss = 1;
+        ++stats.trackingLossCount;
+        track.trackingLossStart = time;
+    }
+    else if (tracked && stats.inTrackingLoss != 0)
+    {
+        XrTime lossDuration = time - track.trackingLossStart;
+        stats.inTrackingLoss = 0;
+        stats.trackingLossTotal += lossDuration;
+        if (lossDuration > stats.trackingLossLongest)
+            stats.trackingLossLongest = lossDuration;
+    }
+
+    // Apps commonly locate the same space several times for one predicted time, only new times move the stats.
+    XrTime stepDuration = time - track.lastTime;
+    if (stats.sampleCount > 0 && stepDuration <= 0)
+        return;
+
+    ++stats.sampleCount;
+    track.lastTime = time;
+
+    // Untracked poses are runtime guesses, restart the motion model once tracking comes back.
+    if (!tracked)
+    {
+        track.motionSamples = 0;
+        return;
+    }
+
+    if (track.motionSamples > 0)
+    {
+        XrVector3f linearStep = {
+            (pose.position.x - track.lastPose.position.x) / stepDuration,
+            (pose.position.y - track.lastPose.position.y) / stepDuration,
+            (pose.position.z - track.lastPose.position.z) / stepDuration};
+        XrQuaternionf angularStep = QuatMul(pose.orientation, QuatConjugate(track.lastPose.orientation));
+
+        if (track.motionSamples > 1)
+        {
+            float alpha = 1.0f / kPoseStatsWindow;
+
+            // Deviation from where constant velocity would have put us.
+            float dx = (linearStep.x - track.lastLinearStep.x) * stepDuration;
+            float dy = (linearStep.y - track.lastLinearStep.y) * stepDuration;
+            float dz = (linearStep.z - track.lastLinearStep.z) * stepDuration;
+            float positionalError = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+            XrQuaternionf predicted = QuatScaleAngle(track.lastAngularStep, (float)stepDuration / (float)track.lastStepDuration);
+            float rotationalError = QuatAngle(QuatMul(angularStep, QuatConjugate(predicted)));
+
+            track.positionalJitterSq += alpha * (positionalError * positionalError - track.positionalJitterSq);
+            track.rotationalJitterSq += alpha * (rotationalError * rotationalError - track.rotationalJitterSq);
+            stats.positionalJitter = std::sqrt(track.positionalJitterSq);
+            stats.rotationalJitter = std::sqrt(track.rotationalJitterSq);
+            if (positionalError > stats.maxPositionalJitter)
+                stats.maxPositionalJitter = positionalError;
+            if (rotationalError > stats.maxRotationalJitter)
+                stats.maxRotationalJitter = rotationalError;
+
+            float linearSpeed = std::sqrt(linearStep.x * linearStep.x + linearStep.y * linearStep.y + linearStep.z * linearStep.z) * 1e9f;
+            float angularSpeed = QuatAngle(angularStep) / stepDuration * 1e9f;
+            stats.linearSpeed += alpha * (linearSpeed - stats.linearSpeed);
+            stats.angularSpeed += alpha * (angularSpeed - stats.angularSpeed);
+        }
+
+        track.lastLinearStep = linearStep;
+        track.lastAngularStep = angularStep;
+        track.lastStepDuration = stepDuration;
+    }
+
+    ++track.motionSamples;
+    track.lastPose = pose;
+}
+
+// Must be called with s_PoseStreamMutex held.
+static void RecordPose(uint64_t space, uint64_t baseSpace, uint32_t viewIndex, XrTime time, const XrPosef& pose, uint64_t flags)
+{
+    uint32_t trackIndex = FindOrAddPoseTrack(space, baseSpace, viewIndex);
+    if (trackIndex == kMaxPoseTracks)
+        return;
+
+    uint32_t i = s_PoseStream.head;
+    s_PoseStream.time[i] = time;
+    s_PoseStream.positionX[i] = pose.position.x;
+    s_PoseStream.positionY[i] = pose.position.y;
+    s_PoseStream.positionZ[i] = pose.position.z;
+    s_PoseStream.orientationX[i] = pose.orientation.x;
+    s_PoseStream.orientationY[i] = pose.orientation.y;
+    s_PoseStream.orientationZ[i] = pose.orientation.z;
+    s_PoseStream.orientationW[i] = pose.orientation.w;
+    s_PoseStream.flags[i] = (uint16_t)flags;
+    s_PoseStream.track[i] = (uint16_t)trackIndex;
+
+    s_PoseStream.head = (i + 1) % kPoseStreamCapacity;
+    if (s_PoseStream.count < kPoseStreamCapacity)
+        ++s_PoseStream.count;
+
+    UpdatePoseTrack(s_PoseStream.tracks[trackIndex], time, pose, (uint32_t)flags);
+}
+
+static void RecordSpaceLocation(XrSpace space, XrSpace baseSpace, XrTime time, const XrSpaceLocation* location)
+{
+    if (location == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> guard(s_PoseStreamMutex);
+    RecordPose((uint64_t)space, (uint64_t)baseSpace, kPoseTrackNotAView, time, location->pose, location->locationFlags);
+}
+
+static void RecordSpaceLocations(const XrSpacesLocateInfo* locateInfo, const XrSpaceLocations* spaceLocations)
+{
+    if (locateInfo == nullptr || spaceLocations == nullptr || spaceLocations->locations == nullptr)
+        return;
+
+    uint32_t count = locateInfo->spaceCount < spaceLocations->locationCount ? locateInfo->spaceCount : spaceLocations->locationCount;
+
+    std::lock_guard<std::mutex> guard(s_PoseStreamMutex);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const XrSpaceLocationData& location = spaceLocations->locations[i];
+        RecordPose((uint64_t)locateInfo->spaces[i], (uint64_t)locateInfo->baseSpace, kPoseTrackNotAView, locateInfo->time, location.pose, location.locationFlags);
+    }
+}
+
+static void RecordViewLocations(const XrViewLocateInfo* viewLocateInfo, const XrViewState* viewState, uint32_t viewCapacityInput, const uint32_t* viewCountOutput, const XrView* views)
+{
+    // First call of the two-call idiom only asks for the count.
+    if (viewLocateInfo == nullptr || viewState == nullptr || viewCountOutput == nullptr || views == nullptr || viewCapacityInput == 0)
+        return;
+
+    uint32_t count = *viewCountOutput < viewCapacityInput ? *viewCountOutput : viewCapacityInput;
+
+    std::lock_guard<std::mutex> guard(s_PoseStreamMutex);
+    for (uint32_t i = 0; i < count; ++i)
+        RecordPose(0, (uint64_t)viewLocateInfo->space, i, viewLocateInfo->displayTime, views[i].pose, viewState->viewStateFlags);
+}
+
+// Copies the statistics of up to capacity tracks into stats, returns the number of tracks.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetPoseStreamStats(PoseTrackStats* stats, uint32_t capacity)
+{
+    std::lock_guard<std::mutex> guard(s_PoseStreamMutex);
+    for (uint32_t i = 0; i < capacity && i < s_PoseStream.numTracks; ++i)
+        stats[i] = s_PoseStream.tracks[i].stats;
+    return s_PoseStream.numTracks;
+}
+
+// Copies the most recent samples of one track, oldest first.  positions holds 3 floats per sample, orientations 4 (xyzw).
+// Returns the number of samples written.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetPoseStreamSamples(uint32_t trackIndex, int64_t* times, float* positions, float* orientations, uint32_t* flags, uint32_t capacity)
+{
+    std::lock_guard<std::mutex> guard(s_PoseStreamMutex);
+
+    // Walk backwards from the newest sample to find where the copy starts.
+    uint32_t found = 0;
+    uint32_t start = s_PoseStream.head;
+    for (uint32_t n = 0; n < s_PoseStream.count && found < capacity; ++n)
+    {
+        start = (start + kPoseStreamCapacity - 1) % kPoseStreamCapacity;
+        if (s_PoseStream.track[start] == trackIndex)
+            ++found;
+    }
+
+    uint32_t written = 0;
+    for (uint32_t i = start; written < found; i = (i + 1) % kPoseStreamCapacity)
+    {
+        if (s_PoseStream.track[i] != trackIndex)
+            continue;
+
+        times[written] = s_PoseStream.time[i];
+        positions[written * 3 + 0] = s_PoseStream.positionX[i];
+        positions[written * 3 + 1] = s_PoseStream.positionY[i];
+        positions[written * 3 + 2] = s_PoseStream.positionZ[i];
+        orientations[written * 4 + 0] = s_PoseStream.orientationX[i];
+        orientations[written * 4 + 1] = s_PoseStream.orientationY[i];
+        orientations[written * 4 + 2] = s_PoseStream.orientationZ[i];
+        orientations[written * 4 + 3] = s_PoseStream.orientationW[i];
+        flags[written] = s_PoseStream.flags[i];
+        ++written;
+    }
+    return written;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT ResetPoseStream()
+{
+    std::lock_guard<std::mutex> guard(s_PoseStreamMutex);
+    s_PoseStream.head = 0;
+    s_PoseStream.count = 0;
+    s_PoseStream.numTracks = 0;
+}
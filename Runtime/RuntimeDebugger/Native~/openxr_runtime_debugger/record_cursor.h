@@ -0,0 +1,453 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// Read side of the capture format.
+// A cursor walks a frozen buffer (data handed out by GetDataForRead / GetLUTData, or a saved capture) one top level
+// record at a time and returns views that point straight into that buffer.  The buffer must outlive the cursor.
+// Function calls are skipped using their recorded size, consumers that want the fields parse the field span themselves.
+
+#define GEN_FUNCTION_NAME(name, ...) #name,
+static const char* const kFunctionNames[] = {XR_LIST_FUNCS(GEN_FUNCTION_NAME)};
+#undef GEN_FUNCTION_NAME
+
+#define GEN_FUNCTION_ID(name, ...) kFunctionId_##name,
+enum FunctionId : uint32_t
+{
+    XR_LIST_FUNCS(GEN_FUNCTION_ID)
+};
+#undef GEN_FUNCTION_ID
+
+static const uint32_t kFunctionCount = (uint32_t)(sizeof(kFunctionNames) / sizeof(kFunctionNames[0]));
+static const uint32_t kInvalidFunctionId = 0xFFFFFFFF;
+
+static const uint32_t kMaxRecordDepth = 64;
+
+static uint32_t FindFunctionId(const char* name)
+{
+    if (name == nullptr)
+        return kInvalidFunctionId;
+
+    // Function ids sorted by name, built once.
+    static const std::vector<uint32_t> sortedIds = []() {
+        std::vector<uint32_t> ids(kFunctionCount);
+        for (uint32_t i = 0; i < kFunctionCount; ++i)
+            ids[i] = i;
+        std::sort(ids.begin(), ids.end(), [](uint32_t a, uint32_t b) { return strcmp(kFunctionNames[a], kFunctionNames[b]) < 0; });
+        return ids;
+    }();
+
+    auto it = std::lower_bound(sortedIds.begin(), sortedIds.end(), name, [](uint32_t id, const char* n) { return strcmp(kFunctionNames[id], n) < 0; });
+    if (it == sortedIds.end() || strcmp(kFunctionNames[*it], name) != 0)
+        return kInvalidFunctionId;
+    return *it;
+}
+
+// What the field span of a RecordView (capture_format.h) covers:
+//   kStartFunctionCall    the commands between the call header and kEndFunctionCall
+//   kLUTEntryUpdateStart  the struct describing the entry
+//   kCaptureHeader        everything after the format version
+//   kCaptureDetailChanged, kCaptureCallCounts
+//                         everything after the timestamp
+//   kMarkerPush, kMarkerPop, kMarkerInstant
+//                         the marker name id, see the Markers LUT
+//   kPolledEvent          event id, LUT scope, event size and the event struct, see event_records.h
+//   anything else         everything after the command
+struct RecordCursor
+{
+    const uint8_t* data;
+    uint32_t size;
+    uint32_t offset;
+    uint32_t formatVersion;
+    const char* error;
+};
+
+static bool CursorRead(RecordCursor& cursor, uint32_t& offset, void* out, uint32_t size)
+{
+    if (size > cursor.size - offset)
+    {
+        cursor.error = "Record runs past the end of the buffer";
+        return false;
+    }
+    if (out != nullptr)
+        memcpy(out, cursor.data + offset, size);
+    offset += size;
+    return true;
+}
+
+static bool CursorReadString(RecordCursor& cursor, uint32_t& offset, const char** out)
+{
+    const void* end = memchr(cursor.data + offset, 0, cursor.size - offset);
+    if (end == nullptr)
+    {
+        cursor.error = "Unterminated string";
+        return false;
+    }
+    if (out != nullptr)
+        *out = (const char*)(cursor.data + offset);
+    offset = (uint32_t)((const uint8_t*)end - cursor.data) + 1;
+    return true;
+}
+
+static bool CursorSkipStrings(RecordCursor& cursor, uint32_t& offset, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (!CursorReadString(cursor, offset, nullptr))
+            return false;
+    }
+    return true;
+}
+
+// Walks field commands until the command that closes the current scope.
+// end is left pointing at the closing command.
+static bool CursorSkipFields(RecordCursor& cursor, uint32_t& offset, Command closing, uint32_t& end, uint32_t depth)
+{
+    if (depth > kMaxRecordDepth)
+    {
+        cursor.error = "Structs nested too deeply";
+        return false;
+    }
+
+    while (true)
+    {
+        uint32_t start = offset;
+        Command command;
+        if (!CursorRead(cursor, offset, &command, sizeof(command)))
+            return false;
+
+        switch (command)
+        {
+            case kStartStruct:
+            {
+                uint32_t structEnd;
+                if (!CursorSkipStrings(cursor, offset, 2) || !CursorSkipFields(cursor, offset, kEndStruct, structEnd, depth + 1))
+                    return false;
+                break;
+            }
+            case kFloat:
+            case kInt32:
+            case kUInt32:
+                if (!CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, 4))
+                    return false;
+                break;
+            case kInt64:
+            case kUInt64:
+                if (!CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, 8))
+                    return false;
+                break;
+            case kString:
+                if (!CursorSkipStrings(cursor, offset, 2))
+                    return false;
+                break;
+            case kLUTLookup:
+                if (!CursorRead(cursor, offset, nullptr, sizeof(LUT)) || !CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, 8))
+                    return false;
+                break;
+            case kEndStruct:
+            case kEndFunctionCall:
+                if (command != closing)
+                {
+                    cursor.error = "Mismatched end of struct / function call";
+                    return false;
+                }
+                end = start;
+                if (command == kEndFunctionCall)
+                    return CursorSkipStrings(cursor, offset, 1);
+                return true;
+            default:
+                cursor.error = "Unexpected command inside a record";
+                return false;
+        }
+    }
+}
+
+// Uses the recorded size to find the end of a call without walking its fields.
+// The record ends with kEndFunctionCall and the result string, find them from the back.
+static bool CursorFindCallEnd(RecordCursor& cursor, uint32_t start, uint32_t recordSize, uint32_t fieldsStart, uint32_t& fieldsEnd, const char** result)
+{
+    if (recordSize > cursor.size - start)
+        return false;
+
+    uint32_t recordEnd = start + recordSize;
+    if (recordEnd < fieldsStart + sizeof(Command) + 1 || cursor.data[recordEnd - 1] != 0)
+        return false;
+
+    // The byte before the result string is the last byte of kEndFunctionCall, which is 0.
+    uint32_t resultStart = recordEnd - 1;
+    while (resultStart > fieldsStart && cursor.data[resultStart - 1] != 0)
+        --resultStart;
+
+    if (resultStart < fieldsStart + sizeof(Command))
+        return false;
+
+    Command command;
+    memcpy(&command, cursor.data + resultStart - sizeof(Command), sizeof(Command));
+    if (command != kEndFunctionCall)
+        return false;
+
+    fieldsEnd = resultStart - sizeof(Command);
+    *result = (const char*)(cursor.data + resultStart);
+    return true;
+}
+
+static bool CursorReadCaptureHeader(RecordCursor& cursor, uint32_t& offset, RecordView& view)
+{
+    uint32_t magic, version;
+    if (!CursorRead(cursor, offset, &magic, sizeof(magic)) || !CursorRead(cursor, offset, &version, sizeof(version)))
+        return false;
+    if (magic != kCaptureMagic)
+    {
+        cursor.error = "Not a runtime debugger capture";
+        return false;
+    }
+    if (version == 0 || version > kCaptureFormatVersion)
+    {
+        cursor.error = "Unsupported capture format version";
+        return false;
+    }
+
+    view.fields = cursor.data + offset;
+    uint32_t endianMarker;
+    if (!CursorRead(cursor, offset, &endianMarker, sizeof(endianMarker)))
+        return false;
+    if (endianMarker != kCaptureEndianMarker)
+    {
+        cursor.error = "Capture was written with a different byte order";
+        return false;
+    }
+
+    // pointer size, type safe handles, api version
+    uint32_t commandCount;
+    if (!CursorRead(cursor, offset, nullptr, 4 + 4 + 8) || !CursorRead(cursor, offset, &commandCount, sizeof(commandCount)))
+        return false;
+
+    // Commands are only ever appended, older captures use a subset of ours.
+    if (commandCount > kCaptureCommandCount)
+    {
+        cursor.error = "Capture uses commands newer than this build";
+        return false;
+    }
+
+    // 4 table hashes, clock name, clock rate and epochs
+    if (!CursorRead(cursor, offset, nullptr, 4 * 8) || !CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, 8 + 8 + 8))
+        return false;
+
+    cursor.formatVersion = version;
+    return true;
+}
+
+static bool CursorNextRecord(RecordCursor& cursor, RecordView& view)
+{
+    view = {};
+    view.functionId = kInvalidFunctionId;
+
+    if (cursor.error != nullptr || cursor.offset >= cursor.size)
+        return false;
+
+    uint32_t start = cursor.offset;
+    uint32_t offset = start;
+    Command command;
+    if (!CursorRead(cursor, offset, &command, sizeof(command)))
+        return false;
+
+    view.command = command;
+    view.record = cursor.data + start;
+
+    switch (command)
+    {
+        case kStartFunctionCall:
+        {
+            uint32_t recordSize = 0;
+            if (cursor.formatVersion >= 2 && !CursorRead(cursor, offset, &recordSize, sizeof(recordSize)))
+                return false;
+            if (!CursorReadString(cursor, offset, &view.thread) || !CursorReadString(cursor, offset, &view.name) || !CursorRead(cursor, offset, &view.timestamp, sizeof(view.timestamp)))
+                return false;
+
+            view.functionId = FindFunctionId(view.name);
+            view.fields = cursor.data + offset;
+
+            uint32_t fieldsEnd;
+            if (recordSize != 0 && CursorFindCallEnd(cursor, start, recordSize, offset, fieldsEnd, &view.result))
+            {
+                offset = start + recordSize;
+            }
+            else
+            {
+                // No usable size (older format, or the call was truncated), walk the fields instead.
+                if (!CursorSkipFields(cursor, offset, kEndFunctionCall, fieldsEnd, 0))
+                    return false;
+                view.result = (const char*)(cursor.data + fieldsEnd + sizeof(Command));
+            }
+            view.fieldsSize = fieldsEnd - (uint32_t)(view.fields - cursor.data);
+            break;
+        }
+        case kCacheNotLargeEnough:
+            if (!CursorReadString(cursor, offset, &view.thread) || !CursorReadString(cursor, offset, &view.name) || !CursorReadString(cursor, offset, &view.result))
+                return false;
+            view.functionId = FindFunctionId(view.name);
+            break;
+        case kLUTDefineTables:
+        {
+            view.fields = cursor.data + offset;
+            uint32_t numLuts;
+            if (!CursorRead(cursor, offset, &numLuts, sizeof(numLuts)) || !CursorSkipStrings(cursor, offset, numLuts))
+                return false;
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        }
+        case kLUTEntryUpdateStart:
+        {
+            Command structCommand;
+            uint32_t structEnd;
+            if (!CursorRead(cursor, offset, nullptr, sizeof(LUT) + sizeof(uint64_t)) || !CursorReadString(cursor, offset, &view.name))
+                return false;
+            view.fields = cursor.data + offset;
+            if (!CursorRead(cursor, offset, &structCommand, sizeof(structCommand)))
+                return false;
+            if (structCommand != kStartStruct)
+            {
+                cursor.error = "LUT entry without a struct";
+                return false;
+            }
+            if (!CursorSkipStrings(cursor, offset, 2) || !CursorSkipFields(cursor, offset, kEndStruct, structEnd, 0))
+                return false;
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        }
+        case kLutEntryUpdateEnd:
+            break;
+        case kHandleLiveCounts:
+        {
+            view.fields = cursor.data + offset;
+            uint32_t numHandleTypes;
+            if (!CursorRead(cursor, offset, &numHandleTypes, sizeof(numHandleTypes)))
+                return false;
+            for (uint32_t i = 0; i < numHandleTypes; ++i)
+            {
+                if (!CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, sizeof(uint32_t)))
+                    return false;
+            }
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        }
+        case kHandleLeak:
+            view.fields = cursor.data + offset;
+            if (!CursorReadString(cursor, offset, &view.name) || !CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, sizeof(uint64_t)) || !CursorSkipStrings(cursor, offset, 1))
+                return false;
+            view.functionId = FindFunctionId(view.name);
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        case kHandleUseAfterDestroy:
+            view.fields = cursor.data + offset;
+            if (!CursorReadString(cursor, offset, &view.thread) || !CursorReadString(cursor, offset, &view.name) || !CursorSkipStrings(cursor, offset, 2) || !CursorRead(cursor, offset, nullptr, sizeof(uint64_t)))
+                return false;
+            view.functionId = FindFunctionId(view.name);
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        case kCaptureHeader:
+            if (!CursorReadCaptureHeader(cursor, offset, view))
+                return false;
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        case kCaptureDetailChanged:
+            if (!CursorRead(cursor, offset, &view.timestamp, sizeof(view.timestamp)))
+                return false;
+            view.fields = cursor.data + offset;
+            // previous and new detail, frame cost and bytes
+            if (!CursorRead(cursor, offset, nullptr, 4 + 4 + 8 + 8))
+                return false;
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        case kCaptureCallCounts:
+        {
+            if (!CursorRead(cursor, offset, &view.timestamp, sizeof(view.timestamp)))
+                return false;
+            view.fields = cursor.data + offset;
+            uint32_t numFunctions;
+            if (!CursorRead(cursor, offset, &numFunctions, sizeof(numFunctions)))
+                return false;
+            for (uint32_t i = 0; i < numFunctions; ++i)
+            {
+                if (!CursorSkipStrings(cursor, offset, 1) || !CursorRead(cursor, offset, nullptr, sizeof(uint32_t)))
+                    return false;
+            }
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        }
+        case kMarkerPush:
+        case kMarkerPop:
+        case kMarkerInstant:
+            if (!CursorReadString(cursor, offset, &view.thread) || !CursorRead(cursor, offset, &view.timestamp, sizeof(view.timestamp)))
+                return false;
+            view.fields = cursor.data + offset;
+            if (!CursorRead(cursor, offset, nullptr, sizeof(uint32_t)))
+                return false;
+            view.fieldsSize = sizeof(uint32_t);
+            break;
+        case kPolledEvent:
+        {
+            if (!CursorReadString(cursor, offset, &view.thread) || !CursorRead(cursor, offset, &view.timestamp, sizeof(view.timestamp)))
+                return false;
+            view.fields = cursor.data + offset;
+            uint32_t eventSize;
+            if (!CursorRead(cursor, offset, nullptr, sizeof(uint64_t) + sizeof(uint32_t)) || !CursorRead(cursor, offset, &eventSize, sizeof(eventSize)) ||
+                !CursorRead(cursor, offset, nullptr, eventSize))
+                return false;
+            view.fieldsSize = offset - (uint32_t)(view.fields - cursor.data);
+            break;
+        }
+        default:
+            cursor.error = "Unknown command";
+            return false;
+    }
+
+    view.recordSize = offset - start;
+    cursor.offset = offset;
+    return true;
+}
+
+// Opens a cursor over size bytes at data.  Records are assumed to be in the current format until a capture header says otherwise.
+extern "C" RecordCursor* UNITY_INTERFACE_EXPORT OpenRecordCursor(const uint8_t* data, uint32_t size)
+{
+    RecordCursor* cursor = new RecordCursor();
+    cursor->data = data;
+    cursor->size = data != nullptr ? size : 0;
+    cursor->offset = 0;
+    cursor->formatVersion = kCaptureFormatVersion;
+    cursor->error = nullptr;
+    return cursor;
+}
+
+// Returns false at the end of the buffer, or when the data is malformed (see GetRecordCursorError).
+extern "C" bool UNITY_INTERFACE_EXPORT NextRecord(RecordCursor* cursor, RecordView* view)
+{
+    return cursor != nullptr && view != nullptr && CursorNextRecord(*cursor, *view);
+}
+
+// nullptr unless NextRecord stopped on malformed data.
+extern "C" const char* UNITY_INTERFACE_EXPORT GetRecordCursorError(RecordCursor* cursor)
+{
+    return cursor != nullptr ? cursor->error : nullptr;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT CloseRecordCursor(RecordCursor* cursor)
+{
+    delete cursor;
+}
+
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetFunctionCount()
+{
+    return kFunctionCount;
+}
+
+extern "C" const char* UNITY_INTERFACE_EXPORT GetFunctionName(uint32_t functionId)
+{
+    return functionId < kFunctionCount ? kFunctionNames[functionId] : nullptr;
+}
+
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetFunctionId(const char* name)
+{
+    return FindFunctionId(name);
+}
@@ -22,6 +22,10 @@ struct RingBuf
     uint32_t cacheSize;
     OverflowMode overflowMode;
 
+    // Bytes written to the newest block, and writes that didn't fit since the last ClearWriteStats.
+    uint32_t blockSize;
+    uint32_t failedWrites;
+
     // must be pointer because of thread_local compiler bug
     std::deque<uint32_t>* offsets;
 
@@ -58,6 +62,7 @@ struct RingBuf
             free(data);
             data = nullptr;
             delete (offsets);
+            offsets = nullptr;
             cacheSize = 0;
         }
     }
@@ -66,6 +71,13 @@ struct RingBuf
     {
         if (offsets != nullptr)
             offsets->push_back(offsets->back());
+        blockSize = 0;
+    }
+
+    void ClearWriteStats()
+    {
+        blockSize = 0;
+        failedWrites = 0;
     }
 
     void DropLastBlock()
@@ -75,6 +87,16 @@ struct RingBuf
     }
 
     uint8_t* GetForWrite(uint32_t size)
+    {
+        uint8_t* ret = Allocate(size);
+        if (ret != nullptr)
+            blockSize += size;
+        else
+            ++failedWrites;
+        return ret;
+    }
+
+    uint8_t* Allocate(uint32_t size)
     {
         uint8_t* ret{nullptr};
 
@@ -164,9 +186,23 @@ struct RingBuf
         return ret;
     }
 
+    // Bytes GetForReadAndClear would hand out, over all chunks.
+    uint32_t ReadableSize() const
+    {
+        uint32_t size = 0;
+        if (offsets == nullptr)
+            return 0;
+        for (size_t i = 1; i < offsets->size(); ++i)
+        {
+            if ((*offsets)[i] > (*offsets)[i - 1])
+                size += (*offsets)[i] - (*offsets)[i - 1];
+        }
+        return size;
+    }
+
     bool HasDataForRead()
     {
-        return offsets != nullptr && offsets->size() > 1 && offsets[0] != offsets[1];
+        return offsets != nullptr && offsets->size() > 1 && (*offsets)[0] != (*offsets)[1];
     }
 
     // returns true if there is more data to read
@@ -233,6 +269,13 @@ struct RingBuf
                 {
                     memcpy(dst, ptr, size);
                 }
+                else if (overflowMode == kOverflowModeTruncate)
+                {
+                    // A failed truncating write already forgot the new block, don't write the rest of it after the previous one.
+                    while (more)
+                        more = other.GetForReadAndClear(&ptr, &size);
+                    return false;
+                }
             } while (more);
         }
         else
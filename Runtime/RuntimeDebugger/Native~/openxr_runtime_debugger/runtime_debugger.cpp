@@ -78,8 +78,20 @@ void SendToCSharpNullPtr(const char* fieldname)
 #include "serialize_nextptr.h"
 #include "serialize_external.h"
 #include "serialize_structs.h"
+#include "event_records.h"
 #include "serialize_todo.h"
 #include "serialize_nextptr_impl.h"
+#include "serialize_handle_tracking.h"
+#include "pose_stream.h"
+#include "frame_pacing.h"
+#include "debugger_stats.h"
+#include "record_cursor.h"
+#include "capture_filter.h"
+#include "dispatch_table.h"
+#include "capture_governor.h"
+#include "capture_markers.h"
+#include "stack_capture.h"
+#include "capture_stream.h"
 
 #include "serialize_funcs_specialization.h"
 #include "serialize_funcs.h"
@@ -87,6 +99,10 @@ void SendToCSharpNullPtr(const char* fieldname)
 
 extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function)
 {
+    DispatchTable& dispatch = AcquireDispatchTable(instance);
+    PFN_xrGetInstanceProcAddr getInstanceProcAddr = dispatch.getInstanceProcAddr.load(std::memory_order_relaxed);
+    s_LUTScope = dispatch.lutScope.load(std::memory_order_relaxed);
+
     StartFunctionCall("xrGetInstanceProcAddr");
     SendToCSharp("instance", instance);
     SendToCSharp("name", name);
@@ -96,15 +112,19 @@ extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrGetInstanceProcAddr(XrIns
 
     EndFunctionCall("xrGetInstanceProcAddr", "UNKNOWN FUNC");
 
-    return orig_xrGetInstanceProcAddr(instance, name, function);
+    return getInstanceProcAddr(instance, name, function);
 }
 
 extern "C" PFN_xrGetInstanceProcAddr UNITY_INTERFACE_EXPORT XRAPI_PTR HookXrInstanceProcAddr(PFN_xrGetInstanceProcAddr func, uint32_t cacheSize, uint32_t perThreadCacheSize)
 {
-    ResetLUT();
+    // Instances created through the previous hook may still be live (e.g. OpenXRRestarter), keep their LUT entries.
+    if (!HasLiveDispatchTables())
+        ResetLUT();
+    if (s_PerThreadCacheSize != perThreadCacheSize)
+        ClearThreadBufferPool();
     s_CacheSize = cacheSize;
     s_PerThreadCacheSize = perThreadCacheSize;
     s_MainDataStore.SetOverflowMode(RingBuf::kOverflowModeTruncate);
-    orig_xrGetInstanceProcAddr = func;
+    s_GlobalDispatchTable.getInstanceProcAddr.store(func, std::memory_order_relaxed);
     return xrGetInstanceProcAddr;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <deque>
 #include <mutex>
@@ -7,52 +8,50 @@
 #include <string>
 #include <thread>
 
-enum Command
-{
-    kStartFunctionCall,
-    kStartStruct,
-
-    kFloat,
-    kString,
-    kInt32,
-    kInt64,
-    kUInt32,
-    kUInt64,
-
-    kEndStruct,
-    kEndFunctionCall,
-
-    kCacheNotLargeEnough,
-
-    kLUTDefineTables,
-    kLUTEntryUpdateStart,
-    kLutEntryUpdateEnd,
-    kLUTLookup,
-
-    kEndData = 0xFFFFFFFF
-};
-
-enum LUT
-{
-    kXrPath,
-    kXrAction,
-    kXrActionSet,
-    kXrSpace,
-
-    kLUTPadding = 0xFFFFFFFF,
-};
+#include "capture_format.h"
 
 static const char* const kLutNames[] = {
     "XrPaths",
     "XrActions",
     "XrActionSets",
     "XrSpaces",
+    "Markers",
+    "Stacks",
+    "Events",
 };
 
+// LUT entries are scoped per instance, handle values from different instances can collide (XrPath especially).
+// The scope of the instance the current call belongs to goes in the upper 16 bits of the LUT written to the stream.
+thread_local uint32_t s_LUTScope = 0;
+
+static LUT ScopedLUT(LUT lut)
+{
+    return (LUT)(lut | (s_LUTScope << kLutScopeShift));
+}
+
 #include "ringbuf.h"
 
+#include "capture_header.h"
+
 static std::mutex s_DataMutex;
 
+// How often the capture path took s_DataMutex, and how often it had to wait for another thread to get it.
+static std::atomic<uint64_t> s_DataMutexAcquisitions{0};
+static std::atomic<uint64_t> s_DataMutexContentions{0};
+
+// Locks s_DataMutex from the capture path, counting contention.
+static std::unique_lock<std::mutex> LockDataMutex()
+{
+    std::unique_lock<std::mutex> lock(s_DataMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        s_DataMutexContentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+    s_DataMutexAcquisitions.fetch_add(1, std::memory_order_relaxed);
+    return lock;
+}
+
 // These get set from c# in HookXrInstanceProcAddr
 static uint32_t s_CacheSize = 0;
 static uint32_t s_PerThreadCacheSize = 0;
@@ -64,22 +63,303 @@ static RingBuf s_MainDataStore = {};
 
 static RingBuf s_LUTDataStore = {};
 
+// Bumped every time ResetLUT starts the LUT store over.  Protected with s_DataMutex.
+static uint32_t s_LUTGeneration = 0;
+
 // Thread local storage of serialized commands.
 // On EndFunctionCall they'll be moved into the static storage w/ mutex lock.
 thread_local RingBuf s_ThreadLocalDataStore = {};
 
-static void StartFunctionCall(const char* funcName)
+// Size slot of the call being written, filled in at EndFunctionCall so readers can skip whole calls.
+thread_local uint32_t* s_ThreadLocalRecordSize = nullptr;
+
+// Markers and polled events written by this thread that haven't gone out yet, see capture_markers.h and event_records.h.
+// EndFunctionCall moves them ahead of the call under the same lock, so a thread's markers and calls stay in order.
+thread_local RingBuf s_ThreadLocalMarkerStore = {};
+thread_local bool s_ThreadLocalMarkersPending = false;
+thread_local uint32_t s_ThreadLocalMarkerBytes = 0;
+
+// Set once the thread makes an OpenXR call.  Threads that never do flush their markers themselves.
+thread_local bool s_ThreadMakesCalls = false;
+
+// Markers written on any thread, frame pacing diffs this across a frame.
+static std::atomic<uint32_t> s_MarkersWritten{0};
+
+// Formatting std::thread::id goes through a stringstream, do it once per thread.
+static const std::string& CurrentThreadName()
+{
+    thread_local std::string name = []() {
+        std::stringstream ss;
+        ss << std::this_thread::get_id();
+        return ss.str();
+    }();
+    return name;
+}
+
+// Calls dropped because they didn't fit into s_MainDataStore.  Protected with s_DataMutex.
+static uint64_t s_CacheNotLargeEnoughCount = 0;
+
+// Time spent capturing the current call, excluding the call into the runtime.  0 start means the clock isn't running.
+thread_local int64_t s_CaptureCostStart = 0;
+thread_local int64_t s_CaptureCost = 0;
+
+// Capture cost and bytes stored since the last frame, summed over all threads for the capture governor.
+static std::atomic<int64_t> s_FrameCaptureCost{0};
+static std::atomic<uint64_t> s_FrameCaptureBytes{0};
+
+// Stops the capture cost clock around the call into the runtime.  Both return the time they were called at.
+static int64_t PauseCaptureCost()
+{
+    int64_t now = CaptureTimestamp();
+    if (s_CaptureCostStart != 0)
+        s_CaptureCost += now - s_CaptureCostStart;
+    s_CaptureCostStart = 0;
+    return now;
+}
+
+static int64_t ResumeCaptureCost()
 {
-    if (s_ThreadLocalDataStore.cacheSize != s_PerThreadCacheSize)
+    s_CaptureCostStart = CaptureTimestamp();
+    return s_CaptureCostStart;
+}
+
+static void CommitCaptureCost(uint32_t bytes)
+{
+    PauseCaptureCost();
+    s_FrameCaptureCost.fetch_add(s_CaptureCost, std::memory_order_relaxed);
+    s_FrameCaptureBytes.fetch_add(bytes, std::memory_order_relaxed);
+    s_CaptureCost = 0;
+}
+
+// Thread local data stores are pooled so thread churn (job systems, thread pools) doesn't leak a buffer per thread.
+// Buffers go back into the pool when their thread exits, and new ones are sized from the largest call seen so far
+// rather than always taking s_PerThreadCacheSize.
+static const uint32_t kMinThreadBufferSize = 4 * 1024;
+static const uint32_t kMaxPooledThreadBuffers = 8;
+static const uint32_t kThreadMarkerStoreSize = 4 * 1024;
+
+// Accessing the pool must be protected with s_ThreadBufferPoolMutex.
+static std::mutex s_ThreadBufferPoolMutex;
+static std::deque<RingBuf> s_PooledThreadBuffers;
+
+static std::atomic<uint32_t> s_ThreadBufferHighWaterMark{0};
+static std::atomic<uint32_t> s_LiveThreadBuffers{0};
+static std::atomic<uint64_t> s_LiveThreadBufferBytes{0};
+static std::atomic<uint64_t> s_ThreadBufferFailedWrites{0};
+
+static uint32_t GetThreadBufferSize()
+{
+    uint32_t size = kMinThreadBufferSize;
+    uint32_t wanted = s_ThreadBufferHighWaterMark.load(std::memory_order_relaxed) * 2;
+    while (size < wanted && size < s_PerThreadCacheSize)
+        size *= 2;
+    return size < s_PerThreadCacheSize ? size : s_PerThreadCacheSize;
+}
+
+static void ReleaseThreadLocalDataStore()
+{
+    if (s_ThreadLocalDataStore.data == nullptr)
+        return;
+
+    s_LiveThreadBuffers.fetch_sub(1, std::memory_order_relaxed);
+    s_LiveThreadBufferBytes.fetch_sub(s_ThreadLocalDataStore.cacheSize, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> guard(s_ThreadBufferPoolMutex);
+        if (s_PooledThreadBuffers.size() < kMaxPooledThreadBuffers && s_ThreadLocalDataStore.cacheSize <= s_PerThreadCacheSize)
+        {
+            s_ThreadLocalDataStore.Reset();
+            s_ThreadLocalDataStore.ClearWriteStats();
+            s_PooledThreadBuffers.push_back(s_ThreadLocalDataStore);
+            s_ThreadLocalDataStore = {};
+            return;
+        }
+    }
+
+    s_ThreadLocalDataStore.Destroy();
+}
+
+// Must be called with s_DataMutex held.
+static void PrepareMainDataStore();
+
+// Must be called with s_DataMutex held.
+static void PrepareLUTDataStore();
+
+// Must be called with s_DataMutex held.
+static void MoveThreadLocalMarkers()
+{
+    // Marker and event records refer to LUTs, make sure the tables are defined before they go out.
+    PrepareLUTDataStore();
+    PrepareMainDataStore();
+    if (s_MainDataStore.MoveFrom(s_ThreadLocalMarkerStore))
+        s_FrameCaptureBytes.fetch_add(s_MainDataStore.blockSize, std::memory_order_relaxed);
+    s_ThreadLocalMarkerStore.Reset();
+    s_ThreadLocalMarkersPending = false;
+    s_ThreadLocalMarkerBytes = 0;
+}
+
+static void FlushThreadLocalMarkers()
+{
+    if (!s_ThreadLocalMarkersPending)
+        return;
+
+    std::unique_lock<std::mutex> guard = LockDataMutex();
+    MoveThreadLocalMarkers();
+}
+
+// Flushes unless another thread holds s_DataMutex, in which case the markers wait for the next try.
+static void TryFlushThreadLocalMarkers()
+{
+    std::unique_lock<std::mutex> lock(s_DataMutex, std::try_to_lock);
+    if (lock.owns_lock())
+        MoveThreadLocalMarkers();
+}
+
+// Hands the thread's buffer back to the pool on thread exit.
+struct ThreadLocalDataStoreOwner
+{
+    // Touched on acquire so the thread_local is constructed (and later destroyed) on every thread that gets a buffer.
+    bool acquired;
+
+    ~ThreadLocalDataStoreOwner()
     {
+        FlushThreadLocalMarkers();
+        ReleaseThreadLocalDataStore();
+        if (s_ThreadLocalMarkerStore.data != nullptr)
+        {
+            s_LiveThreadBufferBytes.fetch_sub(s_ThreadLocalMarkerStore.cacheSize, std::memory_order_relaxed);
+            s_ThreadLocalMarkerStore.Destroy();
+        }
+    }
+};
+
+thread_local ThreadLocalDataStoreOwner s_ThreadLocalDataStoreOwner;
+
+// Markers are small and flushed often, a fixed size store is enough.  It isn't pooled.
+static void PrepareThreadLocalMarkerStore()
+{
+    if (s_ThreadLocalMarkerStore.data != nullptr)
+        return;
+
+    s_ThreadLocalMarkerStore.Create(kThreadMarkerStoreSize, RingBuf::kOverflowModeWrap);
+    s_LiveThreadBufferBytes.fetch_add(s_ThreadLocalMarkerStore.cacheSize, std::memory_order_relaxed);
+    s_ThreadLocalDataStoreOwner.acquired = true;
+}
+
+static void AcquireThreadLocalDataStore(uint32_t minSize)
+{
+    uint32_t size = GetThreadBufferSize();
+    if (size < minSize)
+        size = minSize < s_PerThreadCacheSize ? minSize : s_PerThreadCacheSize;
+    if (size == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(s_ThreadBufferPoolMutex);
+        if (!s_PooledThreadBuffers.empty())
+        {
+            s_ThreadLocalDataStore = s_PooledThreadBuffers.back();
+            s_PooledThreadBuffers.pop_back();
+        }
+    }
+
+    if (s_ThreadLocalDataStore.cacheSize < size)
+        s_ThreadLocalDataStore.Destroy();
+    s_ThreadLocalDataStore.Create(size, RingBuf::kOverflowModeWrap);
+
+    s_LiveThreadBuffers.fetch_add(1, std::memory_order_relaxed);
+    s_LiveThreadBufferBytes.fetch_add(s_ThreadLocalDataStore.cacheSize, std::memory_order_relaxed);
+    s_ThreadLocalDataStoreOwner.acquired = true;
+}
+
+static void PrepareThreadLocalDataStore()
+{
+    if (s_ThreadLocalDataStore.data == nullptr)
+    {
+        AcquireThreadLocalDataStore(0);
+        return;
+    }
+
+    // The cache size was lowered from c#, or the last call didn't fit: swap for a buffer of the right size.
+    uint32_t failedWrites = s_ThreadLocalDataStore.failedWrites;
+    if (s_ThreadLocalDataStore.cacheSize > s_PerThreadCacheSize || (failedWrites != 0 && s_ThreadLocalDataStore.cacheSize < s_PerThreadCacheSize))
+    {
+        uint32_t minSize = failedWrites != 0 ? s_ThreadLocalDataStore.cacheSize * 2 : 0;
+        s_ThreadBufferFailedWrites.fetch_add(failedWrites, std::memory_order_relaxed);
+        s_LiveThreadBuffers.fetch_sub(1, std::memory_order_relaxed);
+        s_LiveThreadBufferBytes.fetch_sub(s_ThreadLocalDataStore.cacheSize, std::memory_order_relaxed);
         s_ThreadLocalDataStore.Destroy();
-        s_ThreadLocalDataStore.Create(s_PerThreadCacheSize, RingBuf::kOverflowModeWrap);
+        AcquireThreadLocalDataStore(minSize);
+    }
+    else if (failedWrites != 0)
+    {
+        s_ThreadBufferFailedWrites.fetch_add(failedWrites, std::memory_order_relaxed);
+        s_ThreadLocalDataStore.ClearWriteStats();
+    }
+}
+
+// Remembers the largest call written so new thread buffers get sized to fit it.
+static void UpdateThreadBufferHighWaterMark(uint32_t blockSize)
+{
+    uint32_t highWaterMark = s_ThreadBufferHighWaterMark.load(std::memory_order_relaxed);
+    while (blockSize > highWaterMark && !s_ThreadBufferHighWaterMark.compare_exchange_weak(highWaterMark, blockSize, std::memory_order_relaxed))
+    {
+    }
+}
+
+// Drops pooled buffers, e.g. when the per thread cache size changes.
+static void ClearThreadBufferPool()
+{
+    std::lock_guard<std::mutex> guard(s_ThreadBufferPoolMutex);
+    for (RingBuf& buffer : s_PooledThreadBuffers)
+        buffer.Destroy();
+    s_PooledThreadBuffers.clear();
+}
+
+// Must be called with s_DataMutex held.
+static void PrepareMainDataStore()
+{
+    if (s_MainDataStore.cacheSize != s_CacheSize)
+    {
+        s_MainDataStore.Destroy();
+        s_MainDataStore.Create(s_CacheSize, RingBuf::kOverflowModeTruncate);
     }
+}
+
+// Calls that aren't captured never reach EndFunctionCall, pending markers go out ahead of them instead.
+static void FlushMarkersBeforeCall()
+{
+    s_ThreadMakesCalls = true;
+    FlushThreadLocalMarkers();
+}
+
+static void StartFunctionCall(const char* funcName)
+{
+    int64_t timestamp = CaptureTimestamp();
+    if (s_CaptureCostStart == 0)
+        s_CaptureCostStart = timestamp;
+
+    // Pending markers go out with this call in EndFunctionCall.
+    s_ThreadMakesCalls = true;
+    PrepareThreadLocalDataStore();
 
+    // Drop anything left over from a call that was abandoned (see AbandonFunctionCall).
+    s_ThreadLocalDataStore.Reset();
     s_ThreadLocalDataStore.CreateNewBlock();
     s_ThreadLocalDataStore.Write(kStartFunctionCall);
-    s_ThreadLocalDataStore.Write(std::this_thread::get_id());
+    s_ThreadLocalRecordSize = (uint32_t*)s_ThreadLocalDataStore.GetForWrite(sizeof(uint32_t));
+    s_ThreadLocalDataStore.Write(CurrentThreadName());
     s_ThreadLocalDataStore.Write(funcName);
+    s_ThreadLocalDataStore.Write(timestamp);
+}
+
+// Throws away a call started with StartFunctionCall, e.g. one restarted by StoreInLUT for a call that isn't captured.
+static void AbandonFunctionCall()
+{
+    s_ThreadLocalDataStore.Reset();
+    s_ThreadLocalRecordSize = nullptr;
+    s_CaptureCostStart = 0;
+    s_CaptureCost = 0;
 }
 
 static void StartStruct(const char* fieldName, const char* structName)
@@ -140,32 +420,50 @@ static void EndFunctionCall(const char* funcName, const char* result)
 {
     s_ThreadLocalDataStore.Write(kEndFunctionCall);
     s_ThreadLocalDataStore.Write(result);
+    UpdateThreadBufferHighWaterMark(s_ThreadLocalDataStore.blockSize);
 
-    {
-        std::lock_guard<std::mutex> guard(s_DataMutex);
+    // 0 if part of the call didn't fit, readers then have to walk the fields.
+    if (s_ThreadLocalRecordSize != nullptr)
+        *s_ThreadLocalRecordSize = s_ThreadLocalDataStore.failedWrites == 0 ? s_ThreadLocalDataStore.blockSize : 0;
+    s_ThreadLocalRecordSize = nullptr;
 
-        if (s_MainDataStore.cacheSize != s_CacheSize)
-        {
-            s_MainDataStore.Destroy();
-            s_MainDataStore.Create(s_CacheSize, RingBuf::kOverflowModeTruncate);
-        }
+    uint32_t recordSize = s_ThreadLocalDataStore.blockSize;
+    bool stored;
+    {
+        std::unique_lock<std::mutex> guard = LockDataMutex();
+        if (s_ThreadLocalMarkersPending)
+            MoveThreadLocalMarkers();
+        PrepareMainDataStore();
 
-        if (!s_MainDataStore.MoveFrom(s_ThreadLocalDataStore))
+        stored = s_MainDataStore.MoveFrom(s_ThreadLocalDataStore);
+        if (!stored)
         {
+            ++s_CacheNotLargeEnoughCount;
             s_MainDataStore.CreateNewBlock();
             s_MainDataStore.Write(kCacheNotLargeEnough);
-            s_MainDataStore.Write(std::this_thread::get_id());
+            s_MainDataStore.Write(CurrentThreadName());
             s_MainDataStore.Write(funcName);
             s_MainDataStore.Write(result);
         }
     }
+
+    CommitCaptureCost(stored ? recordSize : 0);
 }
 
-void ResetLUT()
+// Must be called with s_DataMutex held.
+static void WriteMarkerNames(RingBuf& store);
+static void ForgetKnownStacks();
+
+// Must be called with s_DataMutex held.
+static void ResetLUTLocked()
 {
     s_LUTDataStore.Destroy();
     s_LUTDataStore.Create(s_LUTCacheSize, RingBuf::kOverflowModeGrowDouble);
     s_LUTDataStore.CreateNewBlock();
+    ++s_LUTGeneration;
+
+    // The LUT store is always sent first, so the header leads every capture.
+    WriteCaptureHeader(s_LUTDataStore);
 
     // Setup LUTS
     s_LUTDataStore.Write(kLUTDefineTables);
@@ -175,17 +473,32 @@ void ResetLUT()
     {
         s_LUTDataStore.Write(kLutNames[i]);
     }
+
+    // Markers are registered once, keep their names across captures.  Stacks are written again the next time they're seen.
+    WriteMarkerNames(s_LUTDataStore);
+    ForgetKnownStacks();
 }
 
-static void StoreInLUT(const char* funcName)
+void ResetLUT()
+{
+    // The capture stream reads the LUT store from its own thread.
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    ResetLUTLocked();
+}
+
+// Starts the LUT store if it hasn't been yet.  The check and the reset happen under one lock, so two threads can't
+// both reset it, and neither can write an entry into a store that's about to be replaced.
+static void PrepareLUTDataStore()
 {
     if (s_LUTDataStore.cacheSize < s_LUTCacheSize)
-    {
-        ResetLUT();
-    }
+        ResetLUTLocked();
+}
 
+static void StoreInLUT(const char* funcName)
+{
     {
-        std::lock_guard<std::mutex> guard(s_DataMutex); // TODO: probably have a different mutex for LUT data store
+        std::unique_lock<std::mutex> guard = LockDataMutex(); // TODO: probably have a different mutex for LUT data store
+        PrepareLUTDataStore();
         s_LUTDataStore.MoveFrom(s_ThreadLocalDataStore);
     }
 
@@ -199,7 +512,7 @@ static void SendXrPathCreate(const char* funcName, XrPath path, const char* stri
     s_ThreadLocalDataStore.Reset();
     s_ThreadLocalDataStore.CreateNewBlock();
     s_ThreadLocalDataStore.Write(kLUTEntryUpdateStart);
-    s_ThreadLocalDataStore.Write(kXrPath);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrPath));
     s_ThreadLocalDataStore.Write((uint64_t)path);
     s_ThreadLocalDataStore.Write(string);
     StartStruct("", "");
@@ -211,7 +524,7 @@ static void SendXrPathCreate(const char* funcName, XrPath path, const char* stri
 static void SendXrPath(const char* fieldName, XrPath t)
 {
     s_ThreadLocalDataStore.Write(kLUTLookup);
-    s_ThreadLocalDataStore.Write(kXrPath);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrPath));
     s_ThreadLocalDataStore.Write(fieldName);
     s_ThreadLocalDataStore.Write((uint64_t)t);
 }
@@ -223,7 +536,7 @@ static void SendXrActionCreate(const char* funcName, XrAction action, const XrAc
     s_ThreadLocalDataStore.Reset();
     s_ThreadLocalDataStore.CreateNewBlock();
     s_ThreadLocalDataStore.Write(kLUTEntryUpdateStart);
-    s_ThreadLocalDataStore.Write(kXrAction);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrAction));
     s_ThreadLocalDataStore.Write((uint64_t)action);
     s_ThreadLocalDataStore.Write(createInfo->actionName);
     SendToCSharp("", createInfo);
@@ -234,7 +547,7 @@ static void SendXrActionCreate(const char* funcName, XrAction action, const XrAc
 static void SendXrAction(const char* fieldName, XrAction t)
 {
     s_ThreadLocalDataStore.Write(kLUTLookup);
-    s_ThreadLocalDataStore.Write(kXrAction);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrAction));
     s_ThreadLocalDataStore.Write(fieldName);
     s_ThreadLocalDataStore.Write((uint64_t)t);
 }
@@ -246,7 +559,7 @@ static void SendXrActionSetCreate(const char* funcName, XrActionSet actionSet, c
     s_ThreadLocalDataStore.Reset();
     s_ThreadLocalDataStore.CreateNewBlock();
     s_ThreadLocalDataStore.Write(kLUTEntryUpdateStart);
-    s_ThreadLocalDataStore.Write(kXrActionSet);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrActionSet));
     s_ThreadLocalDataStore.Write((uint64_t)actionSet);
     s_ThreadLocalDataStore.Write(createInfo->actionSetName);
     SendToCSharp("", createInfo);
@@ -257,7 +570,7 @@ static void SendXrActionSetCreate(const char* funcName, XrActionSet actionSet, c
 static void SendXrActionSet(const char* fieldName, XrActionSet t)
 {
     s_ThreadLocalDataStore.Write(kLUTLookup);
-    s_ThreadLocalDataStore.Write(kXrActionSet);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrActionSet));
     s_ThreadLocalDataStore.Write(fieldName);
     s_ThreadLocalDataStore.Write((uint64_t)t);
 }
@@ -269,7 +582,7 @@ static void SendXrActionSpaceCreate(const char* funcName, const XrActionSpaceCre
     s_ThreadLocalDataStore.Reset();
     s_ThreadLocalDataStore.CreateNewBlock();
     s_ThreadLocalDataStore.Write(kLUTEntryUpdateStart);
-    s_ThreadLocalDataStore.Write(kXrSpace);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrSpace));
     s_ThreadLocalDataStore.Write((uint64_t)*space);
     s_ThreadLocalDataStore.Write("Action Space");
     SendToCSharp("", createInfo);
@@ -297,7 +610,7 @@ static void SendXrReferenceSpaceCreate(const char* funcName, const XrReferenceSp
     s_ThreadLocalDataStore.Reset();
     s_ThreadLocalDataStore.CreateNewBlock();
     s_ThreadLocalDataStore.Write(kLUTEntryUpdateStart);
-    s_ThreadLocalDataStore.Write(kXrSpace);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrSpace));
     s_ThreadLocalDataStore.Write((uint64_t)*space);
     s_ThreadLocalDataStore.Write(GetReferenceSpaceString(createInfo->referenceSpaceType));
     SendToCSharp("", createInfo);
@@ -308,7 +621,7 @@ static void SendXrReferenceSpaceCreate(const char* funcName, const XrReferenceSp
 static void SendXrSpace(const char* fieldName, XrSpace t)
 {
     s_ThreadLocalDataStore.Write(kLUTLookup);
-    s_ThreadLocalDataStore.Write(kXrSpace);
+    s_ThreadLocalDataStore.Write(ScopedLUT(kXrSpace));
     s_ThreadLocalDataStore.Write(fieldName);
     s_ThreadLocalDataStore.Write((uint64_t)t);
 }
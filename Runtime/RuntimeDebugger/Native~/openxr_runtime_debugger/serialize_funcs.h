@@ -1,13 +1,6 @@
 #pragma once
 
-// Begin Declaration of original functions
-static PFN_xrGetInstanceProcAddr orig_xrGetInstanceProcAddr;
-
-#define GEN_ORIG_FUNC_PTRS(f, ...) \
-    static PFN_##f orig_##f;
-
-XR_LIST_FUNCS(GEN_ORIG_FUNC_PTRS)
-// End Declaration of original functions
+// Original functions live in per-instance dispatch tables, see dispatch_table.h.
 
 #define GEN_PARAMS(...) \
     __VA_ARGS__
@@ -22,28 +15,71 @@ XR_LIST_FUNCS(GEN_ORIG_FUNC_PTRS)
             SendToCSharp(#param, param[i]);                    \
     }
 
-#define GEN_FUNCS(f, ...)                                                     \
-    extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR f(__VA_ARGS__)       \
-    {                                                                         \
-        XR_BEFORE_##f(#f);                                                    \
-        StartFunctionCall(#f);                                                \
-        XrResult result = orig_##f(XR_LIST_FUNC_PARAM_NAMES_##f(GEN_PARAMS)); \
-        XR_AFTER_##f(#f);                                                     \
-        uint32_t lastCount = 0;                                               \
-        XR_LIST_FUNC_##f(SEND_PARAM_TO_CSHARP);                               \
-        XR_LIST_FUNC_ARRAYS_##f(SEND_ARRAY_TO_CSHARP);                        \
-        EndFunctionCall(#f, XrEnumStr(result));                               \
-        return result;                                                        \
+#define CHECK_HANDLE_USE(param) \
+    CheckHandleUse(__func__, #param, param);
+
+#define SEND_TOP_LEVEL_PARAM(param) \
+    SendTopLevel(#param, param);
+
+// Detail is sampled once per call, the governor may change it while the call is in flight.
+#define GEN_FUNCS(f, ...)                                                                     \
+    extern "C" XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR f(__VA_ARGS__)                       \
+    {                                                                                         \
+        DispatchTable& dispatch = DispatchTableFor(XR_LIST_FUNC_PARAM_NAMES_##f(GEN_PARAMS)); \
+        PFN_##f func = dispatch.f.load(std::memory_order_relaxed);                            \
+        s_LUTScope = dispatch.lutScope.load(std::memory_order_relaxed);                       \
+        XR_BEFORE_##f(#f);                                                                    \
+        if (HasRetiredHandles())                                                              \
+        {                                                                                     \
+            XR_LIST_FUNC_##f(CHECK_HANDLE_USE);                                               \
+        }                                                                                     \
+        CaptureDetail detail = CurrentCaptureDetail();                                        \
+        if (detail == kCaptureDetailCounts)                                                   \
+        {                                                                                     \
+            /* Not captured, but LUT entries are still needed to read later calls. */         \
+            FlushMarkersBeforeCall();                                                         \
+            PrepareThreadLocalDataStore();                                                    \
+            XrResult result = func(XR_LIST_FUNC_PARAM_NAMES_##f(GEN_PARAMS));                 \
+            XR_AFTER_##f(#f);                                                                 \
+            AbandonFunctionCall();                                                            \
+            TrackHandles(#f, result, XR_LIST_FUNC_PARAM_NAMES_##f(GEN_PARAMS));               \
+            CountCall(kFunctionId_##f);                                                       \
+            return result;                                                                    \
+        }                                                                                     \
+        StartFunctionCall(#f);                                                                \
+        int64_t callStart = PauseCaptureCost();                                               \
+        XrResult result = func(XR_LIST_FUNC_PARAM_NAMES_##f(GEN_PARAMS));                     \
+        int64_t callEnd = ResumeCaptureCost();                                                \
+        XR_AFTER_##f(#f);                                                                     \
+        TrackHandles(#f, result, XR_LIST_FUNC_PARAM_NAMES_##f(GEN_PARAMS));                   \
+        if (detail == kCaptureDetailFull)                                                     \
+        {                                                                                     \
+            uint32_t lastCount = 0;                                                           \
+            XR_LIST_FUNC_##f(SEND_PARAM_TO_CSHARP);                                           \
+            XR_LIST_FUNC_ARRAYS_##f(SEND_ARRAY_TO_CSHARP);                                    \
+        }                                                                                     \
+        else if (detail == kCaptureDetailTopLevel)                                            \
+        {                                                                                     \
+            XR_LIST_FUNC_##f(SEND_TOP_LEVEL_PARAM);                                           \
+        }                                                                                     \
+        CaptureStackIfNeeded(kFunctionId_##f, result, callEnd - callStart);                   \
+        EndFunctionCall(#f, XrEnumStr(result));                                               \
+        return result;                                                                        \
     }
 
 XR_LIST_FUNCS(GEN_FUNCS)
 
-#define GEN_FUNC_LOAD(f, ...)                                                                  \
-    if (strcmp(#f, name) == 0)                                                                 \
-    {                                                                                          \
-        auto ret = orig_xrGetInstanceProcAddr(instance, name, (PFN_xrVoidFunction*)&orig_##f); \
-        if (ret == XR_SUCCESS)                                                                 \
-            *function = (PFN_xrVoidFunction)&f;                                                \
-        EndFunctionCall(#f, XrEnumStr(ret));                                                   \
-        return ret;                                                                            \
+#define GEN_FUNC_LOAD(f, ...)                                                         \
+    if (strcmp(#f, name) == 0)                                                        \
+    {                                                                                 \
+        PFN_##f loaded = nullptr;                                                     \
+        auto ret = getInstanceProcAddr(instance, name, (PFN_xrVoidFunction*)&loaded); \
+        if (ret == XR_SUCCESS)                                                        \
+        {                                                                             \
+            dispatch.f.store(loaded, std::memory_order_relaxed);                      \
+            *function = (PFN_xrVoidFunction)&f;                                       \
+            ShareDispatchFunction(&DispatchTable::f, loaded);                         \
+        }                                                                             \
+        EndFunctionCall(#f, XrEnumStr(ret));                                          \
+        return ret;                                                                   \
     }
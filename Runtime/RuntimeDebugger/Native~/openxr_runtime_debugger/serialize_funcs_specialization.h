@@ -2,17 +2,33 @@
 
 //XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrLoadControllerModelMSFT(XrSession session, XrControllerModelKeyMSFT modelKey, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, uint8_t* buffer)
 #undef XR_BEFORE_xrLoadControllerModelMSFT
-#define XR_BEFORE_xrLoadControllerModelMSFT(funcName)                                                                        \
-    {                                                                                                                        \
-        StartFunctionCall(funcName);                                                                                         \
-        XrResult result = orig_xrLoadControllerModelMSFT(session, modelKey, bufferCapacityInput, bufferCountOutput, buffer); \
-        SendToCSharp("session", session);                                                                                    \
-        SendToCSharp("modelKey", modelKey);                                                                                  \
-        SendToCSharp("bufferCapacityInput", bufferCapacityInput);                                                            \
-        SendToCSharp("bufferCountOutput", bufferCountOutput);                                                                \
-        SendToCSharp("buffer", "<TODO>");                                                                                    \
-        EndFunctionCall("xrLoadControllerModelMSFT", XrEnumStr(result));                                                     \
-        return result;                                                                                                       \
+#define XR_BEFORE_xrLoadControllerModelMSFT(funcName)                                                                            \
+    {                                                                                                                            \
+        StartFunctionCall(funcName);                                                                                             \
+        XrResult result = func(session, modelKey, bufferCapacityInput, bufferCountOutput, buffer);                               \
+        SendToCSharp("session", session);                                                                                        \
+        SendToCSharp("modelKey", modelKey);                                                                                      \
+        SendToCSharp("bufferCapacityInput", bufferCapacityInput);                                                                \
+        SendToCSharp("bufferCountOutput", bufferCountOutput);                                                                    \
+        SendToCSharp("buffer", "<TODO>");                                                                                        \
+        EndFunctionCall("xrLoadControllerModelMSFT", XrEnumStr(result));                                                         \
+        return result;                                                                                                           \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrCreateInstance)(const XrInstanceCreateInfo* createInfo, XrInstance* instance);
+#undef XR_AFTER_xrCreateInstance
+#define XR_AFTER_xrCreateInstance(funcName)              \
+    {                                                    \
+        if (XR_SUCCEEDED(result) && instance != nullptr) \
+            AcquireDispatchTable(*instance);             \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrDestroyInstance)(XrInstance instance);
+#undef XR_AFTER_xrDestroyInstance
+#define XR_AFTER_xrDestroyInstance(funcName) \
+    {                                        \
+        if (XR_SUCCEEDED(result))            \
+            ReleaseDispatchTable(instance);  \
     }
 
 //XrResult UNITY_INTERFACE_EXPORT XRAPI_PTR xrStringToPath(XrInstance instance, const char* pathString, XrPath* path)
@@ -55,3 +71,63 @@
         if (XR_SUCCEEDED(result))                                    \
             SendXrReferenceSpaceCreate(funcName, createInfo, space); \
     }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrEndFrame)(XrSession session, const XrFrameEndInfo* frameEndInfo);
+#undef XR_AFTER_xrEndFrame
+#define XR_AFTER_xrEndFrame(funcName)     \
+    {                                     \
+        if (XR_SUCCEEDED(result))         \
+            RecordEndFrame(frameEndInfo); \
+        SendHandleLiveCountsIfChanged();  \
+        EvaluateCaptureBudget();          \
+        NotifyCaptureStream();            \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrWaitFrame)(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState);
+#undef XR_AFTER_xrWaitFrame
+#define XR_AFTER_xrWaitFrame(funcName)   \
+    {                                    \
+        if (XR_SUCCEEDED(result))        \
+            RecordWaitFrame(frameState); \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrBeginFrame)(XrSession session, const XrFrameBeginInfo* frameBeginInfo);
+#undef XR_AFTER_xrBeginFrame
+#define XR_AFTER_xrBeginFrame(funcName) \
+    {                                   \
+        if (XR_SUCCEEDED(result))       \
+            RecordBeginFrame(result);   \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrLocateSpace)(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location);
+#undef XR_AFTER_xrLocateSpace
+#define XR_AFTER_xrLocateSpace(funcName)                           \
+    {                                                              \
+        if (XR_SUCCEEDED(result))                                  \
+            RecordSpaceLocation(space, baseSpace, time, location); \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrLocateSpaces)(XrSession session, const XrSpacesLocateInfo* locateInfo, XrSpaceLocations* spaceLocations);
+#undef XR_AFTER_xrLocateSpaces
+#define XR_AFTER_xrLocateSpaces(funcName)                     \
+    {                                                         \
+        if (XR_SUCCEEDED(result))                             \
+            RecordSpaceLocations(locateInfo, spaceLocations); \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrLocateViews)(XrSession session, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views);
+#undef XR_AFTER_xrLocateViews
+#define XR_AFTER_xrLocateViews(funcName)                                                               \
+    {                                                                                                  \
+        if (XR_SUCCEEDED(result))                                                                      \
+            RecordViewLocations(viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views); \
+    }
+
+// typedef XrResult (XRAPI_PTR *PFN_xrPollEvent)(XrInstance instance, XrEventDataBuffer* eventData);
+#undef XR_AFTER_xrPollEvent
+#define XR_AFTER_xrPollEvent(funcName)                    \
+    {                                                     \
+        s_PolledEventId = 0;                              \
+        if (result == XR_SUCCESS && eventData != nullptr) \
+            WritePolledEvent(eventData);                  \
+    }
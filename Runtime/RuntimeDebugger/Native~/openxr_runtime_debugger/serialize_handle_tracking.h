@@ -0,0 +1,664 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+// Lifetime tracking for every handle type in XR_LIST_HANDLES.
+// Handles are recorded when a call hands one back through a handle out-parameter and retired by the matching xrDestroy* call.
+// Going by parameter types rather than names also catches creates such as xrTryCreateSpatialGraphStaticNodeBindingMSFT.
+// Handles returned inside structs (the completion structs of async creates) are not tracked.
+// Retired handles stay in the table so that later calls passing them can be reported as use-after-destroy.
+// Destroying a session or instance reports every descendant the application didn't destroy itself as a leak.
+#if XR_TYPE_SAFE_HANDLES
+
+#define GEN_HANDLE_TYPE_ENUM(handlename) kHandleType_##handlename,
+
+enum HandleType : uint32_t
+{
+    XR_LIST_HANDLES(GEN_HANDLE_TYPE_ENUM)
+
+    kHandleTypeCount,
+
+    kHandleTypeNone = 0xFFFFFFFF
+};
+
+#define GEN_HANDLE_TYPE_NAME(handlename) #handlename,
+
+static const char* const kHandleTypeNames[] = {
+    XR_LIST_HANDLES(GEN_HANDLE_TYPE_NAME)
+};
+
+template <typename T>
+struct HandleTypeOf
+{
+    static const HandleType value = kHandleTypeNone;
+};
+
+#define GEN_HANDLE_TYPE_OF(handlename)                            \
+    template <>                                                   \
+    struct HandleTypeOf<handlename>                               \
+    {                                                             \
+        static const HandleType value = kHandleType_##handlename; \
+    };
+
+XR_LIST_HANDLES(GEN_HANDLE_TYPE_OF)
+
+template <typename T>
+struct IsHandle : std::integral_constant<bool, HandleTypeOf<T>::value != kHandleTypeNone>
+{
+};
+
+// Non-const pointers to handles are where calls return new handles, const ones are input arrays.
+template <typename T>
+struct IsHandleOutParam : std::false_type
+{
+};
+
+template <typename T>
+struct IsHandleOutParam<T*> : IsHandle<T>
+{
+};
+
+template <typename... Args>
+struct HasHandleOutParam : std::false_type
+{
+};
+
+template <typename T, typename... Args>
+struct HasHandleOutParam<T, Args...> : std::integral_constant<bool, IsHandleOutParam<T>::value || HasHandleOutParam<Args...>::value>
+{
+};
+
+struct HandleRef
+{
+    uint64_t handle;
+    HandleType type;
+};
+
+enum HandleState : uint32_t
+{
+    kHandleStateEmpty,
+    kHandleStateLive,
+    kHandleStateDestroyed,
+};
+
+struct HandleRecord
+{
+    // Read without the lock by HandleTable::TryFind.  handle is 0 while the slot is empty and is stored last on insert.
+    std::atomic<uint64_t> handle;
+    std::atomic<HandleType> type;
+    std::atomic<HandleState> state;
+    std::atomic<uint32_t> dispatchIndex; // Dispatch table of the XrInstance the handle was created under, see DispatchIndexOf
+
+    // Only accessed with s_HandleMutex held.
+    uint64_t parent;
+    const char* createFunc;
+    HandleType parentType;
+};
+
+// Open-addressing (linear probe) table keyed on (type, handle).  Records are never removed individually,
+// destroyed ones are only dropped when the table is rebuilt and they outnumber the live ones.
+// Changes must be protected with s_HandleMutex, TryFind reads without it.  Must call Create first.
+struct HandleTable
+{
+    std::atomic<HandleRecord*> records{nullptr};
+    std::atomic<uint32_t> capacity{0};
+    uint32_t used = 0;
+    uint32_t destroyed = 0;
+
+    // Odd while Rebuild moves records around, lock-free readers retry with the lock if it changed under them.
+    std::atomic<uint32_t> version{0};
+
+    // Arrays replaced by growing.  A lock-free reader may still be probing one, so they are only freed by Destroy.
+    std::vector<HandleRecord*> replacedRecords;
+
+    void Create(uint32_t initialCapacity)
+    {
+        if (records.load(std::memory_order_relaxed) == nullptr)
+        {
+            records.store((HandleRecord*)calloc(initialCapacity, sizeof(HandleRecord)), std::memory_order_release);
+            capacity.store(initialCapacity, std::memory_order_release);
+            used = 0;
+            destroyed = 0;
+        }
+    }
+
+    void Destroy()
+    {
+        HandleRecord* current = records.load(std::memory_order_relaxed);
+        if (current != nullptr)
+        {
+            capacity.store(0, std::memory_order_relaxed);
+            records.store(nullptr, std::memory_order_relaxed);
+            free(current);
+            for (HandleRecord* replaced : replacedRecords)
+                free(replaced);
+            replacedRecords.clear();
+            used = 0;
+            destroyed = 0;
+        }
+    }
+
+    static uint32_t Hash(HandleType type, uint64_t handle)
+    {
+        uint64_t h = (handle ^ ((uint64_t)type << 56)) * 0x9E3779B97F4A7C15ull;
+        return (uint32_t)(h >> 32);
+    }
+
+    HandleRecord* Find(HandleType type, uint64_t handle)
+    {
+        HandleRecord* current = records.load(std::memory_order_relaxed);
+        if (current == nullptr)
+            return nullptr;
+
+        uint32_t mask = capacity.load(std::memory_order_relaxed) - 1;
+        for (uint32_t i = Hash(type, handle) & mask;; i = (i + 1) & mask)
+        {
+            HandleRecord& record = current[i];
+            uint64_t recordHandle = record.handle.load(std::memory_order_relaxed);
+            if (recordHandle == 0)
+                return nullptr;
+            if (recordHandle == handle && record.type.load(std::memory_order_relaxed) == type)
+                return &record;
+        }
+    }
+
+    // Looks up a handle without s_HandleMutex, so every call can check and route its handles without contending on it.
+    // Inserts and state changes are single atomic stores.  Returns false if a rebuild ran meanwhile, the caller then uses Find with the lock.
+    bool TryFind(HandleType type, uint64_t handle, HandleState& state, uint32_t& dispatchIndex) const
+    {
+        uint32_t before = version.load(std::memory_order_acquire);
+        if ((before & 1) != 0)
+            return false;
+
+        // Capacity is stored after the array it belongs to and never shrinks, so probing stays in bounds.
+        uint32_t currentCapacity = capacity.load(std::memory_order_acquire);
+        const HandleRecord* current = records.load(std::memory_order_acquire);
+
+        state = kHandleStateEmpty;
+        dispatchIndex = 0;
+        if (current != nullptr && currentCapacity != 0)
+        {
+            uint32_t mask = currentCapacity - 1;
+            uint32_t i = Hash(type, handle) & mask;
+            for (uint32_t probes = 0; probes < currentCapacity; ++probes, i = (i + 1) & mask)
+            {
+                const HandleRecord& record = current[i];
+                uint64_t recordHandle = record.handle.load(std::memory_order_acquire);
+                if (recordHandle == 0)
+                    break;
+                if (recordHandle == handle && record.type.load(std::memory_order_relaxed) == type)
+                {
+                    state = record.state.load(std::memory_order_relaxed);
+                    dispatchIndex = record.dispatchIndex.load(std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version.load(std::memory_order_relaxed) == before;
+    }
+
+    HandleRecord* FindOrInsert(HandleType type, uint64_t handle)
+    {
+        HandleRecord* record = Find(type, handle);
+        if (record != nullptr)
+            return record;
+
+        // Keep the load factor under 3/4 so probes stay short.
+        uint32_t currentCapacity = capacity.load(std::memory_order_relaxed);
+        if ((used + 1) * 4 > currentCapacity * 3)
+        {
+            if (destroyed * 2 > used)
+                Rebuild(currentCapacity, true);
+            else
+                Rebuild(currentCapacity * 2, false);
+        }
+
+        HandleRecord* current = records.load(std::memory_order_relaxed);
+        uint32_t mask = capacity.load(std::memory_order_relaxed) - 1;
+        uint32_t i = Hash(type, handle) & mask;
+        while (current[i].handle.load(std::memory_order_relaxed) != 0)
+            i = (i + 1) & mask;
+
+        record = &current[i];
+        record->state.store(kHandleStateEmpty, std::memory_order_relaxed);
+        record->type.store(type, std::memory_order_relaxed);
+        record->handle.store(handle, std::memory_order_release);
+        ++used;
+        return record;
+    }
+
+    static void Insert(HandleRecord* target, uint32_t targetCapacity, const HandleRecord& record)
+    {
+        uint32_t mask = targetCapacity - 1;
+        uint32_t i = Hash(record.type.load(std::memory_order_relaxed), record.handle.load(std::memory_order_relaxed)) & mask;
+        while (target[i].handle.load(std::memory_order_relaxed) != 0)
+            i = (i + 1) & mask;
+
+        HandleRecord& copy = target[i];
+        copy.type.store(record.type.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        copy.state.store(record.state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        copy.dispatchIndex.store(record.dispatchIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        copy.parent = record.parent;
+        copy.createFunc = record.createFunc;
+        copy.parentType = record.parentType;
+        copy.handle.store(record.handle.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // Growing moves records to a new array, dropping destroyed records compacts the array in place.
+    void Rebuild(uint32_t newCapacity, bool dropDestroyed)
+    {
+        HandleRecord* oldRecords = records.load(std::memory_order_relaxed);
+        uint32_t oldCapacity = capacity.load(std::memory_order_relaxed);
+        bool inPlace = newCapacity == oldCapacity;
+
+        HandleRecord* source = oldRecords;
+        HandleRecord* target = oldRecords;
+        if (inPlace)
+        {
+            source = (HandleRecord*)calloc(oldCapacity, sizeof(HandleRecord));
+            for (uint32_t o = 0; o < oldCapacity; ++o)
+            {
+                if (oldRecords[o].handle.load(std::memory_order_relaxed) != 0)
+                    Insert(source, oldCapacity, oldRecords[o]);
+            }
+        }
+        else
+        {
+            target = (HandleRecord*)calloc(newCapacity, sizeof(HandleRecord));
+        }
+
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (inPlace)
+        {
+            for (uint32_t i = 0; i < oldCapacity; ++i)
+                target[i].handle.store(0, std::memory_order_relaxed);
+        }
+
+        used = 0;
+        destroyed = 0;
+        for (uint32_t o = 0; o < oldCapacity; ++o)
+        {
+            const HandleRecord& record = source[o];
+            if (record.handle.load(std::memory_order_relaxed) == 0)
+                continue;
+            if (record.state.load(std::memory_order_relaxed) == kHandleStateDestroyed)
+            {
+                if (dropDestroyed)
+                    continue;
+                ++destroyed;
+            }
+
+            Insert(target, newCapacity, record);
+            ++used;
+        }
+
+        if (inPlace)
+        {
+            free(source);
+        }
+        else
+        {
+            records.store(target, std::memory_order_release);
+            capacity.store(newCapacity, std::memory_order_release);
+            replacedRecords.push_back(oldRecords);
+        }
+
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+static const uint32_t kHandleTableInitialCapacity = 256;
+
+// Accessing these must be protected with s_HandleMutex.
+static std::mutex s_HandleMutex;
+static HandleTable s_HandleTable;
+static uint32_t s_HandleLiveCounts[kHandleTypeCount] = {};
+static uint32_t s_HandleCreatedCounts[kHandleTypeCount] = {};
+static bool s_HandleLiveCountsChanged = false;
+
+// Mirrors s_HandleTable.destroyed so calls can skip use-after-destroy checks without taking the lock.
+static std::atomic<uint32_t> s_RetiredHandleCount{0};
+
+struct LeakedHandle
+{
+    uint64_t handle;
+    const char* createFunc;
+    HandleType type;
+};
+
+template <typename T>
+static HandleRef HandleRefOf(T t, std::true_type)
+{
+    return {(uint64_t)t, HandleTypeOf<T>::value};
+}
+
+template <typename T>
+static HandleRef HandleRefOf(T, std::false_type)
+{
+    return {0, kHandleTypeNone};
+}
+
+template <typename T>
+static HandleRef HandleRefOf(T t)
+{
+    return HandleRefOf(t, IsHandle<T>());
+}
+
+static HandleRef FirstHandleOf()
+{
+    return {0, kHandleTypeNone};
+}
+
+// OpenXR passes the parent (or dispatch) handle first, so this is the parent of anything a create call returns.
+template <typename T, typename... Args>
+static HandleRef FirstHandleOf(T t, Args... args)
+{
+    HandleRef ref = HandleRefOf(t);
+    if (ref.type != kHandleTypeNone)
+        return ref;
+    return FirstHandleOf(args...);
+}
+
+static void SendHandleUseAfterDestroy(const char* funcName, const char* fieldName, HandleRef ref)
+{
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    PrepareMainDataStore();
+    s_MainDataStore.CreateNewBlock();
+    s_MainDataStore.Write(kHandleUseAfterDestroy);
+    s_MainDataStore.Write(CurrentThreadName());
+    s_MainDataStore.Write(funcName);
+    s_MainDataStore.Write(fieldName);
+    s_MainDataStore.Write(kHandleTypeNames[ref.type]);
+    s_MainDataStore.Write(ref.handle);
+}
+
+static void SendHandleLeaks(const char* funcName, const std::vector<LeakedHandle>& leaks)
+{
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    PrepareMainDataStore();
+    for (const LeakedHandle& leak : leaks)
+    {
+        s_MainDataStore.CreateNewBlock();
+        s_MainDataStore.Write(kHandleLeak);
+        s_MainDataStore.Write(funcName);
+        s_MainDataStore.Write(kHandleTypeNames[leak.type]);
+        s_MainDataStore.Write(leak.handle);
+        s_MainDataStore.Write(leak.createFunc);
+    }
+}
+
+// Sends the live count of every handle type seen so far, if anything was created or destroyed since the last send.
+static void SendHandleLiveCountsIfChanged()
+{
+    uint32_t liveCounts[kHandleTypeCount];
+    uint32_t numTypes = 0;
+    {
+        std::lock_guard<std::mutex> guard(s_HandleMutex);
+        if (!s_HandleLiveCountsChanged)
+            return;
+        s_HandleLiveCountsChanged = false;
+
+        memcpy(liveCounts, s_HandleLiveCounts, sizeof(liveCounts));
+        for (uint32_t i = 0; i < kHandleTypeCount; ++i)
+        {
+            if (s_HandleCreatedCounts[i] == 0)
+                liveCounts[i] = 0xFFFFFFFF;
+            else
+                ++numTypes;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(s_DataMutex);
+    PrepareMainDataStore();
+    s_MainDataStore.CreateNewBlock();
+    s_MainDataStore.Write(kHandleLiveCounts);
+    s_MainDataStore.Write(numTypes);
+    for (uint32_t i = 0; i < kHandleTypeCount; ++i)
+    {
+        if (liveCounts[i] == 0xFFFFFFFF)
+            continue;
+        s_MainDataStore.Write(kHandleTypeNames[i]);
+        s_MainDataStore.Write(liveCounts[i]);
+    }
+}
+
+template <typename T>
+static void CheckHandleUse(const char*, const char*, T, std::false_type)
+{
+}
+
+template <typename T>
+static void CheckHandleUse(const char* funcName, const char* fieldName, T t, std::true_type)
+{
+    HandleRef ref = HandleRefOf(t);
+    if (ref.handle == 0)
+        return;
+
+    HandleState state;
+    uint32_t dispatchIndex;
+    if (!s_HandleTable.TryFind(ref.type, ref.handle, state, dispatchIndex))
+    {
+        std::lock_guard<std::mutex> guard(s_HandleMutex);
+        HandleRecord* record = s_HandleTable.Find(ref.type, ref.handle);
+        state = record != nullptr ? record->state.load(std::memory_order_relaxed) : kHandleStateEmpty;
+    }
+
+    if (state == kHandleStateDestroyed)
+        SendHandleUseAfterDestroy(funcName, fieldName, ref);
+}
+
+template <typename T>
+static void CheckHandleUse(const char* funcName, const char* fieldName, T t)
+{
+    CheckHandleUse(funcName, fieldName, t, IsHandle<T>());
+}
+
+static bool HasRetiredHandles()
+{
+    return s_RetiredHandleCount.load(std::memory_order_relaxed) != 0;
+}
+
+// Must be called with s_HandleMutex held.
+static void RetireHandle(HandleRecord& record)
+{
+    record.state.store(kHandleStateDestroyed, std::memory_order_relaxed);
+    ++s_HandleTable.destroyed;
+    --s_HandleLiveCounts[record.type.load(std::memory_order_relaxed)];
+    s_HandleLiveCountsChanged = true;
+}
+
+// Must be called with s_HandleMutex held.
+static bool IsDescendantOf(const HandleRecord& record, HandleRef ancestor)
+{
+    HandleType parentType = record.parentType;
+    uint64_t parent = record.parent;
+
+    // Handle trees in OpenXR are shallow, the depth limit only guards against cycles from reused handle values.
+    for (int depth = 0; depth < 16 && parentType != kHandleTypeNone; ++depth)
+    {
+        if (parentType == ancestor.type && parent == ancestor.handle)
+            return true;
+
+        const HandleRecord* parentRecord = s_HandleTable.Find(parentType, parent);
+        if (parentRecord == nullptr)
+            return false;
+        parentType = parentRecord->parentType;
+        parent = parentRecord->parent;
+    }
+    return false;
+}
+
+static uint32_t DispatchIndexOf(uint64_t instance); // dispatch_table.h
+
+template <typename T>
+static void TrackCreatedHandle(const char*, HandleRef, T)
+{
+}
+
+template <typename T>
+static void TrackCreatedHandle(const char*, HandleRef, T*, std::false_type)
+{
+}
+
+template <typename T>
+static void TrackCreatedHandle(const char* funcName, HandleRef parent, T* t, std::true_type)
+{
+    if (t == nullptr || *t == XR_NULL_HANDLE)
+        return;
+
+    HandleRef ref = HandleRefOf(*t);
+
+    std::lock_guard<std::mutex> guard(s_HandleMutex);
+    s_HandleTable.Create(kHandleTableInitialCapacity);
+
+    HandleRecord* record = s_HandleTable.FindOrInsert(ref.type, ref.handle);
+    HandleState state = record->state.load(std::memory_order_relaxed);
+    if (state == kHandleStateLive)
+        return;
+    if (state == kHandleStateDestroyed)
+        --s_HandleTable.destroyed;
+
+    record->parent = parent.handle;
+    record->parentType = parent.type;
+    record->createFunc = funcName;
+
+    uint32_t dispatchIndex = 0;
+    if (ref.type == kHandleType_XrInstance)
+        dispatchIndex = DispatchIndexOf(ref.handle);
+    else if (parent.type == kHandleType_XrInstance)
+        dispatchIndex = DispatchIndexOf(parent.handle);
+    else
+    {
+        const HandleRecord* parentRecord = s_HandleTable.Find(parent.type, parent.handle);
+        dispatchIndex = parentRecord != nullptr ? parentRecord->dispatchIndex.load(std::memory_order_relaxed) : 0;
+    }
+    record->dispatchIndex.store(dispatchIndex, std::memory_order_relaxed);
+    record->state.store(kHandleStateLive, std::memory_order_relaxed);
+    ++s_HandleLiveCounts[ref.type];
+    ++s_HandleCreatedCounts[ref.type];
+    s_HandleLiveCountsChanged = true;
+    s_RetiredHandleCount.store(s_HandleTable.destroyed, std::memory_order_relaxed);
+}
+
+template <typename T>
+static void TrackCreatedHandle(const char* funcName, HandleRef parent, T* t)
+{
+    TrackCreatedHandle(funcName, parent, t, IsHandle<T>());
+}
+
+static void TrackDestroyedHandle(const char* funcName, HandleRef ref)
+{
+    if (ref.type == kHandleTypeNone || ref.handle == 0)
+        return;
+
+    std::vector<LeakedHandle> leaks;
+    {
+        std::lock_guard<std::mutex> guard(s_HandleMutex);
+        HandleRecord* record = s_HandleTable.Find(ref.type, ref.handle);
+        if (record == nullptr || record->state.load(std::memory_order_relaxed) != kHandleStateLive)
+            return;
+
+        RetireHandle(*record);
+
+        // Destroying a session or instance implicitly destroys its children.  Anything still live under it leaked.
+        if (ref.type == kHandleType_XrSession || ref.type == kHandleType_XrInstance)
+        {
+            HandleRecord* records = s_HandleTable.records.load(std::memory_order_relaxed);
+            uint32_t capacity = s_HandleTable.capacity.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < capacity; ++i)
+            {
+                HandleRecord& child = records[i];
+                if (child.handle.load(std::memory_order_relaxed) == 0 || child.state.load(std::memory_order_relaxed) != kHandleStateLive || !IsDescendantOf(child, ref))
+                    continue;
+
+                leaks.push_back({child.handle.load(std::memory_order_relaxed), child.createFunc, child.type.load(std::memory_order_relaxed)});
+                RetireHandle(child);
+            }
+        }
+
+        s_RetiredHandleCount.store(s_HandleTable.destroyed, std::memory_order_relaxed);
+    }
+
+    if (!leaks.empty())
+        SendHandleLeaks(funcName, leaks);
+
+    if (ref.type == kHandleType_XrSession || ref.type == kHandleType_XrInstance)
+        SendHandleLiveCountsIfChanged();
+}
+
+template <typename... Args>
+static void TrackCreatedHandles(const char*, std::false_type, Args...)
+{
+}
+
+template <typename... Args>
+static void TrackCreatedHandles(const char* funcName, std::true_type, Args... args)
+{
+    HandleRef parent = FirstHandleOf(args...);
+    int expand[] = {0, (TrackCreatedHandle(funcName, parent, args), 0)...};
+    (void)expand;
+}
+
+template <typename... Args>
+static void TrackHandles(const char* funcName, XrResult result, Args... args)
+{
+    if (XR_FAILED(result))
+        return;
+
+    // Which calls create handles is known at compile time, only destroys are told apart by name.
+    if (HasHandleOutParam<Args...>::value)
+        TrackCreatedHandles(funcName, HasHandleOutParam<Args...>(), args...);
+    else if (strncmp(funcName, "xrDestroy", 9) == 0)
+        TrackDestroyedHandle(funcName, FirstHandleOf(args...));
+}
+
+#else
+
+template <typename T>
+static void CheckHandleUse(const char*, const char*, T)
+{
+}
+
+static bool HasRetiredHandles()
+{
+    return false;
+}
+
+template <typename... Args>
+static void TrackHandles(const char*, XrResult, Args...)
+{
+}
+
+static void SendHandleLiveCountsIfChanged()
+{
+}
+
+#endif
+
+// Fills counts with the number of live handles per handle type (indexed like GetHandleTypeName), returns the number of handle types.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetHandleLiveCounts(uint32_t* counts, uint32_t capacity)
+{
+#if XR_TYPE_SAFE_HANDLES
+    std::lock_guard<std::mutex> guard(s_HandleMutex);
+    uint32_t numTypes = capacity < kHandleTypeCount ? capacity : (uint32_t)kHandleTypeCount;
+    if (counts != nullptr)
+        memcpy(counts, s_HandleLiveCounts, numTypes * sizeof(uint32_t));
+    return kHandleTypeCount;
+#else
+    return 0;
+#endif
+}
+
+extern "C" const char* UNITY_INTERFACE_EXPORT GetHandleTypeName(uint32_t handleType)
+{
+#if XR_TYPE_SAFE_HANDLES
+    if (handleType < kHandleTypeCount)
+        return kHandleTypeNames[handleType];
+#endif
+    return nullptr;
+}
@@ -1,12 +1,5 @@
 #pragma once
 
-template <>
-void SendToCSharp<>(const char* fieldname, XrEventDataBuffer* t)
-{
-    XrEventDataBaseHeader* evt = reinterpret_cast<XrEventDataBaseHeader*>(t);
-    SendToCSharp("varying", evt);
-}
-
 template <>
 void SendToCSharp<>(const char* fieldname, XrDebugUtilsMessengerCreateInfoEXT const* t)
 {
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <unordered_set>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <unwind.h>
+#endif
+
+// Native stacks for calls that fail or take too long, to find the engine code path that made them.
+// Stacks are unwound on the calling thread right after the call, rate limited, and identified by a hash of their
+// return addresses.  The first time a stack is seen it's written to the Stacks LUT, after that the call only carries a
+// kLUTLookup of its id.
+// Frames are recorded as module+offset and not symbolized on device.  Offsets are return addresses, symbolizers
+// (addr2line, llvm-symbolizer, ...) want the offset minus 1 to land on the call instruction.
+// Calls made at kCaptureDetailCounts aren't recorded, so neither are their stacks.
+
+enum StackCaptureFlags : uint32_t
+{
+    kStackCaptureOnError = 1 << 0,    // XR_FAILED results
+    kStackCaptureOnSlowCall = 1 << 1, // the runtime took longer than slowCallNs
+};
+
+// Layout is mirrored in c#.
+struct StackCaptureSettings
+{
+    int64_t slowCallNs;
+    uint32_t flags;
+    uint32_t maxStacksPerSecond;
+};
+
+static const uint32_t kMaxStackFrames = 32;
+
+// Frames inside the debugger itself are skipped, capture a few more than are kept.
+static const uint32_t kMaxSkippedStackFrames = 8;
+
+// Read on every call, written by SetStackCapture.
+static std::atomic<uint32_t> s_StackCaptureFlags{0};
+static std::atomic<int64_t> s_StackCaptureSlowCallNs{0};
+static std::atomic<uint32_t> s_StackCaptureMaxPerSecond{0};
+static std::atomic<bool> s_StackCaptureFunctions[kFunctionCount];
+
+// Rate limit, counted per one second window.
+static std::atomic<int64_t> s_StackWindowStart{0};
+static std::atomic<uint32_t> s_StacksInWindow{0};
+static std::atomic<uint64_t> s_StacksRateLimited{0};
+
+// Accessing this must be protected with s_DataMutex.
+static std::unordered_set<uint64_t> s_KnownStacks;
+
+// Must be called with s_DataMutex held.
+static void ForgetKnownStacks()
+{
+    s_KnownStacks.clear();
+}
+
+#if defined(_WIN32)
+
+static uintptr_t GetModuleBase(uintptr_t address, const char** path)
+{
+    static thread_local char modulePath[MAX_PATH];
+    HMODULE module;
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)address, &module))
+        return 0;
+    if (path != nullptr)
+    {
+        DWORD length = GetModuleFileNameA(module, modulePath, MAX_PATH);
+        *path = length != 0 ? modulePath : nullptr;
+    }
+    return (uintptr_t)module;
+}
+
+static uint32_t UnwindStack(uintptr_t* frames, uint32_t capacity)
+{
+    return RtlCaptureStackBackTrace(0, capacity, (PVOID*)frames, nullptr);
+}
+
+#else
+
+static uintptr_t GetModuleBase(uintptr_t address, const char** path)
+{
+    Dl_info info;
+    if (dladdr((void*)address, &info) == 0)
+        return 0;
+    if (path != nullptr)
+        *path = info.dli_fname;
+    return (uintptr_t)info.dli_fbase;
+}
+
+struct StackUnwindState
+{
+    uintptr_t* frames;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+static _Unwind_Reason_Code UnwindStackFrame(struct _Unwind_Context* context, void* arg)
+{
+    StackUnwindState* state = (StackUnwindState*)arg;
+    uintptr_t ip = (uintptr_t)_Unwind_GetIP(context);
+    if (ip == 0 || state->count == state->capacity)
+        return _URC_END_OF_STACK;
+    state->frames[state->count++] = ip;
+    return _URC_NO_REASON;
+}
+
+static uint32_t UnwindStack(uintptr_t* frames, uint32_t capacity)
+{
+    StackUnwindState state = {frames, 0, capacity};
+    _Unwind_Backtrace(UnwindStackFrame, &state);
+    return state.count;
+}
+
+#endif
+
+// Unwinds the calling thread, dropping the frames at the top that are inside the debugger.
+static uint32_t CaptureStackFrames(uintptr_t* frames)
+{
+    uintptr_t unwound[kMaxStackFrames + kMaxSkippedStackFrames];
+    uint32_t count = UnwindStack(unwound, kMaxStackFrames + kMaxSkippedStackFrames);
+
+    uintptr_t debuggerModule = GetModuleBase((uintptr_t)&CaptureStackFrames, nullptr);
+    uint32_t first = 0;
+    while (first < count && first < kMaxSkippedStackFrames && GetModuleBase(unwound[first], nullptr) == debuggerModule)
+        ++first;
+
+    uint32_t kept = count - first < kMaxStackFrames ? count - first : kMaxStackFrames;
+    memcpy(frames, unwound + first, kept * sizeof(uintptr_t));
+    return kept;
+}
+
+static void DescribeStackFrame(uintptr_t address, char* buf, size_t size)
+{
+    const char* path = nullptr;
+    uintptr_t base = GetModuleBase(address, &path);
+    if (base == 0 || path == nullptr)
+    {
+        snprintf(buf, size, "0x%llx", (unsigned long long)address);
+        return;
+    }
+
+    const char* name = path;
+    for (const char* c = path; *c != 0; ++c)
+    {
+        if (*c == '/' || *c == '\\')
+            name = c + 1;
+    }
+    snprintf(buf, size, "%s+0x%llx", name, (unsigned long long)(address - base));
+}
+
+// Must be called with s_DataMutex held.
+static void WriteStack(uint64_t stackId, const uintptr_t* frames, uint32_t count)
+{
+    char frame[256];
+    DescribeStackFrame(count != 0 ? frames[0] : 0, frame, sizeof(frame));
+
+    s_LUTDataStore.CreateNewBlock();
+    s_LUTDataStore.Write(kLUTEntryUpdateStart);
+    s_LUTDataStore.Write(kStacks);
+    s_LUTDataStore.Write(stackId);
+    s_LUTDataStore.Write(frame);
+    s_LUTDataStore.Write(kStartStruct);
+    s_LUTDataStore.Write("");
+    s_LUTDataStore.Write("");
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        char index[16];
+        snprintf(index, sizeof(index), "%u", i);
+        DescribeStackFrame(frames[i], frame, sizeof(frame));
+        s_LUTDataStore.Write(kString);
+        s_LUTDataStore.Write(index);
+        s_LUTDataStore.Write(frame);
+    }
+    s_LUTDataStore.Write(kEndStruct);
+}
+
+static bool TakeStackCaptureToken()
+{
+    int64_t now = CaptureTimestamp();
+    int64_t windowStart = s_StackWindowStart.load(std::memory_order_relaxed);
+    if (now - windowStart >= 1000000000 && s_StackWindowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+        s_StacksInWindow.store(0, std::memory_order_relaxed);
+
+    if (s_StacksInWindow.fetch_add(1, std::memory_order_relaxed) < s_StackCaptureMaxPerSecond.load(std::memory_order_relaxed))
+        return true;
+
+    s_StacksRateLimited.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Called before EndFunctionCall.  Adds a "stack" field to the call when it matches the stack capture settings.
+static void CaptureStackIfNeeded(FunctionId functionId, XrResult result, int64_t callDuration)
+{
+    uint32_t flags = s_StackCaptureFlags.load(std::memory_order_relaxed);
+    if (flags == 0)
+        return;
+
+    bool matches = ((flags & kStackCaptureOnError) != 0 && XR_FAILED(result)) ||
+        ((flags & kStackCaptureOnSlowCall) != 0 && callDuration > s_StackCaptureSlowCallNs.load(std::memory_order_relaxed));
+    if (!matches || !s_StackCaptureFunctions[functionId].load(std::memory_order_relaxed) || !TakeStackCaptureToken())
+        return;
+
+    uintptr_t frames[kMaxStackFrames];
+    uint32_t count = CaptureStackFrames(frames);
+    uint64_t stackId = CaptureHash(kCaptureHashSeed, frames, count * sizeof(uintptr_t));
+
+    {
+        std::unique_lock<std::mutex> guard = LockDataMutex();
+        PrepareLUTDataStore();
+        if (s_KnownStacks.insert(stackId).second)
+            WriteStack(stackId, frames, count);
+    }
+
+    s_ThreadLocalDataStore.Write(kLUTLookup);
+    s_ThreadLocalDataStore.Write(kStacks);
+    s_ThreadLocalDataStore.Write("stack");
+    s_ThreadLocalDataStore.Write(stackId);
+}
+
+// Turns stack capture on for calls matching settings.  functionIds may be null to match all functions.  flags of 0 turns it off.
+extern "C" void UNITY_INTERFACE_EXPORT SetStackCapture(const StackCaptureSettings* settings, const uint32_t* functionIds, uint32_t functionIdCount)
+{
+    bool allFunctions = functionIds == nullptr || functionIdCount == 0;
+    for (uint32_t i = 0; i < kFunctionCount; ++i)
+        s_StackCaptureFunctions[i].store(allFunctions, std::memory_order_relaxed);
+    for (uint32_t i = 0; !allFunctions && i < functionIdCount; ++i)
+    {
+        if (functionIds[i] < kFunctionCount)
+            s_StackCaptureFunctions[functionIds[i]].store(true, std::memory_order_relaxed);
+    }
+
+    s_StackCaptureSlowCallNs.store(settings->slowCallNs, std::memory_order_relaxed);
+    s_StackCaptureMaxPerSecond.store(settings->maxStacksPerSecond, std::memory_order_relaxed);
+    s_StackCaptureFlags.store(settings->flags, std::memory_order_relaxed);
+}
+
+// Stacks not captured because of the rate limit.
+extern "C" uint64_t UNITY_INTERFACE_EXPORT GetStacksRateLimited()
+{
+    return s_StacksRateLimited.load(std::memory_order_relaxed);
+}
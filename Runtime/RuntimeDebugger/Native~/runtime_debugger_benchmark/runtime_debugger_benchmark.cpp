@@ -0,0 +1,649 @@
+// Measures the overhead openxr_runtime_debugger adds to OpenXR calls.
+//
+// The debugger is loaded in front of the mock runtime and driven with the call mix of a typical frame:
+//   xrPollEvent, xrWaitFrame, xrBeginFrame, xrSyncActions, xrLocateViews, xrEndFrame (3 layers) on the frame thread,
+//   10 xrGetActionState* and 8 xrLocateSpace on every thread.
+// Each capture mode is run with 1 to 8 threads and reports ns per call, capture bytes per frame and how often the
+// debugger's data mutex was contended.  The capture is drained every frame the way the c# side does.
+//
+// Usage: runtime_debugger_benchmark [frames]
+// mock_runtime and openxr_runtime_debugger must be loadable from the working directory or library path.
+
+#define XR_NO_PROTOTYPES
+#include <openxr/openxr.h>
+
+#include "../openxr_runtime_debugger/capture_format.h"
+#include "plugin_load.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const uint32_t kMaxThreads = 8;
+static const uint32_t kDefaultFrames = 2000;
+
+// Exports of openxr_runtime_debugger.
+typedef PFN_xrGetInstanceProcAddr (*PFN_HookXrInstanceProcAddr)(PFN_xrGetInstanceProcAddr func, uint32_t cacheSize, uint32_t perThreadCacheSize);
+typedef void (*PFN_StartDataAccess)();
+typedef bool (*PFN_GetDataForRead)(uint8_t** ptr, uint32_t* size);
+typedef uint32_t (*PFN_GetFilteredDataForRead)(uint8_t** ptr, uint32_t* size);
+typedef void (*PFN_EndDataAccess)();
+typedef void (*PFN_SetCaptureFilter)(const CaptureFilter* filter, const uint32_t* functionIds, uint32_t functionIdCount, const char* thread);
+typedef void (*PFN_ClearCaptureFilter)();
+typedef uint32_t (*PFN_GetFunctionId)(const char* name);
+typedef void (*PFN_GetDebuggerLockStats)(uint64_t* acquisitions, uint64_t* contentions);
+typedef void (*PFN_SetCaptureBudget)(const CaptureBudget* budget);
+typedef uint32_t (*PFN_GetCaptureDetail)();
+
+struct Debugger
+{
+    PluginHandle library;
+    PFN_HookXrInstanceProcAddr HookXrInstanceProcAddr;
+    PFN_StartDataAccess StartDataAccess;
+    PFN_GetDataForRead GetDataForRead;
+    PFN_GetFilteredDataForRead GetFilteredDataForRead;
+    PFN_EndDataAccess EndDataAccess;
+    PFN_SetCaptureFilter SetCaptureFilter;
+    PFN_ClearCaptureFilter ClearCaptureFilter;
+    PFN_GetFunctionId GetFunctionId;
+    PFN_GetDebuggerLockStats GetDebuggerLockStats;
+    PFN_SetCaptureBudget SetCaptureBudget;
+    PFN_GetCaptureDetail GetCaptureDetail;
+};
+
+enum CaptureMode
+{
+    kCaptureModeNone,      // debugger not loaded, calls go straight to the mock
+    kCaptureModeFull,      // default cache sizes, everything captured
+    kCaptureModeTruncated, // main cache too small for a frame, most calls are sent as kCacheNotLargeEnough
+    kCaptureModeFiltered,  // full capture drained through a filter keeping only the frame loop
+    kCaptureModeGoverned,  // default cache sizes with a capture budget most frames go over, detail is lowered to fit
+
+    kCaptureModeCount
+};
+
+static const char* const kCaptureModeNames[] = {
+    "none",
+    "full",
+    "truncated",
+    "filtered",
+    "governed",
+};
+
+struct CaptureModeSettings
+{
+    uint32_t cacheSize;
+    uint32_t perThreadCacheSize;
+    CaptureBudget budget;
+};
+
+// Full and filtered match the c# defaults in RuntimeDebuggerOpenXRFeature.
+static const CaptureModeSettings kCaptureModeSettings[] = {
+    {0, 0, {0, 0}},
+    {1024 * 1024, 50 * 1024, {0, 0}},
+    {4 * 1024, 50 * 1024, {0, 0}},
+    {1024 * 1024, 50 * 1024, {0, 0}},
+    {1024 * 1024, 50 * 1024, {50 * 1000, 0}},
+};
+
+#define TOOL_FUNCS(_)                      \
+    _(xrDestroyInstance)                   \
+    _(xrGetSystem)                         \
+    _(xrPollEvent)                         \
+    _(xrCreateSession)                     \
+    _(xrDestroySession)                    \
+    _(xrBeginSession)                      \
+    _(xrCreateReferenceSpace)              \
+    _(xrCreateActionSpace)                 \
+    _(xrLocateSpace)                       \
+    _(xrStringToPath)                      \
+    _(xrCreateActionSet)                   \
+    _(xrCreateAction)                      \
+    _(xrSuggestInteractionProfileBindings) \
+    _(xrAttachSessionActionSets)           \
+    _(xrSyncActions)                       \
+    _(xrGetActionStateBoolean)             \
+    _(xrGetActionStateFloat)               \
+    _(xrGetActionStateVector2f)            \
+    _(xrGetActionStatePose)                \
+    _(xrWaitFrame)                         \
+    _(xrBeginFrame)                        \
+    _(xrLocateViews)                       \
+    _(xrEndFrame)
+
+#include "openxr_tool.h"
+
+// Per hand: select (bool), trigger (float), thumbstick (vector2), grip and aim (pose).
+static const uint32_t kActionCount = 5;
+static const uint32_t kHandCount = 2;
+static const uint32_t kLocatedSpaceCount = 8;
+static const uint32_t kLayerCount = 3;
+static const uint32_t kViewCount = 2;
+
+struct XrState
+{
+    XrFunctions xr;
+    XrInstance instance;
+    XrSystemId systemId;
+    XrSession session;
+    XrActionSet actionSet;
+    XrAction actions[kActionCount];
+    XrPath hands[kHandCount];
+    XrSpace baseSpace;
+    XrSpace spaces[kLocatedSpaceCount];
+    XrTime predictedDisplayTime;
+};
+
+static bool CreateActions(XrState& state)
+{
+    XrActionSetCreateInfo actionSetInfo = {XR_TYPE_ACTION_SET_CREATE_INFO};
+    strcpy(actionSetInfo.actionSetName, "benchmark");
+    strcpy(actionSetInfo.localizedActionSetName, "Benchmark");
+    CHECK_XR(state.xr.xrCreateActionSet(state.instance, &actionSetInfo, &state.actionSet));
+
+    CHECK_XR(state.xr.xrStringToPath(state.instance, "/user/hand/left", &state.hands[0]));
+    CHECK_XR(state.xr.xrStringToPath(state.instance, "/user/hand/right", &state.hands[1]));
+
+    struct ActionDesc
+    {
+        const char* name;
+        XrActionType type;
+        const char* bindings[kHandCount];
+    };
+
+    static const ActionDesc kActions[kActionCount] = {
+        {"select", XR_ACTION_TYPE_BOOLEAN_INPUT, {"/user/hand/left/input/x/click", "/user/hand/right/input/a/click"}},
+        {"trigger", XR_ACTION_TYPE_FLOAT_INPUT, {"/user/hand/left/input/trigger/value", "/user/hand/right/input/trigger/value"}},
+        {"thumbstick", XR_ACTION_TYPE_VECTOR2F_INPUT, {"/user/hand/left/input/thumbstick", "/user/hand/right/input/thumbstick"}},
+        {"grip", XR_ACTION_TYPE_POSE_INPUT, {"/user/hand/left/input/grip/pose", "/user/hand/right/input/grip/pose"}},
+        {"aim", XR_ACTION_TYPE_POSE_INPUT, {"/user/hand/left/input/aim/pose", "/user/hand/right/input/aim/pose"}},
+    };
+
+    XrActionSuggestedBinding bindings[kActionCount * kHandCount];
+    for (uint32_t i = 0; i < kActionCount; ++i)
+    {
+        XrActionCreateInfo actionInfo = {XR_TYPE_ACTION_CREATE_INFO};
+        strcpy(actionInfo.actionName, kActions[i].name);
+        strcpy(actionInfo.localizedActionName, kActions[i].name);
+        actionInfo.actionType = kActions[i].type;
+        actionInfo.countSubactionPaths = kHandCount;
+        actionInfo.subactionPaths = state.hands;
+        CHECK_XR(state.xr.xrCreateAction(state.actionSet, &actionInfo, &state.actions[i]));
+
+        for (uint32_t hand = 0; hand < kHandCount; ++hand)
+        {
+            XrActionSuggestedBinding& binding = bindings[i * kHandCount + hand];
+            binding.action = state.actions[i];
+            CHECK_XR(state.xr.xrStringToPath(state.instance, kActions[i].bindings[hand], &binding.binding));
+        }
+    }
+
+    XrInteractionProfileSuggestedBinding suggested = {XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
+    CHECK_XR(state.xr.xrStringToPath(state.instance, "/interaction_profiles/oculus/touch_controller", &suggested.interactionProfile));
+    suggested.countSuggestedBindings = kActionCount * kHandCount;
+    suggested.suggestedBindings = bindings;
+    CHECK_XR(state.xr.xrSuggestInteractionProfileBindings(state.instance, &suggested));
+
+    XrSessionActionSetsAttachInfo attachInfo = {XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+    attachInfo.countActionSets = 1;
+    attachInfo.actionSets = &state.actionSet;
+    CHECK_XR(state.xr.xrAttachSessionActionSets(state.session, &attachInfo));
+    return true;
+}
+
+static bool CreateSpaces(XrState& state)
+{
+    static const XrReferenceSpaceType kReferenceSpaces[] = {
+        XR_REFERENCE_SPACE_TYPE_LOCAL,
+        XR_REFERENCE_SPACE_TYPE_STAGE,
+        XR_REFERENCE_SPACE_TYPE_VIEW,
+        XR_REFERENCE_SPACE_TYPE_LOCAL,
+    };
+
+    XrReferenceSpaceCreateInfo referenceInfo = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    referenceInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    referenceInfo.poseInReferenceSpace.orientation.w = 1.0f;
+    CHECK_XR(state.xr.xrCreateReferenceSpace(state.session, &referenceInfo, &state.baseSpace));
+
+    uint32_t space = 0;
+    for (XrReferenceSpaceType type : kReferenceSpaces)
+    {
+        referenceInfo.referenceSpaceType = type;
+        CHECK_XR(state.xr.xrCreateReferenceSpace(state.session, &referenceInfo, &state.spaces[space++]));
+    }
+
+    // Grip and aim for both hands.
+    for (uint32_t action = 3; action < kActionCount; ++action)
+    {
+        for (uint32_t hand = 0; hand < kHandCount; ++hand)
+        {
+            XrActionSpaceCreateInfo actionSpaceInfo = {XR_TYPE_ACTION_SPACE_CREATE_INFO};
+            actionSpaceInfo.action = state.actions[action];
+            actionSpaceInfo.subactionPath = state.hands[hand];
+            actionSpaceInfo.poseInActionSpace.orientation.w = 1.0f;
+            CHECK_XR(state.xr.xrCreateActionSpace(state.session, &actionSpaceInfo, &state.spaces[space++]));
+        }
+    }
+    return true;
+}
+
+static bool CreateXrState(XrState& state, PFN_xrGetInstanceProcAddr getInstanceProcAddr)
+{
+    state = {};
+    if (!CreateMockSession(state.xr, getInstanceProcAddr, "runtime_debugger_benchmark", state.instance, state.systemId, state.session))
+        return false;
+
+    return CreateActions(state) && CreateSpaces(state);
+}
+
+static void DestroyXrState(XrState& state)
+{
+    if (state.session != XR_NULL_HANDLE)
+        state.xr.xrDestroySession(state.session);
+    if (state.instance != XR_NULL_HANDLE)
+        state.xr.xrDestroyInstance(state.instance);
+    state = {};
+}
+
+// Reusable barrier, std::barrier needs c++20.
+class FrameBarrier
+{
+public:
+    explicit FrameBarrier(uint32_t count) :
+        m_Count(count) {}
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        uint32_t generation = m_Generation;
+        if (++m_Waiting == m_Count)
+        {
+            m_Waiting = 0;
+            ++m_Generation;
+            m_Condition.notify_all();
+            return;
+        }
+        m_Condition.wait(lock, [&] { return generation != m_Generation; });
+    }
+
+private:
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    uint32_t m_Count;
+    uint32_t m_Waiting = 0;
+    uint32_t m_Generation = 0;
+};
+
+struct ThreadTimes
+{
+    uint64_t callNs;
+    uint64_t calls;
+};
+
+// 10 action state gets and 8 locates, run on every thread.
+static uint64_t QueryInput(const XrState& state)
+{
+    uint64_t calls = 0;
+    XrActionStateGetInfo getInfo = {XR_TYPE_ACTION_STATE_GET_INFO};
+    for (uint32_t hand = 0; hand < kHandCount; ++hand)
+    {
+        getInfo.subactionPath = state.hands[hand];
+
+        XrActionStateBoolean boolState = {XR_TYPE_ACTION_STATE_BOOLEAN};
+        getInfo.action = state.actions[0];
+        state.xr.xrGetActionStateBoolean(state.session, &getInfo, &boolState);
+
+        XrActionStateFloat floatState = {XR_TYPE_ACTION_STATE_FLOAT};
+        getInfo.action = state.actions[1];
+        state.xr.xrGetActionStateFloat(state.session, &getInfo, &floatState);
+
+        XrActionStateVector2f vectorState = {XR_TYPE_ACTION_STATE_VECTOR2F};
+        getInfo.action = state.actions[2];
+        state.xr.xrGetActionStateVector2f(state.session, &getInfo, &vectorState);
+
+        XrActionStatePose poseState = {XR_TYPE_ACTION_STATE_POSE};
+        getInfo.action = state.actions[3];
+        state.xr.xrGetActionStatePose(state.session, &getInfo, &poseState);
+        getInfo.action = state.actions[4];
+        state.xr.xrGetActionStatePose(state.session, &getInfo, &poseState);
+        calls += 5;
+    }
+
+    for (XrSpace space : state.spaces)
+    {
+        XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION};
+        state.xr.xrLocateSpace(space, state.baseSpace, state.predictedDisplayTime, &location);
+        ++calls;
+    }
+    return calls;
+}
+
+static uint64_t BeginFrame(XrState& state)
+{
+    uint64_t calls = 0;
+    for (;;)
+    {
+        XrEventDataBuffer event = {XR_TYPE_EVENT_DATA_BUFFER};
+        ++calls;
+        if (state.xr.xrPollEvent(state.instance, &event) != XR_SUCCESS)
+            break;
+    }
+
+    XrFrameWaitInfo waitInfo = {XR_TYPE_FRAME_WAIT_INFO};
+    XrFrameState frameState = {XR_TYPE_FRAME_STATE};
+    state.xr.xrWaitFrame(state.session, &waitInfo, &frameState);
+    state.predictedDisplayTime = frameState.predictedDisplayTime;
+
+    XrFrameBeginInfo beginInfo = {XR_TYPE_FRAME_BEGIN_INFO};
+    state.xr.xrBeginFrame(state.session, &beginInfo);
+
+    XrActiveActionSet activeSet = {state.actionSet, XR_NULL_PATH};
+    XrActionsSyncInfo syncInfo = {XR_TYPE_ACTIONS_SYNC_INFO};
+    syncInfo.countActiveActionSets = 1;
+    syncInfo.activeActionSets = &activeSet;
+    state.xr.xrSyncActions(state.session, &syncInfo);
+    return calls + 3;
+}
+
+static uint64_t EndFrame(XrState& state)
+{
+    XrViewLocateInfo locateInfo = {XR_TYPE_VIEW_LOCATE_INFO};
+    locateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    locateInfo.displayTime = state.predictedDisplayTime;
+    locateInfo.space = state.baseSpace;
+    XrViewState viewState = {XR_TYPE_VIEW_STATE};
+    XrView views[kViewCount] = {{XR_TYPE_VIEW}, {XR_TYPE_VIEW}};
+    uint32_t viewCount = 0;
+    state.xr.xrLocateViews(state.session, &locateInfo, &viewState, kViewCount, &viewCount, views);
+
+    // A stereo projection layer and two quads (e.g. a HUD and a loading overlay).
+    XrCompositionLayerProjectionView projectionViews[kViewCount] = {};
+    for (uint32_t i = 0; i < kViewCount; ++i)
+    {
+        projectionViews[i].type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW;
+        projectionViews[i].pose = views[i].pose;
+        projectionViews[i].fov = views[i].fov;
+        projectionViews[i].subImage.imageRect.extent = {1024, 1024};
+        projectionViews[i].subImage.imageArrayIndex = i;
+    }
+
+    XrCompositionLayerProjection projection = {XR_TYPE_COMPOSITION_LAYER_PROJECTION};
+    projection.space = state.baseSpace;
+    projection.viewCount = kViewCount;
+    projection.views = projectionViews;
+
+    XrCompositionLayerQuad quads[kLayerCount - 1] = {};
+    for (XrCompositionLayerQuad& quad : quads)
+    {
+        quad.type = XR_TYPE_COMPOSITION_LAYER_QUAD;
+        quad.space = state.spaces[2];
+        quad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+        quad.subImage.imageRect.extent = {512, 512};
+        quad.pose.orientation.w = 1.0f;
+        quad.pose.position.z = -1.0f;
+        quad.size = {1.0f, 1.0f};
+    }
+
+    const XrCompositionLayerBaseHeader* layers[kLayerCount] = {
+        (const XrCompositionLayerBaseHeader*)&projection,
+        (const XrCompositionLayerBaseHeader*)&quads[0],
+        (const XrCompositionLayerBaseHeader*)&quads[1],
+    };
+
+    XrFrameEndInfo endInfo = {XR_TYPE_FRAME_END_INFO};
+    endInfo.displayTime = state.predictedDisplayTime;
+    endInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+    endInfo.layerCount = kLayerCount;
+    endInfo.layers = layers;
+    state.xr.xrEndFrame(state.session, &endInfo);
+    return 2;
+}
+
+// Empties the main capture store like the c# side does every frame.  Returns the bytes read.
+static uint64_t DrainCapture(const Debugger& debugger, CaptureMode mode)
+{
+    uint64_t bytes = 0;
+    uint8_t* data;
+    uint32_t size;
+    debugger.StartDataAccess();
+    if (mode == kCaptureModeFiltered)
+    {
+        debugger.GetFilteredDataForRead(&data, &size);
+        bytes += size;
+    }
+    else
+    {
+        // Ring buffer, so the data may come in two chunks.
+        bool more = true;
+        for (int i = 0; i < 2 && more; ++i)
+        {
+            more = debugger.GetDataForRead(&data, &size);
+            bytes += size;
+        }
+    }
+    debugger.EndDataAccess();
+    return bytes;
+}
+
+struct BenchmarkResult
+{
+    double nsPerCall;
+    double bytesPerFrame;
+    double drainNsPerFrame;
+    uint64_t acquisitions;
+    uint64_t contentions;
+};
+
+static void RunFrames(XrState& state, const Debugger* debugger, CaptureMode mode, uint32_t threadCount, uint32_t frames, BenchmarkResult& result)
+{
+    FrameBarrier barrier(threadCount);
+    std::vector<ThreadTimes> times(threadCount, ThreadTimes{0, 0});
+    uint64_t captureBytes = 0;
+    uint64_t drainNs = 0;
+
+    auto frameThread = [&](uint32_t threadIndex) {
+        // Accumulated locally, threads writing neighbouring entries of times would skew each other.
+        ThreadTimes threadTimes = {0, 0};
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            if (threadIndex == 0)
+            {
+                int64_t start = NowNs();
+                threadTimes.calls += BeginFrame(state);
+                threadTimes.callNs += NowNs() - start;
+            }
+            barrier.Wait();
+
+            int64_t start = NowNs();
+            threadTimes.calls += QueryInput(state);
+            threadTimes.callNs += NowNs() - start;
+            barrier.Wait();
+
+            if (threadIndex == 0)
+            {
+                start = NowNs();
+                threadTimes.calls += EndFrame(state);
+                threadTimes.callNs += NowNs() - start;
+
+                if (debugger != nullptr)
+                {
+                    start = NowNs();
+                    captureBytes += DrainCapture(*debugger, mode);
+                    drainNs += NowNs() - start;
+                }
+            }
+        }
+        times[threadIndex] = threadTimes;
+    };
+
+    uint64_t acquisitionsBefore = 0, contentionsBefore = 0;
+    if (debugger != nullptr)
+        debugger->GetDebuggerLockStats(&acquisitionsBefore, &contentionsBefore);
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(frameThread, i);
+    frameThread(0);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    result = {};
+    if (debugger != nullptr)
+    {
+        debugger->GetDebuggerLockStats(&result.acquisitions, &result.contentions);
+        result.acquisitions -= acquisitionsBefore;
+        result.contentions -= contentionsBefore;
+    }
+
+    uint64_t callNs = 0, calls = 0;
+    for (const ThreadTimes& threadTimes : times)
+    {
+        callNs += threadTimes.callNs;
+        calls += threadTimes.calls;
+    }
+    result.nsPerCall = calls != 0 ? (double)callNs / calls : 0.0;
+    result.bytesPerFrame = (double)captureBytes / frames;
+    result.drainNsPerFrame = (double)drainNs / frames;
+}
+
+static bool LoadDebugger(Debugger& debugger)
+{
+    debugger = {};
+    debugger.library = Plugin_LoadLibrary(L"openxr_runtime_debugger");
+    if (debugger.library == nullptr)
+        return false;
+
+#define LOAD_DEBUGGER_FUNC(f)                                     \
+    debugger.f = (PFN_##f)Plugin_GetSymbol(debugger.library, #f); \
+    if (debugger.f == nullptr)                                    \
+    {                                                             \
+        printf("openxr_runtime_debugger is missing %s\n", #f);    \
+        return false;                                             \
+    }
+
+    LOAD_DEBUGGER_FUNC(HookXrInstanceProcAddr)
+    LOAD_DEBUGGER_FUNC(StartDataAccess)
+    LOAD_DEBUGGER_FUNC(GetDataForRead)
+    LOAD_DEBUGGER_FUNC(GetFilteredDataForRead)
+    LOAD_DEBUGGER_FUNC(EndDataAccess)
+    LOAD_DEBUGGER_FUNC(SetCaptureFilter)
+    LOAD_DEBUGGER_FUNC(ClearCaptureFilter)
+    LOAD_DEBUGGER_FUNC(GetFunctionId)
+    LOAD_DEBUGGER_FUNC(GetDebuggerLockStats)
+    LOAD_DEBUGGER_FUNC(SetCaptureBudget)
+    LOAD_DEBUGGER_FUNC(GetCaptureDetail)
+
+#undef LOAD_DEBUGGER_FUNC
+    return true;
+}
+
+static bool RunCaptureMode(PFN_xrGetInstanceProcAddr mockGetInstanceProcAddr, const Debugger& debugger, CaptureMode mode, uint32_t frames)
+{
+    PFN_xrGetInstanceProcAddr getInstanceProcAddr = mockGetInstanceProcAddr;
+    const Debugger* activeDebugger = nullptr;
+    if (mode != kCaptureModeNone)
+    {
+        const CaptureModeSettings& settings = kCaptureModeSettings[mode];
+        getInstanceProcAddr = debugger.HookXrInstanceProcAddr(mockGetInstanceProcAddr, settings.cacheSize, settings.perThreadCacheSize);
+        activeDebugger = &debugger;
+        debugger.SetCaptureBudget(&settings.budget);
+
+        if (mode == kCaptureModeFiltered)
+        {
+            const uint32_t functionIds[] = {debugger.GetFunctionId("xrWaitFrame"), debugger.GetFunctionId("xrEndFrame")};
+            CaptureFilter filter = {};
+            debugger.SetCaptureFilter(&filter, functionIds, 2, nullptr);
+        }
+        else
+        {
+            debugger.ClearCaptureFilter();
+        }
+    }
+
+    for (uint32_t threadCount = 1; threadCount <= kMaxThreads; threadCount *= 2)
+    {
+        XrState state;
+        if (!CreateXrState(state, getInstanceProcAddr))
+        {
+            DestroyXrState(state);
+            return false;
+        }
+
+        // Warm up so thread buffers and the LUT store have grown to their working size.
+        BenchmarkResult result;
+        RunFrames(state, activeDebugger, mode, threadCount, frames / 10 + 1, result);
+        RunFrames(state, activeDebugger, mode, threadCount, frames, result);
+
+        double contention = result.acquisitions != 0 ? 100.0 * result.contentions / result.acquisitions : 0.0;
+        printf("%-10s %7u %10.1f %14.0f %12.0f %12llu %10.2f%%\n",
+            kCaptureModeNames[mode],
+            threadCount,
+            result.nsPerCall,
+            result.bytesPerFrame,
+            result.drainNsPerFrame,
+            (unsigned long long)result.contentions,
+            contention);
+        if (mode == kCaptureModeGoverned)
+            printf("%-10s %7s capture detail settled at %u\n", "", "", activeDebugger->GetCaptureDetail());
+
+        DestroyXrState(state);
+    }
+
+    if (mode == kCaptureModeFiltered)
+        debugger.ClearCaptureFilter();
+    if (mode == kCaptureModeGoverned)
+    {
+        CaptureBudget noBudget = {};
+        debugger.SetCaptureBudget(&noBudget);
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : kDefaultFrames;
+    if (frames == 0)
+        frames = kDefaultFrames;
+
+    PluginHandle mock = Plugin_LoadLibrary(L"mock_runtime");
+    if (mock == nullptr)
+    {
+        printf("Failed to load mock_runtime\n");
+        return 1;
+    }
+
+    PFN_xrGetInstanceProcAddr mockGetInstanceProcAddr = (PFN_xrGetInstanceProcAddr)Plugin_GetSymbol(mock, "xrGetInstanceProcAddr");
+    if (mockGetInstanceProcAddr == nullptr)
+    {
+        printf("mock_runtime is missing xrGetInstanceProcAddr\n");
+        return 1;
+    }
+
+    Debugger debugger;
+    if (!LoadDebugger(debugger))
+    {
+        printf("Failed to load openxr_runtime_debugger\n");
+        return 1;
+    }
+
+    printf("%u frames per run\n", frames);
+    printf("%-10s %7s %10s %14s %12s %12s %11s\n", "mode", "threads", "ns/call", "bytes/frame", "drain ns", "contended", "contention");
+
+    int exitCode = 0;
+    for (int mode = 0; mode < kCaptureModeCount; ++mode)
+    {
+        if (!RunCaptureMode(mockGetInstanceProcAddr, debugger, (CaptureMode)mode, frames))
+        {
+            printf("%s capture mode failed\n", kCaptureModeNames[mode]);
+            exitCode = 1;
+        }
+    }
+
+    Plugin_FreeLibrary(debugger.library);
+    Plugin_FreeLibrary(mock);
+    return exitCode;
+}
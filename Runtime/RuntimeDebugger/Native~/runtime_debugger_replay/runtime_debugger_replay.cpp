@@ -0,0 +1,1474 @@
+// Replays a runtime debugger capture against the mock runtime.
+//
+// The recorded OpenXR calls are re-issued against mock_runtime on the schedule they were recorded at, with the handles
+// and paths they refer to rebuilt from the capture's LUT records.  Every replayed result is compared with the recorded
+// one and the calls that returned something else are reported, so a capture taken on a device can be rerun on a
+// desktop as a load test.
+//
+// Captures are read as:
+//   - a file saved from the Runtime Debugger window, decompressed first (gzip -dc capture.openxrdump > capture.bin)
+//   - a recording of the capture stream (see capture_stream.h), e.g. nc 127.0.0.1 7960 > capture.bin
+//   - raw records, as handed out by GetLUTData and GetDataForRead
+//
+// Calls are replayed on one thread in timestamp order.  The mock runtime is thread safe, but calls of recorded threads
+// depend on each other (handles created on one thread are used on another, xrWaitFrame gates xrBeginFrame), and one
+// thread keeps that order as recorded and the results comparable between runs.  Objects the capture uses but whose
+// creation it lost (the capture cache wraps) are created up front: the instance and session with defaults, action sets,
+// actions and spaces from their LUT entries.  Only the calls in kReplayFunctions are replayed, and only
+// if they were captured at full detail.  The rest are counted as skipped.  Composition layers aren't rebuilt, xrEndFrame
+// is replayed without layers, and recorded times are replaced with the display time predicted by the last xrWaitFrame.
+//
+// Usage: runtime_debugger_replay <capture> [--speed <factor>] [--max-divergences <count>]
+//   --speed 0 replays as fast as possible, 2 twice as fast as recorded.  Defaults to 1.
+//   --max-divergences limits how many divergent calls are listed, all of them are counted.  Defaults to 20.
+// mock_runtime and openxr_runtime_debugger must be loadable from the working directory or library path.
+// Exits with 0 when every replayed call returned what it did in the capture, 2 when some diverged and 1 on errors.
+
+#define XR_NO_PROTOTYPES
+#include <openxr/openxr.h>
+#include <openxr/openxr_reflection.h>
+
+#include "../openxr_runtime_debugger/capture_format.h"
+#include "plugin_load.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static const double kDefaultSpeed = 1.0;
+static const uint32_t kDefaultMaxDivergences = 20;
+static const uint32_t kMaxReplayViews = 16;
+
+// First bytes of a capture saved from the Runtime Debugger window, followed by a file version byte.  See DebuggerState.Header.
+static const uint8_t kSavedCaptureHeader[] = {0xea, 0x24, 0x39, 0x5c, 0xe0, 0xac, 0x79};
+
+// Exports of openxr_runtime_debugger.
+typedef void* (*PFN_OpenRecordCursor)(const uint8_t* data, uint32_t size);
+typedef bool (*PFN_NextRecord)(void* cursor, RecordView* view);
+typedef const char* (*PFN_GetRecordCursorError)(void* cursor);
+typedef void (*PFN_CloseRecordCursor)(void* cursor);
+
+struct Debugger
+{
+    PluginHandle library;
+    PFN_OpenRecordCursor OpenRecordCursor;
+    PFN_NextRecord NextRecord;
+    PFN_GetRecordCursorError GetRecordCursorError;
+    PFN_CloseRecordCursor CloseRecordCursor;
+};
+
+#define TOOL_FUNCS(_)                      \
+    _(xrDestroyInstance)                   \
+    _(xrGetSystem)                         \
+    _(xrPollEvent)                         \
+    _(xrCreateSession)                     \
+    _(xrDestroySession)                    \
+    _(xrBeginSession)                      \
+    _(xrEndSession)                        \
+    _(xrRequestExitSession)                \
+    _(xrCreateReferenceSpace)              \
+    _(xrCreateActionSpace)                 \
+    _(xrDestroySpace)                      \
+    _(xrLocateSpace)                       \
+    _(xrStringToPath)                      \
+    _(xrCreateActionSet)                   \
+    _(xrDestroyActionSet)                  \
+    _(xrCreateAction)                      \
+    _(xrDestroyAction)                     \
+    _(xrSuggestInteractionProfileBindings) \
+    _(xrAttachSessionActionSets)           \
+    _(xrSyncActions)                       \
+    _(xrGetActionStateBoolean)             \
+    _(xrGetActionStateFloat)               \
+    _(xrGetActionStateVector2f)            \
+    _(xrGetActionStatePose)                \
+    _(xrWaitFrame)                         \
+    _(xrBeginFrame)                        \
+    _(xrLocateViews)                       \
+    _(xrEndFrame)
+
+#include "openxr_tool.h"
+
+// One field of a recorded call or LUT entry.  Names of nested fields are joined with '.', e.g. createInfo.poseInReferenceSpace.position.x.
+// Arrays repeat their name once per element.  Strings point into the capture.
+struct ReplayField
+{
+    std::string path;
+    uint32_t command; // kStartStruct for structs, string is then the struct type
+    uint32_t lut;     // kLUTLookup only
+    uint64_t value;   // integers, handles and paths
+    float number;     // kFloat only
+    const char* string;
+};
+
+struct ReplayFields
+{
+    std::vector<ReplayField> fields;
+
+    const ReplayField* Find(const std::string& path) const
+    {
+        for (const ReplayField& field : fields)
+        {
+            if (field.path == path)
+                return &field;
+        }
+        return nullptr;
+    }
+
+    std::vector<const ReplayField*> FindAll(const std::string& path) const
+    {
+        std::vector<const ReplayField*> found;
+        for (const ReplayField& field : fields)
+        {
+            if (field.path == path)
+                found.push_back(&field);
+        }
+        return found;
+    }
+
+    uint64_t Value(const std::string& path) const
+    {
+        const ReplayField* field = Find(path);
+        return field != nullptr ? field->value : 0;
+    }
+
+    float Number(const std::string& path) const
+    {
+        const ReplayField* field = Find(path);
+        return field != nullptr ? field->number : 0.0f;
+    }
+
+    const char* String(const std::string& path) const
+    {
+        const ReplayField* field = Find(path);
+        return field != nullptr && field->string != nullptr ? field->string : "";
+    }
+};
+
+static bool ReadFieldBytes(const uint8_t* data, uint32_t size, uint32_t& offset, void* out, uint32_t count)
+{
+    if (count > size - offset)
+        return false;
+    memcpy(out, data + offset, count);
+    offset += count;
+    return true;
+}
+
+static bool ReadFieldString(const uint8_t* data, uint32_t size, uint32_t& offset, const char** out)
+{
+    const void* end = memchr(data + offset, 0, size - offset);
+    if (end == nullptr)
+        return false;
+    *out = (const char*)(data + offset);
+    offset = (uint32_t)((const uint8_t*)end - data) + 1;
+    return true;
+}
+
+static std::string JoinFieldPath(const std::vector<std::string>& scope, const char* name)
+{
+    if (scope.empty() || scope.back().empty())
+        return name;
+    if (name[0] == 0)
+        return scope.back();
+    return scope.back() + "." + name;
+}
+
+// Flattens the field span of a call or LUT entry (see RecordView).
+static bool ParseFields(const uint8_t* data, uint32_t size, ReplayFields& out)
+{
+    std::vector<std::string> scope;
+    uint32_t offset = 0;
+    while (offset < size)
+    {
+        uint32_t command;
+        const char* name;
+        if (!ReadFieldBytes(data, size, offset, &command, sizeof(command)))
+            return false;
+
+        if (command == kEndStruct)
+        {
+            if (scope.empty())
+                return false;
+            scope.pop_back();
+            continue;
+        }
+
+        ReplayField field = {};
+        field.command = command;
+        if (command == kLUTLookup && !ReadFieldBytes(data, size, offset, &field.lut, sizeof(field.lut)))
+            return false;
+        if (!ReadFieldString(data, size, offset, &name))
+            return false;
+        field.path = JoinFieldPath(scope, name);
+
+        bool read = true;
+        switch (command)
+        {
+            case kStartStruct:
+                read = ReadFieldString(data, size, offset, &field.string);
+                scope.push_back(field.path);
+                break;
+            case kFloat:
+                read = ReadFieldBytes(data, size, offset, &field.number, sizeof(float));
+                break;
+            case kInt32:
+            {
+                int32_t value;
+                read = ReadFieldBytes(data, size, offset, &value, sizeof(value));
+                field.value = (uint64_t)(int64_t)value;
+                break;
+            }
+            case kUInt32:
+            {
+                uint32_t value;
+                read = ReadFieldBytes(data, size, offset, &value, sizeof(value));
+                field.value = value;
+                break;
+            }
+            case kInt64:
+            case kUInt64:
+            case kLUTLookup:
+                read = ReadFieldBytes(data, size, offset, &field.value, sizeof(uint64_t));
+                break;
+            case kString:
+                read = ReadFieldString(data, size, offset, &field.string);
+                break;
+            default:
+                return false;
+        }
+        if (!read)
+            return false;
+        out.fields.push_back(field);
+    }
+    return scope.empty();
+}
+
+#define REPLAY_ENUM_ENTRY(name, value) {#name, (int64_t)value},
+
+static int64_t EnumValue(const char* name)
+{
+    static const std::unordered_map<std::string, int64_t> values = {
+        XR_LIST_ENUM_XrReferenceSpaceType(REPLAY_ENUM_ENTRY)
+            XR_LIST_ENUM_XrActionType(REPLAY_ENUM_ENTRY)
+                XR_LIST_ENUM_XrFormFactor(REPLAY_ENUM_ENTRY)
+                    XR_LIST_ENUM_XrViewConfigurationType(REPLAY_ENUM_ENTRY)
+                        XR_LIST_ENUM_XrEnvironmentBlendMode(REPLAY_ENUM_ENTRY)};
+
+    auto it = values.find(name);
+    return it != values.end() ? it->second : 0;
+}
+
+#undef REPLAY_ENUM_ENTRY
+
+#define REPLAY_RESULT_CASE(name, value) \
+    case name:                          \
+        return #name;
+
+// Same names the debugger records results with.
+static const char* ResultName(XrResult result)
+{
+    switch (result)
+    {
+        XR_LIST_ENUM_XrResult(REPLAY_RESULT_CASE) default : return "Unknown";
+    }
+}
+
+#undef REPLAY_RESULT_CASE
+
+struct LutEntry
+{
+    const char* name;
+    ReplayFields fields;
+};
+
+struct ReplayState
+{
+    XrFunctions xr;
+    std::set<std::string> mockExtensions;
+
+    XrInstance instance;
+    XrSystemId systemId;
+    XrSession session;
+
+    // Actions rebuilt from the LUT go into this set, their own isn't recorded in their LUT entry.
+    XrActionSet lutActionSet;
+
+    // Predicted by the last replayed xrWaitFrame, replaces every recorded time.
+    XrTime displayTime;
+
+    // Recorded handle (and system id) values to replayed ones.
+    std::unordered_map<uint64_t, uint64_t> handles;
+
+    // (scoped LUT, recorded path) to replayed paths.
+    std::map<std::pair<uint32_t, uint64_t>, XrPath> paths;
+
+    // LUT entries of the capture by (scoped LUT, id).
+    std::map<std::pair<uint32_t, uint64_t>, LutEntry> lut;
+
+    std::set<std::string> droppedExtensions;
+};
+
+template <typename T>
+static bool MapHandle(const ReplayState& state, uint64_t recorded, T& replayed)
+{
+    if (recorded == 0)
+    {
+        replayed = (T)0;
+        return true;
+    }
+
+    auto it = state.handles.find(recorded);
+    if (it == state.handles.end())
+        return false;
+    replayed = (T)it->second;
+    return true;
+}
+
+template <typename T>
+static void AddHandle(ReplayState& state, uint64_t recorded, T replayed)
+{
+    if (recorded != 0)
+        state.handles[recorded] = (uint64_t)replayed;
+}
+
+static bool MapPath(ReplayState& state, const ReplayField* field, XrPath& replayed)
+{
+    replayed = XR_NULL_PATH;
+    if (field == nullptr || field->value == 0)
+        return true;
+
+    // 32-bit captures send paths as plain values, with no LUT entry to rebuild them from.
+    if (field->command != kLUTLookup)
+        return false;
+
+    std::pair<uint32_t, uint64_t> key(field->lut, field->value);
+    auto it = state.paths.find(key);
+    if (it != state.paths.end())
+    {
+        replayed = it->second;
+        return true;
+    }
+
+    auto entry = state.lut.find(key);
+    if (entry == state.lut.end() || state.instance == XR_NULL_HANDLE)
+        return false;
+    if (XR_FAILED(state.xr.xrStringToPath(state.instance, entry->second.name, &replayed)))
+        return false;
+    state.paths[key] = replayed;
+    return true;
+}
+
+static XrPosef ReadPose(const ReplayFields& fields, const std::string& path)
+{
+    XrPosef pose;
+    pose.orientation = {fields.Number(path + ".orientation.x"), fields.Number(path + ".orientation.y"), fields.Number(path + ".orientation.z"), fields.Number(path + ".orientation.w")};
+    pose.position = {fields.Number(path + ".position.x"), fields.Number(path + ".position.y"), fields.Number(path + ".position.z")};
+    return pose;
+}
+
+static void CopyName(char* dst, size_t size, const char* src)
+{
+    strncpy(dst, src, size - 1);
+    dst[size - 1] = 0;
+}
+
+static XrResult CreateInstance(ReplayState& state, const char* applicationName, XrVersion apiVersion, const std::vector<const char*>& extensions, XrInstance& instance)
+{
+    XrInstanceCreateInfo instanceInfo = {XR_TYPE_INSTANCE_CREATE_INFO};
+    CopyName(instanceInfo.applicationInfo.applicationName, XR_MAX_APPLICATION_NAME_SIZE, applicationName);
+    instanceInfo.applicationInfo.apiVersion = apiVersion != 0 ? apiVersion : XR_CURRENT_API_VERSION;
+    instanceInfo.enabledExtensionCount = (uint32_t)extensions.size();
+    instanceInfo.enabledExtensionNames = extensions.data();
+
+    instance = XR_NULL_HANDLE;
+    XrResult result = state.xr.xrCreateInstance(&instanceInfo, &instance);
+    if (XR_SUCCEEDED(result))
+    {
+        state.instance = instance;
+        if (!LoadFunctions(state.xr, instance))
+            return XR_ERROR_FUNCTION_UNSUPPORTED;
+    }
+    return result;
+}
+
+static void ForgetInstance(ReplayState& state)
+{
+    state.instance = XR_NULL_HANDLE;
+    state.systemId = XR_NULL_SYSTEM_ID;
+    state.session = XR_NULL_HANDLE;
+    state.lutActionSet = XR_NULL_HANDLE;
+    state.handles.clear();
+    state.paths.clear();
+}
+
+// Stands in for an instance and session whose creation isn't in the capture.
+static bool CreateDefaultSession(ReplayState& state)
+{
+    if (state.instance == XR_NULL_HANDLE)
+    {
+        XrInstance instance;
+        CHECK_XR(CreateInstance(state, "runtime_debugger_replay", XR_CURRENT_API_VERSION, {}, instance));
+    }
+
+    if (state.systemId == XR_NULL_SYSTEM_ID)
+    {
+        XrSystemGetInfo systemInfo = {XR_TYPE_SYSTEM_GET_INFO};
+        systemInfo.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+        CHECK_XR(state.xr.xrGetSystem(state.instance, &systemInfo, &state.systemId));
+    }
+
+    if (state.session == XR_NULL_HANDLE)
+    {
+        XrSessionCreateInfo sessionInfo = {XR_TYPE_SESSION_CREATE_INFO};
+        sessionInfo.systemId = state.systemId;
+        CHECK_XR(state.xr.xrCreateSession(state.instance, &sessionInfo, &state.session));
+        if (!PollEvents(state.xr, state.instance))
+            return false;
+
+        XrSessionBeginInfo beginInfo = {XR_TYPE_SESSION_BEGIN_INFO};
+        beginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        CHECK_XR(state.xr.xrBeginSession(state.session, &beginInfo));
+        if (!PollEvents(state.xr, state.instance))
+            return false;
+    }
+    return true;
+}
+
+// Replays one recorded call.  Returns false if the call can't be rebuilt, e.g. it refers to a handle the replay doesn't have.
+typedef bool (*ReplayFunction)(ReplayState& state, const ReplayFields& fields, XrResult& result);
+
+static bool ReplayCreateInstance(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    // Graphics extensions the mock doesn't have fall back to its null graphics.
+    std::vector<const char*> extensions;
+    for (const ReplayField* extension : fields.FindAll("createInfo.enabledExtensionNames"))
+    {
+        if (state.mockExtensions.count(extension->string) != 0)
+            extensions.push_back(extension->string);
+        else
+            state.droppedExtensions.insert(extension->string);
+    }
+
+    XrInstance instance;
+    result = CreateInstance(state, fields.String("createInfo.applicationInfo.applicationName"), (XrVersion)fields.Value("createInfo.applicationInfo.apiVersion"), extensions, instance);
+    if (XR_SUCCEEDED(result))
+        AddHandle(state, fields.Value("instance"), instance);
+    return true;
+}
+
+static bool ReplayDestroyInstance(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrInstance instance;
+    if (!MapHandle(state, fields.Value("instance"), instance))
+        return false;
+    result = state.xr.xrDestroyInstance(instance);
+    if (XR_SUCCEEDED(result))
+        ForgetInstance(state);
+    return true;
+}
+
+static bool ReplayGetSystem(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrInstance instance;
+    if (!MapHandle(state, fields.Value("instance"), instance))
+        return false;
+
+    XrSystemGetInfo getInfo = {XR_TYPE_SYSTEM_GET_INFO};
+    getInfo.formFactor = (XrFormFactor)EnumValue(fields.String("getInfo.formFactor"));
+    XrSystemId systemId = XR_NULL_SYSTEM_ID;
+    result = state.xr.xrGetSystem(instance, &getInfo, &systemId);
+    if (XR_SUCCEEDED(result))
+    {
+        state.systemId = systemId;
+        AddHandle(state, fields.Value("systemId"), systemId);
+    }
+    return true;
+}
+
+static bool ReplayPollEvent(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrInstance instance;
+    if (!MapHandle(state, fields.Value("instance"), instance))
+        return false;
+
+    XrEventDataBuffer event = {XR_TYPE_EVENT_DATA_BUFFER};
+    result = state.xr.xrPollEvent(instance, &event);
+    return true;
+}
+
+static bool ReplayCreateSession(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrInstance instance;
+    if (!MapHandle(state, fields.Value("instance"), instance))
+        return false;
+
+    // The mock runtime has a single system, stand in for a lost xrGetSystem with it.
+    XrSessionCreateInfo createInfo = {XR_TYPE_SESSION_CREATE_INFO};
+    if (!MapHandle(state, fields.Value("createInfo.systemId"), createInfo.systemId))
+        createInfo.systemId = state.systemId;
+    if (createInfo.systemId == XR_NULL_SYSTEM_ID)
+        return false;
+
+    XrSession session = XR_NULL_HANDLE;
+    result = state.xr.xrCreateSession(instance, &createInfo, &session);
+    if (XR_SUCCEEDED(result))
+    {
+        state.session = session;
+        AddHandle(state, fields.Value("session"), session);
+    }
+    return true;
+}
+
+static bool ReplayDestroySession(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+    result = state.xr.xrDestroySession(session);
+    if (XR_SUCCEEDED(result) && session == state.session)
+        state.session = XR_NULL_HANDLE;
+    return true;
+}
+
+static bool ReplayBeginSession(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+
+    XrSessionBeginInfo beginInfo = {XR_TYPE_SESSION_BEGIN_INFO};
+    beginInfo.primaryViewConfigurationType = (XrViewConfigurationType)EnumValue(fields.String("beginInfo.primaryViewConfigurationType"));
+    result = state.xr.xrBeginSession(session, &beginInfo);
+    return true;
+}
+
+static bool ReplayEndSession(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+    result = state.xr.xrEndSession(session);
+    return true;
+}
+
+static bool ReplayRequestExitSession(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+    result = state.xr.xrRequestExitSession(session);
+    return true;
+}
+
+static XrResult CreateReferenceSpace(ReplayState& state, XrSession session, const ReplayFields& fields, const std::string& createInfo, XrSpace& space)
+{
+    XrReferenceSpaceCreateInfo spaceInfo = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    spaceInfo.referenceSpaceType = (XrReferenceSpaceType)EnumValue(fields.String(createInfo + "referenceSpaceType"));
+    spaceInfo.poseInReferenceSpace = ReadPose(fields, createInfo + "poseInReferenceSpace");
+    space = XR_NULL_HANDLE;
+    return state.xr.xrCreateReferenceSpace(session, &spaceInfo, &space);
+}
+
+static bool CreateActionSpace(ReplayState& state, XrSession session, const ReplayFields& fields, const std::string& createInfo, XrSpace& space, XrResult& result)
+{
+    XrActionSpaceCreateInfo spaceInfo = {XR_TYPE_ACTION_SPACE_CREATE_INFO};
+    if (!MapHandle(state, fields.Value(createInfo + "action"), spaceInfo.action) || !MapPath(state, fields.Find(createInfo + "subactionPath"), spaceInfo.subactionPath))
+        return false;
+    spaceInfo.poseInActionSpace = ReadPose(fields, createInfo + "poseInActionSpace");
+    space = XR_NULL_HANDLE;
+    result = state.xr.xrCreateActionSpace(session, &spaceInfo, &space);
+    return true;
+}
+
+static bool ReplayCreateReferenceSpace(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+
+    XrSpace space;
+    result = CreateReferenceSpace(state, session, fields, "createInfo.", space);
+    if (XR_SUCCEEDED(result))
+        AddHandle(state, fields.Value("space"), space);
+    return true;
+}
+
+static bool ReplayCreateActionSpace(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    XrSpace space;
+    if (!MapHandle(state, fields.Value("session"), session) || !CreateActionSpace(state, session, fields, "createInfo.", space, result))
+        return false;
+    if (XR_SUCCEEDED(result))
+        AddHandle(state, fields.Value("space"), space);
+    return true;
+}
+
+static bool ReplayDestroySpace(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSpace space;
+    if (!MapHandle(state, fields.Value("space"), space))
+        return false;
+    result = state.xr.xrDestroySpace(space);
+    return true;
+}
+
+static bool ReplayLocateSpace(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSpace space, baseSpace;
+    if (!MapHandle(state, fields.Value("space"), space) || !MapHandle(state, fields.Value("baseSpace"), baseSpace))
+        return false;
+
+    XrSpaceLocation location = {XR_TYPE_SPACE_LOCATION};
+    result = state.xr.xrLocateSpace(space, baseSpace, state.displayTime, &location);
+    return true;
+}
+
+static bool ReplayStringToPath(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrInstance instance;
+    if (!MapHandle(state, fields.Value("instance"), instance))
+        return false;
+
+    XrPath path = XR_NULL_PATH;
+    result = state.xr.xrStringToPath(instance, fields.String("pathString"), &path);
+    const ReplayField* recorded = fields.Find("path");
+    if (XR_SUCCEEDED(result) && recorded != nullptr && recorded->command == kLUTLookup)
+        state.paths[std::make_pair(recorded->lut, recorded->value)] = path;
+    return true;
+}
+
+static XrResult CreateActionSet(ReplayState& state, XrInstance instance, const ReplayFields& fields, const std::string& createInfo, XrActionSet& actionSet)
+{
+    XrActionSetCreateInfo actionSetInfo = {XR_TYPE_ACTION_SET_CREATE_INFO};
+    CopyName(actionSetInfo.actionSetName, XR_MAX_ACTION_SET_NAME_SIZE, fields.String(createInfo + "actionSetName"));
+    CopyName(actionSetInfo.localizedActionSetName, XR_MAX_LOCALIZED_ACTION_SET_NAME_SIZE, fields.String(createInfo + "localizedActionSetName"));
+    actionSetInfo.priority = (uint32_t)fields.Value(createInfo + "priority");
+    actionSet = XR_NULL_HANDLE;
+    return state.xr.xrCreateActionSet(instance, &actionSetInfo, &actionSet);
+}
+
+static bool CreateAction(ReplayState& state, XrActionSet actionSet, const ReplayFields& fields, const std::string& createInfo, XrAction& action, XrResult& result)
+{
+    std::vector<XrPath> subactionPaths;
+    for (const ReplayField* recorded : fields.FindAll(createInfo + "subactionPaths"))
+    {
+        XrPath path;
+        if (!MapPath(state, recorded, path))
+            return false;
+        subactionPaths.push_back(path);
+    }
+
+    XrActionCreateInfo actionInfo = {XR_TYPE_ACTION_CREATE_INFO};
+    CopyName(actionInfo.actionName, XR_MAX_ACTION_NAME_SIZE, fields.String(createInfo + "actionName"));
+    CopyName(actionInfo.localizedActionName, XR_MAX_LOCALIZED_ACTION_NAME_SIZE, fields.String(createInfo + "localizedActionName"));
+    actionInfo.actionType = (XrActionType)EnumValue(fields.String(createInfo + "actionType"));
+    actionInfo.countSubactionPaths = (uint32_t)subactionPaths.size();
+    actionInfo.subactionPaths = subactionPaths.data();
+    action = XR_NULL_HANDLE;
+    result = state.xr.xrCreateAction(actionSet, &actionInfo, &action);
+    return true;
+}
+
+static bool ReplayCreateActionSet(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrInstance instance;
+    if (!MapHandle(state, fields.Value("instance"), instance))
+        return false;
+
+    XrActionSet actionSet;
+    result = CreateActionSet(state, instance, fields, "createInfo.", actionSet);
+    if (XR_SUCCEEDED(result))
+        AddHandle(state, fields.Value("actionSet"), actionSet);
+    return true;
+}
+
+static bool ReplayDestroyActionSet(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrActionSet actionSet;
+    if (!MapHandle(state, fields.Value("actionSet"), actionSet))
+        return false;
+    result = state.xr.xrDestroyActionSet(actionSet);
+    return true;
+}
+
+static bool ReplayCreateAction(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrActionSet actionSet;
+    XrAction action;
+    if (!MapHandle(state, fields.Value("actionSet"), actionSet) || !CreateAction(state, actionSet, fields, "createInfo.", action, result))
+        return false;
+    if (XR_SUCCEEDED(result))
+        AddHandle(state, fields.Value("action"), action);
+    return true;
+}
+
+static bool ReplayDestroyAction(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrAction action;
+    if (!MapHandle(state, fields.Value("action"), action))
+        return false;
+    result = state.xr.xrDestroyAction(action);
+    return true;
+}
+
+static bool ReplaySuggestInteractionProfileBindings(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrInstance instance;
+    XrInteractionProfileSuggestedBinding suggested = {XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
+    if (!MapHandle(state, fields.Value("instance"), instance) || !MapPath(state, fields.Find("suggestedBindings.interactionProfile"), suggested.interactionProfile))
+        return false;
+
+    std::vector<const ReplayField*> actions = fields.FindAll("suggestedBindings.suggestedBindings.action");
+    std::vector<const ReplayField*> paths = fields.FindAll("suggestedBindings.suggestedBindings.binding");
+    if (actions.size() != paths.size())
+        return false;
+
+    std::vector<XrActionSuggestedBinding> bindings(actions.size());
+    for (size_t i = 0; i < bindings.size(); ++i)
+    {
+        if (!MapHandle(state, actions[i]->value, bindings[i].action) || !MapPath(state, paths[i], bindings[i].binding))
+            return false;
+    }
+
+    suggested.countSuggestedBindings = (uint32_t)bindings.size();
+    suggested.suggestedBindings = bindings.data();
+    result = state.xr.xrSuggestInteractionProfileBindings(instance, &suggested);
+    return true;
+}
+
+static bool ReplayAttachSessionActionSets(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+
+    std::vector<XrActionSet> actionSets;
+    for (const ReplayField* recorded : fields.FindAll("attachInfo.actionSets"))
+    {
+        XrActionSet actionSet;
+        if (!MapHandle(state, recorded->value, actionSet))
+            return false;
+        actionSets.push_back(actionSet);
+    }
+
+    // Actions rebuilt from the LUT need their set attached too.
+    if (state.lutActionSet != XR_NULL_HANDLE)
+        actionSets.push_back(state.lutActionSet);
+
+    XrSessionActionSetsAttachInfo attachInfo = {XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+    attachInfo.countActionSets = (uint32_t)actionSets.size();
+    attachInfo.actionSets = actionSets.data();
+    result = state.xr.xrAttachSessionActionSets(session, &attachInfo);
+    return true;
+}
+
+static bool ReplaySyncActions(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+
+    std::vector<const ReplayField*> actionSets = fields.FindAll("syncInfo.activeActionSets.actionSet");
+    std::vector<const ReplayField*> paths = fields.FindAll("syncInfo.activeActionSets.subactionPath");
+    if (actionSets.size() != paths.size())
+        return false;
+
+    std::vector<XrActiveActionSet> activeSets(actionSets.size());
+    for (size_t i = 0; i < activeSets.size(); ++i)
+    {
+        if (!MapHandle(state, actionSets[i]->value, activeSets[i].actionSet) || !MapPath(state, paths[i], activeSets[i].subactionPath))
+            return false;
+    }
+
+    XrActionsSyncInfo syncInfo = {XR_TYPE_ACTIONS_SYNC_INFO};
+    syncInfo.countActiveActionSets = (uint32_t)activeSets.size();
+    syncInfo.activeActionSets = activeSets.data();
+    result = state.xr.xrSyncActions(session, &syncInfo);
+    return true;
+}
+
+static bool ReadActionStateGetInfo(ReplayState& state, const ReplayFields& fields, XrSession& session, XrActionStateGetInfo& getInfo)
+{
+    getInfo = {XR_TYPE_ACTION_STATE_GET_INFO};
+    return MapHandle(state, fields.Value("session"), session) && MapHandle(state, fields.Value("getInfo.action"), getInfo.action) && MapPath(state, fields.Find("getInfo.subactionPath"), getInfo.subactionPath);
+}
+
+static bool ReplayGetActionStateBoolean(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    XrActionStateGetInfo getInfo;
+    if (!ReadActionStateGetInfo(state, fields, session, getInfo))
+        return false;
+    XrActionStateBoolean actionState = {XR_TYPE_ACTION_STATE_BOOLEAN};
+    result = state.xr.xrGetActionStateBoolean(session, &getInfo, &actionState);
+    return true;
+}
+
+static bool ReplayGetActionStateFloat(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    XrActionStateGetInfo getInfo;
+    if (!ReadActionStateGetInfo(state, fields, session, getInfo))
+        return false;
+    XrActionStateFloat actionState = {XR_TYPE_ACTION_STATE_FLOAT};
+    result = state.xr.xrGetActionStateFloat(session, &getInfo, &actionState);
+    return true;
+}
+
+static bool ReplayGetActionStateVector2f(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    XrActionStateGetInfo getInfo;
+    if (!ReadActionStateGetInfo(state, fields, session, getInfo))
+        return false;
+    XrActionStateVector2f actionState = {XR_TYPE_ACTION_STATE_VECTOR2F};
+    result = state.xr.xrGetActionStateVector2f(session, &getInfo, &actionState);
+    return true;
+}
+
+static bool ReplayGetActionStatePose(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    XrActionStateGetInfo getInfo;
+    if (!ReadActionStateGetInfo(state, fields, session, getInfo))
+        return false;
+    XrActionStatePose actionState = {XR_TYPE_ACTION_STATE_POSE};
+    result = state.xr.xrGetActionStatePose(session, &getInfo, &actionState);
+    return true;
+}
+
+static bool ReplayWaitFrame(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+
+    XrFrameWaitInfo waitInfo = {XR_TYPE_FRAME_WAIT_INFO};
+    XrFrameState frameState = {XR_TYPE_FRAME_STATE};
+    result = state.xr.xrWaitFrame(session, &waitInfo, &frameState);
+    if (XR_SUCCEEDED(result))
+        state.displayTime = frameState.predictedDisplayTime;
+    return true;
+}
+
+static bool ReplayBeginFrame(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+
+    XrFrameBeginInfo beginInfo = {XR_TYPE_FRAME_BEGIN_INFO};
+    result = state.xr.xrBeginFrame(session, &beginInfo);
+    return true;
+}
+
+static bool ReplayLocateViews(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    XrViewLocateInfo locateInfo = {XR_TYPE_VIEW_LOCATE_INFO};
+    if (!MapHandle(state, fields.Value("session"), session) || !MapHandle(state, fields.Value("viewLocateInfo.space"), locateInfo.space))
+        return false;
+    locateInfo.viewConfigurationType = (XrViewConfigurationType)EnumValue(fields.String("viewLocateInfo.viewConfigurationType"));
+    locateInfo.displayTime = state.displayTime;
+
+    uint32_t capacity = (uint32_t)fields.Value("viewCapacityInput");
+    if (capacity > kMaxReplayViews)
+        capacity = kMaxReplayViews;
+
+    XrViewState viewState = {XR_TYPE_VIEW_STATE};
+    XrView views[kMaxReplayViews];
+    for (XrView& view : views)
+        view = {XR_TYPE_VIEW};
+    uint32_t viewCount = 0;
+    result = state.xr.xrLocateViews(session, &locateInfo, &viewState, capacity, &viewCount, capacity != 0 ? views : nullptr);
+    return true;
+}
+
+static bool ReplayEndFrame(ReplayState& state, const ReplayFields& fields, XrResult& result)
+{
+    XrSession session;
+    if (!MapHandle(state, fields.Value("session"), session))
+        return false;
+
+    XrFrameEndInfo endInfo = {XR_TYPE_FRAME_END_INFO};
+    endInfo.displayTime = state.displayTime;
+    endInfo.environmentBlendMode = (XrEnvironmentBlendMode)EnumValue(fields.String("frameEndInfo.environmentBlendMode"));
+    result = state.xr.xrEndFrame(session, &endInfo);
+    return true;
+}
+
+struct ReplayFunctionDesc
+{
+    const char* name;
+    ReplayFunction replay;
+    const char* output; // parameter the call creates a handle in, or nullptr
+};
+
+static const ReplayFunctionDesc kReplayFunctions[] = {
+    {"xrCreateInstance", ReplayCreateInstance, "instance"},
+    {"xrDestroyInstance", ReplayDestroyInstance, nullptr},
+    {"xrGetSystem", ReplayGetSystem, "systemId"},
+    {"xrPollEvent", ReplayPollEvent, nullptr},
+    {"xrCreateSession", ReplayCreateSession, "session"},
+    {"xrDestroySession", ReplayDestroySession, nullptr},
+    {"xrBeginSession", ReplayBeginSession, nullptr},
+    {"xrEndSession", ReplayEndSession, nullptr},
+    {"xrRequestExitSession", ReplayRequestExitSession, nullptr},
+    {"xrCreateReferenceSpace", ReplayCreateReferenceSpace, "space"},
+    {"xrCreateActionSpace", ReplayCreateActionSpace, "space"},
+    {"xrDestroySpace", ReplayDestroySpace, nullptr},
+    {"xrLocateSpace", ReplayLocateSpace, nullptr},
+    {"xrStringToPath", ReplayStringToPath, nullptr},
+    {"xrCreateActionSet", ReplayCreateActionSet, "actionSet"},
+    {"xrDestroyActionSet", ReplayDestroyActionSet, nullptr},
+    {"xrCreateAction", ReplayCreateAction, "action"},
+    {"xrDestroyAction", ReplayDestroyAction, nullptr},
+    {"xrSuggestInteractionProfileBindings", ReplaySuggestInteractionProfileBindings, nullptr},
+    {"xrAttachSessionActionSets", ReplayAttachSessionActionSets, nullptr},
+    {"xrSyncActions", ReplaySyncActions, nullptr},
+    {"xrGetActionStateBoolean", ReplayGetActionStateBoolean, nullptr},
+    {"xrGetActionStateFloat", ReplayGetActionStateFloat, nullptr},
+    {"xrGetActionStateVector2f", ReplayGetActionStateVector2f, nullptr},
+    {"xrGetActionStatePose", ReplayGetActionStatePose, nullptr},
+    {"xrWaitFrame", ReplayWaitFrame, nullptr},
+    {"xrBeginFrame", ReplayBeginFrame, nullptr},
+    {"xrLocateViews", ReplayLocateViews, nullptr},
+    {"xrEndFrame", ReplayEndFrame, nullptr},
+};
+
+static const ReplayFunctionDesc* FindReplayFunction(const char* name)
+{
+    for (const ReplayFunctionDesc& desc : kReplayFunctions)
+    {
+        if (strcmp(desc.name, name) == 0)
+            return &desc;
+    }
+    return nullptr;
+}
+
+enum SkipReason
+{
+    kSkipUnsupported,   // not in kReplayFunctions
+    kSkipReducedDetail, // captured without its parameters, see kCaptureDetailChanged
+    kSkipMalformed,     // fields couldn't be parsed
+    kSkipUnmapped,      // refers to a handle or path the replay doesn't have
+
+    kSkipReasonCount
+};
+
+static const char* const kSkipReasonNames[] = {
+    "not replayable",
+    "captured without parameters",
+    "malformed",
+    "unknown handle or path",
+};
+
+struct RecordedCall
+{
+    int64_t timestamp;
+    const char* name;
+    const char* result;
+    const uint8_t* fields;
+    uint32_t fieldsSize;
+    uint32_t detail;
+};
+
+struct FunctionStats
+{
+    uint64_t calls;
+    uint64_t skipped;
+    uint64_t diverged;
+    uint64_t replayNs;
+};
+
+struct Capture
+{
+    std::vector<RecordedCall> calls;
+    uint64_t droppedCalls; // kCacheNotLargeEnough, lost before the capture was saved
+};
+
+static bool LoadCaptureFile(const char* path, std::vector<uint8_t>& capture)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[64 * 1024];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) != 0)
+        bytes.insert(bytes.end(), buffer, buffer + read);
+    fclose(file);
+
+    if (bytes.size() >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b)
+    {
+        printf("%s is compressed, decompress it first: gzip -dc %s > capture.bin\n", path, path);
+        return false;
+    }
+
+    if (bytes.size() >= sizeof(kSavedCaptureHeader) + 1 && memcmp(bytes.data(), kSavedCaptureHeader, sizeof(kSavedCaptureHeader)) == 0)
+    {
+        capture.assign(bytes.begin() + sizeof(kSavedCaptureHeader) + 1, bytes.end());
+        return true;
+    }
+
+    // A capture stream starts with a LUT frame holding the capture header.
+    uint32_t firstCommand = 0;
+    if (bytes.size() >= sizeof(CaptureStreamFrameHeader) + sizeof(uint32_t))
+        memcpy(&firstCommand, bytes.data() + sizeof(CaptureStreamFrameHeader), sizeof(uint32_t));
+    if (firstCommand == kCaptureHeader)
+    {
+        size_t offset = 0;
+        while (offset + sizeof(CaptureStreamFrameHeader) <= bytes.size())
+        {
+            CaptureStreamFrameHeader frame;
+            memcpy(&frame, bytes.data() + offset, sizeof(frame));
+            offset += sizeof(frame);
+
+            // The recording may have been stopped mid frame.
+            if (frame.size > bytes.size() - offset)
+                break;
+            capture.insert(capture.end(), bytes.begin() + offset, bytes.begin() + offset + frame.size);
+            offset += frame.size;
+        }
+        return true;
+    }
+
+    capture.swap(bytes);
+    return true;
+}
+
+static void ReadCapture(const Debugger& debugger, const std::vector<uint8_t>& data, ReplayState& state, Capture& capture)
+{
+    capture = {};
+    void* cursor = debugger.OpenRecordCursor(data.data(), (uint32_t)data.size());
+    uint32_t detail = kCaptureDetailFull;
+    RecordView view;
+    while (debugger.NextRecord(cursor, &view))
+    {
+        switch (view.command)
+        {
+            case kStartFunctionCall:
+                capture.calls.push_back({view.timestamp, view.name, view.result, view.fields, view.fieldsSize, detail});
+                break;
+            case kCacheNotLargeEnough:
+                ++capture.droppedCalls;
+                break;
+            case kCaptureDetailChanged:
+                // previous detail, then the new one
+                memcpy(&detail, view.fields + sizeof(uint32_t), sizeof(detail));
+                break;
+            case kLUTEntryUpdateStart:
+            {
+                uint32_t lut;
+                uint64_t id;
+                memcpy(&lut, view.record + sizeof(uint32_t), sizeof(lut));
+                memcpy(&id, view.record + 2 * sizeof(uint32_t), sizeof(id));
+                LutEntry& entry = state.lut[std::make_pair(lut, id)];
+                entry.name = view.name;
+                entry.fields = {};
+                ParseFields(view.fields, view.fieldsSize, entry.fields);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    const char* error = debugger.GetRecordCursorError(cursor);
+    if (error != nullptr)
+        printf("Capture is malformed after %zu calls (%s), only those are replayed\n", capture.calls.size(), error);
+    debugger.CloseRecordCursor(cursor);
+
+    // Calls of different threads are interleaved in the order they finished.
+    std::stable_sort(capture.calls.begin(), capture.calls.end(), [](const RecordedCall& a, const RecordedCall& b) { return a.timestamp < b.timestamp; });
+}
+
+static bool IsHandleLut(uint32_t lut)
+{
+    uint32_t index = lut & kLutIndexMask;
+    return index == kXrAction || index == kXrActionSet || index == kXrSpace;
+}
+
+// Finds the handles calls use before (or without) a recorded call creating them, their creation was lost.
+static void FindLostHandles(const Capture& capture, bool& lostSession, std::set<std::pair<uint32_t, uint64_t>>& lostObjects)
+{
+    std::set<uint64_t> created;
+    lostSession = false;
+    for (const RecordedCall& call : capture.calls)
+    {
+        const ReplayFunctionDesc* desc = FindReplayFunction(call.name);
+        ReplayFields fields;
+        if (desc == nullptr || call.detail != kCaptureDetailFull || !ParseFields(call.fields, call.fieldsSize, fields))
+            continue;
+
+        for (const ReplayField& field : fields.fields)
+        {
+            if (desc->output != nullptr && field.path == desc->output)
+                continue;
+            if (field.value == 0 || created.count(field.value) != 0)
+                continue;
+            if (field.path == "instance" || field.path == "session")
+                lostSession = true;
+            else if (field.command == kLUTLookup && IsHandleLut(field.lut))
+                lostObjects.insert(std::make_pair(field.lut, field.value));
+        }
+
+        if (desc->output != nullptr)
+            created.insert(fields.Value(desc->output));
+    }
+}
+
+// Creates the session and objects the capture uses without their creation, see FindLostHandles.
+static bool RestoreLostHandles(ReplayState& state, const Capture& capture)
+{
+    bool lostSession;
+    std::set<std::pair<uint32_t, uint64_t>> lostObjects;
+    FindLostHandles(capture, lostSession, lostObjects);
+    if (!lostSession && lostObjects.empty())
+        return true;
+
+    if (!CreateDefaultSession(state))
+        return false;
+
+    // Every lost instance and session handle stands for the default one, the mock runtime only has one of each.
+    for (const RecordedCall& call : capture.calls)
+    {
+        ReplayFields fields;
+        if (call.detail != kCaptureDetailFull || !ParseFields(call.fields, call.fieldsSize, fields))
+            continue;
+        const ReplayFunctionDesc* desc = FindReplayFunction(call.name);
+        if (desc != nullptr && desc->output != nullptr && (strcmp(desc->output, "instance") == 0 || strcmp(desc->output, "session") == 0))
+            break;
+
+        uint64_t instance = fields.Value("instance");
+        uint64_t session = fields.Value("session");
+        if (instance != 0 && state.handles.count(instance) == 0)
+            AddHandle(state, instance, state.instance);
+        if (session != 0 && state.handles.count(session) == 0)
+            AddHandle(state, session, state.session);
+    }
+
+    uint32_t restored = 0, failed = 0;
+    std::vector<XrActionSet> restoredActionSets;
+
+    // Action sets, then the actions going into them, then the spaces that may refer to those actions.
+    static const LUT kRestoreOrder[] = {kXrActionSet, kXrAction, kXrSpace};
+    for (LUT lutIndex : kRestoreOrder)
+    {
+        for (const std::pair<uint32_t, uint64_t>& lost : lostObjects)
+        {
+            if ((lost.first & kLutIndexMask) != lutIndex)
+                continue;
+
+            auto entry = state.lut.find(lost);
+            if (entry == state.lut.end())
+            {
+                ++failed;
+                continue;
+            }
+
+            const ReplayFields& fields = entry->second.fields;
+            const ReplayField* structField = fields.Find("");
+            const char* structName = structField != nullptr && structField->command == kStartStruct ? structField->string : "";
+            XrResult result = XR_ERROR_VALIDATION_FAILURE;
+            uint64_t handle = 0;
+            if (lutIndex == kXrActionSet)
+            {
+                XrActionSet actionSet;
+                result = CreateActionSet(state, state.instance, fields, "", actionSet);
+                handle = (uint64_t)actionSet;
+                if (XR_SUCCEEDED(result))
+                    restoredActionSets.push_back(actionSet);
+            }
+            else if (lutIndex == kXrAction)
+            {
+                if (state.lutActionSet == XR_NULL_HANDLE)
+                {
+                    ReplayFields setFields;
+                    setFields.fields.push_back({"actionSetName", kString, 0, 0, 0.0f, "runtime_debugger_replay"});
+                    setFields.fields.push_back({"localizedActionSetName", kString, 0, 0, 0.0f, "Runtime Debugger Replay"});
+                    CHECK_XR(CreateActionSet(state, state.instance, setFields, "", state.lutActionSet));
+                }
+
+                XrAction action;
+                if (CreateAction(state, state.lutActionSet, fields, "", action, result))
+                    handle = (uint64_t)action;
+            }
+            else if (strcmp(structName, "XrActionSpaceCreateInfo") == 0)
+            {
+                XrSpace space;
+                if (CreateActionSpace(state, state.session, fields, "", space, result))
+                    handle = (uint64_t)space;
+            }
+            else
+            {
+                XrSpace space;
+                result = CreateReferenceSpace(state, state.session, fields, "", space);
+                handle = (uint64_t)space;
+            }
+
+            if (XR_SUCCEEDED(result) && handle != 0)
+            {
+                AddHandle(state, lost.second, handle);
+                ++restored;
+            }
+            else
+            {
+                ++failed;
+            }
+        }
+    }
+
+    // Attach the action sets here if the capture lost its xrAttachSessionActionSets too.  A recorded one attaches lutActionSet along with its own sets.
+    bool attachRecorded = std::any_of(capture.calls.begin(), capture.calls.end(), [](const RecordedCall& call) { return strcmp(call.name, "xrAttachSessionActionSets") == 0; });
+    if (state.lutActionSet != XR_NULL_HANDLE)
+        restoredActionSets.push_back(state.lutActionSet);
+    if (!attachRecorded && !restoredActionSets.empty())
+    {
+        XrSessionActionSetsAttachInfo attachInfo = {XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+        attachInfo.countActionSets = (uint32_t)restoredActionSets.size();
+        attachInfo.actionSets = restoredActionSets.data();
+        CHECK_XR(state.xr.xrAttachSessionActionSets(state.session, &attachInfo));
+    }
+
+    printf("Created %u objects the capture lost the creation of from their LUT entries", restored);
+    if (failed != 0)
+        printf(", %u couldn't be (calls using them are skipped)", failed);
+    printf("\n");
+    return true;
+}
+
+static bool LoadDebugger(Debugger& debugger)
+{
+    debugger = {};
+    debugger.library = Plugin_LoadLibrary(L"openxr_runtime_debugger");
+    if (debugger.library == nullptr)
+        return false;
+
+#define LOAD_DEBUGGER_FUNC(f)                                     \
+    debugger.f = (PFN_##f)Plugin_GetSymbol(debugger.library, #f); \
+    if (debugger.f == nullptr)                                    \
+    {                                                             \
+        printf("openxr_runtime_debugger is missing %s\n", #f);    \
+        return false;                                             \
+    }
+
+    LOAD_DEBUGGER_FUNC(OpenRecordCursor)
+    LOAD_DEBUGGER_FUNC(NextRecord)
+    LOAD_DEBUGGER_FUNC(GetRecordCursorError)
+    LOAD_DEBUGGER_FUNC(CloseRecordCursor)
+
+#undef LOAD_DEBUGGER_FUNC
+    return true;
+}
+
+static bool LoadMock(ReplayState& state, PluginHandle mock)
+{
+    PFN_xrGetInstanceProcAddr getInstanceProcAddr = (PFN_xrGetInstanceProcAddr)Plugin_GetSymbol(mock, "xrGetInstanceProcAddr");
+    if (getInstanceProcAddr == nullptr)
+    {
+        printf("mock_runtime is missing xrGetInstanceProcAddr\n");
+        return false;
+    }
+    if (!LoadGlobalFunctions(state.xr, getInstanceProcAddr))
+        return false;
+
+    uint32_t count = 0;
+    CHECK_XR(state.xr.xrEnumerateInstanceExtensionProperties(nullptr, 0, &count, nullptr));
+    std::vector<XrExtensionProperties> extensions(count, {XR_TYPE_EXTENSION_PROPERTIES});
+    CHECK_XR(state.xr.xrEnumerateInstanceExtensionProperties(nullptr, count, &count, extensions.data()));
+    for (const XrExtensionProperties& extension : extensions)
+        state.mockExtensions.insert(extension.extensionName);
+    return true;
+}
+
+struct Divergence
+{
+    size_t index;
+    const char* function;
+    int64_t at;
+    const char* recorded;
+    const char* replayed;
+};
+
+static int Replay(ReplayState& state, const Capture& capture, double speed, uint32_t maxDivergences)
+{
+    std::map<std::string, FunctionStats> stats;
+    std::vector<Divergence> divergences;
+    uint64_t diverged = 0, replayed = 0;
+    uint64_t skipped[kSkipReasonCount] = {};
+    int64_t maxLateNs = 0, totalLateNs = 0;
+
+    int64_t recordStart = capture.calls.front().timestamp;
+    int64_t replayStart = NowNs();
+    for (size_t i = 0; i < capture.calls.size(); ++i)
+    {
+        const RecordedCall& call = capture.calls[i];
+        FunctionStats& functionStats = stats[call.name];
+        ++functionStats.calls;
+
+        const ReplayFunctionDesc* desc = FindReplayFunction(call.name);
+        ReplayFields fields;
+        SkipReason reason = kSkipReasonCount;
+        if (desc == nullptr)
+            reason = kSkipUnsupported;
+        else if (call.detail != kCaptureDetailFull)
+            reason = kSkipReducedDetail;
+        else if (!ParseFields(call.fields, call.fieldsSize, fields))
+            reason = kSkipMalformed;
+
+        if (reason == kSkipReasonCount && speed > 0.0)
+        {
+            int64_t due = replayStart + (int64_t)((call.timestamp - recordStart) / speed);
+            int64_t now = NowNs();
+            if (now < due)
+                std::this_thread::sleep_for(std::chrono::nanoseconds(due - now));
+            else
+            {
+                maxLateNs = std::max(maxLateNs, now - due);
+                totalLateNs += now - due;
+            }
+        }
+
+        XrResult result = XR_SUCCESS;
+        if (reason == kSkipReasonCount)
+        {
+            int64_t start = NowNs();
+            if (!desc->replay(state, fields, result))
+                reason = kSkipUnmapped;
+            functionStats.replayNs += NowNs() - start;
+        }
+
+        if (reason != kSkipReasonCount)
+        {
+            ++skipped[reason];
+            ++functionStats.skipped;
+            continue;
+        }
+
+        ++replayed;
+        const char* replayedResult = ResultName(result);
+        if (strcmp(replayedResult, call.result) != 0)
+        {
+            ++diverged;
+            ++functionStats.diverged;
+            if (divergences.size() < maxDivergences)
+                divergences.push_back({i, call.name, call.timestamp - recordStart, call.result, replayedResult});
+        }
+    }
+    int64_t replayNs = NowNs() - replayStart;
+
+    printf("Replayed %llu of %zu calls in %.3f s (recorded over %.3f s), %llu diverged\n",
+        (unsigned long long)replayed,
+        capture.calls.size(),
+        replayNs / 1e9,
+        (capture.calls.back().timestamp - recordStart) / 1e9,
+        (unsigned long long)diverged);
+    if (speed > 0.0 && replayed != 0)
+        printf("Behind schedule by %.3f ms at most, %.3f ms on average\n", maxLateNs / 1e6, totalLateNs / 1e6 / replayed);
+    for (int reason = 0; reason < kSkipReasonCount; ++reason)
+    {
+        if (skipped[reason] != 0)
+            printf("Skipped %llu calls: %s\n", (unsigned long long)skipped[reason], kSkipReasonNames[reason]);
+    }
+    if (capture.droppedCalls != 0)
+        printf("%llu calls were dropped from the capture (cache not large enough) and couldn't be replayed\n", (unsigned long long)capture.droppedCalls);
+    for (const std::string& extension : state.droppedExtensions)
+        printf("Extension %s isn't in the mock runtime, replayed without it\n", extension.c_str());
+
+    printf("\n%-40s %10s %10s %10s %12s\n", "function", "calls", "skipped", "diverged", "ns/call");
+    for (const auto& entry : stats)
+    {
+        const FunctionStats& functionStats = entry.second;
+        uint64_t functionReplayed = functionStats.calls - functionStats.skipped;
+        printf("%-40s %10llu %10llu %10llu %12.0f\n",
+            entry.first.c_str(),
+            (unsigned long long)functionStats.calls,
+            (unsigned long long)functionStats.skipped,
+            (unsigned long long)functionStats.diverged,
+            functionReplayed != 0 ? (double)functionStats.replayNs / functionReplayed : 0.0);
+    }
+
+    if (!divergences.empty())
+    {
+        printf("\nDivergences%s:\n", diverged > divergences.size() ? " (first ones)" : "");
+        for (const Divergence& divergence : divergences)
+            printf("  #%zu %s at %.6f s: recorded %s, replayed %s\n", divergence.index, divergence.function, divergence.at / 1e9, divergence.recorded, divergence.replayed);
+    }
+    return diverged != 0 ? 2 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = nullptr;
+    double speed = kDefaultSpeed;
+    uint32_t maxDivergences = kDefaultMaxDivergences;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed = strtod(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--max-divergences") == 0 && i + 1 < argc)
+            maxDivergences = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (path == nullptr)
+            path = argv[i];
+    }
+
+    if (path == nullptr)
+    {
+        printf("Usage: runtime_debugger_replay <capture> [--speed <factor>] [--max-divergences <count>]\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    if (!LoadCaptureFile(path, data))
+        return 1;
+
+    PluginHandle mock = Plugin_LoadLibrary(L"mock_runtime");
+    if (mock == nullptr)
+    {
+        printf("Failed to load mock_runtime\n");
+        return 1;
+    }
+
+    Debugger debugger;
+    if (!LoadDebugger(debugger))
+    {
+        printf("Failed to load openxr_runtime_debugger\n");
+        return 1;
+    }
+
+    ReplayState state = {};
+    Capture capture;
+    if (!LoadMock(state, mock))
+        return 1;
+    ReadCapture(debugger, data, state, capture);
+    if (capture.calls.empty())
+    {
+        printf("%s has no calls to replay\n", path);
+        return 1;
+    }
+
+    int exitCode = 1;
+    if (RestoreLostHandles(state, capture))
+        exitCode = Replay(state, capture, speed, maxDivergences);
+
+    if (state.instance != XR_NULL_HANDLE)
+        state.xr.xrDestroyInstance(state.instance);
+
+    Plugin_FreeLibrary(debugger.library);
+    Plugin_FreeLibrary(mock);
+    return exitCode;
+}
@@ -1,4 +1,7 @@
 using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
 using System.Runtime.InteropServices;
 using UnityEditor;
 using UnityEngine.Networking.PlayerConnection;
@@ -27,6 +30,8 @@ namespace UnityEngine.XR.OpenXR.Features.RuntimeDebugger
     {
         internal static readonly Guid kEditorToPlayerRequestDebuggerOutput = new Guid("B3E6DED1-C6C7-411C-BE58-86031A0877E7");
         internal static readonly Guid kPlayerToEditorSendDebuggerOutput = new Guid("B3E6DED1-C6C7-411C-BE58-86031A0877E8");
+        internal static readonly Guid kEditorToPlayerSetCaptureFilter = new Guid("B3E6DED1-C6C7-411C-BE58-86031A0877E9");
+        internal static readonly Guid kPlayerToEditorSendDebuggerStats = new Guid("B3E6DED1-C6C7-411C-BE58-86031A0877EA");
 
         /// <summary>
         /// Size of main-thread cache on device for runtime debugger in bytes.
@@ -38,13 +43,70 @@ namespace UnityEngine.XR.OpenXR.Features.RuntimeDebugger
         /// </summary>
         public UInt32 perThreadCacheSize = 50 * 1024;
 
+        /// <summary>
+        /// CPU time per frame the runtime debugger may spend capturing, in milliseconds.  When capturing takes longer, less detail is
+        /// captured (top level parameters only, then timing only, then call counts only) until there is headroom again.  0 disables the budget.
+        /// </summary>
+        public float captureBudgetMs = 0.0f;
+
+        /// <summary>
+        /// Capture data per frame the runtime debugger may produce, in bytes.  Enforced like <see cref="captureBudgetMs"/>.  0 disables the budget.
+        /// </summary>
+        public UInt32 captureBandwidthBudget = 0;
+
+        /// <summary>
+        /// Record the native stack of OpenXR calls that return an error, to find the code path that made them.
+        /// </summary>
+        public bool captureStacksOnError = false;
+
+        /// <summary>
+        /// Record the native stack of OpenXR calls the runtime takes longer than this to return from, in milliseconds.  0 disables it.
+        /// </summary>
+        public float slowCallStackThresholdMs = 0.0f;
+
+        /// <summary>
+        /// Most native stacks recorded per second.  Calls over the limit are captured without their stack.
+        /// </summary>
+        public UInt32 maxStacksPerSecond = 10;
+
+        /// <summary>
+        /// Push capture data to a local socket as it's captured, instead of waiting for the Runtime Debugger window to ask for it.
+        /// The window connects to it with Stream, on Android after forwarding the socket with adb.  While the window is connected, Refresh gets no data.
+        /// </summary>
+        public bool streamCapture = false;
+
+        /// <summary>
+        /// TCP port on 127.0.0.1 the capture stream listens on.  Forward it from an Android device with <c>adb forward tcp:port tcp:port</c>.
+        /// </summary>
+        public UInt32 streamPort = 7960;
+
+        /// <summary>
+        /// Unix domain socket the capture stream listens on instead of <see cref="streamPort"/>, if set.  A leading @ puts it in the abstract
+        /// namespace (Android, Linux), forward it with <c>adb forward tcp:port localabstract:name</c>.  Not supported on Windows.
+        /// </summary>
+        public string streamSocketName = "";
+
+        /// <summary>
+        /// Capture data the stream may hold while the window falls behind, in bytes.  Past half of it, less detail is captured.
+        /// Once it's full, calls that don't fit in the cache are dropped.
+        /// </summary>
+        public UInt32 streamQueueSize = 8 * 1024 * 1024;
+
         private UInt32 lutOffset = 0;
+        private bool captureFilterSet = false;
+
+        private static bool debuggerHooked = false;
+        private static bool captureBudgetSet = false;
+        private static bool stackCaptureSet = false;
+        private static bool captureStreaming = false;
+        private static readonly ConcurrentDictionary<string, UInt32> markerIds = new ConcurrentDictionary<string, UInt32>();
 
         /// <inheritdoc/>
         protected override IntPtr HookGetInstanceProcAddr(IntPtr func)
         {
 #if !UNITY_EDITOR
             PlayerConnection.instance.Register(kEditorToPlayerRequestDebuggerOutput, RecvMsg);
+            PlayerConnection.instance.Register(kEditorToPlayerSetCaptureFilter, RecvCaptureFilterMsg);
 #endif
 
             // Reset
@@ -52,11 +114,92 @@ namespace UnityEngine.XR.OpenXR.Features.RuntimeDebugger
             Native_EndDataAccess();
             lutOffset = 0;
 
-            return Native_HookGetInstanceProcAddr(func, cacheSize, perThreadCacheSize);
+            var hooked = Native_HookGetInstanceProcAddr(func, cacheSize, perThreadCacheSize);
+
+            // Only call into the plugin for settings that are used, or to clear ones set by an earlier hook.
+            bool useCaptureBudget = captureBudgetMs > 0.0f || captureBandwidthBudget > 0;
+            if (useCaptureBudget || captureBudgetSet)
+                captureBudgetSet = SetCaptureBudget(captureBudgetMs, captureBandwidthBudget) && useCaptureBudget;
+            bool useStackCapture = captureStacksOnError || slowCallStackThresholdMs > 0.0f;
+            if (useStackCapture || stackCaptureSet)
+                stackCaptureSet = SetStackCapture(captureStacksOnError, slowCallStackThresholdMs, maxStacksPerSecond) && useStackCapture;
+
+            if (streamCapture)
+            {
+                try
+                {
+                    captureStreaming = Native_StartCaptureStream((UInt16)streamPort, streamSocketName, streamQueueSize);
+                    if (!captureStreaming)
+                        Debug.LogWarning($"Runtime Debugger couldn't listen on {(string.IsNullOrEmpty(streamSocketName) ? $"port {streamPort}" : streamSocketName)}, capture stream disabled.");
+                }
+                catch (EntryPointNotFoundException)
+                {
+                    Debug.LogWarning("Runtime Debugger plugin doesn't support capture streaming, streamCapture is ignored.");
+                }
+            }
+            else if (captureStreaming)
+            {
+                Native_StopCaptureStream();
+                captureStreaming = false;
+            }
+            debuggerHooked = true;
+            return hooked;
+        }
+
+        /// <inheritdoc/>
+        protected internal override void OnInstanceDestroy(ulong xrInstance)
+        {
+            base.OnInstanceDestroy(xrInstance);
+
+            // Join the stream thread here rather than when the plugin is unloaded, it's started again with the next instance.
+            if (captureStreaming)
+            {
+                Native_StopCaptureStream();
+                captureStreaming = false;
+            }
+        }
+
+        // Lock free once a name is known.  Threads racing on a new name may both register it, the plugin returns the same id to each.
+        private static UInt32 GetMarkerId(string name) => markerIds.GetOrAdd(name, n => Native_RegisterMarkerName(n));
+
+        /// <summary>
+        /// Opens a named range on the calling thread, shown in the Runtime Debugger window alongside the OpenXR calls.
+        /// Use it to mark engine side work such as scene loads, asset streaming or shader compiles.  Close it with <see cref="PopMarker"/> on the same thread.
+        /// Does nothing unless the Runtime Debugger feature is enabled.
+        /// </summary>
+        /// <param name="name">Name of the range.</param>
+        public static void PushMarker(string name)
+        {
+            if (debuggerHooked)
+                Native_PushMarker(GetMarkerId(name));
+        }
+
+        /// <summary>
+        /// Closes the innermost range opened with <see cref="PushMarker"/> on the calling thread.
+        /// </summary>
+        public static void PopMarker()
+        {
+            if (debuggerHooked)
+                Native_PopMarker();
+        }
+
+        /// <summary>
+        /// Marks a point in time on the calling thread, shown in the Runtime Debugger window alongside the OpenXR calls.
+        /// Does nothing unless the Runtime Debugger feature is enabled.
+        /// </summary>
+        /// <param name="name">Name of the marker.</param>
+        public static void InstantMarker(string name)
+        {
+            if (debuggerHooked)
+                Native_InstantMarker(GetMarkerId(name));
         }
 
         internal void RecvMsg(MessageEventArgs args)
         {
+            // The capture stream is the only reader while a client is connected to it.
+            if (captureStreaming && GetCaptureStreamStats().connected != 0)
+                return;
+
             Native_StartDataAccess();
 
             // LUT for actions / handles
@@ -68,27 +211,602 @@ namespace UnityEngine.XR.OpenXR.Features.RuntimeDebugger
                 Marshal.Copy(lutPtr, lutData, 0, (int)lutSize);
             }
 
-            // ring buffer on native side, so might get two chunks of data
-            Native_GetDataForRead(out var ptr1, out var size1);
-            Native_GetDataForRead(out var ptr2, out var size2);
+            byte[] data;
+            if (captureFilterSet)
+            {
+                // filtered on native side, only matching calls are copied
+                Native_GetFilteredDataForRead(out var ptr, out var size);
+                data = new byte[size];
+                if (size > 0)
+                    Marshal.Copy(ptr, data, 0, (int)size);
+            }
+            else
+            {
+                // ring buffer on native side, so might get two chunks of data
+                Native_GetDataForRead(out var ptr1, out var size1);
+                Native_GetDataForRead(out var ptr2, out var size2);
 
-            byte[] data = new byte[size1 + size2];
-            if (size1 > 0)
-                Marshal.Copy(ptr1, data, 0, (int)size1);
-            if (size2 > 0)
-                Marshal.Copy(ptr2, data, (int)size1, (int)size2);
+                data = new byte[size1 + size2];
+                if (size1 > 0)
+                    Marshal.Copy(ptr1, data, 0, (int)size1);
+                if (size2 > 0)
+                    Marshal.Copy(ptr2, data, (int)size1, (int)size2);
+            }
 
             Native_EndDataAccess();
 
+            var stats = DebuggerStats.Collect();
+
 #if !UNITY_EDITOR
             PlayerConnection.instance.Send(kPlayerToEditorSendDebuggerOutput, lutData);
             PlayerConnection.instance.Send(kPlayerToEditorSendDebuggerOutput, data);
+            if (stats != null)
+                PlayerConnection.instance.Send(kPlayerToEditorSendDebuggerStats, stats.Serialize());
 #else
             DebuggerState.OnMessageEvent(new MessageEventArgs() {playerId = 0, data = lutData});
             DebuggerState.OnMessageEvent(new MessageEventArgs() { playerId = 0, data = data});
+            if (stats != null)
+                DebuggerState.OnStatsEvent(new MessageEventArgs() { playerId = 0, data = stats.Serialize() });
 #endif
         }
 
+        /// <summary>
+        /// Sets or clears the capture filter from a kEditorToPlayerSetCaptureFilter message, see <see cref="SerializeCaptureFilter"/>.
+        /// An empty message clears it.
+        /// </summary>
+        internal void RecvCaptureFilterMsg(MessageEventArgs args)
+        {
+            try
+            {
+                if (args.data == null || args.data.Length == 0)
+                {
+                    ClearCaptureFilter();
+                    return;
+                }
+
+                using (var r = new BinaryReader(new MemoryStream(args.data)))
+                {
+                    var filter = ReadStruct<CaptureFilter>(r);
+                    var thread = r.ReadString();
+                    var functionNames = new string[r.ReadInt32()];
+                    for (int i = 0; i < functionNames.Length; ++i)
+                        functionNames[i] = r.ReadString();
+                    SetCaptureFilter(filter, functionNames.Length > 0 ? functionNames : null, thread.Length > 0 ? thread : null);
+                }
+            }
+            catch (EntryPointNotFoundException)
+            {
+                Debug.LogWarning("Runtime Debugger plugin doesn't support capture filters yet, capturing every call.");
+            }
+        }
+
+        /// <summary>
+        /// Builds a kEditorToPlayerSetCaptureFilter message.  Fields left empty match everything.
+        /// </summary>
+        internal static byte[] SerializeCaptureFilter(CaptureFilter filter, string[] functionNames, string thread)
+        {
+            using (var ms = new MemoryStream())
+            {
+                using (var w = new BinaryWriter(ms))
+                {
+                    WriteStruct(w, filter);
+                    w.Write(thread ?? "");
+                    w.Write(functionNames != null ? functionNames.Length : 0);
+                    if (functionNames != null)
+                    {
+                        foreach (var name in functionNames)
+                            w.Write(name);
+                    }
+                }
+                return ms.ToArray();
+            }
+        }
+
+        // Structs below are copied to messages as is.  None of them hold pointers, so player and editor agree on their layout.
+        private static void WriteStruct<T>(BinaryWriter w, T value) where T : struct
+        {
+            var bytes = new byte[Marshal.SizeOf<T>()];
+            var pinned = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+            try
+            {
+                Marshal.StructureToPtr(value, pinned.AddrOfPinnedObject(), false);
+            }
+            finally
+            {
+                pinned.Free();
+            }
+            w.Write(bytes);
+        }
+
+        private static T ReadStruct<T>(BinaryReader r) where T : struct
+        {
+            var bytes = r.ReadBytes(Marshal.SizeOf<T>());
+            if (bytes.Length != Marshal.SizeOf<T>())
+                throw new EndOfStreamException();
+
+            var pinned = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+            try
+            {
+                return Marshal.PtrToStructure<T>(pinned.AddrOfPinnedObject());
+            }
+            finally
+            {
+                pinned.Free();
+            }
+        }
+
+        /// <summary>
+        /// Fills <paramref name="liveCounts"/> with the number of live OpenXR handles per handle type name.
+        /// Only handle types with live handles are added.  Handles are not tracked on 32-bit players.
+        /// </summary>
+        internal static void GetLiveHandleCounts(Dictionary<string, UInt32> liveCounts)
+        {
+            liveCounts.Clear();
+            var numTypes = Native_GetHandleLiveCounts(null, 0);
+            if (numTypes == 0)
+                return;
+
+            var counts = new UInt32[numTypes];
+            Native_GetHandleLiveCounts(counts, numTypes);
+            for (UInt32 i = 0; i < numTypes; ++i)
+            {
+                if (counts[i] > 0)
+                    liveCounts[Marshal.PtrToStringAnsi(Native_GetHandleTypeName(i))] = counts[i];
+            }
+        }
+
+        /// <summary>
+        /// Rolling pose statistics for one located space (relative to a base space) or one view, computed on device.
+        /// Layout matches PoseTrackStats in pose_stream.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct PoseTrackStats
+        {
+            public UInt64 space;
+            public UInt64 baseSpace;
+            public UInt32 viewIndex;
+            public UInt32 sampleCount;
+            public float positionalJitter;
+            public float rotationalJitter;
+            public float maxPositionalJitter;
+            public float maxRotationalJitter;
+            public float linearSpeed;
+            public float angularSpeed;
+            public UInt32 trackingLossCount;
+            public UInt32 inTrackingLoss;
+            public Int64 trackingLossTotal;
+            public Int64 trackingLossLongest;
+        }
+
+        /// <summary>
+        /// Returns the pose statistics of every space and view located since the debugger was hooked.
+        /// </summary>
+        internal static PoseTrackStats[] GetPoseStreamStats()
+        {
+            var numTracks = Native_GetPoseStreamStats(null, 0);
+            var stats = new PoseTrackStats[numTracks];
+            if (numTracks > 0)
+                Native_GetPoseStreamStats(stats, numTracks);
+            return stats;
+        }
+
+        /// <summary>
+        /// Histograms over the frames currently held in the frame pacing log.
+        /// Layout matches FramePacingHistogram in frame_pacing.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct FramePacingHistogram
+        {
+            internal const int k_NumBuckets = 64;
+
+            public UInt32 totalFrames;
+            public UInt32 windowFrames;
+            public UInt32 missedVsyncs;
+            public UInt32 lateFrames;
+            public UInt32 discardedFrames;
+            public UInt32 bucketWidthUs;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = k_NumBuckets)]
+            public UInt32[] cpuTime;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = k_NumBuckets)]
+            public UInt32[] waitToEnd;
+        }
+
+        internal static FramePacingHistogram GetFramePacingHistogram()
+        {
+            Native_GetFramePacingHistogram(out var histogram);
+            return histogram;
+        }
+
+        /// <summary>
+        /// Time under which <paramref name="fraction"/> of the frames in <paramref name="buckets"/> fall, in milliseconds.
+        /// </summary>
+        internal static float HistogramPercentile(UInt32[] buckets, UInt32 bucketWidthUs, float fraction)
+        {
+            UInt64 total = 0;
+            foreach (var count in buckets)
+                total += count;
+            if (total == 0)
+                return 0.0f;
+
+            UInt64 seen = 0;
+            for (int i = 0; i < buckets.Length; ++i)
+            {
+                seen += buckets[i];
+                if (seen >= fraction * total)
+                    return (i + 1) * bucketWidthUs / 1000.0f;
+            }
+            return buckets.Length * bucketWidthUs / 1000.0f;
+        }
+
+        /// <summary>
+        /// Memory used by the debugger and counts of capture data that was dropped.
+        /// Layout matches DebuggerMemoryStats in debugger_stats.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct DebuggerMemoryStats
+        {
+            public UInt64 totalBytes;
+            public UInt64 mainStoreBytes;
+            public UInt64 lutStoreBytes;
+            public UInt64 threadBufferBytes;
+            public UInt64 pooledThreadBufferBytes;
+            public UInt64 analyticsBytes;
+            public UInt32 liveThreadBuffers;
+            public UInt32 pooledThreadBuffers;
+            public UInt32 threadBufferHighWaterMark;
+            public UInt32 threadBufferSize;
+            public UInt64 cacheNotLargeEnoughCount;
+            public UInt64 threadBufferFailedWrites;
+        }
+
+        internal static DebuggerMemoryStats GetDebuggerMemoryStats()
+        {
+            Native_GetDebuggerMemoryStats(out var stats);
+            return stats;
+        }
+
+        /// <summary>
+        /// Analytics computed on device, sent to the Runtime Debugger window along with each capture.
+        /// </summary>
+        internal class DebuggerStats
+        {
+            public DebuggerMemoryStats memory;
+            public FramePacingHistogram framePacing;
+            public PoseTrackStats[] poses;
+            public UInt64 stacksRateLimited;
+            public CaptureDetail captureDetail;
+
+            /// <summary>
+            /// Returns null if the plugin doesn't compute them.
+            /// </summary>
+            internal static DebuggerStats Collect()
+            {
+                try
+                {
+                    return new DebuggerStats
+                    {
+                        memory = GetDebuggerMemoryStats(),
+                        framePacing = GetFramePacingHistogram(),
+                        poses = GetPoseStreamStats(),
+                        stacksRateLimited = GetStacksRateLimited(),
+                        captureDetail = GetCaptureDetail()
+                    };
+                }
+                catch (EntryPointNotFoundException)
+                {
+                    return null;
+                }
+            }
+
+            internal byte[] Serialize()
+            {
+                using (var ms = new MemoryStream())
+                {
+                    using (var w = new BinaryWriter(ms))
+                    {
+                        WriteStruct(w, memory);
+                        WriteStruct(w, framePacing);
+                        w.Write(poses.Length);
+                        foreach (var pose in poses)
+                            WriteStruct(w, pose);
+                        w.Write(stacksRateLimited);
+                        w.Write((UInt32)captureDetail);
+                    }
+                    return ms.ToArray();
+                }
+            }
+
+            internal static DebuggerStats Deserialize(byte[] data)
+            {
+                using (var r = new BinaryReader(new MemoryStream(data)))
+                {
+                    var stats = new DebuggerStats
+                    {
+                        memory = ReadStruct<DebuggerMemoryStats>(r),
+                        framePacing = ReadStruct<FramePacingHistogram>(r),
+                        poses = new PoseTrackStats[r.ReadInt32()]
+                    };
+                    for (int i = 0; i < stats.poses.Length; ++i)
+                        stats.poses[i] = ReadStruct<PoseTrackStats>(r);
+                    stats.stacksRateLimited = r.ReadUInt64();
+                    stats.captureDetail = (CaptureDetail)r.ReadUInt32();
+                    return stats;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Schema of captures written by the runtime debugger plugin.
+        /// Layout matches CaptureSchema in capture_header.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct CaptureSchema
+        {
+            public UInt32 formatVersion;
+            public UInt32 commandCount;
+            public UInt64 resultTableHash;
+            public UInt64 structureTypeTableHash;
+            public UInt64 functionTableHash;
+            public UInt64 lutTableHash;
+        }
+
+        internal static CaptureSchema GetCaptureSchema()
+        {
+            Native_GetCaptureSchema(out var schema);
+            return schema;
+        }
+
+        /// <summary>
+        /// One top level record of a capture.  Pointers point into the buffer the cursor was opened on.
+        /// Layout matches RecordView in record_cursor.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct RecordView
+        {
+            public Int64 timestamp;
+            public IntPtr record;
+            public IntPtr thread;
+            public IntPtr name;
+            public IntPtr result;
+            public IntPtr fields;
+            public UInt32 command;
+            public UInt32 functionId;
+            public UInt32 recordSize;
+            public UInt32 fieldsSize;
+
+            public string threadString => Marshal.PtrToStringAnsi(thread);
+            public string nameString => Marshal.PtrToStringAnsi(name);
+            public string resultString => Marshal.PtrToStringAnsi(result);
+        }
+
+        /// <summary>
+        /// Walks the records of a capture without copying or parsing the fields of each call.
+        /// The capture is pinned until the cursor is disposed.
+        /// </summary>
+        internal sealed class RecordCursor : IDisposable
+        {
+            private GCHandle m_Data;
+            private IntPtr m_Cursor;
+
+            public RecordCursor(byte[] data)
+            {
+                m_Data = GCHandle.Alloc(data, GCHandleType.Pinned);
+                m_Cursor = Native_OpenRecordCursor(m_Data.AddrOfPinnedObject(), (UInt32)data.Length);
+            }
+
+            /// <summary>
+            /// Returns false at the end of the capture, or if it is malformed (see <see cref="error"/>).
+            /// </summary>
+            public bool Next(out RecordView view)
+            {
+                view = default;
+                return m_Cursor != IntPtr.Zero && Native_NextRecord(m_Cursor, out view);
+            }
+
+            public string error => m_Cursor != IntPtr.Zero ? Marshal.PtrToStringAnsi(Native_GetRecordCursorError(m_Cursor)) : null;
+
+            public void Dispose()
+            {
+                if (m_Cursor != IntPtr.Zero)
+                {
+                    Native_CloseRecordCursor(m_Cursor);
+                    m_Cursor = IntPtr.Zero;
+                }
+                if (m_Data.IsAllocated)
+                    m_Data.Free();
+            }
+        }
+
+        /// <summary>
+        /// Result classes for <see cref="CaptureFilter.resultClasses"/>.
+        /// </summary>
+        [Flags]
+        internal enum CaptureResultClass : UInt32
+        {
+            Success = 1 << 0,
+            QualifiedSuccess = 1 << 1,
+            Error = 1 << 2,
+        }
+
+        /// <summary>
+        /// Criteria for which function calls are sent from the player.  Fields left at 0 match everything.
+        /// Layout matches CaptureFilter in capture_filter.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct CaptureFilter
+        {
+            public Int64 startTime;
+            public Int64 endTime;
+            public UInt64 handle;
+            public CaptureResultClass resultClasses;
+        }
+
+        /// <summary>
+        /// Only send function calls that match <paramref name="filter"/>.  Calls are filtered on the native side before they are copied.
+        /// </summary>
+        /// <param name="filter">Time range, handle and result criteria.</param>
+        /// <param name="functionNames">Functions to keep, or null for all functions.</param>
+        /// <param name="thread">Thread to keep, or null for all threads.</param>
+        internal void SetCaptureFilter(CaptureFilter filter, string[] functionNames = null, string thread = null)
+        {
+            UInt32[] functionIds = null;
+            if (functionNames != null)
+            {
+                functionIds = new UInt32[functionNames.Length];
+                for (int i = 0; i < functionNames.Length; ++i)
+                    functionIds[i] = GetFunctionId(functionNames[i]);
+            }
+
+            Native_SetCaptureFilter(ref filter, functionIds, functionIds != null ? (UInt32)functionIds.Length : 0, thread);
+            captureFilterSet = true;
+        }
+
+        internal void ClearCaptureFilter()
+        {
+            Native_ClearCaptureFilter();
+            captureFilterSet = false;
+        }
+
+        /// <summary>
+        /// Detail the runtime debugger captures calls with.  Lowered automatically when capturing goes over budget, see <see cref="captureBudgetMs"/>.
+        /// Values match CaptureDetail in capture_governor.h.
+        /// </summary>
+        internal enum CaptureDetail : UInt32
+        {
+            Full,
+            TopLevel,
+            Timing,
+            Counts,
+        }
+
+        /// <summary>
+        /// Layout matches CaptureBudget in capture_governor.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct CaptureBudget
+        {
+            public Int64 cpuNsPerFrame;
+            public UInt64 bytesPerFrame;
+        }
+
+        /// <summary>
+        /// Returns false if the plugin was built without capture budgets.
+        /// </summary>
+        internal static bool SetCaptureBudget(float cpuMsPerFrame, UInt32 bytesPerFrame)
+        {
+            var budget = new CaptureBudget
+            {
+                cpuNsPerFrame = (Int64)(Math.Max(cpuMsPerFrame, 0.0f) * 1000000.0f),
+                bytesPerFrame = bytesPerFrame
+            };
+            try
+            {
+                Native_SetCaptureBudget(ref budget);
+                return true;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                Debug.LogWarning("Runtime Debugger plugin doesn't support capture budgets, captureBudgetMs and captureBandwidthBudget are ignored.");
+                return false;
+            }
+        }
+
+        internal static CaptureDetail GetCaptureDetail() => (CaptureDetail)Native_GetCaptureDetail();
+
+        /// <summary>
+        /// Values match StackCaptureFlags in stack_capture.h.
+        /// </summary>
+        [Flags]
+        internal enum StackCaptureFlags : UInt32
+        {
+            OnError = 1 << 0,
+            OnSlowCall = 1 << 1,
+        }
+
+        /// <summary>
+        /// Layout matches StackCaptureSettings in stack_capture.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct StackCaptureSettings
+        {
+            public Int64 slowCallNs;
+            public StackCaptureFlags flags;
+            public UInt32 maxStacksPerSecond;
+        }
+
+        /// <summary>
+        /// Returns false if the plugin was built without stack capture.
+        /// </summary>
+        internal static bool SetStackCapture(bool onError, float slowCallMs, UInt32 maxPerSecond)
+        {
+            var settings = new StackCaptureSettings
+            {
+                slowCallNs = (Int64)(Math.Max(slowCallMs, 0.0f) * 1000000.0f),
+                maxStacksPerSecond = maxPerSecond
+            };
+            if (onError)
+                settings.flags |= StackCaptureFlags.OnError;
+            if (slowCallMs > 0.0f)
+                settings.flags |= StackCaptureFlags.OnSlowCall;
+            try
+            {
+                Native_SetStackCapture(ref settings, null, 0);
+                return true;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                Debug.LogWarning("Runtime Debugger plugin doesn't support stack capture, captureStacksOnError and slowCallStackThresholdMs are ignored.");
+                return false;
+            }
+        }
+
+        internal static UInt64 GetStacksRateLimited() => Native_GetStacksRateLimited();
+
+        /// <summary>
+        /// Values match CaptureStreamFrameKind in capture_stream.h.
+        /// </summary>
+        internal enum CaptureStreamFrameKind : UInt32
+        {
+            LUT,
+            Data,
+        }
+
+        /// <summary>
+        /// Layout matches CaptureStreamStats in capture_stream.h.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct CaptureStreamStats
+        {
+            public UInt64 bytesSent;
+            public UInt64 framesSent;
+            public UInt64 connections;
+            public UInt32 queuedBytes;
+            public UInt32 connected;
+        }
+
+        internal static CaptureStreamStats GetCaptureStreamStats()
+        {
+            Native_GetCaptureStreamStats(out var stats);
+            return stats;
+        }
+
+        internal static string GetFunctionName(UInt32 functionId) => Marshal.PtrToStringAnsi(Native_GetFunctionName(functionId));
+
+        internal static UInt32 GetFunctionId(string functionName) => Native_GetFunctionId(functionName);
+
+        /// <summary>
+        /// Expands the event struct of a kPolledEvent record into fields, or returns null if it can't be read.
+        /// </summary>
+        internal static byte[] ExpandPolledEvent(byte[] eventData, UInt32 scope)
+        {
+            var expanded = new byte[16 * 1024];
+            var size = Native_ExpandPolledEvent(eventData, (UInt32)eventData.Length, scope, expanded, (UInt32)expanded.Length);
+            if (size == 0)
+                return null;
+            Array.Resize(ref expanded, (int)size);
+            return expanded;
+        }
+
         private const string Library = "openxr_runtime_debugger";
         [DllImport(Library, EntryPoint = "HookXrInstanceProcAddr")]
         private static extern IntPtr Native_HookGetInstanceProcAddr(IntPtr func, UInt32 cacheSize, UInt32 perThreadCacheSize);
@@ -105,5 +823,88 @@ namespace UnityEngine.XR.OpenXR.Features.RuntimeDebugger
 
         [DllImport(Library, EntryPoint = "EndDataAccess")]
         private static extern void Native_EndDataAccess();
+
+        [DllImport(Library, EntryPoint = "GetHandleLiveCounts")]
+        private static extern UInt32 Native_GetHandleLiveCounts([Out] UInt32[] counts, UInt32 capacity);
+
+        [DllImport(Library, EntryPoint = "GetHandleTypeName")]
+        private static extern IntPtr Native_GetHandleTypeName(UInt32 handleType);
+
+        [DllImport(Library, EntryPoint = "GetPoseStreamStats")]
+        private static extern UInt32 Native_GetPoseStreamStats([Out] PoseTrackStats[] stats, UInt32 capacity);
+
+        [DllImport(Library, EntryPoint = "GetFramePacingHistogram")]
+        private static extern void Native_GetFramePacingHistogram(out FramePacingHistogram histogram);
+
+        [DllImport(Library, EntryPoint = "GetDebuggerMemoryStats")]
+        private static extern void Native_GetDebuggerMemoryStats(out DebuggerMemoryStats stats);
+
+        [DllImport(Library, EntryPoint = "GetCaptureSchema")]
+        private static extern void Native_GetCaptureSchema(out CaptureSchema schema);
+
+        [DllImport(Library, EntryPoint = "OpenRecordCursor")]
+        private static extern IntPtr Native_OpenRecordCursor(IntPtr data, UInt32 size);
+
+        [DllImport(Library, EntryPoint = "NextRecord")]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static extern bool Native_NextRecord(IntPtr cursor, out RecordView view);
+
+        [DllImport(Library, EntryPoint = "GetRecordCursorError")]
+        private static extern IntPtr Native_GetRecordCursorError(IntPtr cursor);
+
+        [DllImport(Library, EntryPoint = "CloseRecordCursor")]
+        private static extern void Native_CloseRecordCursor(IntPtr cursor);
+
+        [DllImport(Library, EntryPoint = "SetCaptureFilter")]
+        private static extern void Native_SetCaptureFilter(ref CaptureFilter filter, [In] UInt32[] functionIds, UInt32 functionIdCount, [MarshalAs(UnmanagedType.LPStr)] string thread);
+
+        [DllImport(Library, EntryPoint = "ClearCaptureFilter")]
+        private static extern void Native_ClearCaptureFilter();
+
+        [DllImport(Library, EntryPoint = "GetFilteredDataForRead")]
+        private static extern UInt32 Native_GetFilteredDataForRead(out IntPtr ptr, out UInt32 size);
+
+        [DllImport(Library, EntryPoint = "GetFunctionName")]
+        private static extern IntPtr Native_GetFunctionName(UInt32 functionId);
+
+        [DllImport(Library, EntryPoint = "GetFunctionId")]
+        private static extern UInt32 Native_GetFunctionId([MarshalAs(UnmanagedType.LPStr)] string functionName);
+
+        [DllImport(Library, EntryPoint = "ExpandPolledEvent")]
+        private static extern UInt32 Native_ExpandPolledEvent([In] byte[] eventData, UInt32 size, UInt32 scope, [Out] byte[] expanded, UInt32 capacity);
+
+        [DllImport(Library, EntryPoint = "SetCaptureBudget")]
+        private static extern void Native_SetCaptureBudget(ref CaptureBudget budget);
+
+        [DllImport(Library, EntryPoint = "GetCaptureDetail")]
+        private static extern UInt32 Native_GetCaptureDetail();
+
+        [DllImport(Library, EntryPoint = "SetStackCapture")]
+        private static extern void Native_SetStackCapture(ref StackCaptureSettings settings, [In] UInt32[] functionIds, UInt32 functionIdCount);
+
+        [DllImport(Library, EntryPoint = "GetStacksRateLimited")]
+        private static extern UInt64 Native_GetStacksRateLimited();
+
+        [DllImport(Library, EntryPoint = "StartCaptureStream")]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static extern bool Native_StartCaptureStream(UInt16 port, [MarshalAs(UnmanagedType.LPStr)] string socketName, UInt32 maxQueuedBytes);
+
+        [DllImport(Library, EntryPoint = "StopCaptureStream")]
+        private static extern void Native_StopCaptureStream();
+
+        [DllImport(Library, EntryPoint = "GetCaptureStreamStats")]
+        private static extern void Native_GetCaptureStreamStats(out CaptureStreamStats stats);
+
+        [DllImport(Library, EntryPoint = "RegisterMarkerName")]
+        private static extern UInt32 Native_RegisterMarkerName([MarshalAs(UnmanagedType.LPStr)] string name);
+
+        [DllImport(Library, EntryPoint = "PushMarker")]
+        private static extern void Native_PushMarker(UInt32 nameId);
+
+        [DllImport(Library, EntryPoint = "PopMarker")]
+        private static extern void Native_PopMarker();
+
+        [DllImport(Library, EntryPoint = "InstantMarker")]
+        private static extern void Native_InstantMarker(UInt32 nameId);
     }
 }
@@ -0,0 +1,106 @@
+#pragma once
+
+// Skeleton shared by the command line tools that drive the mock runtime (runtime_debugger_benchmark,
+// runtime_debugger_replay, mock_runtime_benchmark).
+// Include after <openxr/openxr.h>, with TOOL_FUNCS(_) defined as the list of functions the tool calls once it has an
+// instance.  They're loaded into XrFunctions by LoadFunctions.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifndef TOOL_FUNCS
+#error Define TOOL_FUNCS(_) before including openxr_tool.h
+#endif
+
+#define CHECK_XR(call)                                                                 \
+    do                                                                                 \
+    {                                                                                  \
+        XrResult checkResult = (call);                                                 \
+        if (XR_FAILED(checkResult))                                                    \
+        {                                                                              \
+            printf("%s failed: %d (%s:%d)\n", #call, checkResult, __FILE__, __LINE__); \
+            return false;                                                              \
+        }                                                                              \
+    } while (0)
+
+#define GEN_TOOL_MEMBER(f) PFN_##f f;
+
+struct XrFunctions
+{
+    PFN_xrGetInstanceProcAddr xrGetInstanceProcAddr;
+    PFN_xrEnumerateInstanceExtensionProperties xrEnumerateInstanceExtensionProperties;
+    PFN_xrCreateInstance xrCreateInstance;
+    TOOL_FUNCS(GEN_TOOL_MEMBER)
+};
+
+#undef GEN_TOOL_MEMBER
+
+// Functions that don't need an instance.
+static bool LoadGlobalFunctions(XrFunctions& xr, PFN_xrGetInstanceProcAddr getInstanceProcAddr)
+{
+    xr.xrGetInstanceProcAddr = getInstanceProcAddr;
+    CHECK_XR(getInstanceProcAddr(XR_NULL_HANDLE, "xrCreateInstance", (PFN_xrVoidFunction*)&xr.xrCreateInstance));
+    CHECK_XR(getInstanceProcAddr(XR_NULL_HANDLE, "xrEnumerateInstanceExtensionProperties", (PFN_xrVoidFunction*)&xr.xrEnumerateInstanceExtensionProperties));
+    return true;
+}
+
+static bool LoadFunctions(XrFunctions& xr, XrInstance instance)
+{
+#define GEN_TOOL_LOAD(f) CHECK_XR(xr.xrGetInstanceProcAddr(instance, #f, (PFN_xrVoidFunction*)&xr.f));
+    TOOL_FUNCS(GEN_TOOL_LOAD)
+#undef GEN_TOOL_LOAD
+    return true;
+}
+
+// Polls until the event queue is empty.
+static bool PollEvents(const XrFunctions& xr, XrInstance instance)
+{
+    for (;;)
+    {
+        XrEventDataBuffer event = {XR_TYPE_EVENT_DATA_BUFFER};
+        XrResult result = xr.xrPollEvent(instance, &event);
+        CHECK_XR(result);
+        if (result == XR_EVENT_UNAVAILABLE)
+            return true;
+    }
+}
+
+// Creates an instance with the mock's test extensions and a running session.  Needs xrGetSystem, xrCreateSession,
+// xrBeginSession and xrPollEvent in TOOL_FUNCS.
+static bool CreateMockSession(XrFunctions& xr, PFN_xrGetInstanceProcAddr getInstanceProcAddr, const char* applicationName, XrInstance& instance, XrSystemId& systemId, XrSession& session)
+{
+    if (!LoadGlobalFunctions(xr, getInstanceProcAddr))
+        return false;
+
+    const char* const extensions[] = {"XR_UNITY_mock_test", "XR_UNITY_null_gfx"};
+    XrInstanceCreateInfo instanceInfo = {XR_TYPE_INSTANCE_CREATE_INFO};
+    strncpy(instanceInfo.applicationInfo.applicationName, applicationName, XR_MAX_APPLICATION_NAME_SIZE - 1);
+    instanceInfo.applicationInfo.apiVersion = XR_CURRENT_API_VERSION;
+    instanceInfo.enabledExtensionCount = 2;
+    instanceInfo.enabledExtensionNames = extensions;
+    CHECK_XR(xr.xrCreateInstance(&instanceInfo, &instance));
+
+    if (!LoadFunctions(xr, instance))
+        return false;
+
+    XrSystemGetInfo systemInfo = {XR_TYPE_SYSTEM_GET_INFO};
+    systemInfo.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+    CHECK_XR(xr.xrGetSystem(instance, &systemInfo, &systemId));
+
+    XrSessionCreateInfo sessionInfo = {XR_TYPE_SESSION_CREATE_INFO};
+    sessionInfo.systemId = systemId;
+    CHECK_XR(xr.xrCreateSession(instance, &sessionInfo, &session));
+    if (!PollEvents(xr, instance))
+        return false;
+
+    XrSessionBeginInfo beginInfo = {XR_TYPE_SESSION_BEGIN_INFO};
+    beginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    CHECK_XR(xr.xrBeginSession(session, &beginInfo));
+    return PollEvents(xr, instance);
+}
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,124 @@
+using System;
+using System.IO;
+using System.Linq;
+using System.Text;
+using NUnit.Framework;
+using UnityEditor.XR.OpenXR.Features.RuntimeDebugger;
+using UnityEngine;
+using UnityEngine.Networking.PlayerConnection;
+using Command = UnityEditor.XR.OpenXR.Features.RuntimeDebugger.DebuggerState.Command;
+
+namespace UnityEditor.XR.OpenXR.Tests
+{
+    class RuntimeDebuggerStateTests
+    {
+        static readonly string[] k_LutNames = { "XrPaths", "XrActions", "XrActionSets", "XrSpaces", "Markers", "Stacks", "Events" };
+
+        string m_FirstPath;
+        string m_SecondPath;
+
+        [SetUp]
+        public void SetUp()
+        {
+            m_FirstPath = Path.GetTempFileName();
+            m_SecondPath = Path.GetTempFileName();
+            DebuggerState.SetDoneCallback(null);
+            DebuggerState.Clear();
+        }
+
+        [TearDown]
+        public void TearDown()
+        {
+            File.Delete(m_FirstPath);
+            File.Delete(m_SecondPath);
+            DebuggerState.Clear();
+        }
+
+        static void WriteString(BinaryWriter w, string value)
+        {
+            w.Write(Encoding.UTF8.GetBytes(value));
+            w.Write((byte)0);
+        }
+
+        // Capture header and LUT definition, as sent once by the player (see capture_header.h and ResetLUT in serialize_data.h).
+        static byte[] LutMessage()
+        {
+            var lutHash = k_LutNames.Aggregate(DebuggerState.CaptureHeader.HashSeed, DebuggerState.CaptureHeader.Hash);
+
+            using var ms = new MemoryStream();
+            using var w = new BinaryWriter(ms);
+            w.Write((UInt32)Command.kCaptureHeader);
+            w.Write(DebuggerState.CaptureHeader.Magic);
+            w.Write(DebuggerState.CaptureHeader.SupportedFormatVersion);
+            w.Write(DebuggerState.CaptureHeader.EndianMarker);
+            w.Write((UInt32)IntPtr.Size);
+            w.Write((UInt32)1);
+            w.Write((UInt64)0);
+            w.Write((UInt32)Command.kCaptureCommandCount);
+            w.Write((UInt64)0);
+            w.Write((UInt64)0);
+            w.Write((UInt64)0);
+            w.Write(lutHash);
+            WriteString(w, "steady_clock");
+            w.Write((UInt64)1000000000);
+            w.Write((Int64)0);
+            w.Write((Int64)0);
+
+            w.Write((UInt32)Command.kLUTDefineTables);
+            w.Write((UInt32)k_LutNames.Length);
+            foreach (var name in k_LutNames)
+                WriteString(w, name);
+            return ms.ToArray();
+        }
+
+        static byte[] CallMessage(string function, Int64 timestamp)
+        {
+            using var body = new MemoryStream();
+            using var bw = new BinaryWriter(body);
+            WriteString(bw, "main");
+            WriteString(bw, function);
+            bw.Write(timestamp);
+            bw.Write((UInt32)Command.kUInt32);
+            WriteString(bw, "value");
+            bw.Write((UInt32)42);
+            bw.Write((UInt32)Command.kEndFunctionCall);
+            WriteString(bw, "XR_SUCCESS");
+            var bodyBytes = body.ToArray();
+
+            using var ms = new MemoryStream();
+            using var w = new BinaryWriter(ms);
+            w.Write((UInt32)Command.kStartFunctionCall);
+            w.Write((UInt32)(8 + bodyBytes.Length));
+            w.Write(bodyBytes);
+            return ms.ToArray();
+        }
+
+        [Test]
+        public void SaveAfterClearKeepsHeaderAndLut()
+        {
+            DebuggerState.OnMessageEvent(new MessageEventArgs() { data = LutMessage() });
+            DebuggerState.OnMessageEvent(new MessageEventArgs() { data = CallMessage("xrFirst", 1000) });
+            DebuggerState.SaveToFile(m_FirstPath);
+
+            // The player doesn't send the header and LUT again after a Clear.
+            DebuggerState.Clear();
+            Assert.IsNotNull(DebuggerState.captureHeader, "Clear must keep the capture header of the player");
+            Assert.AreEqual(0, DebuggerState._functionCalls.Count);
+
+            DebuggerState.OnMessageEvent(new MessageEventArgs() { data = CallMessage("xrSecond", 2000) });
+            DebuggerState.SaveToFile(m_SecondPath);
+
+            DebuggerState.Clear();
+            DebuggerState.LoadFromFile(m_SecondPath);
+
+            Assert.IsNotNull(DebuggerState.captureHeader, "Capture saved after Clear has no header");
+            CollectionAssert.AreEqual(new[] { "All Calls" }.Concat(k_LutNames), DebuggerState.lutNames, "Capture saved after Clear has no LUT");
+            Assert.AreEqual(1, DebuggerState._functionCalls.Count);
+
+            var call = DebuggerState._functionCalls[0];
+            Assert.AreEqual("main", call.threadId);
+            Assert.AreEqual("xrSecond = XR_SUCCESS", call.displayName);
+            Assert.AreEqual(2000, call.timestamp);
+        }
+    }
+}
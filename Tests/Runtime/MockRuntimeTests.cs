@@ -1,8 +1,14 @@
+using System;
 using System.Collections;
 using System.Collections.Generic;
+using System.Runtime.InteropServices;
 using NUnit.Framework;
+using UnityEngine.InputSystem;
 using UnityEngine.XR.OpenXR.Features;
+using UnityEngine.XR.OpenXR.Features.ConformanceAutomation;
+using UnityEngine.XR.OpenXR.Features.Interactions;
 using UnityEngine.XR.OpenXR.Features.Mock;
+using UnityEngine.XR.OpenXR.Input;
 using UnityEngine.TestTools;
 using UnityEngine.TestTools.Utils;
 using UnityEngine.XR.OpenXR.NativeTypes;
@@ -214,6 +220,360 @@ namespace UnityEngine.XR.OpenXR.Tests
             Assert.IsTrue(instanceLost);
         }
 
+        [UnityTest]
+        public IEnumerator VirtualClockFastForward()
+        {
+            const long displayPeriod = 16666000;
+
+            InitializeAndStart();
+
+            yield return new WaitForXrFrame(1);
+
+            try
+            {
+                MockRuntime.SetClockMode(MockRuntime.ClockMode.Virtual);
+            }
+            catch (EntryPointNotFoundException)
+            {
+                Assert.Ignore("The MockRuntime library doesn't export MockRuntime_SetClockMode, rebuild it to run this test.");
+            }
+
+            var startTime = MockRuntime.GetClockTime();
+
+            yield return new WaitForXrFrame(2);
+
+            Assert.AreEqual(startTime, MockRuntime.GetClockTime(), "Virtual clock moved without being advanced");
+
+            MockRuntime.AdvanceClock(displayPeriod);
+            Assert.AreEqual(startTime + displayPeriod, MockRuntime.GetClockTime());
+
+            MockRuntime.SetClockMode(MockRuntime.ClockMode.VirtualFastForward);
+
+            yield return new WaitForXrFrame(3);
+
+            MockRuntime.SetClockMode(MockRuntime.ClockMode.Virtual);
+            var elapsed = MockRuntime.GetClockTime() - startTime;
+            Assert.IsTrue(elapsed > displayPeriod, "Fast forward clock didn't advance on xrWaitFrame");
+            Assert.AreEqual(0, elapsed % displayPeriod, "Fast forward clock advanced by something other than display periods");
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        struct XrActionsSyncInfo
+        {
+            public XrStructureType type;
+            public IntPtr next;
+            public uint countActiveActionSets;
+            public IntPtr activeActionSets;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        struct XrActiveActionSet
+        {
+            public ulong actionSet;
+            public ulong subactionPath;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        struct XrReferenceSpaceCreateInfo
+        {
+            public XrStructureType type;
+            public IntPtr next;
+            public XrReferenceSpaceType referenceSpaceType;
+            public XrPosef poseInReferenceSpace;
+        }
+
+        delegate XrResult GetInstanceProcAddrDelegate(ulong instance, [MarshalAs(UnmanagedType.LPStr)] string name, out IntPtr function);
+        delegate XrResult SyncActionsDelegate(ulong session, ref XrActionsSyncInfo syncInfo);
+        delegate XrResult StringToPathDelegate(ulong instance, [MarshalAs(UnmanagedType.LPStr)] string pathString, out ulong path);
+        delegate XrResult CreateReferenceSpaceDelegate(ulong session, ref XrReferenceSpaceCreateInfo createInfo, out ulong space);
+        delegate XrResult DestroySpaceDelegate(ulong space);
+
+        /// <summary>
+        /// Returns an OpenXR function of the running instance, for the calls the plugin has no c# entry point for.
+        /// </summary>
+        static T GetInstanceProc<T>(string name) where T : Delegate
+        {
+            var getInstanceProcAddr = Marshal.GetDelegateForFunctionPointer<GetInstanceProcAddrDelegate>(OpenXRFeature.Internal_GetProcAddressPtr(false));
+            Assert.AreEqual(XrResult.Success, getInstanceProcAddr(MockRuntime.Instance.XrInstance, name, out var function), $"Failed to get {name}");
+            return Marshal.GetDelegateForFunctionPointer<T>(function);
+        }
+
+        /// <summary>
+        /// Calls xrSyncActions without any active action set, which leaves every action set the plugin attached unsynced.
+        /// </summary>
+        static XrResult SyncNoActionSets()
+        {
+            var syncActions = GetInstanceProc<SyncActionsDelegate>("xrSyncActions");
+            var syncInfo = new XrActionsSyncInfo { type = XrStructureType.ActionsSyncInfo };
+            return syncActions(MockRuntime.Instance.XrSession, ref syncInfo);
+        }
+
+        /// <summary>
+        /// Returns the left hand select action of the simple controller profile.
+        /// </summary>
+        static ulong GetLeftSelectAction()
+        {
+            var action = OpenXRInput.GetActionHandle(new InputAction(null, InputActionType.Value, "<KHRSimpleController>{LeftHand}/select"));
+            Assert.AreNotEqual(0ul, action, "No action is bound to the left hand select click");
+            return action;
+        }
+
+        /// <summary>
+        /// Calls xrSyncActions with a single active action set, limited to one subaction path.
+        /// </summary>
+        static XrResult SyncActionSet(ulong actionSet, ulong subactionPath)
+        {
+            var syncActions = GetInstanceProc<SyncActionsDelegate>("xrSyncActions");
+            var activeActionSet = new XrActiveActionSet { actionSet = actionSet, subactionPath = subactionPath };
+            var handle = GCHandle.Alloc(activeActionSet, GCHandleType.Pinned);
+            try
+            {
+                var syncInfo = new XrActionsSyncInfo
+                {
+                    type = XrStructureType.ActionsSyncInfo,
+                    countActiveActionSets = 1,
+                    activeActionSets = handle.AddrOfPinnedObject()
+                };
+                return syncActions(MockRuntime.Instance.XrSession, ref syncInfo);
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+
+        static ulong StringToPath(string pathString)
+        {
+            var stringToPath = GetInstanceProc<StringToPathDelegate>("xrStringToPath");
+            Assert.AreEqual(XrResult.Success, stringToPath(MockRuntime.Instance.XrInstance, pathString, out var path), $"Failed to get the path of {pathString}");
+            return path;
+        }
+
+        static void SetLeftSelect(bool value) =>
+            ConformanceAutomationFeature.ConformanceAutomationSetBool("/user/hand/left", KHRSimpleControllerProfile.select, value);
+
+        static void SetRightSelect(bool value) =>
+            ConformanceAutomationFeature.ConformanceAutomationSetBool("/user/hand/right", KHRSimpleControllerProfile.select, value);
+
+        static XrResult ReadActionState(ulong action, out MockRuntime.ActionStateResult state) =>
+            ReadActionState(action, 0, out state);
+
+        static XrResult ReadActionState(ulong action, ulong subactionPath, out MockRuntime.ActionStateResult state)
+        {
+            var requests = new[] { new MockRuntime.ActionStateRequest { action = action, subactionPath = subactionPath } };
+            var results = new MockRuntime.ActionStateResult[1];
+            var result = MockRuntime.GetActionStates(requests, results);
+            state = results[0];
+            return result != XrResult.Success ? result : state.result;
+        }
+
+        /// <summary>
+        /// Aggregated state of an action in the snapshot of the last xrSyncActions.  Ignores the test if the MockRuntime
+        /// library was built before MockRuntime_GetActionStates was added.
+        /// </summary>
+        static MockRuntime.ActionStateResult GetActionState(ulong action, ulong subactionPath = 0)
+        {
+            var result = XrResult.Success;
+            var state = default(MockRuntime.ActionStateResult);
+            try
+            {
+                result = ReadActionState(action, subactionPath, out state);
+            }
+            catch (EntryPointNotFoundException)
+            {
+                Assert.Ignore("The MockRuntime library doesn't export MockRuntime_GetActionStates, rebuild it to run this test.");
+            }
+
+            Assert.AreEqual(XrResult.Success, result);
+            return state;
+        }
+
+        [UnityTest]
+        public IEnumerator ActionStateChangeTracking()
+        {
+            EnableFeature<KHRSimpleControllerProfile>();
+            EnableFeature<ConformanceAutomationFeature>();
+
+            InitializeAndStart();
+
+            yield return new WaitForXrFrame(2);
+
+            var select = GetLeftSelectAction();
+            SetLeftSelect(false);
+            var state = GetActionState(select);
+            Assert.AreEqual(1u, state.isActive, "Synced action should be active");
+            Assert.AreEqual(0u, state.booleanValue);
+
+            // Snapshot after every sync, the plugin may sync more than once per frame
+            var states = new List<MockRuntime.ActionStateResult>();
+            MockRuntime.SetFunctionCallback("xrSyncActions", (_, result) =>
+            {
+                if (result == XrResult.Success && ReadActionState(select, out var syncedState) == XrResult.Success)
+                    states.Add(syncedState);
+            });
+
+            SetLeftSelect(true);
+
+            yield return new WaitForXrFrame(3);
+
+            MockRuntime.ClearFunctionCallbacks();
+
+            var changed = states.FindIndex(s => s.booleanValue != 0);
+            Assert.GreaterOrEqual(changed, 0, "Select click never reached the action");
+            Assert.Greater(states.Count, changed + 1, "No xrSyncActions after the one that saw the change");
+            Assert.AreEqual(1u, states[changed].changedSinceLastSync, "changedSinceLastSync not set by the sync that saw the change");
+            Assert.Greater(states[changed].lastChangeTime, 0, "lastChangeTime not set by the sync that saw the change");
+
+            for (var i = changed + 1; i < states.Count; i++)
+            {
+                Assert.AreEqual(1u, states[i].booleanValue);
+                Assert.AreEqual(0u, states[i].changedSinceLastSync, "changedSinceLastSync set without a change");
+                Assert.AreEqual(states[changed].lastChangeTime, states[i].lastChangeTime, "lastChangeTime moved without a change");
+            }
+        }
+
+        [UnityTest]
+        public IEnumerator UnsyncedActionSetsAreInactive()
+        {
+            EnableFeature<KHRSimpleControllerProfile>();
+            EnableFeature<ConformanceAutomationFeature>();
+
+            InitializeAndStart();
+
+            yield return new WaitForXrFrame(1);
+
+            var select = GetLeftSelectAction();
+            SetLeftSelect(true);
+
+            yield return new WaitForXrFrame(2);
+
+            var state = GetActionState(select);
+            Assert.AreEqual(1u, state.isActive, "Synced action should be active");
+            Assert.AreEqual(1u, state.booleanValue);
+
+            Assert.AreEqual(XrResult.Success, SyncNoActionSets());
+
+            state = GetActionState(select);
+            Assert.AreEqual(0u, state.isActive, "Action in an action set that wasn't synced should be inactive");
+            Assert.AreEqual(0u, state.changedSinceLastSync);
+            Assert.AreEqual(1u, state.booleanValue, "Action in an action set that wasn't synced should keep its value");
+        }
+
+        [UnityTest]
+        public IEnumerator ActionStatesInactiveWhenNotFocused()
+        {
+            EnableFeature<KHRSimpleControllerProfile>();
+            EnableFeature<ConformanceAutomationFeature>();
+
+            InitializeAndStart();
+
+            yield return new WaitForXrFrame(1);
+
+            var select = GetLeftSelectAction();
+            SetLeftSelect(true);
+
+            yield return new WaitForXrFrame(2);
+
+            Assert.AreEqual(1u, GetActionState(select).isActive, "Synced action should be active");
+
+            var unfocusedStates = new List<MockRuntime.ActionStateResult>();
+            MockRuntime.SetFunctionCallback("xrSyncActions", (_, result) =>
+            {
+                if (result == XrResult.SessionNotFocused && ReadActionState(select, out var unfocusedState) == XrResult.Success)
+                    unfocusedStates.Add(unfocusedState);
+            });
+
+            Assert.IsTrue(MockRuntime.TransitionToState(XrSessionState.Visible, false), "Failed to transition to visible state");
+            Assert.AreEqual(XrResult.SessionNotFocused, SyncNoActionSets());
+
+            // Syncs made by the plugin while unfocused must leave its actions inactive too
+            yield return new WaitForXrFrame(2);
+
+            MockRuntime.ClearFunctionCallbacks();
+
+            Assert.IsNotEmpty(unfocusedStates);
+            foreach (var state in unfocusedStates)
+                Assert.AreEqual(0u, state.isActive, "Action should be inactive while the session isn't focused");
+        }
+
+        [UnityTest]
+        public IEnumerator SyncWithSubactionPath()
+        {
+            EnableFeature<KHRSimpleControllerProfile>();
+            EnableFeature<ConformanceAutomationFeature>();
+
+            InitializeAndStart();
+
+            yield return new WaitForXrFrame(1);
+
+            var select = GetLeftSelectAction();
+            var left = StringToPath("/user/hand/left");
+            var right = StringToPath("/user/hand/right");
+            SetLeftSelect(true);
+            SetRightSelect(true);
+
+            yield return new WaitForXrFrame(2);
+
+            Assert.AreEqual(1u, GetActionState(select, left).booleanValue);
+            Assert.AreEqual(1u, GetActionState(select, right).booleanValue);
+
+            var actionSet = 0ul;
+            try
+            {
+                actionSet = MockRuntime.GetActionSet(select);
+            }
+            catch (EntryPointNotFoundException)
+            {
+                Assert.Ignore("The MockRuntime library doesn't export MockRuntime_GetActionSet, rebuild it to run this test.");
+            }
+            Assert.AreNotEqual(0ul, actionSet, "No action set for the left hand select action");
+
+            SetLeftSelect(false);
+            SetRightSelect(false);
+            Assert.AreEqual(XrResult.Success, SyncActionSet(actionSet, left));
+
+            var leftState = GetActionState(select, left);
+            Assert.AreEqual(1u, leftState.isActive, "Synced subaction path should be active");
+            Assert.AreEqual(0u, leftState.booleanValue);
+            Assert.AreEqual(1u, leftState.changedSinceLastSync);
+
+            var rightState = GetActionState(select, right);
+            Assert.AreEqual(0u, rightState.isActive, "Subaction path that wasn't synced should be inactive");
+            Assert.AreEqual(0u, rightState.changedSinceLastSync);
+            Assert.AreEqual(1u, rightState.booleanValue, "Subaction path that wasn't synced should keep its value");
+
+            Assert.AreEqual(1u, GetActionState(select).isActive, "Aggregate state should be active when any subaction path is synced");
+        }
+
+        [UnityTest]
+        public IEnumerator StaleHandleAfterSlotReuse()
+        {
+            InitializeAndStart();
+
+            yield return new WaitForXrFrame(1);
+
+            var createReferenceSpace = GetInstanceProc<CreateReferenceSpaceDelegate>("xrCreateReferenceSpace");
+            var destroySpace = GetInstanceProc<DestroySpaceDelegate>("xrDestroySpace");
+            var createInfo = new XrReferenceSpaceCreateInfo
+            {
+                type = XrStructureType.ReferenceSpaceCreateInfo,
+                referenceSpaceType = XrReferenceSpaceType.Local,
+                poseInReferenceSpace = new XrPosef(Vector3.zero, Quaternion.identity)
+            };
+
+            Assert.AreEqual(XrResult.Success, createReferenceSpace(MockRuntime.Instance.XrSession, ref createInfo, out var staleSpace));
+            Assert.AreEqual(XrResult.Success, destroySpace(staleSpace));
+            Assert.AreEqual(XrResult.Success, createReferenceSpace(MockRuntime.Instance.XrSession, ref createInfo, out var space));
+
+            // The low 32 bits of a handle are its slot, see mock_slot_map.h
+            if ((space & 0xFFFFFFFF) != (staleSpace & 0xFFFFFFFF))
+                Assert.Ignore("The MockRuntime library doesn't reuse the slots of destroyed handles, rebuild it to run this test.");
+
+            Assert.AreNotEqual(staleSpace, space, "Handle of a reused slot must differ from the destroyed handle");
+            Assert.AreEqual(XrResult.HandleInvalid, destroySpace(staleSpace), "Destroyed handle must stay invalid after its slot is reused");
+            Assert.AreEqual(XrResult.Success, destroySpace(space), "Destroying the stale handle must not reach the space that reused its slot");
+        }
+
         [UnityTest]
         public IEnumerator DisplayTransparent()
         {
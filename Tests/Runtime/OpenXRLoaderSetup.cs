@@ -199,6 +199,7 @@ namespace UnityEngine.XR.OpenXR.Tests
 
             OpenXRRestarter.Instance.ResetCallbacks();
             StopAndShutdown();
+            DestroyLeakedRuntimes();
             EnableMockRuntime(false);
             MockRuntime.Instance.TestCallback = (_, _) => true;
             MockRuntime.KeepFunctionCallbacks = false;
@@ -212,6 +213,18 @@ namespace UnityEngine.XR.OpenXR.Tests
             WaitForRestarterToFinish();
         }
 
+        // Tests that make xrDestroyInstance fail leave their runtime behind, don't let it pile up across the run.
+        static void DestroyLeakedRuntimes()
+        {
+            try
+            {
+                MockRuntime.DestroyLeakedRuntimes();
+            }
+            catch (EntryPointNotFoundException)
+            {
+            }
+        }
+
         IEnumerable WaitForRestarterToFinish()
         {
             // It is possible that a test may have done something to initiate the OpenXRRestarter.  To ensure